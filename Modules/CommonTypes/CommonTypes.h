@@ -11,6 +11,8 @@
 #include <utility>
 #include <nlohmann/json.hpp>
 #include <atomic>
+#include <array>
+#include <cstdint>
 
 class ParameterManager;
 
@@ -294,6 +296,92 @@ struct UniqueIDGenerator
     }
 };
 
+// Pipeline stages a tick passes through on its way to becoming an order.
+enum class TraceStage
+{
+    Generation,
+    ContainerInsert,
+    Processing,
+    RiskAudit,
+    Filter,
+    Submission,
+    Ack,
+    Count
+};
+
+// Latency trace carried from TradeSignal to PendingOrder to ExecutedOrder.
+// A trace starts with the processing pass that created it: a TradeSystem::Process iteration, or a LevelManager pass for
+// level signals. It measures from the start of that pass, not from the platform's tick, whose arrival time is not
+// exposed. All timestamps are steady_clock nanoseconds so that stage deltas are monotonic; a stage left at 0 was not
+// reached.
+struct TraceContext
+{
+    static constexpr size_t StageCount = static_cast<size_t>(TraceStage::Count);
+
+    uint64_t iteration = 0;     // process-wide count of started traces; 0 means the trace was never started
+    int64_t processStartNs = 0; // when the processing pass that started the trace began
+    std::array<int64_t, StageCount> stageTimestampsNs{};
+
+    static int64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Starts a new trace for the processing pass that is about to run.
+    static TraceContext Begin()
+    {
+        static std::atomic<uint64_t> nextSequence{1};
+        TraceContext trace;
+        trace.iteration = nextSequence.fetch_add(1, std::memory_order_relaxed);
+        trace.processStartNs = Now();
+        return trace;
+    }
+
+    bool IsActive() const
+    {
+        return iteration != 0;
+    }
+
+    void Stamp(TraceStage stage)
+    {
+        if (IsActive())
+        {
+            stageTimestampsNs[static_cast<size_t>(stage)] = Now();
+        }
+    }
+
+    int64_t GetStageTimestamp(TraceStage stage) const
+    {
+        return stageTimestampsNs[static_cast<size_t>(stage)];
+    }
+
+    // Nanoseconds from the start of the processing pass to the given stage, or -1 if the stage was not reached.
+    int64_t GetLatencyFromStart(TraceStage stage) const
+    {
+        int64_t timestamp = GetStageTimestamp(stage);
+        return (IsActive() && timestamp != 0) ? timestamp - processStartNs : -1;
+    }
+
+    nlohmann::json ToJson() const
+    {
+        return {
+            {"iteration", iteration},
+            {"processStartNs", processStartNs},
+            {"stageTimestampsNs", stageTimestampsNs}};
+    }
+
+    static TraceContext FromJson(const nlohmann::json &j)
+    {
+        TraceContext trace;
+        trace.iteration = j.at("iteration").get<uint64_t>();
+        trace.processStartNs = j.at("processStartNs").get<int64_t>();
+        trace.stageTimestampsNs = j.at("stageTimestampsNs").get<std::array<int64_t, StageCount>>();
+        return trace;
+    }
+};
+
 enum class OrderType
 {
     Market,
@@ -429,6 +517,7 @@ struct PendingOrder
     OrderDirection direction;
     RiskAssessment orderRisk;
     std::optional<std::vector<PendingOrder>> attachedOrders;
+    TraceContext trace;
 };
 
 struct ExecutedOrder
@@ -444,6 +533,7 @@ struct ExecutedOrder
     DateTime exitTime;
     OrderStatus status = OrderStatus::None;
     OrderDirection direction = OrderDirection::None;
+    TraceContext trace;
 
     std::string ToString() const
     {
@@ -863,6 +953,7 @@ struct TradeSignal
     double signalWeight = 1.0;
     std::vector<std::string> attachedSignalIds;
     std::string tradeSystemName = GetTradeSystemName(); // Assign from function
+    TraceContext trace;
 
     TradeSignal() : id(UniqueIDGenerator::GenerateID()) {}
 
@@ -908,7 +999,8 @@ struct TradeSignal
             {"quantity", quantity},
             {"signalWeight", signalWeight},
             {"attachedSignalIds", attachedSignalIds},
-            {"tradeSystemName", tradeSystemName} // Add tradeSystemName to JSON
+            {"tradeSystemName", tradeSystemName}, // Add tradeSystemName to JSON
+            {"trace", trace.ToJson()}
         };
     }
 
@@ -931,6 +1023,10 @@ struct TradeSignal
         signal.signalWeight = j.at("signalWeight").get<double>();
         signal.attachedSignalIds = j.at("attachedSignalIds").get<std::vector<std::string>>();
         signal.tradeSystemName = j.at("tradeSystemName").get<std::string>(); // Add tradeSystemName
+        if (j.contains("trace"))
+        {
+            signal.trace = TraceContext::FromJson(j.at("trace"));
+        }
         return signal;
     }
 
@@ -1302,6 +1398,7 @@ struct BaseLevel
     std::string levelType;
     DateTime timestamp = DateTime();
     bool clearOnTouch = false;
+    bool touched = false; // Set once the market has reached the level
     std::optional<double> targetPrice;
     std::optional<double> stopLossPrice;
     std::string tradeSystemName = GetTradeSystemName(); // Assign from function
@@ -1325,6 +1422,7 @@ struct BaseLevel
         j["levelType"] = levelType;
         j["timestamp"] = timestamp.ToString();
         j["clearOnTouch"] = clearOnTouch;
+        j["touched"] = touched;
         if (targetPrice.has_value())
             j["targetPrice"] = targetPrice.value();
         if (stopLossPrice.has_value())
@@ -1338,6 +1436,8 @@ struct BaseLevel
         BaseLevel level(j.at("price").get<double>(), j.at("levelType").get<std::string>(), DateTime::FromString(j.at("timestamp").get<std::string>()));
         level.id = j.at("id").get<std::string>();
         level.clearOnTouch = j.at("extendUntilIntersection").get<bool>();
+        if (j.contains("touched"))
+            level.touched = j.at("touched").get<bool>();
         if (j.contains("targetPrice"))
             level.targetPrice = j.at("targetPrice").get<double>();
         if (j.contains("stopLossPrice"))
@@ -1353,7 +1453,8 @@ struct BaseLevel
            << ", Price: " << price
            << ", LevelType: " << levelType
            << ", Timestamp: " << timestamp.ToString()
-           << ", ExtendUntilIntersection: " << clearOnTouch;
+           << ", ExtendUntilIntersection: " << clearOnTouch
+           << ", Touched: " << touched;
         if (targetPrice.has_value())
             os << ", TargetPrice: " << targetPrice.value();
         if (stopLossPrice.has_value())
@@ -1695,12 +1796,17 @@ struct SystemSettings
 {
     bool enableLogging;
     int liveResultsSnapshotIntervalMinutes;
+    // Log levels, e.g. {"level": "INFO", "modules": {"Networking": "DEBUG"}}; see Logger::ApplyLevelConfig
+    std::optional<nlohmann::json> logLevels;
 
     nlohmann::json ToJson() const
     {
-        return {
+        nlohmann::json j = {
             {"enableLogging", enableLogging},
             {"liveResultsSnapshotIntervalMinutes", liveResultsSnapshotIntervalMinutes}};
+        if (logLevels)
+            j["logLevels"] = *logLevels;
+        return j;
     }
 
     static SystemSettings FromJson(const nlohmann::json &j)
@@ -1708,6 +1814,8 @@ struct SystemSettings
         SystemSettings ss;
         ss.enableLogging = j.at("enableLogging").get<bool>();
         ss.liveResultsSnapshotIntervalMinutes = j.at("liveResultsSnapshotIntervalMinutes").get<int>();
+        if (j.contains("logLevels") && !j.at("logLevels").is_null())
+            ss.logLevels = j.at("logLevels");
         return ss;
     }
 };
@@ -159,9 +159,9 @@ bool ContextManager::IsTradingDay(const DateTime& currentTime)
 
      if(tradingSystem.IsLoggingEnabled())
      {
-         Logger::Log("CurrentTime System Time: " + currentTime.ToString(), Logger::LogLevel::LOG_INFO);
-         Logger::Log("Trade Window Start: " + tradingWindow->GetStartTime(&currentTime).ToString(), Logger::LogLevel::LOG_INFO);
-         Logger::Log("Trade Window End: " + tradingWindow->GetEndTime(&currentTime).ToString(), Logger::LogLevel::LOG_INFO);
+         LOG_INFO("CurrentTime System Time: {}", currentTime);
+         LOG_INFO("Trade Window Start: {}", tradingWindow->GetStartTime(&currentTime));
+         LOG_INFO("Trade Window End: {}", tradingWindow->GetEndTime(&currentTime));
      }    
 
     auto tradingWindowValue = tradingWindow.value();
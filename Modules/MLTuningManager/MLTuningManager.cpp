@@ -18,16 +18,30 @@ namespace net = boost::asio;
 using tcp = net::ip::tcp;
 using json = nlohmann::json;
 
-MLTuningManager::MLTuningManager(std::shared_ptr<ITuningDataProcessor> tuner, ParameterManager& parameterManager, std::shared_ptr<Messaging> messaging)
-    : tuner(tuner), parameterManager(parameterManager), running(true), ioc(1), httpClient(std::make_shared<HttpClient>()), server(std::make_shared<MLTuningManagerServer>(ioc, std::nullopt, messaging)), messaging_(messaging) {    
+namespace {
+    HttpClientConfig PythonServerConfig(WireFormat wireFormat) {
+        HttpClientConfig config;
+        config.format = wireFormat;
+        return config;
+    }
+}
 
-    messaging_->Subscribe([this](const std::string& data) {
-        DataBlob dataBlob;
-        dataBlob.key = "performance_data";
-        dataBlob.data = json::parse(data);
-        
-        ProcessQueue(data);
-    });
+MLTuningManager::MLTuningManager(std::shared_ptr<ITuningDataProcessor> tuner, ParameterManager& parameterManager, std::shared_ptr<MessageBus> bus,
+                                 WireFormat wireFormat)
+    : tuner(tuner), parameterManager(parameterManager), running(true), ioc(1), httpClient(std::make_shared<HttpClient>(PythonServerConfig(wireFormat))), server(std::make_shared<MLTuningManagerServer>(ioc, std::nullopt, bus)), bus_(bus) {    
+
+    // Processed on the thread pool, as the tuner may be slow
+    dataSubscription_ = bus_->GetTopic<DataBlob>(TuningDataTopic, TuningDataTopicConfig())->SubscribeEach(
+        [this](const DataBlob& dataBlob) { ProcessData(dataBlob); }, DeliveryThread::ThreadPool);
+
+    OutboxConfig tuningOutboxConfig;
+    tuningOutboxConfig.route = "/process-data-batch";
+    tuningOutboxConfig.recordRoute = "/process-data";
+    tuningOutboxConfig.spillPath = parameterManager.GetSystemName() + "-tuning.outbox";
+    tuningOutboxConfig.onResponse = [this](const HttpResponse& response) {
+        HandleProcessDataResponse(DecodeWire(response.content, response.contentType));
+    };
+    tuningOutbox_ = std::make_unique<Outbox>(httpClient, tuningOutboxConfig);
     
     server->Start();
 }
@@ -35,40 +49,80 @@ MLTuningManager::MLTuningManager(std::shared_ptr<ITuningDataProcessor> tuner, Pa
 MLTuningManager::~MLTuningManager() {
     running = false;
     cv.notify_all();
+    dataSubscription_->Cancel();
+    {
+        std::lock_guard<std::mutex> lock(transportMutex_);
+        transport_.reset();
+    }
     server.reset();
+    tuningOutbox_.reset();
     httpClient.reset();    
-    messaging_.reset();
+    bus_.reset();
     tuner.reset();
 }
 
-void MLTuningManager::ProcessQueue(const std::string& request) {
-    ThreadPool::Instance().Enqueue([this, request] {        
-        DataBlob newData;                
-        newData.key = "performance_data";
-        newData.data = json::parse(request);                               
-        
-        auto mlInput = tuner->ProcessData(parameterManager.GetParameterGroup(), newData);
-
-        // We can aggregate multiple blobs in ProcessData implementation. When we're ready to actually submit a request.
-        // We would return the MachineLearningInput value to send along.
-        if(mlInput.has_value())
-        {
-            SendDataToPythonServer(mlInput.value());
-        }
-    });
+void MLTuningManager::ProcessData(const DataBlob& dataBlob) {
+    auto mlInput = tuner->ProcessData(parameterManager.GetParameterGroup(), dataBlob);
+
+    // We can aggregate multiple blobs in ProcessData implementation. When we're ready to actually submit a request.
+    // We would return the MachineLearningInput value to send along.
+    if(mlInput.has_value())
+    {
+        SendDataToPythonServer(mlInput.value());
+    }
 }
 
 void MLTuningManager::SendDataToPythonServer(const MachineLearningInput& mlInput) {
     json j = mlInput.ToJson();
-    std::string body = j.dump();
-
-    httpClient->SendRequest("/process-data", body, [this](HttpResponse response) {
-        if (response.success) {
-            auto responseData = json::parse(response.content);
-            // TODO: Some callback to alert system that tuned parameters are avilable.
-            Logger::Log("ML Tuning Response Success", Logger::LogLevel::LOG_INFO);
-        } else {
-            Logger::Log("Error: " + response.content, Logger::LogLevel::LOG_ERROR);
+
+    std::shared_ptr<IMessageTransport> transport;
+    {
+        std::lock_guard<std::mutex> lock(transportMutex_);
+        transport = transport_;
+    }
+    if (transport) {
+        if (!transport->Send("/process-data\n" + j.dump())) {
+            LOG_ERROR("Error: shared memory transport full; process-data request dropped");
+        }
+        return;
+    }
+
+    tuningOutbox_->Post(std::move(j));
+}
+
+void MLTuningManager::HandleProcessDataResponse([[maybe_unused]] const json& responseData) {
+    // TODO: Some callback to alert system that tuned parameters are avilable.
+    LOG_INFO("ML Tuning Response Success");
+}
+
+bool MLTuningManager::EnableSharedMemoryTransport(const std::string& name) {
+    auto transport = std::make_shared<SharedMemoryTransport>(name, SharedMemoryTransport::Role::Host);
+    if (!transport->IsOpen()) {
+        return false;
+    }
+    transport->Subscribe([this](std::string_view message) { HandleTransportMessage(message); });
+
+    std::lock_guard<std::mutex> lock(transportMutex_);
+    transport_ = std::move(transport);
+    return true;
+}
+
+void MLTuningManager::HandleTransportMessage(std::string_view message) {
+    size_t separator = message.find('\n');
+    std::string_view route = message.substr(0, separator);
+    std::string_view body = separator == std::string_view::npos ? std::string_view() : message.substr(separator + 1);
+
+    if (route == "/receive-data") {
+        // Same handling as MLTuningManagerServer, minus the HTTP round trip
+        DataBlob dataBlob;
+        dataBlob.key = "performance_data";
+        dataBlob.data = json::parse(body);
+        if (!bus_->GetTopic<DataBlob>(TuningDataTopic, TuningDataTopicConfig())->Publish(std::move(dataBlob))) {
+            LOG_ERROR("Tuning data queue full; data blob dropped");
         }
-    });
+    } else if (route == "/process-data") {
+        HandleProcessDataResponse(json::parse(body));
+    } else {
+        LOG_WARNING("Unknown shared memory route: {}", route);
+    }
 }
@@ -16,7 +16,9 @@
 #include "ThreadSafeQueue.h"
 #include "ThreadPool.h"
 #include "HttpClient.h"
+#include "Outbox.h"
 #include "MLTuningManagerServer.h"
+#include "SharedMemoryTransport.h"
 #include "nlohmann/json.hpp"
 
 namespace beast = boost::beast;
@@ -30,11 +32,20 @@ class ParameterManager;
 
 class MLTuningManager {
 public:
-    MLTuningManager(std::shared_ptr<ITuningDataProcessor> tuner, ParameterManager& parameterManager, std::shared_ptr<Messaging> messaging);
+    // wireFormat is asked of the Python server for responses and used for the batches posted to it; JSON is the fallback.
+    MLTuningManager(std::shared_ptr<ITuningDataProcessor> tuner, ParameterManager& parameterManager, std::shared_ptr<MessageBus> bus,
+                    WireFormat wireFormat = WireFormat::Json);
     ~MLTuningManager();
 
+    // Exchanges data with a Python server on the same host through shared memory instead of HTTP. Each message is
+    // the HTTP route, a newline and the JSON body: "/receive-data" from the server, "/process-data" to it and back.
+    // Returns false, staying on HTTP, if the segments could not be created.
+    bool EnableSharedMemoryTransport(const std::string& name);
+
 private:    
-    void ProcessQueue(const std::string& request);
+    void ProcessData(const DataBlob& dataBlob);
+    void HandleTransportMessage(std::string_view message);
+    void HandleProcessDataResponse(const json& responseData);
     void SendDataToPythonServer(const MachineLearningInput& mlInput);
 
     std::shared_ptr<ITuningDataProcessor> tuner;
@@ -44,8 +55,13 @@ private:
     std::mutex mtx;
     net::io_context ioc;
     std::shared_ptr<HttpClient> httpClient;
+    std::unique_ptr<Outbox> tuningOutbox_; // batches inputs to /process-data-batch over HTTP
     std::shared_ptr<Server> server;
-    std::shared_ptr<Messaging> messaging_;        
+    std::shared_ptr<MessageBus> bus_;
+    std::shared_ptr<MessageTopic<DataBlob>::Subscription> dataSubscription_;
+
+    std::mutex transportMutex_;
+    std::shared_ptr<IMessageTransport> transport_; // null while the Python server is reached over HTTP
 };
 
 #endif // PARAMETER_PERFORMANCE_MANAGER_H
@@ -9,17 +9,25 @@ void MLTuningManagerServer::HandleRequest(tcp::socket socket) {
         http::read(stream, buffer, req);
 
         if (req.method() == http::verb::post && req.target() == "/receive-data") {
-            auto body = req.body();            
-            messaging_->PushRequest(body);            
+            // Decoded once here, from JSON, MessagePack or CBOR; subscribers receive the document itself
+            std::optional<nlohmann::json> body = ReadBody(stream, req);
+            if (!body) {
+                return;
+            }
+            DataBlob dataBlob;
+            dataBlob.key = "performance_data";
+            dataBlob.data = std::move(*body);
 
-            http::response<http::string_body> res{http::status::ok, req.version()};
-            res.set(http::field::server, "Boost.Beast");
-            res.set(http::field::content_type, "application/json");
-            res.body() = R"({"status":"Data received"})";
-            res.prepare_payload();
-            http::write(stream, res);
+            // Tells the client to retry instead of acknowledging data that was never queued
+            bool queued = bus_->GetTopic<DataBlob>(TuningDataTopic, TuningDataTopicConfig())->Publish(std::move(dataBlob));
+            if (!queued) {
+                LOG_ERROR("Tuning data queue full; data blob dropped");
+            }
+
+            WriteResponse(stream, req, queued ? http::status::ok : http::status::service_unavailable,
+                          {{"status", queued ? "Data received" : "Busy, retry later"}});
         }
     } catch (const std::exception& e) {
-        Logger::Log("Error handling request: " + std::string(e.what()), Logger::LogLevel::LOG_ERROR);
+        LOG_ERROR("Error handling request: {}", e.what());
     }
 }
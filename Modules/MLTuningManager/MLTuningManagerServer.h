@@ -2,6 +2,18 @@
 #define PARAMETER_PERFORMANCE_MANAGER_SERVER_H
 
 #include "Server.h"
+#include <string>
+
+// Tuning data posted to /receive-data, published as DataBlobs keyed "performance_data"
+inline const std::string TuningDataTopic = "tuning-data";
+
+// Every blob feeds the tuner, so a full queue holds the posting request back rather than losing data.
+inline TopicConfig<DataBlob> TuningDataTopicConfig() {
+    TopicConfig<DataBlob> config;
+    config.overflow = OverflowPolicy::Block;
+    config.blockTimeout = std::chrono::seconds(5);
+    return config;
+}
 
 class MLTuningManagerServer : public Server {
 public:
@@ -2,6 +2,7 @@
 #define DEFAULT_ORDER_MANAGER_H
 
 #include "OrderManager.h"
+#include "LatencyTracer.h"
 #include <unordered_map>
 #include <vector>
 
@@ -14,9 +15,20 @@ public:
         std::vector<ExecutedOrder> executedOrders;
 
         for (const auto& pendingOrder : pendingOrders) {
-            auto result = orderProcessor_->ProcessPendingOrder(pendingOrder, tp);
+            PendingOrder submittedOrder = pendingOrder;
+            submittedOrder.trace.Stamp(TraceStage::Submission);
+
+            auto result = orderProcessor_->ProcessPendingOrder(submittedOrder, tp);
             if (result.has_value()) {
                 auto orders = result.value();
+                for (auto& order : orders) {
+                    // Processors that build their own ExecutedOrder may not carry the trace forward
+                    if (!order.trace.IsActive()) {
+                        order.trace = submittedOrder.trace;
+                    }
+                    order.trace.Stamp(TraceStage::Ack);
+                    LatencyTracer::Instance().Record(order.trace);
+                }
                 executedOrders.insert(executedOrders.end(), orders.begin(), orders.end());
             }
         }
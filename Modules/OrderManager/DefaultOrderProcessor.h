@@ -19,6 +19,7 @@ public:
         order.entryPrice = pendingOrder.price;
         order.filledQuantity = pendingOrder.quantity;
         order.status = OrderStatus::Filled;
+        order.trace = pendingOrder.trace;
         executedOrders.push_back(order);
 
         return executedOrders;
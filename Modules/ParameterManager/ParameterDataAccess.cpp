@@ -6,7 +6,6 @@
 #include <boost/beast/version.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
-#include "ParameterDataAccessServer.h"
 
 namespace beast = boost::beast;
 namespace http = beast::http;
@@ -14,42 +13,52 @@ namespace net = boost::asio;
 using tcp = net::ip::tcp;
 using json = nlohmann::json;
 
-ParameterDataAccess::ParameterDataAccess(std::shared_ptr<Messaging> messaging, ParameterManager& parameterManager)
-    : parameterManager(parameterManager), messaging_(messaging), ioc_(), httpClient_(std::make_shared<HttpClient>()), server(std::make_shared<ParameterDataAccessServer>(ioc_, std::nullopt, messaging)) {
+namespace {
+    HttpClientConfig DataServerConfig(WireFormat wireFormat) {
+        HttpClientConfig config;
+        config.format = wireFormat;
+        return config;
+    }
+}
 
-    server->Start();    
-    messaging->Subscribe([this](const std::string& data) {
-        json jsonData = json::parse(data);
-        if (jsonData.contains("tradeSystemName")) {
-            std::string tradeSystemName = jsonData["tradeSystemName"];
-            std::optional<std::string> groupId = jsonData.contains("groupId") ? std::optional<std::string>(jsonData["groupId"].get<std::string>()) : std::nullopt;
+ParameterDataAccess::ParameterDataAccess(std::shared_ptr<MessageBus> bus, ParameterManager& parameterManager, WireFormat wireFormat)
+    : parameterManager(parameterManager), bus_(bus), httpClient_(std::make_shared<HttpClient>(DataServerConfig(wireFormat))), ioc_(), server(std::make_shared<ParameterDataAccessServer>(ioc_, std::nullopt, bus)) {
 
-            if (jsonData.contains("action") && jsonData["action"] == "update-parameter-group") {
-                FetchParameterGroupFromDatabase(tradeSystemName, groupId);
-            } else if (jsonData.contains("action") && jsonData["action"] == "update-trading-system") {
-                FetchTradingSystemFromDatabase(tradeSystemName);
-            }
-        }
-    });
+    updateSubscription_ = bus_->GetTopic<ParameterUpdateRequest>(ParameterUpdateTopic, ParameterUpdateTopicConfig())->SubscribeEach(
+        [this](const ParameterUpdateRequest& update) { HandleUpdateRequest(update); });
+
+    OutboxConfig sessionOutboxConfig;
+    sessionOutboxConfig.route = "/insert-sessions";
+    sessionOutboxConfig.recordRoute = "/insert-session";
+    sessionOutboxConfig.spillPath = parameterManager.GetSystemName() + "-sessions.outbox";
+    sessionOutbox_ = std::make_unique<Outbox>(httpClient_, sessionOutboxConfig);
+    server->Start();
 }
 
 ParameterDataAccess::~ParameterDataAccess() {
     running_ = false;    
+    updateSubscription_->Cancel();
+    sessionOutbox_.reset();
     httpClient_.reset();
-    messaging_.reset();
+    bus_.reset();
     ioc_.reset();
     server.reset();
 }
 
-void ParameterDataAccess::SendSessionToServer(const TradeSession &sessionResult) {
-    json j = sessionResult.ToJson();
-    std::string body = j.dump();
+void ParameterDataAccess::HandleUpdateRequest(const ParameterUpdateRequest& update) {
+    switch (update.action) {
+        case ParameterUpdateRequest::Action::UpdateParameterGroup:
+            FetchParameterGroupFromDatabase(update.tradeSystemName, update.groupId);
+            break;
+        case ParameterUpdateRequest::Action::UpdateTradingSystem:
+            FetchTradingSystemFromDatabase(update.tradeSystemName);
+            break;
+    }
+}
 
-    httpClient_->SendRequest("/insert-session", body, [](HttpResponse response) {
-        if (!response.success) {
-            Logger::Log("Error: " + response.content, Logger::LogLevel::LOG_ERROR);
-        }
-    }, http::verb::post);
+void ParameterDataAccess::SendSessionToServer(const TradeSession &sessionResult) {
+    // Snapshots of a session still waiting to be sent are replaced, so backtests do not flood the server
+    sessionOutbox_->Post(sessionResult.ToJson(), sessionResult.id);
 }
 
 void ParameterDataAccess::FetchParameterGroupFromDatabase(const std::string &tradeSystemName, const std::optional<std::string> &groupId, bool block) {
@@ -83,7 +92,7 @@ void ParameterDataAccess::FetchParameterGroupFromDatabase(const std::string &tra
 void ParameterDataAccess::FetchParameterGroupCallback(const HttpResponse &response) {
     if (response.success) {
         try {
-            json j = json::parse(response.content);
+            json j = DecodeWire(response.content, response.contentType);
             if (j.empty()) {
                 Logger::Log("Error: No parameter group returned from database.", Logger::LogLevel::LOG_ERROR);
             }
@@ -121,7 +130,7 @@ void ParameterDataAccess::FetchTradingSystemFromDatabase(const std::string &trad
 void ParameterDataAccess::FetchTradingSystemCallback(const HttpResponse &response) {
     if (response.success) {
         try {
-            json j = json::parse(response.content);
+            json j = DecodeWire(response.content, response.contentType);
             if (j.empty() || !j.is_array() || j.size() == 0) {
                 Logger::Log("Error: No trading system returned from database.", Logger::LogLevel::LOG_ERROR);
                 return;
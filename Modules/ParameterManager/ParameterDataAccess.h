@@ -10,8 +10,10 @@
 #include <boost/asio.hpp>
 #include "CommonTypes.h"
 #include "HttpClient.h"
-#include "Messaging.h"
+#include "MessageBus.h"
+#include "Outbox.h"
 #include "Server.h"
+#include "ParameterDataAccessServer.h"
 
 class ParameterManager;
 
@@ -21,16 +23,20 @@ public:
     void FetchParameterGroupFromDatabase(const std::string& tradeSystemName, const std::optional<std::string>& groupId = std::nullopt, bool block = false);
     void FetchTradingSystemFromDatabase(const std::string& tradeSystemName, bool block = false);
 
-    ParameterDataAccess(std::shared_ptr<Messaging> messaging, ParameterManager& parameterManager);
+    // Responses are requested in wireFormat, and session batches sent in it, with JSON as the fallback.
+    ParameterDataAccess(std::shared_ptr<MessageBus> bus, ParameterManager& parameterManager, WireFormat wireFormat = WireFormat::Json);
     ~ParameterDataAccess();
 private:
 
     void FetchParameterGroupCallback(const HttpResponse& response);
     void FetchTradingSystemCallback(const HttpResponse& response);
+    void HandleUpdateRequest(const ParameterUpdateRequest& update);
 
     ParameterManager& parameterManager;
-    std::shared_ptr<Messaging> messaging_;
+    std::shared_ptr<MessageBus> bus_;
+    std::shared_ptr<MessageTopic<ParameterUpdateRequest>::Subscription> updateSubscription_;
     std::shared_ptr<HttpClient> httpClient_;
+    std::unique_ptr<Outbox> sessionOutbox_; // latest snapshot per session id, batched to /insert-sessions
     std::atomic<bool> running_;
     net::io_context ioc_;
     std::shared_ptr<Server> server;    
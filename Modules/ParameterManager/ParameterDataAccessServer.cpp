@@ -19,54 +19,51 @@ void ParameterDataAccessServer::HandleRequest(tcp::socket socket) {
         http::request<http::string_body> req;
         http::read(stream, buffer, req);
 
+        auto updates = bus_->GetTopic<ParameterUpdateRequest>(ParameterUpdateTopic, ParameterUpdateTopicConfig());
+
         if (req.method() == http::verb::post && req.target() == "/update-parameter-group") {
-            auto body = req.body();
-            json wrappedMessage = {
-                {"action", "update-parameter-group"},
-                {"tradeSystemName", ""},
-                {"groupId", ""}
-            };
+            ParameterUpdateRequest update;
+            update.action = ParameterUpdateRequest::Action::UpdateParameterGroup;
 
             // Parse the body to extract relevant fields
-            json bodyJson = json::parse(body);
+            std::optional<json> body = ReadBody(stream, req);
+            if (!body) {
+                return;
+            }
+            const json& bodyJson = *body;
             if (bodyJson.contains("tradeSystemName")) {
-                wrappedMessage["tradeSystemName"] = bodyJson["tradeSystemName"];
+                update.tradeSystemName = bodyJson["tradeSystemName"].get<std::string>();
             }
-            if (bodyJson.contains("groupId")) {
-                wrappedMessage["groupId"] = bodyJson["groupId"];
+            if (bodyJson.contains("groupId") && bodyJson["groupId"].is_string() && !bodyJson["groupId"].get<std::string>().empty()) {
+                update.groupId = bodyJson["groupId"].get<std::string>();
             }
 
-            messaging_->PushRequest(wrappedMessage.dump());
+            if (!updates->Publish(std::move(update))) {
+                LOG_ERROR("Parameter update queue full; update-parameter-group dropped");
+            }
 
-            http::response<http::string_body> res{http::status::ok, req.version()};
-            res.set(http::field::server, "Boost.Beast");
-            res.set(http::field::content_type, "application/json");
-            res.body() = R"({"status":"Parameter group update triggered"})";
-            res.prepare_payload();
-            http::write(stream, res);
+            WriteResponse(stream, req, http::status::ok, {{"status", "Parameter group update triggered"}});
         } else if (req.method() == http::verb::post && req.target() == "/update-trading-system") {
-            auto body = req.body();
-            json wrappedMessage = {
-                {"action", "update-trading-system"},
-                {"tradeSystemName", ""}
-            };
+            ParameterUpdateRequest update;
+            update.action = ParameterUpdateRequest::Action::UpdateTradingSystem;
 
             // Parse the body to extract relevant fields
-            json bodyJson = json::parse(body);
+            std::optional<json> body = ReadBody(stream, req);
+            if (!body) {
+                return;
+            }
+            const json& bodyJson = *body;
             if (bodyJson.contains("tradeSystemName")) {
-                wrappedMessage["tradeSystemName"] = bodyJson["tradeSystemName"];
+                update.tradeSystemName = bodyJson["tradeSystemName"].get<std::string>();
             }
 
-            messaging_->PushRequest(wrappedMessage.dump());
+            if (!updates->Publish(std::move(update))) {
+                LOG_ERROR("Parameter update queue full; update-trading-system dropped");
+            }
 
-            http::response<http::string_body> res{http::status::ok, req.version()};
-            res.set(http::field::server, "Boost.Beast");
-            res.set(http::field::content_type, "application/json");
-            res.body() = R"({"status":"Trading system update triggered"})";
-            res.prepare_payload();
-            http::write(stream, res);
+            WriteResponse(stream, req, http::status::ok, {{"status", "Trading system update triggered"}});
         }
     } catch (const std::exception& e) {
-        Logger::Log("Error handling request: " + std::string(e.what()), Logger::LogLevel::LOG_ERROR);
+        LOG_ERROR("Error handling request: {}", e.what());
     }
 }
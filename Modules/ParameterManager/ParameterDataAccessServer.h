@@ -2,6 +2,33 @@
 #define PARAMETER_DATA_ACCESS_SERVER_H
 
 #include "Server.h"
+#include <optional>
+#include <string>
+
+// Sent by the UI through ParameterDataAccessServer when a parameter group or trading system changed in the database.
+struct ParameterUpdateRequest {
+    enum class Action {
+        UpdateParameterGroup,
+        UpdateTradingSystem
+    };
+
+    Action action;
+    std::string tradeSystemName;
+    std::optional<std::string> groupId;  // latest group when not set
+};
+
+inline const std::string ParameterUpdateTopic = "parameter-updates";
+
+// A burst of saves in the UI asks for the same fetch repeatedly; requests for one system and group collapse into
+// whichever is still queued.
+inline TopicConfig<ParameterUpdateRequest> ParameterUpdateTopicConfig() {
+    TopicConfig<ParameterUpdateRequest> config;
+    config.overflow = OverflowPolicy::CoalesceByKey;
+    config.coalesceKey = [](const ParameterUpdateRequest& update) {
+        return std::to_string(static_cast<int>(update.action)) + '|' + update.tradeSystemName + '|' + update.groupId.value_or("");
+    };
+    return config;
+}
 
 class ParameterDataAccessServer : public Server {
 public:
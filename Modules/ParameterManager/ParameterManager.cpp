@@ -21,13 +21,17 @@ ParameterManager::~ParameterManager() {
     instance_.reset();
 }
 
-void ParameterManager::InitializeParameterManager(const std::string& systemName) {
+void ParameterManager::InitializeParameterManager(const std::string& systemName, WireFormat wireFormat) {
     systemName_ = systemName;
-    parameterDataAccess = std::make_shared<ParameterDataAccess>(std::make_shared<Messaging>(), *this);
+    parameterDataAccess = std::make_shared<ParameterDataAccess>(std::make_shared<MessageBus>(), *this, wireFormat);
 }
 
-void ParameterManager::InitializeMLTuningManager(std::shared_ptr<ITuningDataProcessor> tuner) {
-    _MLTuningManager = std::make_shared<MLTuningManager>(tuner, *this, std::make_shared<Messaging>());
+void ParameterManager::InitializeMLTuningManager(std::shared_ptr<ITuningDataProcessor> tuner, const std::optional<std::string>& sharedMemoryName,
+                                                 WireFormat wireFormat) {
+    _MLTuningManager = std::make_shared<MLTuningManager>(tuner, *this, std::make_shared<MessageBus>(), wireFormat);
+    if (sharedMemoryName && !_MLTuningManager->EnableSharedMemoryTransport(*sharedMemoryName)) {
+        LOG_WARNING("Shared memory transport '{}' unavailable; using HTTP", *sharedMemoryName);
+    }
 }
 
 std::string ParameterManager::GetSystemName() const {
@@ -45,9 +49,15 @@ void ParameterManager::UpdateParameterGroup(const TradeSystemParameterGroup& new
 }
 
 void ParameterManager::UpdateTradingSystem(const TradingSystem& newTradingSystem) {
-    std::unique_lock<std::shared_mutex> lock(mtx);
-    tradingSystem = newTradingSystem;
-    tradeSystemStale = true;
+    {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        tradingSystem = newTradingSystem;
+        tradeSystemStale = true;
+    }
+    // Applied on every update, so levels can be changed from the server while the system runs
+    if (newTradingSystem.systemSettings && newTradingSystem.systemSettings->logLevels) {
+        Logger::Instance().ApplyLevelConfig(*newTradingSystem.systemSettings->logLevels);
+    }
 }
 
 void ParameterManager::SendSession(const TradeSession& sessionResult) {
@@ -24,8 +24,10 @@ public:
     ParameterManager(const ParameterManager&) = delete;
     void operator=(const ParameterManager&) = delete;
 
-    void InitializeParameterManager(const std::string& systemName);
-    void InitializeMLTuningManager(std::shared_ptr<ITuningDataProcessor> tuner);
+    void InitializeParameterManager(const std::string& systemName, WireFormat wireFormat = WireFormat::Json);
+    // With `sharedMemoryName`, the Python tuning server on this host is reached through shared memory rather than HTTP.
+    void InitializeMLTuningManager(std::shared_ptr<ITuningDataProcessor> tuner, const std::optional<std::string>& sharedMemoryName = std::nullopt,
+                                   WireFormat wireFormat = WireFormat::Json);
     void InitializeParameters(ContextType contextType, const std::optional<std::string>& specificId = std::nullopt);
     ParameterValue GetParameter(const std::string& key) const;
     std::vector<ParameterValue> GetAllParameterValues() const;    
@@ -6,18 +6,26 @@ std::optional<std::vector<PendingOrder>> DefaultSignalManager::GeneratePendingOr
     std::vector<TradeSignal> newSignals = signalGenerator->GenerateSignals();
 
     // Add new signals to the unprocessed signals map
-    for (const auto& signal : newSignals) {
+    for (auto& signal : newSignals) {
+        AttachIterationTrace(signal.trace);
+        signal.trace.Stamp(TraceStage::Generation);
         signalContainer.AddSignal(signal);
     }
 
     // If running in synchronous mode, process levels and generate signals immediately
     // Otherwise, this is handled in its own thread and called on a loop.
-    if(mode_ == Mode::Synchronous && levelManager_) {
+    if(levelManager_ && levelManager_->GetMode() == Mode::Synchronous) {
         levelManager_->ProcessLevelsAndGenerateSignals();
     } 
 
     // Process signals and generate pending orders
     std::optional<std::vector<PendingOrder>> pendingOrders = signalProcessor->ProcessSignals();
+    if (pendingOrders.has_value()) {
+        for (auto& order : pendingOrders.value()) {
+            AttachIterationTrace(order.trace);
+            order.trace.Stamp(TraceStage::Processing);
+        }
+    }
 
     // Clear processed signals
     std::vector<TradeSignal> signalsToClear = signalProcessor->GetSignalsToClear();
@@ -11,30 +11,23 @@ public:
     std::optional<std::vector<PendingOrder>> ProcessSignals() override {
         std::vector<PendingOrder> pendingOrders;
 
-        // Example logic for processing signals and creating pending orders
-        auto signal2Opt = signalContainer.GetSignalById("SIGNAL_2");
-
-        if (signal2Opt.has_value()) {
-            auto signal2 = signal2Opt.value();
-            for (const auto& attachedId : signal2.attachedSignalIds) {
-                auto signal1Opt = signalContainer.GetSignalById(attachedId);
-                if (signal1Opt.has_value()) {
-                    auto signal1 = signal1Opt.value();
-
-                    PendingOrder order;
-                    order.signalWeight = 1; // Example weight
-                    order.symbol = "SYMBOL"; // Example symbol
-                    order.quantity = 1; // Example quantity
-                    order.price = signal1.price; // Example price from signal 1
-
-                    pendingOrders.push_back(order);
-
-                    // Mark the processed signals for clearing
-                    signalsToClear.push_back(signal1);
-                }
-            }
+        // Example logic: each SIGNAL_2 whose attached signals have all arrived is handed over as one group.
+        // The container removes the group as it hands it over, so nothing is added to signalsToClear.
+        if (!signalContainer.HasCompletedGroups()) {
+            return std::nullopt;
+        }
+
+        for (const auto& group : signalContainer.TakeCompletedGroups("SIGNAL_2")) {
+            for (const auto& signal1 : group.attachedSignals) {
+                PendingOrder order;
+                order.signalWeight = 1; // Example weight
+                order.symbol = "SYMBOL"; // Example symbol
+                order.quantity = 1; // Example quantity
+                order.price = signal1.price; // Example price from signal 1
+                order.trace = group.parent.trace; // Carry the originating tick trace into the order
 
-            signalsToClear.push_back(signal2);
+                pendingOrders.push_back(order);
+            }
         }
 
         if (!pendingOrders.empty()) {
@@ -42,9 +35,6 @@ public:
         }
         return std::nullopt;
     }
-
-private:
-    std::vector<TradeSignal> signalsToClear;
 };
 
 #endif // DEFAULT_SIGNAL_PROCESSOR_H
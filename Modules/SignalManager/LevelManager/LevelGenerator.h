@@ -2,14 +2,29 @@
 
 #include "CommonTypes.h"
 #include "ITradingPlatform.h"
+#include "IndicatorCache.h"
 #include <vector>
 #include <memory>
+#include <string>
+#include <typeinfo>
 
+// Generators run concurrently on the LevelManager's own pool, so GenerateLevels must not touch state shared with other
+// generators, and may only call the platform functions ITradingPlatform documents as safe from any thread.
 class LevelGenerator {
 public:
-    LevelGenerator(std::shared_ptr<ITradingPlatform> tradingPlatform) : tp(tradingPlatform) {}
+    LevelGenerator(std::shared_ptr<ITradingPlatform> tradingPlatform, UpdateIntervalType updateIntervalType = UpdateIntervalType::Always)
+        : tp(tradingPlatform), updateIntervalType_(updateIntervalType), indicatorCache(tradingPlatform->GetIndicatorCache()) {}
     virtual ~LevelGenerator() = default;
     virtual std::vector<BaseLevel> GenerateLevels(double currentPrice) = 0;
+
+    // New_Bar generators are skipped on intra-bar updates.
+    UpdateIntervalType GetUpdateIntervalType() const { return updateIntervalType_; }
+
+    // Identifies the generator in log messages; defaults to the compiler's name for the dynamic type.
+    virtual std::string GetName() const { return typeid(*this).name(); }
+
 protected:     
     std::shared_ptr<ITradingPlatform> tp;
+    UpdateIntervalType updateIntervalType_;
+    Calculations::IndicatorCache& indicatorCache; // The platform's cache; safe for concurrent reads from parallel generators
 };
@@ -1,13 +1,25 @@
 #include "LevelManager.h"
+#include "LevelUtilities.h"
+#include "Logger.h"
+#include <future>
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 
-LevelManager::LevelManager(std::vector<std::shared_ptr<LevelGenerator>> levelGenerators, std::shared_ptr<LevelProcessor> levelProcessor, std::shared_ptr<ITradingPlatform> tradingPlatform)
-    : levelGenerators(std::move(levelGenerators)), levelProcessor(std::move(levelProcessor)), tp(tradingPlatform), running(true)
+LevelManager::LevelManager(std::vector<std::shared_ptr<LevelGenerator>> levelGenerators, std::shared_ptr<LevelProcessor> levelProcessor, std::shared_ptr<ITradingPlatform> tradingPlatform, Mode mode, WaitPolicy waitPolicy, uint32_t spinIterations)
+    : levelGenerators(std::move(levelGenerators)), levelProcessor(std::move(levelProcessor)), tp(tradingPlatform), running(true), mode_(mode), waitPolicy_(waitPolicy), spinIterations_(spinIterations)
 {
-    mode_ = Mode::Synchronous;
-    messaging_ = std::make_shared<Messaging>(mode_);
+    // Generators get their own workers, so a busy shared ThreadPool (HTTP, servers, snapshot writes) cannot delay a pass
+    if (this->levelGenerators.size() > 1)
+    {
+        size_t workers = std::min(this->levelGenerators.size() - 1, std::max<size_t>(1, std::thread::hardware_concurrency()));
+        generatorPool_ = std::make_unique<ThreadPool>(workers);
+    }
+    bus_ = std::make_shared<MessageBus>(mode_);
+    TopicConfig<TradeSignal> signalConfig;
+    signalConfig.overflow = OverflowPolicy::Block; // a trade signal is never dropped for a slow subscriber
+    signalTopic_ = bus_->GetTopic<TradeSignal>("level-signals", std::move(signalConfig));
+    marketCursor_ = tp->GetMarketUpdateNotifier().GetSequence();
     if (mode_ == Mode::Asynchronous)
     {
         Start(); // Start the thread for async mode
@@ -17,11 +29,18 @@ LevelManager::LevelManager(std::vector<std::shared_ptr<LevelGenerator>> levelGen
 LevelManager::~LevelManager()
 {
     Stop();
+
+    // Final snapshot so a study reload resumes from the latest state
+    std::lock_guard<std::mutex> lock(levelsMutex);
+    if (snapshotStore_)
+    {
+        snapshotStore_->Save(CollectLevels());
+    }
 }
 
-void LevelManager::SubscribeToMessages(std::function<void(const std::string &)> callback)
+void LevelManager::SubscribeToSignals(std::function<void(const TradeSignal &)> callback)
 {
-    messaging_->Subscribe(callback);
+    signalTopic_->SubscribeEach(std::move(callback));
 }
 
 void LevelManager::Start()
@@ -35,70 +54,335 @@ void LevelManager::Start()
 void LevelManager::Stop()
 {
     running = false;
+    tp->GetMarketUpdateNotifier().WakeAll();
     if (processAndGenerateThread.joinable())
     {
         processAndGenerateThread.join();
     }
 }
 
+Mode LevelManager::GetMode() const
+{
+    return mode_;
+}
+
 void LevelManager::Run()
 {
+    auto &notifier = tp->GetMarketUpdateNotifier();
     while (running)
     {
-        ProcessLevelsAndGenerateSignals();        
+        // Park until the platform publishes; the timeout only bounds how long Stop can take if a wake-up is missed
+        if (notifier.WaitForUpdate(marketCursor_, std::chrono::milliseconds(100), waitPolicy_, spinIterations_))
+        {
+            ProcessNewMarketData();
+        }
     }
 }
 
 void LevelManager::ProcessLevelsAndGenerateSignals()
 {
-    if (tp->IsReadyForTradeIteration())
+    // Uses our own cursor rather than tp->IsReadyForTradeIteration so the trade loop's bookkeeping is untouched
+    uint64_t sequence = tp->GetMarketUpdateNotifier().GetSequence();
+    if (sequence == marketCursor_)
+    {
+        return;
+    }
+    marketCursor_ = sequence;
+    ProcessNewMarketData();
+}
+
+void LevelManager::ProcessNewMarketData()
+{
+    double currentPrice = tp->GetCurrentPrice();
+    auto barStartTime = GetCurrentBarStartTime();
+    bool isNewBar = !barStartTime.has_value() || barStartTime != lastBarStartTime_;
+
+    // A publish without a price change or a new bar has nothing for generators or touch detection
+    if (!isNewBar && lastProcessedPrice_.has_value() && lastProcessedPrice_.value() == currentPrice)
     {
-        double currentPrice = tp->GetCurrentPrice();
-        ExecuteLevelProcessing(currentPrice);        
+        return;
     }
+
+    lastBarStartTime_ = barStartTime;
+
+    // In synchronous mode the trade loop has already advanced the indicator cache for this update
+    if (mode_ == Mode::Asynchronous)
+    {
+        tp->GetIndicatorCache().OnMarketUpdate(tp->GetCurrentBarIndex());
+    }
+    ExecuteLevelProcessing(currentPrice, isNewBar);
 }
 
-void LevelManager::ExecuteLevelProcessing(double currentPrice)
+void LevelManager::ExecuteLevelProcessing(double currentPrice, bool isNewBar)
 {
+    // Signals from this pass are traced from its start, independently of the trade iteration that later consumes them
+    TraceContext trace = TraceContext::Begin();
+
+    // Generators only read platform data, so they run before the ladder is locked
+    auto generatedByGenerator = GenerateLevelsInParallel(currentPrice, isNewBar);
+
     std::lock_guard<std::mutex> lock(levelsMutex);
-    for (const auto &levelGenerator : levelGenerators)
+
+    // Keep the dense part of the ladder centred on the market
+    if (levels.ShouldReanchor(currentPrice))
+    {
+        levels.Anchor(currentPrice, tp->GetTickSize());
+    }
+
+    // Detect touches against the levels that existed before this update, so new levels are not touched on creation
+    std::vector<LevelTouch> touches;
+    if (lastProcessedPrice_.has_value())
+    {
+        touches = levels.GetLevelsCrossed(lastProcessedPrice_.value(), currentPrice);
+        for (auto &touch : touches)
+        {
+            touch.level.touched = true;
+            levels.MarkTouched(touch.level.id);
+        }
+    }
+    lastProcessedPrice_ = currentPrice;
+
+    // Merge in generator order so the ladder contents do not depend on which generator finished first
+    for (const auto &generatedLevels : generatedByGenerator)
     {
-        auto generatedLevels = levelGenerator->GenerateLevels(currentPrice);
         for (const auto &level : generatedLevels)
         {
-            levels[currentPrice].push_back(level);
+            levels.Add(level);
         }
     }
 
-    auto signals = levelProcessor->ProcessLevels(levels, currentPrice);
-    for (const auto &signal : signals)
+    auto signals = levelProcessor->ProcessLevels(levels, touches, currentPrice);
+    for (auto &signal : signals)
     {
-        messaging_->PushRequest(signal.ToJsonString());
+        if (!signal.trace.IsActive())
+        {
+            signal.trace = trace;
+        }
+        if (signal.trace.GetStageTimestamp(TraceStage::Generation) == 0)
+        {
+            signal.trace.Stamp(TraceStage::Generation);
+        }
+        if (!signalTopic_->Publish(std::move(signal)))
+        {
+            LOG_ERROR("Level signal queue full; signal dropped");
+        }
     }
 
     auto levelsToClear = levelProcessor->GetLevelsToClear(levels, currentPrice);
+    for (const auto &touch : touches)
+    {
+        if (touch.level.clearOnTouch)
+        {
+            levelsToClear.push_back(touch.level);
+        }
+    }
     ClearLevels(levelsToClear);
+
+    SnapshotIfDue();
 }
 
-void LevelManager::ClearLevels(const std::vector<BaseLevel> &levelsToClear)
+void LevelManager::SetSnapshotStore(std::shared_ptr<LevelSnapshotStore> snapshotStore, std::chrono::seconds snapshotInterval)
 {
-    for (const auto &level : levelsToClear)
+    std::lock_guard<std::mutex> lock(levelsMutex);
+    snapshotStore_ = std::move(snapshotStore);
+    snapshotInterval_ = snapshotInterval;
+}
+
+void LevelManager::Initialize()
+{
+    std::lock_guard<std::mutex> lock(levelsMutex);
+    if (!snapshotStore_)
+    {
+        return;
+    }
+
+    auto restoredLevels = snapshotStore_->Load();
+    if (!restoredLevels.has_value())
+    {
+        return;
+    }
+
+    // In asynchronous mode generation may already have added levels, possibly re-deriving ones from the snapshot,
+    // so the snapshot is merged in rather than assumed to be the only source
+    size_t restoredCount = 0;
+    for (const auto &level : restoredLevels.value())
+    {
+        if (levels.FindById(level.id) != nullptr)
+        {
+            continue;
+        }
+        int64_t tick = levels.ToTick(level.price);
+        bool alreadyPresent = false;
+        levels.ForEachInTickRange(tick, tick, [&level, &alreadyPresent](const BaseLevel &existing)
+                                  { alreadyPresent = alreadyPresent || existing == level; });
+        if (alreadyPresent)
+        {
+            continue;
+        }
+
+        levels.Add(level);
+        ++restoredCount;
+    }
+    lastSnapshotTime_ = std::chrono::steady_clock::now();
+
+    LOG_INFO("Restored {} levels from {}", restoredCount, snapshotStore_->GetFilePath());
+}
+
+void LevelManager::SnapshotIfDue()
+{
+    if (!snapshotStore_)
     {
-        auto it = levels.find(level.price);
-        if (it != levels.end())
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastSnapshotTime_ < snapshotInterval_)
+    {
+        return;
+    }
+    lastSnapshotTime_ = now;
+
+    // Only the copy happens under levelsMutex; serialization and file IO run on the thread pool
+    snapshotStore_->SaveAsync(CollectLevels());
+}
+
+std::vector<BaseLevel> LevelManager::CollectLevels() const
+{
+    std::vector<BaseLevel> collected;
+    collected.reserve(levels.Size());
+    levels.ForEach([&collected](const BaseLevel &level)
+                   { collected.push_back(level); });
+    return collected;
+}
+
+std::vector<std::vector<BaseLevel>> LevelManager::GenerateLevelsInParallel(double currentPrice, bool isNewBar)
+{
+    std::vector<std::vector<BaseLevel>> generatedByGenerator(levelGenerators.size());
+    std::vector<std::future<std::vector<BaseLevel>>> pending(levelGenerators.size());
+    std::optional<size_t> inlineIndex;
+
+    for (size_t i = 0; i < levelGenerators.size(); ++i)
+    {
+        const auto &levelGenerator = levelGenerators[i];
+        if (levelGenerator->GetUpdateIntervalType() == UpdateIntervalType::New_Bar && !isNewBar)
         {
-            auto &levelList = it->second;
-            levelList.erase(std::remove_if(levelList.begin(), levelList.end(), [&level](const BaseLevel &l)
-                                           { return l == level; }),
-                            levelList.end());
-            if (levelList.empty())
+            continue;
+        }
+
+        // The first active generator runs on this thread instead of waiting idle for the pool
+        if (!inlineIndex.has_value())
+        {
+            inlineIndex = i;
+            continue;
+        }
+
+        auto promise = std::make_shared<std::promise<std::vector<BaseLevel>>>();
+        pending[i] = promise->get_future();
+        generatorPool_->Enqueue([levelGenerator, promise, currentPrice]
+                                {
+            try
             {
-                levels.erase(it);
+                promise->set_value(levelGenerator->GenerateLevels(currentPrice));
             }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            } });
+    }
+
+    // A failing generator contributes no levels; the others are unaffected
+    auto logFailure = [this](size_t index, const std::string &reason)
+    {
+        LOG_ERROR("Level generator {} failed: {}", levelGenerators[index]->GetName(), reason);
+    };
+
+    if (inlineIndex.has_value())
+    {
+        try
+        {
+            generatedByGenerator[inlineIndex.value()] = levelGenerators[inlineIndex.value()]->GenerateLevels(currentPrice);
+        }
+        catch (const std::exception &e)
+        {
+            logFailure(inlineIndex.value(), e.what());
+        }
+        catch (...)
+        {
+            logFailure(inlineIndex.value(), "unknown exception");
+        }
+    }
+
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        if (!pending[i].valid())
+        {
+            continue;
+        }
+        try
+        {
+            generatedByGenerator[i] = pending[i].get();
+        }
+        catch (const std::exception &e)
+        {
+            logFailure(i, e.what());
+        }
+        catch (...)
+        {
+            logFailure(i, "unknown exception");
+        }
+    }
+
+    return generatedByGenerator;
+}
+
+std::optional<std::chrono::system_clock::time_point> LevelManager::GetCurrentBarStartTime() const
+{
+    auto currentBar = tp->GetBarByOffsetFromCurrent(0);
+    if (!currentBar.has_value())
+    {
+        return std::nullopt;
+    }
+    return currentBar->startTime.timePoint;
+}
+
+void LevelManager::ClearLevels(const std::vector<BaseLevel> &levelsToClear)
+{
+    for (const auto &level : levelsToClear)
+    {
+        // Every stored level comparing equal is cleared, as PriceLadder::Remove does
+        int64_t tick = levels.ToTick(level.price);
+        std::vector<std::string> ids;
+        levels.ForEachInTickRange(tick, tick, [&level, &ids](const BaseLevel &stored)
+                                  {
+            if (stored == level)
+            {
+                ids.push_back(stored.id);
+            } });
+        for (const auto &id : ids)
+        {
+            levels.RemoveById(id);
         }
     }
 }
 
+std::vector<BaseLevel> LevelManager::GetLevelsInRange(double currentPrice, double range) const
+{
+    std::lock_guard<std::mutex> lock(levelsMutex);
+    return LevelUtilities::GetLevelsInRange(levels, currentPrice, range);
+}
+
+void LevelManager::ClearExpiredLevels(const std::chrono::minutes &maxAge)
+{
+    std::lock_guard<std::mutex> lock(levelsMutex);
+    LevelUtilities::ClearExpiredLevels(levels, maxAge);
+}
+
+void LevelManager::PrintCurrentLevels() const
+{
+    std::lock_guard<std::mutex> lock(levelsMutex);
+    LevelUtilities::PrintCurrentLevels(levels);
+}
+
 bool LevelManager::IsWithinRange(double currentPrice, double levelPrice, double range)
 {
     return std::abs(currentPrice - levelPrice) <= range;
@@ -2,19 +2,31 @@
 
 #include "LevelGenerator.h"
 #include "LevelProcessor.h"
-#include "Messaging.h"
+#include "PriceLadder.h"
+#include "LevelSnapshotStore.h"
+#include "MessageBus.h"
 #include "CommonTypes.h"
 #include "ThreadPool.h"
-#include <unordered_map>
 #include <memory>
+#include <optional>
+#include <chrono>
 #include <vector>
 #include <thread>
 #include <mutex>
 
 class LevelManager {
 public:
-    LevelManager(std::vector<std::shared_ptr<LevelGenerator>> levelGenerators, std::shared_ptr<LevelProcessor> levelProcessor, std::shared_ptr<ITradingPlatform> tradingPlatform);    
-    void SubscribeToMessages(std::function<void(const std::string&)> callback);
+    LevelManager(std::vector<std::shared_ptr<LevelGenerator>> levelGenerators, std::shared_ptr<LevelProcessor> levelProcessor, std::shared_ptr<ITradingPlatform> tradingPlatform,
+                 Mode mode = Mode::Synchronous, WaitPolicy waitPolicy = WaitPolicy::Park, uint32_t spinIterations = 0);
+    Mode GetMode() const;
+
+    // Restores levels from the snapshot store, if one is configured. Levels already in the ladder are kept and
+    // not duplicated, so this is safe while an asynchronous manager is generating.
+    void Initialize();
+
+    // Enables periodic background snapshots of the ladder.
+    void SetSnapshotStore(std::shared_ptr<LevelSnapshotStore> snapshotStore, std::chrono::seconds snapshotInterval);
+    void SubscribeToSignals(std::function<void(const TradeSignal&)> callback);
     void ProcessLevelsAndGenerateSignals();
     std::vector<BaseLevel> GetLevelsInRange(double currentPrice, double range) const;
     void ClearExpiredLevels(const std::chrono::minutes& maxAge);
@@ -26,18 +38,33 @@ protected:
     void Start();
     void Stop();
     void Run();
-    void ExecuteLevelProcessing(double currentPrice);
+    void ProcessNewMarketData();
+    void ExecuteLevelProcessing(double currentPrice, bool isNewBar);
+    std::vector<std::vector<BaseLevel>> GenerateLevelsInParallel(double currentPrice, bool isNewBar);
+    std::optional<std::chrono::system_clock::time_point> GetCurrentBarStartTime() const;
     void ClearLevels(const std::vector<BaseLevel>& levelsToClear);
+    void SnapshotIfDue();
+    std::vector<BaseLevel> CollectLevels() const;
 
-    std::unordered_map<double, std::vector<BaseLevel>> levels;
+    PriceLadder levels;  // Levels indexed by their own price, in ticks
+    std::optional<double> lastProcessedPrice_;
+    std::optional<std::chrono::system_clock::time_point> lastBarStartTime_;
+    std::shared_ptr<LevelSnapshotStore> snapshotStore_;
+    std::chrono::seconds snapshotInterval_{60};
+    std::chrono::steady_clock::time_point lastSnapshotTime_;
     std::vector<std::shared_ptr<LevelGenerator>> levelGenerators;
+    std::unique_ptr<ThreadPool> generatorPool_;  // Runs all generators but the first, which runs on the calling thread
     std::shared_ptr<LevelProcessor> levelProcessor;
     std::shared_ptr<ITradingPlatform> tp;
-    std::shared_ptr<Messaging> messaging_;     
+    std::shared_ptr<MessageBus> bus_;  // synchronous when the manager is, so signals arrive before processing returns
+    std::shared_ptr<MessageTopic<TradeSignal>> signalTopic_;
     std::thread processAndGenerateThread;
-    std::mutex levelsMutex;  // Mutex to protect the levels map
+    mutable std::mutex levelsMutex;  // Mutex to protect the levels ladder
     std::atomic<bool> running;
     Mode mode_;  // Mode to determine sync or async operation
+    WaitPolicy waitPolicy_;  // How the async loop waits for market updates
+    uint32_t spinIterations_;  // Spin budget before parking when waitPolicy_ is SpinThenPark
+    uint64_t marketCursor_ = 0;  // Last market update sequence this manager has consumed
 
     bool IsWithinRange(double currentPrice, double levelPrice, double range = 1.0);
 };
@@ -2,8 +2,8 @@
 
 #include "CommonTypes.h"
 #include "ITradingPlatform.h"
+#include "PriceLadder.h"
 #include <vector>
-#include <unordered_map>
 #include <memory>
 #include <mutex>
 
@@ -11,11 +11,13 @@ class LevelProcessor {
 public:
     LevelProcessor(std::shared_ptr<ITradingPlatform> tradingPlatform) : tp(tradingPlatform) {}
     virtual ~LevelProcessor() = default;
+    // touches holds every level crossed since the previous update, in the order the market reached them.
     virtual std::vector<TradeSignal> ProcessLevels(
-        const std::unordered_map<double, std::vector<BaseLevel>>& levels, 
+        const PriceLadder& levels, 
+        const std::vector<LevelTouch>& touches,
         double currentPrice) = 0;
 
-    virtual std::vector<BaseLevel> GetLevelsToClear(const std::unordered_map<double, std::vector<BaseLevel>>& levels, double currentPrice) = 0;
+    virtual std::vector<BaseLevel> GetLevelsToClear(const PriceLadder& levels, double currentPrice) = 0;
 
 protected:
     std::shared_ptr<ITradingPlatform> tp;
@@ -0,0 +1,306 @@
+#include "LevelSnapshotStore.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+
+namespace {
+    enum LevelFlags : uint8_t {
+        ClearOnTouch = 1 << 0,
+        Touched = 1 << 1,
+        HasTarget = 1 << 2,
+        HasStop = 1 << 3
+    };
+
+    uint32_t Fnv1a(const char* data, size_t size) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Same-sized unsigned integer, so every field is shifted out and in byte by byte whatever the host's byte order
+    template <typename T>
+    using Bits = std::conditional_t<sizeof(T) == 8, uint64_t,
+                 std::conditional_t<sizeof(T) == 4, uint32_t,
+                 std::conditional_t<sizeof(T) == 2, uint16_t, uint8_t>>>;
+
+    template <typename T>
+    void Write(std::string& out, T value) {
+        Bits<T> bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            out.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+        }
+    }
+
+    template <typename T>
+    T ReadLittleEndian(const char* bytes) {
+        Bits<T> bits = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bits |= static_cast<Bits<T>>(static_cast<uint8_t>(bytes[i])) << (8 * i);
+        }
+        T value;
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    void WriteString(std::string& out, const std::string& value) {
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>(value.size(), UINT16_MAX));
+        Write(out, length);
+        out.append(value.data(), length);
+    }
+
+    class Reader {
+    public:
+        Reader(const std::string& data, size_t end) : data_(data), end_(end) {}
+
+        template <typename T>
+        bool Read(T& value) {
+            if (offset_ + sizeof(T) > end_) {
+                return false;
+            }
+            value = ReadLittleEndian<T>(data_.data() + offset_);
+            offset_ += sizeof(T);
+            return true;
+        }
+
+        bool ReadString(std::string& value) {
+            uint16_t length;
+            if (!Read(length) || offset_ + length > end_) {
+                return false;
+            }
+            value.assign(data_.data() + offset_, length);
+            offset_ += length;
+            return true;
+        }
+
+    private:
+        const std::string& data_;
+        size_t end_;
+        size_t offset_ = 0;
+    };
+}
+
+LevelSnapshotStore::LevelSnapshotStore(std::string filePath)
+    : filePath_(std::move(filePath))
+{
+}
+
+void LevelSnapshotStore::SaveAsync(std::vector<BaseLevel> levels)
+{
+    bool expected = false;
+    if (!writeInFlight_.compare_exchange_strong(expected, true))
+    {
+        return;
+    }
+
+    auto self = shared_from_this();
+    uint64_t sequence = ++nextSequence_;
+    auto snapshot = std::make_shared<std::vector<BaseLevel>>(std::move(levels));
+    ThreadPool::Instance().Enqueue([self, snapshot, sequence]
+                                   {
+        // The flag must clear even if serializing throws, or no later snapshot would ever be written
+        try
+        {
+            self->WriteFile(Serialize(*snapshot), sequence);
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR("Exception occurred while saving level snapshot: {}", e.what());
+        }
+        self->writeInFlight_ = false; });
+}
+
+bool LevelSnapshotStore::Save(const std::vector<BaseLevel> &levels)
+{
+    uint64_t sequence = ++nextSequence_;
+    return WriteFile(Serialize(levels), sequence);
+}
+
+std::optional<std::vector<BaseLevel>> LevelSnapshotStore::Load() const
+{
+    std::ifstream file(filePath_, std::ios::binary);
+    if (!file.is_open())
+    {
+        return std::nullopt; // No snapshot yet, cold start
+    }
+
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto levels = Deserialize(data);
+    if (!levels.has_value())
+    {
+        LOG_WARNING("Ignoring unreadable level snapshot: {}", filePath_);
+    }
+    return levels;
+}
+
+std::string LevelSnapshotStore::Serialize(const std::vector<BaseLevel> &levels)
+{
+    std::string out;
+    out.reserve(16 + levels.size() * 64);
+
+    Write(out, Magic);
+    Write(out, CurrentVersion);
+    Write(out, uint16_t(0));
+    Write(out, static_cast<uint32_t>(levels.size()));
+
+    for (const auto &level : levels)
+    {
+        uint8_t flags = 0;
+        flags |= level.clearOnTouch ? ClearOnTouch : 0;
+        flags |= level.touched ? Touched : 0;
+        flags |= level.targetPrice.has_value() ? HasTarget : 0;
+        flags |= level.stopLossPrice.has_value() ? HasStop : 0;
+
+        WriteString(out, level.id);
+        Write(out, level.price);
+        WriteString(out, level.levelType);
+        Write(out, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(level.timestamp.timePoint.time_since_epoch()).count()));
+        Write(out, flags);
+        if (level.targetPrice.has_value())
+        {
+            Write(out, level.targetPrice.value());
+        }
+        if (level.stopLossPrice.has_value())
+        {
+            Write(out, level.stopLossPrice.value());
+        }
+        WriteString(out, level.tradeSystemName);
+    }
+
+    Write(out, Fnv1a(out.data(), out.size()));
+    return out;
+}
+
+std::optional<std::vector<BaseLevel>> LevelSnapshotStore::Deserialize(const std::string &data)
+{
+    if (data.size() < sizeof(uint32_t))
+    {
+        return std::nullopt;
+    }
+
+    size_t payloadSize = data.size() - sizeof(uint32_t);
+    uint32_t storedChecksum = ReadLittleEndian<uint32_t>(data.data() + payloadSize);
+    if (storedChecksum != Fnv1a(data.data(), payloadSize))
+    {
+        return std::nullopt;
+    }
+
+    Reader reader(data, payloadSize);
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t count;
+    if (!reader.Read(magic) || !reader.Read(version) || !reader.Read(reserved) || !reader.Read(count) || magic != Magic)
+    {
+        return std::nullopt;
+    }
+    if (version > CurrentVersion)
+    {
+        LOG_WARNING("Level snapshot version {} is newer than supported version {}", version, CurrentVersion);
+        return std::nullopt;
+    }
+
+    std::vector<BaseLevel> levels;
+    levels.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        std::string id;
+        std::string levelType;
+        std::string tradeSystemName;
+        double price;
+        int64_t timestampMicros;
+        uint8_t flags;
+
+        if (!reader.ReadString(id) || !reader.Read(price) || !reader.ReadString(levelType) || !reader.Read(timestampMicros) || !reader.Read(flags))
+        {
+            return std::nullopt;
+        }
+
+        DateTime timestamp(std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(timestampMicros))));
+        BaseLevel level(price, levelType, timestamp);
+        level.id = id;
+        level.clearOnTouch = (flags & ClearOnTouch) != 0;
+        level.touched = (flags & Touched) != 0;
+
+        if (flags & HasTarget)
+        {
+            double targetPrice;
+            if (!reader.Read(targetPrice))
+            {
+                return std::nullopt;
+            }
+            level.targetPrice = targetPrice;
+        }
+        if (flags & HasStop)
+        {
+            double stopLossPrice;
+            if (!reader.Read(stopLossPrice))
+            {
+                return std::nullopt;
+            }
+            level.stopLossPrice = stopLossPrice;
+        }
+        if (!reader.ReadString(tradeSystemName))
+        {
+            return std::nullopt;
+        }
+        level.tradeSystemName = tradeSystemName;
+
+        levels.push_back(std::move(level));
+    }
+
+    return levels;
+}
+
+bool LevelSnapshotStore::WriteFile(const std::string &data, uint64_t sequence)
+{
+    std::lock_guard<std::mutex> lock(fileMutex_);
+    if (sequence < writtenSequence_)
+    {
+        return true; // A newer snapshot is already on disk
+    }
+
+    std::string tempPath = filePath_ + ".tmp";
+
+    try
+    {
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                LOG_ERROR("Failed to open level snapshot for writing: {}", tempPath);
+                return false;
+            }
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file)
+            {
+                LOG_ERROR("Failed to write level snapshot: {}", tempPath);
+                return false;
+            }
+        }
+
+        // filesystem::rename replaces an existing file atomically, unlike std::rename on Windows
+        std::error_code ec;
+        std::filesystem::rename(tempPath, filePath_, ec);
+        if (ec)
+        {
+            LOG_ERROR("Failed to replace level snapshot: {} ({})", filePath_, ec.message());
+            return false;
+        }
+        writtenSequence_ = sequence;
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        LOG_ERROR("Exception occurred while writing level snapshot: {}", e.what());
+    }
+    return false;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CommonTypes.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Persists LevelManager levels to a compact, versioned binary file so a restart can warm start
+// instead of re-deriving every level from history.
+//
+// Layout (little-endian, written byte by byte so the file does not depend on the host's byte order):
+//   header  : magic "SFLV" (u32), version (u16), reserved (u16), level count (u32)
+//   level   : id (str), price (f64), levelType (str), timestamp in microseconds since epoch (i64),
+//             flags (u8: clearOnTouch, touched, hasTarget, hasStop), [targetPrice (f64)], [stopLossPrice (f64)],
+//             tradeSystemName (str)
+//   trailer : FNV-1a checksum of everything before it (u32)
+// Strings are a u16 length followed by the bytes.
+class LevelSnapshotStore : public std::enable_shared_from_this<LevelSnapshotStore> {
+public:
+    static constexpr uint32_t Magic = 0x564C4653; // "SFLV"
+    static constexpr uint16_t CurrentVersion = 1;
+
+    explicit LevelSnapshotStore(std::string filePath);
+
+    // Serializes and writes on the thread pool. If a write is still in flight the call is skipped,
+    // since the next periodic snapshot will carry newer state anyway.
+    void SaveAsync(std::vector<BaseLevel> levels);
+
+    // Writes on the calling thread; used for the final snapshot on shutdown. Waits for an async write
+    // already touching the file, and an async write that has not started yet is discarded, so an older
+    // snapshot never replaces this one.
+    bool Save(const std::vector<BaseLevel>& levels);
+
+    // Returns the levels from the last complete snapshot, or nullopt if there is none or it is unreadable.
+    std::optional<std::vector<BaseLevel>> Load() const;
+
+    static std::string Serialize(const std::vector<BaseLevel>& levels);
+    static std::optional<std::vector<BaseLevel>> Deserialize(const std::string& data);
+
+    const std::string& GetFilePath() const { return filePath_; }
+
+private:
+    // Writes to a temporary file and renames it over the snapshot so readers never see a partial file.
+    // A write older than the last one on disk is skipped.
+    bool WriteFile(const std::string& data, uint64_t sequence);
+
+    std::string filePath_;
+    std::atomic<bool> writeInFlight_{false};
+    std::atomic<uint64_t> nextSequence_{0}; // Taken when the levels are handed in, so it follows ladder order
+    std::mutex fileMutex_;
+    uint64_t writtenSequence_ = 0; // Guarded by fileMutex_
+};
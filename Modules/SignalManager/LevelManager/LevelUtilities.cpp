@@ -6,38 +6,29 @@
 
 namespace LevelUtilities {
 
-    std::vector<BaseLevel> GetLevelsInRange(const std::unordered_map<double, std::vector<BaseLevel>>& levels, double currentPrice, double range) {
-        std::vector<BaseLevel> levelsInRange;
-        for (const auto& [price, levelList] : levels) {
-            if (IsWithinRange(currentPrice, price, range)) {
-                levelsInRange.insert(levelsInRange.end(), levelList.begin(), levelList.end());
-            }
-        }
-        return levelsInRange;
+    std::vector<BaseLevel> GetLevelsInRange(const PriceLadder& levels, double currentPrice, double range) {
+        return levels.GetLevelsInRange(currentPrice - range, currentPrice + range);
     }
     
-    void ClearExpiredLevels(std::unordered_map<double, std::vector<BaseLevel>>& levels, const std::chrono::minutes& maxAge) {
+    void ClearExpiredLevels(PriceLadder& levels, const std::chrono::minutes& maxAge) {
         auto now = std::chrono::system_clock::now();
-        for (auto it = levels.begin(); it != levels.end();) {
-            auto& levelList = it->second;
-            levelList.erase(std::remove_if(levelList.begin(), levelList.end(), [now, maxAge](const BaseLevel& level) {
-                return std::chrono::duration_cast<std::chrono::minutes>(now - level.timestamp.timePoint) > maxAge;
-            }), levelList.end());
-            if (levelList.empty()) {
-                it = levels.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        levels.RemoveIf([now, maxAge](const BaseLevel& level) {
+            return std::chrono::duration_cast<std::chrono::minutes>(now - level.timestamp.timePoint) > maxAge;
+        });
     }
     
-    void PrintCurrentLevels(const std::unordered_map<double, std::vector<BaseLevel>>& levels) {
-        for (const auto& [price, levelList] : levels) {
-            std::cout << "Price: " << price << "\n";
-            for (const auto& level : levelList) {
-                std::cout << "  " << level.ToString() << "\n";
+    void PrintCurrentLevels(const PriceLadder& levels) {
+        bool first = true;
+        int64_t currentTick = 0;
+        levels.ForEach([&](const BaseLevel& level) {
+            int64_t tick = levels.ToTick(level.price);
+            if (first || tick != currentTick) {
+                std::cout << "Price: " << levels.ToPrice(tick) << "\n";
+                currentTick = tick;
+                first = false;
             }
-        }
+            std::cout << "  " << level.ToString() << "\n";
+        });
     }
 
     bool IsWithinRange(double currentPrice, double levelPrice, double range) {
@@ -1,16 +1,16 @@
 #pragma once
 
 #include "CommonTypes.h"
+#include "PriceLadder.h"
 #include <vector>
-#include <unordered_map>
 
 namespace LevelUtilities {
     
-    std::vector<BaseLevel> GetLevelsInRange(const std::unordered_map<double, std::vector<BaseLevel>>& levels, double currentPrice, double range);
+    std::vector<BaseLevel> GetLevelsInRange(const PriceLadder& levels, double currentPrice, double range);
     
-    void ClearExpiredLevels(std::unordered_map<double, std::vector<BaseLevel>>& levels, const std::chrono::minutes& maxAge);
+    void ClearExpiredLevels(PriceLadder& levels, const std::chrono::minutes& maxAge);
     
-    void PrintCurrentLevels(const std::unordered_map<double, std::vector<BaseLevel>>& levels);
+    void PrintCurrentLevels(const PriceLadder& levels);
 
     bool IsWithinRange(double currentPrice, double levelPrice, double range);
 }
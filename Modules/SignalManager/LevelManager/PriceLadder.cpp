@@ -0,0 +1,292 @@
+#include "PriceLadder.h"
+#include <cmath>
+
+PriceLadder::PriceLadder(double tickSize, size_t denseHalfWidth)
+    : tickSize_(tickSize > 0.0 ? tickSize : DefaultTickSize), denseHalfWidth_(denseHalfWidth)
+{
+}
+
+void PriceLadder::SetTickSize(double tickSize)
+{
+    if (tickSize <= 0.0 || tickSize == tickSize_)
+    {
+        return;
+    }
+    double anchorPrice = ToPrice(anchorTick_);
+    Rebuild(tickSize, static_cast<int64_t>(std::llround(anchorPrice / tickSize)));
+}
+
+void PriceLadder::Anchor(double price, double tickSize)
+{
+    double newTickSize = tickSize > 0.0 ? tickSize : tickSize_;
+    int64_t anchorTick = static_cast<int64_t>(std::llround(price / newTickSize));
+    if (anchored_ && newTickSize == tickSize_ && anchorTick == anchorTick_)
+    {
+        return;
+    }
+    anchored_ = true;
+    Rebuild(newTickSize, anchorTick);
+}
+
+bool PriceLadder::ShouldReanchor(double price) const
+{
+    if (!anchored_)
+    {
+        return true;
+    }
+    int64_t distance = ToTick(price) - anchorTick_;
+    return static_cast<size_t>(distance < 0 ? -distance : distance) > denseHalfWidth_ / 2;
+}
+
+int64_t PriceLadder::ToTick(double price) const
+{
+    return static_cast<int64_t>(std::llround(price / tickSize_));
+}
+
+double PriceLadder::ToPrice(int64_t tick) const
+{
+    return static_cast<double>(tick) * tickSize_;
+}
+
+void PriceLadder::Add(const BaseLevel &level)
+{
+    int64_t tick = ToTick(level.price);
+    GetOrCreateBucket(tick).push_back(level);
+    tickById_[level.id] = tick;
+    ++count_;
+}
+
+bool PriceLadder::Remove(const BaseLevel &level)
+{
+    int64_t tick = ToTick(level.price);
+    auto *bucket = FindBucket(tick);
+    if (!bucket)
+    {
+        return false;
+    }
+
+    size_t removed = 0;
+    for (auto it = bucket->begin(); it != bucket->end();)
+    {
+        if (*it == level)
+        {
+            tickById_.erase(it->id);
+            it = bucket->erase(it);
+            ++removed;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    if (removed == 0)
+    {
+        return false;
+    }
+
+    count_ -= removed;
+    ReleaseBucketIfEmpty(tick);
+    return true;
+}
+
+bool PriceLadder::RemoveById(const std::string &id)
+{
+    auto idIt = tickById_.find(id);
+    if (idIt == tickById_.end())
+    {
+        return false;
+    }
+
+    int64_t tick = idIt->second;
+    tickById_.erase(idIt);
+
+    auto *bucket = FindBucket(tick);
+    if (!bucket)
+    {
+        return false;
+    }
+
+    auto it = std::find_if(bucket->begin(), bucket->end(), [&id](const BaseLevel &l)
+                           { return l.id == id; });
+    if (it == bucket->end())
+    {
+        return false;
+    }
+
+    bucket->erase(it);
+    --count_;
+    ReleaseBucketIfEmpty(tick);
+    return true;
+}
+
+bool PriceLadder::MarkTouched(const std::string &id)
+{
+    auto idIt = tickById_.find(id);
+    if (idIt == tickById_.end())
+    {
+        return false;
+    }
+
+    auto *bucket = FindBucket(idIt->second);
+    if (!bucket)
+    {
+        return false;
+    }
+
+    for (auto &level : *bucket)
+    {
+        if (level.id == id)
+        {
+            level.touched = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PriceLadder::Clear()
+{
+    for (auto &bucket : dense_)
+    {
+        bucket.clear();
+    }
+    std::fill(occupancy_.begin(), occupancy_.end(), 0);
+    sparse_.clear();
+    tickById_.clear();
+    count_ = 0;
+}
+
+std::vector<BaseLevel> PriceLadder::GetLevelsWithinTicks(double price, int64_t ticks) const
+{
+    std::vector<BaseLevel> result;
+    int64_t centre = ToTick(price);
+    ForEachInTickRange(centre - ticks, centre + ticks, [&result](const BaseLevel &level)
+                       { result.push_back(level); });
+    return result;
+}
+
+std::vector<BaseLevel> PriceLadder::GetLevelsInRange(double lowPrice, double highPrice) const
+{
+    std::vector<BaseLevel> result;
+    ForEachInTickRange(ToTick(lowPrice), ToTick(highPrice), [&result](const BaseLevel &level)
+                       { result.push_back(level); });
+    return result;
+}
+
+std::vector<LevelTouch> PriceLadder::GetLevelsCrossed(double lastPrice, double currentPrice) const
+{
+    std::vector<LevelTouch> result;
+    int64_t lastTick = ToTick(lastPrice);
+    int64_t currentTick = ToTick(currentPrice);
+    if (currentTick == lastTick)
+    {
+        return result;
+    }
+
+    bool movingUp = currentTick > lastTick;
+    TouchDirection direction = movingUp ? TouchDirection::Up : TouchDirection::Down;
+    ForEachBucketInTickRange(movingUp ? lastTick + 1 : currentTick, movingUp ? currentTick : lastTick - 1,
+                             [&result, direction, currentTick](int64_t tick, const std::vector<BaseLevel> &bucket)
+                             {
+        for (const auto &level : bucket)
+        {
+            result.push_back(LevelTouch{level, tick, direction, tick != currentTick});
+        } });
+
+    if (!movingUp)
+    {
+        // Report in the order the market reached them
+        std::reverse(result.begin(), result.end());
+    }
+    return result;
+}
+
+const BaseLevel *PriceLadder::FindById(const std::string &id) const
+{
+    auto idIt = tickById_.find(id);
+    if (idIt == tickById_.end())
+    {
+        return nullptr;
+    }
+
+    const auto *bucket = FindBucket(idIt->second);
+    if (!bucket)
+    {
+        return nullptr;
+    }
+
+    auto it = std::find_if(bucket->begin(), bucket->end(), [&id](const BaseLevel &l)
+                           { return l.id == id; });
+    return it != bucket->end() ? &*it : nullptr;
+}
+
+const std::vector<BaseLevel> *PriceLadder::FindBucket(int64_t tick) const
+{
+    if (IsDense(tick))
+    {
+        size_t index = static_cast<size_t>(tick - DenseLowTick());
+        return (occupancy_[index / 64] >> (index % 64)) & 1 ? &dense_[index] : nullptr;
+    }
+
+    auto it = sparse_.find(tick);
+    return it != sparse_.end() ? &it->second : nullptr;
+}
+
+std::vector<BaseLevel> &PriceLadder::GetOrCreateBucket(int64_t tick)
+{
+    if (IsDense(tick))
+    {
+        size_t index = static_cast<size_t>(tick - DenseLowTick());
+        occupancy_[index / 64] |= uint64_t(1) << (index % 64);
+        return dense_[index];
+    }
+    return sparse_[tick];
+}
+
+void PriceLadder::ReleaseBucketIfEmpty(int64_t tick)
+{
+    if (IsDense(tick))
+    {
+        size_t index = static_cast<size_t>(tick - DenseLowTick());
+        if (dense_[index].empty())
+        {
+            occupancy_[index / 64] &= ~(uint64_t(1) << (index % 64));
+        }
+        return;
+    }
+
+    auto it = sparse_.find(tick);
+    if (it != sparse_.end() && it->second.empty())
+    {
+        sparse_.erase(it);
+    }
+}
+
+void PriceLadder::Rebuild(double tickSize, int64_t anchorTick)
+{
+    // Collect using the current layout before the tick size or anchor changes it
+    std::vector<BaseLevel> existing;
+    existing.reserve(count_);
+    ForEach([&existing](const BaseLevel &level)
+            { existing.push_back(level); });
+
+    tickSize_ = tickSize;
+    anchorTick_ = anchorTick;
+    dense_.clear();
+    occupancy_.clear();
+    sparse_.clear();
+    tickById_.clear();
+    count_ = 0;
+
+    if (anchored_)
+    {
+        size_t width = 2 * denseHalfWidth_ + 1;
+        dense_.resize(width);
+        occupancy_.assign((width + 63) / 64, 0);
+    }
+
+    for (const auto &level : existing)
+    {
+        Add(level);
+    }
+}
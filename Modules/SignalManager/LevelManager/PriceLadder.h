@@ -0,0 +1,185 @@
+#pragma once
+
+#include "CommonTypes.h"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+enum class TouchDirection {
+    Up,
+    Down
+};
+
+// A level the market reached between two price updates, as stored in the ladder when the touch was detected.
+struct LevelTouch {
+    BaseLevel level;
+    int64_t tick;
+    TouchDirection direction;
+    bool gapped; // the update jumped past the level rather than ending on it
+};
+
+// Price-ordered index of levels keyed by integer tick, so lookups never compare doubles.
+// Ticks within denseHalfWidth of the session anchor live in a flat bucket array with an occupancy bitmap;
+// everything further away falls back to an ordered map. Range and crossing queries therefore cost
+// O(log n + k) for the sparse part plus one bitmap word per 64 ticks of the dense part.
+class PriceLadder {
+public:
+    static constexpr double DefaultTickSize = 0.01;
+
+    explicit PriceLadder(double tickSize = 0.0, size_t denseHalfWidth = 2048);
+
+    // Sets the tick size used to convert prices. Existing levels are re-indexed.
+    // Until a positive tick size is set, prices are bucketed at DefaultTickSize.
+    void SetTickSize(double tickSize);
+    double GetTickSize() const { return tickSize_; }
+
+    // Centres the dense window on the given price, switching to tickSize first when it is positive.
+    // Existing levels are re-indexed once, and not at all if neither the anchor nor the tick size changes.
+    void Anchor(double price, double tickSize = 0.0);
+    bool IsAnchored() const { return anchored_; }
+    int64_t GetAnchorTick() const { return anchorTick_; }
+
+    // True when price has drifted far enough from the anchor that re-anchoring would keep queries dense.
+    bool ShouldReanchor(double price) const;
+
+    int64_t ToTick(double price) const;
+    double ToPrice(int64_t tick) const;
+
+    void Add(const BaseLevel& level);
+    bool Remove(const BaseLevel& level);
+    bool RemoveById(const std::string& id);
+    bool MarkTouched(const std::string& id);
+    void Clear();
+
+    // The stored level with the given id, or nullptr. The pointer is invalidated by any change to the ladder.
+    const BaseLevel* FindById(const std::string& id) const;
+
+    size_t Size() const { return count_; }
+    bool Empty() const { return count_ == 0; }
+
+    // Levels whose own price is within the given number of ticks of price (inclusive), in ascending price order.
+    std::vector<BaseLevel> GetLevelsWithinTicks(double price, int64_t ticks) const;
+
+    // Levels priced in [lowPrice, highPrice], in ascending price order.
+    std::vector<BaseLevel> GetLevelsInRange(double lowPrice, double highPrice) const;
+
+    // Levels the market moved through going from lastPrice to currentPrice, in the order it reached them.
+    // The starting tick is excluded and the ending tick included, so consecutive calls never report a level twice.
+    std::vector<LevelTouch> GetLevelsCrossed(double lastPrice, double currentPrice) const;
+
+    // Visits levels with lowTick <= tick <= highTick in ascending tick order.
+    template <typename Func>
+    void ForEachInTickRange(int64_t lowTick, int64_t highTick, Func&& func) const {
+        ForEachBucketInTickRange(lowTick, highTick, [&func](int64_t, const std::vector<BaseLevel>& bucket) {
+            for (const auto& level : bucket) {
+                func(level);
+            }
+        });
+    }
+
+    // Visits every level in ascending tick order.
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        ForEachInTickRange(INT64_MIN, INT64_MAX, std::forward<Func>(func));
+    }
+
+    // Removes every level matching the predicate and returns how many were removed.
+    template <typename Predicate>
+    size_t RemoveIf(Predicate&& predicate) {
+        std::vector<BaseLevel> toRemove;
+        ForEach([&](const BaseLevel& level) {
+            if (predicate(level)) {
+                toRemove.push_back(level);
+            }
+        });
+        for (const auto& level : toRemove) {
+            Remove(level);
+        }
+        return toRemove.size();
+    }
+
+private:
+    // Visits the non-empty buckets with lowTick <= tick <= highTick in ascending tick order, as func(tick, bucket).
+    template <typename Func>
+    void ForEachBucketInTickRange(int64_t lowTick, int64_t highTick, Func&& func) const {
+        if (lowTick > highTick) {
+            return;
+        }
+
+        int64_t denseLow = DenseLowTick();
+        int64_t denseHigh = DenseHighTick();
+
+        // Sparse levels below the dense window
+        for (auto it = sparse_.lower_bound(lowTick); it != sparse_.end() && it->first <= highTick && (dense_.empty() || it->first < denseLow); ++it) {
+            func(it->first, it->second);
+        }
+
+        // Dense window, walking set bits only
+        if (!dense_.empty() && highTick >= denseLow && lowTick <= denseHigh) {
+            size_t first = static_cast<size_t>(std::max(lowTick, denseLow) - denseLow);
+            size_t last = static_cast<size_t>(std::min(highTick, denseHigh) - denseLow);
+            for (size_t word = first / 64; word <= last / 64; ++word) {
+                uint64_t bits = occupancy_[word];
+                if (word == first / 64) {
+                    bits &= ~uint64_t(0) << (first % 64);
+                }
+                if (word == last / 64 && (last % 64) != 63) {
+                    bits &= (uint64_t(1) << ((last % 64) + 1)) - 1;
+                }
+                while (bits != 0) {
+                    size_t index = word * 64 + CountTrailingZeros(bits);
+                    func(denseLow + static_cast<int64_t>(index), dense_[index]);
+                    bits &= bits - 1;
+                }
+            }
+        }
+
+        // Sparse levels above the dense window
+        if (dense_.empty()) {
+            return; // everything was visited by the first loop
+        }
+        for (auto it = sparse_.lower_bound(std::max(lowTick, denseHigh + 1)); it != sparse_.end() && it->first <= highTick; ++it) {
+            func(it->first, it->second);
+        }
+    }
+
+    static size_t CountTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<size_t>(index);
+#else
+        return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    int64_t DenseLowTick() const { return anchorTick_ - static_cast<int64_t>(denseHalfWidth_); }
+    int64_t DenseHighTick() const { return DenseLowTick() + static_cast<int64_t>(dense_.size()) - 1; }
+    bool IsDense(int64_t tick) const { return !dense_.empty() && tick >= DenseLowTick() && tick <= DenseHighTick(); }
+
+    const std::vector<BaseLevel>* FindBucket(int64_t tick) const;
+    std::vector<BaseLevel>* FindBucket(int64_t tick) {
+        return const_cast<std::vector<BaseLevel>*>(static_cast<const PriceLadder*>(this)->FindBucket(tick));
+    }
+    std::vector<BaseLevel>& GetOrCreateBucket(int64_t tick);
+    void ReleaseBucketIfEmpty(int64_t tick);
+    void Rebuild(double tickSize, int64_t anchorTick);
+
+    double tickSize_;
+    size_t denseHalfWidth_;
+    int64_t anchorTick_ = 0;
+    bool anchored_ = false;
+    size_t count_ = 0;
+
+    std::vector<std::vector<BaseLevel>> dense_;
+    std::vector<uint64_t> occupancy_;
+    std::map<int64_t, std::vector<BaseLevel>> sparse_;
+    std::unordered_map<std::string, int64_t> tickById_;
+};
@@ -3,11 +3,23 @@
 
 #include "CommonTypes.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <queue>
 #include <optional>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <algorithm>
 
+// A composite pattern: a parent signal together with every signal listed in its attachedSignalIds.
+struct SignalGroup {
+    TradeSignal parent;
+    std::vector<TradeSignal> attachedSignals;
+};
+
+// Stores unprocessed signals and tracks the dependency graph declared through TradeSignal::attachedSignalIds.
+// A signal with attached ids is a parent; it becomes a completed group once every attached signal is present,
+// at which point processors can take the whole group in a single locked operation.
 class SignalContainer {
 public:
     static SignalContainer& Instance() {
@@ -17,8 +29,18 @@ public:
 
     void AddSignal(const TradeSignal& signal) {
         std::lock_guard<std::mutex> lock(mtx_);
-        unprocessedSignals[signal.signalKey].push(signal);
-        signalsById[signal.id] = signal;
+        // A signal re-added under the same id replaces the stored one, which may have been queued under another key.
+        auto existing = ExtractSignalLocked(signal.id);
+        if (existing.has_value()) {
+            RemoveFromQueuesLocked({{existing->signalKey, {signal.id}}});
+        }
+        TradeSignal inserted = signal;
+        inserted.trace.Stamp(TraceStage::ContainerInsert);
+        RemoveDuplicateAttachedIds(inserted.attachedSignalIds);
+        unprocessedSignals[inserted.signalKey].push(inserted);
+        const TradeSignal& stored = signalsById.emplace(inserted.id, std::move(inserted)).first->second;
+        RegisterAttachedSignalsLocked(stored);
+        ResolveDependentsLocked(stored.id);
     }
 
     std::optional<TradeSignal> GetSignal(const std::string& key) {
@@ -26,7 +48,7 @@ public:
         if (unprocessedSignals.find(key) != unprocessedSignals.end() && !unprocessedSignals[key].empty()) {
             TradeSignal signal = unprocessedSignals[key].front();
             unprocessedSignals[key].pop();
-            signalsById.erase(signal.id);
+            ExtractSignalLocked(signal.id);
             return signal;
         }
         return std::nullopt;
@@ -42,19 +64,9 @@ public:
 
     bool RemoveSignalById(const std::string& id) {
         std::lock_guard<std::mutex> lock(mtx_);
-        if (signalsById.find(id) != signalsById.end()) {
-            TradeSignal signal = signalsById[id];
-            signalsById.erase(id);
-            auto& queue = unprocessedSignals[signal.signalKey];
-            std::queue<TradeSignal> tempQueue;
-            while (!queue.empty()) {
-                TradeSignal tempSignal = queue.front();
-                queue.pop();
-                if (tempSignal.id != id) {
-                    tempQueue.push(tempSignal);
-                }
-            }
-            std::swap(queue, tempQueue);
+        auto signal = ExtractSignalLocked(id);
+        if (signal.has_value()) {
+            RemoveFromQueuesLocked({{signal->signalKey, {id}}});
             return true;
         }
         return false;
@@ -65,7 +77,7 @@ public:
         if (unprocessedSignals.find(key) != unprocessedSignals.end() && !unprocessedSignals[key].empty()) {
             TradeSignal signal = unprocessedSignals[key].front();
             unprocessedSignals[key].pop();
-            signalsById.erase(signal.id);
+            ExtractSignalLocked(signal.id);
             return true;
         }
         return false;
@@ -76,13 +88,72 @@ public:
         if (unprocessedSignals.find(key) != unprocessedSignals.end()) {
             auto& queue = unprocessedSignals[key];
             while (!queue.empty()) {
-                signalsById.erase(queue.front().id);
+                ExtractSignalLocked(queue.front().id);
                 queue.pop();
             }
             unprocessedSignals.erase(key);
         }
     }
 
+    // Cheap check that can be polled without taking the container lock.
+    bool HasCompletedGroups() const {
+        return completedGroupCount_.load(std::memory_order_acquire) > 0;
+    }
+
+    bool HasCompletedGroups(const std::string& parentKey) const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = completedGroups.find(parentKey);
+        return it != completedGroups.end() && !it->second.empty();
+    }
+
+    // Hands over every completed group whose parent has the given key, in completion order.
+    // The parent and its attached signals are removed from the container as part of the same locked operation.
+    std::vector<SignalGroup> TakeCompletedGroups(const std::string& parentKey) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::vector<SignalGroup> groups;
+
+        auto completedIt = completedGroups.find(parentKey);
+        if (completedIt == completedGroups.end() || completedIt->second.empty()) {
+            return groups;
+        }
+
+        std::vector<std::string> parentIds = std::move(completedIt->second);
+        completedIt->second.clear();
+        completedGroupCount_.fetch_sub(parentIds.size(), std::memory_order_acq_rel);
+
+        std::unordered_map<std::string, std::unordered_set<std::string>> removedByKey;
+        groups.reserve(parentIds.size());
+
+        for (const auto& parentId : parentIds) {
+            // A parent sharing an attached signal with an earlier group in this batch is no longer complete.
+            auto missingIt = missingAttachedCount.find(parentId);
+            if (missingIt == missingAttachedCount.end() || missingIt->second != 0) {
+                continue;
+            }
+
+            std::vector<std::string> attachedIds = signalsById.at(parentId).attachedSignalIds;
+            auto parent = ExtractSignalLocked(parentId, false);
+
+            SignalGroup group;
+            group.parent = std::move(*parent);
+            group.attachedSignals.reserve(attachedIds.size());
+            removedByKey[group.parent.signalKey].insert(parentId);
+
+            for (const auto& attachedId : attachedIds) {
+                auto attached = ExtractSignalLocked(attachedId);
+                if (attached.has_value()) {
+                    removedByKey[attached->signalKey].insert(attachedId);
+                    group.attachedSignals.push_back(std::move(*attached));
+                }
+            }
+
+            groups.push_back(std::move(group));
+        }
+
+        RemoveFromQueuesLocked(removedByKey);
+        return groups;
+    }
+
 private:
     SignalContainer() = default;
     ~SignalContainer() = default;
@@ -90,9 +161,148 @@ private:
     SignalContainer(const SignalContainer&) = delete;
     SignalContainer& operator=(const SignalContainer&) = delete;
 
+    // Each edge is recorded once per attached id, so a repeated id would leave a parent listed twice under it.
+    static void RemoveDuplicateAttachedIds(std::vector<std::string>& attachedIds) {
+        std::unordered_set<std::string> seen;
+        attachedIds.erase(std::remove_if(attachedIds.begin(), attachedIds.end(),
+                                         [&seen](const std::string& id) { return !seen.insert(id).second; }),
+                          attachedIds.end());
+    }
+
+    // Records the parent -> attached edges of a newly added signal and counts the attached signals not yet present.
+    void RegisterAttachedSignalsLocked(const TradeSignal& parent) {
+        if (parent.attachedSignalIds.empty()) {
+            return;
+        }
+
+        size_t missing = 0;
+        for (const auto& attachedId : parent.attachedSignalIds) {
+            dependentsById[attachedId].push_back(parent.id);
+            if (signalsById.find(attachedId) == signalsById.end()) {
+                ++missing;
+            }
+        }
+
+        missingAttachedCount[parent.id] = missing;
+        if (missing == 0) {
+            MarkCompleteLocked(parent);
+        }
+    }
+
+    // Called when a signal arrives; every parent waiting on it gets one step closer to completion.
+    void ResolveDependentsLocked(const std::string& attachedId) {
+        auto it = dependentsById.find(attachedId);
+        if (it == dependentsById.end()) {
+            return;
+        }
+
+        for (const auto& parentId : it->second) {
+            auto missingIt = missingAttachedCount.find(parentId);
+            if (missingIt != missingAttachedCount.end() && missingIt->second > 0 && --missingIt->second == 0) {
+                MarkCompleteLocked(signalsById.at(parentId));
+            }
+        }
+    }
+
+    void MarkCompleteLocked(const TradeSignal& parent) {
+        completedGroups[parent.signalKey].push_back(parent.id);
+        completedGroupCount_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void UnmarkCompleteLocked(const TradeSignal& parent) {
+        auto it = completedGroups.find(parent.signalKey);
+        if (it == completedGroups.end()) {
+            return;
+        }
+        auto& ids = it->second;
+        auto idIt = std::find(ids.begin(), ids.end(), parent.id);
+        if (idIt != ids.end()) {
+            ids.erase(idIt);
+            completedGroupCount_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    // Removes a signal from the id index and the dependency graph. Queue entries are left to the caller so that
+    // batch removals can rebuild each queue once.
+    std::optional<TradeSignal> ExtractSignalLocked(const std::string& id, bool unmarkIfComplete = true) {
+        auto it = signalsById.find(id);
+        if (it == signalsById.end()) {
+            return std::nullopt;
+        }
+        TradeSignal& signal = it->second;
+
+        // Drop the edges this signal declared as a parent.
+        auto missingIt = missingAttachedCount.find(id);
+        if (missingIt != missingAttachedCount.end()) {
+            if (missingIt->second == 0 && unmarkIfComplete) {
+                UnmarkCompleteLocked(signal);
+            }
+            missingAttachedCount.erase(missingIt);
+
+            for (const auto& attachedId : signal.attachedSignalIds) {
+                auto dependentsIt = dependentsById.find(attachedId);
+                if (dependentsIt == dependentsById.end()) {
+                    continue;
+                }
+                auto& parents = dependentsIt->second;
+                auto parentIt = std::find(parents.begin(), parents.end(), id);
+                if (parentIt != parents.end()) {
+                    parents.erase(parentIt);
+                }
+                if (parents.empty()) {
+                    dependentsById.erase(dependentsIt);
+                }
+            }
+        }
+
+        // Parents that relied on this signal are incomplete again until it is re-added.
+        auto dependentsIt = dependentsById.find(id);
+        if (dependentsIt != dependentsById.end()) {
+            for (const auto& parentId : dependentsIt->second) {
+                auto parentMissingIt = missingAttachedCount.find(parentId);
+                if (parentMissingIt == missingAttachedCount.end()) {
+                    continue;
+                }
+                if (parentMissingIt->second++ == 0) {
+                    UnmarkCompleteLocked(signalsById.at(parentId));
+                }
+            }
+        }
+
+        TradeSignal extracted = std::move(signal);
+        signalsById.erase(it);
+        return extracted;
+    }
+
+    void RemoveFromQueuesLocked(const std::unordered_map<std::string, std::unordered_set<std::string>>& idsByKey) {
+        for (const auto& [key, ids] : idsByKey) {
+            auto queueIt = unprocessedSignals.find(key);
+            if (queueIt == unprocessedSignals.end()) {
+                continue;
+            }
+            auto& queue = queueIt->second;
+            std::queue<TradeSignal> tempQueue;
+            while (!queue.empty()) {
+                if (ids.find(queue.front().id) == ids.end()) {
+                    tempQueue.push(std::move(queue.front()));
+                }
+                queue.pop();
+            }
+            std::swap(queue, tempQueue);
+        }
+    }
+
     mutable std::mutex mtx_;
     std::unordered_map<std::string, std::queue<TradeSignal>> unprocessedSignals;
     std::unordered_map<std::string, TradeSignal> signalsById;
+
+    // Dependency graph: attached signal id -> ids of the parents that declared it.
+    std::unordered_map<std::string, std::vector<std::string>> dependentsById;
+    // Parent id -> number of attached signals that are not currently in the container.
+    std::unordered_map<std::string, size_t> missingAttachedCount;
+    // Parent key -> ids of complete parents, in completion order.
+    std::unordered_map<std::string, std::vector<std::string>> completedGroups;
+    std::atomic<size_t> completedGroupCount_{0};
 };
 
 #endif // SIGNAL_CONTAINER_H
@@ -4,13 +4,14 @@
 #include "CommonTypes.h"
 #include "SignalContainer.h"
 #include "ITradingPlatform.h"
+#include "IndicatorCache.h"
 #include <vector>
 
 class SignalManager;
 
 class SignalGenerator {
 public:
-    SignalGenerator(std::shared_ptr<ITradingPlatform> tp) : tp(tp), signalContainer(SignalContainer::Instance()) {}
+    SignalGenerator(std::shared_ptr<ITradingPlatform> tp) : tp(tp), signalContainer(SignalContainer::Instance()), indicatorCache(tp->GetIndicatorCache()) {}
 
     virtual ~SignalGenerator() = default;
     virtual std::vector<TradeSignal> GenerateSignals() = 0;
@@ -18,6 +19,7 @@ public:
 protected:
     SignalContainer& signalContainer;
     std::shared_ptr<ITradingPlatform> tp;
+    Calculations::IndicatorCache& indicatorCache; // The platform's cache, shared with every generator on its chart; use instead of recomputing indicators
 };
 
 #endif // SIGNAL_GENERATOR_H
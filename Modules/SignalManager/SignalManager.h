@@ -23,15 +23,30 @@ public:
         mode_ = Mode::Synchronous;
 
         if (levelManager) {
-            levelManager_->SubscribeToMessages([this](const std::string& message) {
-                TradeSignal signal = ParseSignal(message);
-                signalContainer.AddSignal(signal);
+            // Level signals keep the trace of the LevelManager pass that created them, which may run on another thread
+            // and finish during a later trade iteration
+            levelManager_->SubscribeToSignals([this](const TradeSignal& levelSignal) {
+                signalContainer.AddSignal(levelSignal);
             });
         }
     }
 
     virtual std::optional<std::vector<PendingOrder>> GeneratePendingOrders() = 0;
 
+    // Warm starts the level manager from its last snapshot, if configured
+    virtual void Initialize() {
+        if (levelManager_) {
+            levelManager_->Initialize();
+        }
+    }
+
+    // Called at the start of each trade iteration; signals and orders produced during the iteration
+    // inherit this trace unless they already carry one.
+    void BeginIterationTrace(const TraceContext& trace) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        currentIterationTrace_ = trace;
+    }
+
     // Clear processed signals
     void ClearProcessedSignals() {
         std::vector<TradeSignal> signalsToClear = signalProcessor->GetSignalsToClear();
@@ -48,10 +63,13 @@ protected:
     std::shared_ptr<SignalProcessor> signalProcessor;
     Mode mode_;
     mutable std::mutex mtx_;
+    TraceContext currentIterationTrace_;
 
-    TradeSignal ParseSignal(const std::string& message) {        
-        TradeSignal signal = TradeSignal::FromJsonString(message);        
-        return signal;
+    void AttachIterationTrace(TraceContext& trace) const {
+        if (!trace.IsActive()) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            trace = currentIterationTrace_;
+        }
     }
 };
 
@@ -79,9 +79,40 @@ void TradeSystem::Initialize()
     _tzset(); // Apply the timezone change immediately
     parameterManager_ = ParameterManager::Instance();
     contextManager_->Initialize();
+    RegisterIndicatorSeries();
+    signalManager_->Initialize();
     Logger::Log("TradeSystem initialized", Logger::LogLevel::LOG_INFO);
 }
 
+void TradeSystem::RegisterIndicatorSeries()
+{
+    using Field = double BarData::*;
+    const std::vector<std::pair<std::string, Field>> priceFields = {
+        {"open", &BarData::open}, {"high", &BarData::high}, {"low", &BarData::low}, {"close", &BarData::close}};
+
+    // The cache belongs to the platform, so its sources hold the platform weakly to avoid a reference cycle
+    Calculations::IndicatorCache &cache = tradingPlatform_->GetIndicatorCache();
+    std::weak_ptr<ITradingPlatform> platform = tradingPlatform_;
+    for (const auto &[name, field] : priceFields)
+    {
+        cache.RegisterSeries(name, [platform, field = field](int barIndex) -> std::optional<double>
+                             {
+            auto tp = platform.lock();
+            auto bar = tp ? tp->GetBarByIndex(barIndex) : std::nullopt;
+            if (!bar.has_value())
+            {
+                return std::nullopt;
+            }
+            return bar.value().*field; });
+    }
+
+    cache.RegisterSeries("volume", [platform](int barIndex) -> std::optional<double>
+                         {
+        auto tp = platform.lock();
+        auto bar = tp ? tp->GetBarByIndex(barIndex) : std::nullopt;
+        return bar.has_value() ? bar.value().volume : std::nullopt; });
+}
+
 // Main process method to run the trading system
 void TradeSystem::Process()
 {
@@ -129,6 +160,12 @@ void TradeSystem::Process()
         }
     }
 
+    // Start the latency trace for this iteration; signals and orders created during it inherit it
+    signalManager_->BeginIterationTrace(TraceContext::Begin());
+
+    // Close out finished bars and refresh the forming bar in the platform's indicator cache
+    tradingPlatform_->GetIndicatorCache().OnMarketUpdate(tradingPlatform_->GetCurrentBarIndex());
+
     // Generate pending orders
     auto pendingOrdersOpt = GeneratePendingOrders();
     if (!pendingOrdersOpt.has_value())
@@ -153,6 +190,10 @@ void TradeSystem::Process()
         return;
     }
     auto auditedOrders = auditedOrdersOpt.value();
+    for (auto &order : auditedOrders)
+    {
+        order.trace.Stamp(TraceStage::RiskAudit);
+    }
 
     // Filter pending orders
     auto filteredOrdersOpt = FilterPendingOrders(auditedOrders);
@@ -161,6 +202,10 @@ void TradeSystem::Process()
         return;
     }
     auto filteredOrders = filteredOrdersOpt.value();
+    for (auto &order : filteredOrders)
+    {
+        order.trace.Stamp(TraceStage::Filter);
+    }
 
     // Execute pending orders
     auto executedOrdersOpt = ExecutePendingOrders(filteredOrders);
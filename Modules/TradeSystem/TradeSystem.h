@@ -72,6 +72,9 @@ public:
     std::shared_ptr<ITradingPlatform> tradingPlatform_;
 
 protected:
+    // Registers the platform's open, high, low, close and volume series with the shared indicator cache
+    void RegisterIndicatorSeries();
+
     // Converts the active orders map to a vector
     std::vector<ExecutedOrder> GetActiveOrdersAsVector() const {
         std::vector<ExecutedOrder> orders;
@@ -75,6 +75,23 @@ public:
         return *this;
     }
 
+    // Asynchronous mode runs level generation on its own thread, woken by the platform's market updates
+    TradeSystemBuilder &WithLevelManagerMode(Mode mode, WaitPolicy waitPolicy = WaitPolicy::Park, uint32_t spinIterations = 0)
+    {
+        levelManagerMode_ = mode;
+        levelManagerWaitPolicy_ = waitPolicy;
+        levelManagerSpinIterations_ = spinIterations;
+        return *this;
+    }
+
+    // Snapshots levels to filePath every interval and restores them on Initialize
+    TradeSystemBuilder &WithLevelSnapshots(const std::string &filePath, std::chrono::seconds interval = std::chrono::seconds(60))
+    {
+        levelSnapshotStore_ = std::make_shared<LevelSnapshotStore>(filePath);
+        levelSnapshotInterval_ = interval;
+        return *this;
+    }
+
     template <typename TLevelGenerator>
     TradeSystemBuilder &WithLevelGenerator()
     {
@@ -202,11 +219,15 @@ private:
                     levelGenerators_->push_back(std::make_shared<DefaultLevelGenerator>(tradingPlatform_));
                 }
 
-                levelManager_ = std::make_shared<LevelManager>(*levelGenerators_, levelProcessor_, tradingPlatform_);
+                levelManager_ = std::make_shared<LevelManager>(*levelGenerators_, levelProcessor_, tradingPlatform_, levelManagerMode_, levelManagerWaitPolicy_, levelManagerSpinIterations_);
             }
 
             // Convert optional to shared_ptr
             std::shared_ptr<LevelManager> levelManagerPtr = levelManager_.value_or(nullptr);
+            if (levelManagerPtr && levelSnapshotStore_)
+            {
+                levelManagerPtr->SetSnapshotStore(levelSnapshotStore_, levelSnapshotInterval_);
+            }
 
             signalManager_ = std::make_shared<DefaultSignalManager>(signalGenerator_, signalProcessor_, tradingPlatform_, levelManagerPtr);
         }
@@ -241,6 +262,11 @@ private:
     }
 
     bool includeLevelManager = false;
+    Mode levelManagerMode_ = Mode::Synchronous;
+    WaitPolicy levelManagerWaitPolicy_ = WaitPolicy::Park;
+    uint32_t levelManagerSpinIterations_ = 0;
+    std::shared_ptr<LevelSnapshotStore> levelSnapshotStore_;
+    std::chrono::seconds levelSnapshotInterval_{60};
     std::shared_ptr<SignalManager> signalManager_;
     std::shared_ptr<SignalGenerator> signalGenerator_;
     std::shared_ptr<SignalProcessor> signalProcessor_;
@@ -1,11 +1,17 @@
 #pragma once
 
 #include "CommonTypes.h"
+#include "MarketUpdateNotifier.h"
+#include "IndicatorCache.h"
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <optional>
 
+// Thread safety: the data retrieval, statistics, market data, market depth, MBO, time and sales, price, tick, bar
+// index, context and time functions, GetMarketUpdateNotifier and GetIndicatorCache may be called from any thread,
+// concurrently with each other; LevelManager runs its generators in parallel and they rely on this. Message, order,
+// initialization and settings functions and IsReadyForTradeIteration are called from the trading thread only.
 class ITradingPlatform {
 public:
     virtual ~ITradingPlatform() = default;
@@ -170,6 +176,10 @@ public:
     // Returns: The current price
     virtual double GetCurrentPrice() = 0;
 
+    // Retrieves the index of the bar currently forming
+    // Returns: The current bar index; earlier indexes are closed bars
+    virtual int GetCurrentBarIndex() const = 0;
+
     // Retrieves the tick size
     // Returns: The tick size
     virtual double GetTickSize() = 0;
@@ -182,6 +192,14 @@ public:
     // Returns: True if ready, otherwise false
     virtual bool IsReadyForTradeIteration() = 0;
 
+    // Retrieves the notifier the platform publishes to whenever new market data arrives
+    // Returns: The market update notifier; consumers wait on it with their own cursor
+    virtual MarketUpdateNotifier& GetMarketUpdateNotifier() = 0;
+
+    // Retrieves the indicator cache shared by the generators trading this platform's chart
+    // Returns: The platform's own cache; its series read this platform's bars
+    virtual Calculations::IndicatorCache& GetIndicatorCache() = 0;
+
     // Retrieves the platform context
     // Returns: The platform context
     virtual ContextType GetPlatformContext() const = 0;
@@ -0,0 +1,114 @@
+#ifndef MARKET_UPDATE_NOTIFIER_H
+#define MARKET_UPDATE_NOTIFIER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MARKET_UPDATE_NOTIFIER_PAUSE() _mm_pause()
+#else
+#define MARKET_UPDATE_NOTIFIER_PAUSE() std::this_thread::yield()
+#endif
+
+// How a consumer waits for the next market update.
+enum class WaitPolicy
+{
+    Park,        // Block on the condition variable straight away
+    SpinThenPark // Spin for a bounded number of iterations first, trading a core for wake-up latency
+};
+
+// Published by the platform whenever new market data is available.
+// Each consumer keeps its own cursor (the last sequence it has seen), so consumers never interfere with
+// one another or with the platform's own trade-iteration bookkeeping. Several publishes between two waits
+// coalesce into a single wake-up.
+class MarketUpdateNotifier
+{
+public:
+    void Publish()
+    {
+        sequence_.fetch_add(1);
+        // Only pay for the mutex when someone is parked; the seq_cst pair with WaitForUpdate prevents lost wake-ups
+        if (waiters_.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            cv_.notify_all();
+        }
+    }
+
+    uint64_t GetSequence() const
+    {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+    // Waits until the sequence moves past cursor, the timeout expires or WakeAll is called.
+    // Returns true and advances cursor when there is new data.
+    bool WaitForUpdate(uint64_t &cursor, std::chrono::milliseconds timeout, WaitPolicy policy = WaitPolicy::Park, uint32_t spinIterations = 0)
+    {
+        if (TryAdvance(cursor))
+        {
+            return true;
+        }
+
+        if (policy == WaitPolicy::SpinThenPark)
+        {
+            for (uint32_t i = 0; i < spinIterations; ++i)
+            {
+                MARKET_UPDATE_NOTIFIER_PAUSE();
+                if (TryAdvance(cursor))
+                {
+                    return true;
+                }
+            }
+        }
+
+        uint64_t wakeEpoch = wakeEpoch_.load();
+        waiters_.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_.wait_for(lock, timeout, [this, cursor, wakeEpoch]
+                         { return sequence_.load() != cursor || wakeEpoch_.load() != wakeEpoch; });
+        }
+        waiters_.fetch_sub(1);
+
+        return TryAdvance(cursor);
+    }
+
+    // Consumers that have committed to parking; a Publish or WakeAll from now on is guaranteed to reach them.
+    int GetWaiterCount() const
+    {
+        return waiters_.load();
+    }
+
+    // Releases every waiter without publishing, e.g. so a consumer thread can observe a stop flag.
+    void WakeAll()
+    {
+        wakeEpoch_.fetch_add(1);
+        std::lock_guard<std::mutex> lock(mtx_);
+        cv_.notify_all();
+    }
+
+private:
+    bool TryAdvance(uint64_t &cursor) const
+    {
+        uint64_t sequence = sequence_.load(std::memory_order_acquire);
+        if (sequence != cursor)
+        {
+            cursor = sequence;
+            return true;
+        }
+        return false;
+    }
+
+    std::atomic<uint64_t> sequence_{0};
+    std::atomic<uint64_t> wakeEpoch_{0};
+    std::atomic<int> waiters_{0};
+    std::mutex mtx_;
+    std::condition_variable cv_;
+};
+
+#endif // MARKET_UPDATE_NOTIFIER_H
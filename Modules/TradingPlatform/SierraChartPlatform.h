@@ -4,6 +4,7 @@
 #include "ITradingPlatform.h"
 #include "SierraChartHelpers.h"
 #include "CommonTypes.h"
+#include "PerformanceMetrics.h"
 #include <sierrachart.h>
 #include <string>
 #include <vector>
@@ -25,6 +26,12 @@ public:
         return sc->Close[sc->Index];
     }
 
+    int GetCurrentBarIndex() const override
+    {
+        std::shared_lock<std::shared_mutex> lock(scMutex);
+        return sc->Index;
+    }
+
     // Message Functions
     void AddMessageToLog(const std::string &message, bool showLog) override
     {
@@ -256,62 +263,13 @@ public:
     std::optional<BarData> GetBarByOffsetFromCurrent(int offsetFromCurrentBar = 0) const override
     {
         std::shared_lock<std::shared_mutex> lock(scMutex);
-        int index = sc->Index - offsetFromCurrentBar;
-        if (index < 0 || index >= sc->ArraySize)
-        {
-            return std::nullopt;
-        }
-
-        return BarData(
-            DateTime(sc->BaseDateTimeIn[index].ToUNIXTime()),
-            DateTime(sc->BaseDataEndDateTime[index].ToUNIXTime()),
-            sc->BaseData[SC_OPEN][index],
-            sc->BaseData[SC_HIGH][index],
-            sc->BaseData[SC_LOW][index],
-            sc->BaseData[SC_CLOSE][index],
-            sc->BaseData[SC_VOLUME][index],
-            sc->NumberOfTrades[index],
-            sc->OpenInterest[index],
-            sc->OHLCAvg[index],
-            sc->HLCAvg[index],
-            sc->HLAvg[index],
-            sc->BidVolume[index],
-            sc->AskVolume[index],
-            sc->UpTickVolume[index],
-            sc->DownTickVolume[index],
-            sc->NumberOfBidTrades[index],
-            sc->NumberOfAskTrades[index]);
+        return BarAtIndexUnlocked(sc->Index - offsetFromCurrentBar);
     }
 
     std::optional<BarData> GetBarByTime(const DateTime &dateTime) const override
     {
         std::shared_lock<std::shared_mutex> lock(scMutex);
-        for (int index = 0; index < sc->ArraySize; ++index)
-        {
-            if (sc->BaseDataEndDateTime[index].GetAsDouble() == dateTime.ToTimeT())
-            {
-                return BarData(
-                    DateTime(sc->BaseDateTimeIn[index].ToUNIXTime()),
-                    DateTime(sc->BaseDataEndDateTime[index].ToUNIXTime()),
-                    sc->BaseData[SC_OPEN][index],
-                    sc->BaseData[SC_HIGH][index],
-                    sc->BaseData[SC_LOW][index],
-                    sc->BaseData[SC_CLOSE][index],
-                    sc->BaseData[SC_VOLUME][index],
-                    sc->NumberOfTrades[index],
-                    sc->OpenInterest[index],
-                    sc->OHLCAvg[index],
-                    sc->HLCAvg[index],
-                    sc->HLAvg[index],
-                    sc->BidVolume[index],
-                    sc->AskVolume[index],
-                    sc->UpTickVolume[index],
-                    sc->DownTickVolume[index],
-                    sc->NumberOfBidTrades[index],
-                    sc->NumberOfAskTrades[index]);
-            }
-        }
-        return std::nullopt;
+        return BarAtTimeUnlocked(dateTime);
     }
 
     std::vector<BarData> GetBarRangeByOffset(int startOffset, int endOffset) const override
@@ -328,7 +286,7 @@ public:
 
         for (int i = startIndex; i <= endIndex; ++i)
         {
-            auto barData = GetBarByOffsetFromCurrent(sc->Index - i);
+            auto barData = BarAtIndexUnlocked(i);
             if (barData)
             {
                 bars.push_back(*barData);
@@ -344,7 +302,7 @@ public:
         DateTime currentTime = startDateTime;
         while (currentTime <= endDateTime)
         {
-            auto barData = GetBarByTime(currentTime);
+            auto barData = BarAtTimeUnlocked(currentTime);
             if (barData)
             {
                 bars.push_back(*barData);
@@ -357,36 +315,13 @@ public:
     std::optional<BarData> GetBarByIndex(int index) const override
     {
         std::shared_lock<std::shared_mutex> lock(scMutex);
-        if (index < 0 || index >= sc->ArraySize)
-        {
-            return std::nullopt;
-        }
-
-        return BarData(
-            DateTime(sc->BaseDateTimeIn[index].ToUNIXTime()),
-            DateTime(sc->BaseDataEndDateTime[index].ToUNIXTime()),
-            sc->BaseData[SC_OPEN][index],
-            sc->BaseData[SC_HIGH][index],
-            sc->BaseData[SC_LOW][index],
-            sc->BaseData[SC_CLOSE][index],
-            sc->BaseData[SC_VOLUME][index],
-            sc->NumberOfTrades[index],
-            sc->OpenInterest[index],
-            sc->OHLCAvg[index],
-            sc->HLCAvg[index],
-            sc->HLAvg[index],
-            sc->BidVolume[index],
-            sc->AskVolume[index],
-            sc->UpTickVolume[index],
-            sc->DownTickVolume[index],
-            sc->NumberOfBidTrades[index],
-            sc->NumberOfAskTrades[index]);
+        return BarAtIndexUnlocked(index);
     }
 
     TradeStatistics GetAccountWideTradeStatistics() const override
     {
         // TODO: Need better stat calculation, use GetTradeListEntry() and iterate through the trades of the chart to calculate.
-        std::shared_lock<std::shared_mutex> lock(scMutex);
+        std::unique_lock<std::shared_mutex> lock(scMutex);
         n_ACSIL::s_TradeStatistics scStats;
         sc->GetTradeStatisticsForSymbolV2(n_ACSIL::TradeStatisticsTypeEnum::STATS_TYPE_ALL_TRADES, scStats);
         return SierraChartHelpers::MapToTradeStatistics(scStats);
@@ -394,6 +329,7 @@ public:
 
     TradeStatistics GetCurrentSessionTradeStatistics(bool flatToFlat = false) const override
     {
+        std::unique_lock<std::shared_mutex> lock(scMutex);
         int tradeListSize = sc->GetTradeListSize();
         int flatToFlatTradeListSize = sc->GetFlatToFlatTradeListSize();
 
@@ -401,6 +337,10 @@ public:
 
         // Initialize statistics
         auto stats = TradeStatistics();
+        // Trades are the periods here, so the ratios are per trade rather than annualized
+        Calculations::PerformanceMetricsConfig metricsConfig;
+        metricsConfig.periodsPerYear = 1.0;
+        Calculations::PerformanceMetrics metrics(metricsConfig);
 
         double totalProfit = 0.0;
         double totalProfitFlatToFlat = 0.0;
@@ -426,6 +366,7 @@ public:
                     stats.maximumOpenPositionProfit = Max(stats.maximumOpenPositionProfit, tradeEntry.MaximumOpenPositionProfit);
                     stats.maximumOpenPositionLoss = Max(stats.maximumOpenPositionLoss, tradeEntry.MaximumOpenPositionLoss);
                     stats.largestTradeQuantity = Max(stats.largestTradeQuantity, static_cast<double>(tradeEntry.TradeQuantity));
+                    metrics.AddTrade(tradeEntry.TradeProfitLoss);
 
                     if (tradeEntry.TradeProfitLoss > 0)
                     {
@@ -458,9 +399,7 @@ public:
                 stats.totalLosingQuantity = totalLossQuantity;
             }
 
-            // Calculate additional statistics like Sharpe, Sortino ratios etc.
             stats.profit = totalProfit + totalLoss;
-            stats.maxDrawdown = Min(stats.maxDrawdown, totalLoss); // Example, you'll want to properly calculate drawdown
             stats.winRate = (stats.totalTrades > 0) ? (static_cast<double>(stats.winningTrades) / stats.totalTrades) * 100.0 : 0.0;
         }
         else
@@ -479,6 +418,7 @@ public:
                     stats.maximumOpenPositionProfit = Max(stats.maximumOpenPositionProfit, tradeEntry.MaximumOpenPositionProfit);
                     stats.maximumOpenPositionLoss = Max(stats.maximumOpenPositionLoss, tradeEntry.MaximumOpenPositionLoss);
                     stats.largestTradeQuantity = Max(stats.largestTradeQuantity, static_cast<double>(tradeEntry.TradeQuantity));
+                    metrics.AddTrade(tradeEntry.TradeProfitLoss);
 
                     if (tradeEntry.TradeProfitLoss > 0)
                     {
@@ -512,10 +452,12 @@ public:
             }
 
             stats.profit = totalProfitFlatToFlat + totalLossFlatToFlat;
-            stats.maxDrawdown = Min(stats.maxDrawdown, totalLossFlatToFlat); // Example, you'll want to properly calculate drawdown
             stats.winRate = (stats.totalTrades > 0) ? (static_cast<double>(stats.winningTrades) / stats.totalTrades) * 100.0 : 0.0;
         }
 
+        // Drawdown, run-up, Sharpe, Sortino and Calmar over the closed-trade equity curve
+        metrics.ApplyTo(stats);
+
         return stats;
     }
 
@@ -567,7 +509,7 @@ public:
 
     bool IsReadyForTradeIteration() override
     {
-        std::shared_lock<std::shared_mutex> lock(scMutex);
+        std::unique_lock<std::shared_mutex> lock(scMutex);
         if (sc->IsFullRecalculation)
         {
             if (sc->Index == 0)
@@ -594,9 +536,20 @@ public:
             lastClosePrice = sc->Close[sc->Index];
         }
 
+        marketUpdateNotifier_.Publish();
         return true;
     }
 
+    MarketUpdateNotifier &GetMarketUpdateNotifier() override
+    {
+        return marketUpdateNotifier_;
+    }
+
+    Calculations::IndicatorCache &GetIndicatorCache() override
+    {
+        return indicatorCache_;
+    }
+
     PositionData GetPositionData() const override
     {
         std::shared_lock<std::shared_mutex> lock(scMutex);
@@ -705,11 +658,13 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
 
     double GetTickSize() override
     {
+        std::shared_lock<std::shared_mutex> lock(scMutex);
         return sc->TickSize;
     }
 
     double GetCurrencyValuePerTick() override
     {
+        std::shared_lock<std::shared_mutex> lock(scMutex);
         return sc->CurrencyValuePerTick;
     }
 
@@ -735,7 +690,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
 
     std::vector<TimeAndSales> GetTimeAndSalesData() override
     {
-        std::shared_lock<std::shared_mutex> lock(scMutex);
+        std::unique_lock<std::shared_mutex> lock(scMutex);
         c_SCTimeAndSalesArray tsArray;
         sc->GetTimeAndSales(tsArray);
 
@@ -749,7 +704,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
 
     std::optional<TimeAndSales> GetLatestTimeAndSales() override
     {
-        std::shared_lock<std::shared_mutex> lock(scMutex);
+        std::unique_lock<std::shared_mutex> lock(scMutex);
         c_SCTimeAndSalesArray tsArray;
         sc->GetTimeAndSales(tsArray);
 
@@ -762,7 +717,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
 
     std::vector<TimeAndSales> GetTimeAndSalesForBarIndex(int barIndex) override
     {
-        std::shared_lock<std::shared_mutex> lock(scMutex);
+        std::unique_lock<std::shared_mutex> lock(scMutex);
         int beginIndex, endIndex;
         sc->GetTimeSalesArrayIndexesForBarIndex(barIndex, beginIndex, endIndex);
 
@@ -783,7 +738,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
     // Market Depth Functions
     std::vector<MarketDepth> GetBidMarketDepth(int depthLevel) const override
     {
-        std::shared_lock<std::shared_mutex> lock(scMutex);
+        std::unique_lock<std::shared_mutex> lock(scMutex);
         std::vector<MarketDepth> bidDepth;
 
         int bidLevels = depthLevel > 0 ? depthLevel : sc->GetBidMarketDepthNumberOfLevels();
@@ -793,7 +748,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
             if (sc->GetBidMarketDepthEntryAtLevel(depthEntry, level))
             {
                 MarketDepth md;
-                md.timestamp = GetCurrentPlatformTime(); // Use current time or fetch from depthEntry if available
+                md.timestamp = CurrentPlatformTimeUnlocked(true); // Use current time or fetch from depthEntry if available
                 md.type = MarketDepthType::Bid;
                 md.price = depthEntry.AdjustedPrice;
                 md.quantity = depthEntry.Quantity;
@@ -809,7 +764,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
 
     std::vector<MarketDepth> GetAskMarketDepth(int depthLevel) const override
     {
-        std::shared_lock<std::shared_mutex> lock(scMutex);
+        std::unique_lock<std::shared_mutex> lock(scMutex);
         std::vector<MarketDepth> askDepth;
 
         int askLevels = depthLevel > 0 ? depthLevel : sc->GetAskMarketDepthNumberOfLevels();
@@ -819,7 +774,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
             if (sc->GetAskMarketDepthEntryAtLevel(depthEntry, level))
             {
                 MarketDepth md;
-                md.timestamp = GetCurrentPlatformTime(); // Use current time or fetch from depthEntry if available
+                md.timestamp = CurrentPlatformTimeUnlocked(true); // Use current time or fetch from depthEntry if available
                 md.type = MarketDepthType::Ask;
                 md.price = depthEntry.AdjustedPrice;
                 md.quantity = depthEntry.Quantity;
@@ -836,7 +791,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
     // Market By Order (MBO) Functions
     std::vector<MarketOrderData> GetBidMarketOrdersForPrice(double price) const override
     {
-        std::shared_lock<std::shared_mutex> lock(scMutex);
+        std::unique_lock<std::shared_mutex> lock(scMutex);
         std::vector<MarketOrderData> marketOrders;
         int priceInTicks = static_cast<int>(price / sc->TickSize);
         n_ACSIL::s_MarketOrderData marketOrderDataArray[100]; // Example array size
@@ -846,7 +801,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
         for (int i = 0; i < numOrders; ++i)
         {
             MarketOrderData mod;
-            mod.timestamp = GetCurrentPlatformTime(); // Use current time or fetch from data source if available
+            mod.timestamp = CurrentPlatformTimeUnlocked(true); // Use current time or fetch from data source if available
             mod.price = price;
             mod.quantity = marketOrderDataArray[i].OrderQuantity;
             mod.orderId = marketOrderDataArray[i].OrderID;
@@ -858,7 +813,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
 
     std::vector<MarketOrderData> GetAskMarketOrdersForPrice(double price) const override
     {
-        std::shared_lock<std::shared_mutex> lock(scMutex);
+        std::unique_lock<std::shared_mutex> lock(scMutex);
         std::vector<MarketOrderData> marketOrders;
         int priceInTicks = static_cast<int>(price / sc->TickSize);
         n_ACSIL::s_MarketOrderData marketOrderDataArray[100]; // Example array size
@@ -868,7 +823,7 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
         for (int i = 0; i < numOrders; ++i)
         {
             MarketOrderData mod;
-            mod.timestamp = GetCurrentPlatformTime(); // Use current time or fetch from data source if available
+            mod.timestamp = CurrentPlatformTimeUnlocked(true); // Use current time or fetch from data source if available
             mod.price = price;
             mod.quantity = marketOrderDataArray[i].OrderQuantity;
             mod.orderId = marketOrderDataArray[i].OrderID;
@@ -888,28 +843,87 @@ void SetBarPeriod(const std::string &barType, std::string barPeriod) override
 
     DateTime GetCurrentPlatformTime(bool getBasedOnBar = true) const override
     {
-        if(getBasedOnBar)
+        if (getBasedOnBar)
         {
-            // Returns the current time of the last bar.
-            return DateTime(sc->BaseDataEndDateTime[sc->Index].ToUNIXTime());
-            
-        } else {
-            return DateTime(sc->GetCurrentDateTime().ToUNIXTime());
-        }                             
+            std::shared_lock<std::shared_mutex> lock(scMutex);
+            return CurrentPlatformTimeUnlocked(true);
+        }
+        std::unique_lock<std::shared_mutex> lock(scMutex);
+        return CurrentPlatformTimeUnlocked(false);
     }
 
     void UpdateSCRef(s_sc *new_sc)
     {
-        std::unique_lock<std::shared_mutex> lock(scMutex);
-        sc = new_sc; // Update the reference directly
+        {
+            std::unique_lock<std::shared_mutex> lock(scMutex);
+            sc = new_sc; // Update the reference directly
+        }
+        // The study is called when chart data changes, so wake consumers waiting for market data
+        marketUpdateNotifier_.Publish();
     }
 
 private:
-    mutable std::shared_mutex scMutex; // Ensure thread-safety with shared_mutex
+    // The *Unlocked helpers are for callers already holding scMutex, which is not recursive
+    std::optional<BarData> BarAtIndexUnlocked(int index) const
+    {
+        if (index < 0 || index >= sc->ArraySize)
+        {
+            return std::nullopt;
+        }
+
+        return BarData(
+            DateTime(sc->BaseDateTimeIn[index].ToUNIXTime()),
+            DateTime(sc->BaseDataEndDateTime[index].ToUNIXTime()),
+            sc->BaseData[SC_OPEN][index],
+            sc->BaseData[SC_HIGH][index],
+            sc->BaseData[SC_LOW][index],
+            sc->BaseData[SC_CLOSE][index],
+            sc->BaseData[SC_VOLUME][index],
+            sc->NumberOfTrades[index],
+            sc->OpenInterest[index],
+            sc->OHLCAvg[index],
+            sc->HLCAvg[index],
+            sc->HLAvg[index],
+            sc->BidVolume[index],
+            sc->AskVolume[index],
+            sc->UpTickVolume[index],
+            sc->DownTickVolume[index],
+            sc->NumberOfBidTrades[index],
+            sc->NumberOfAskTrades[index]);
+    }
+
+    std::optional<BarData> BarAtTimeUnlocked(const DateTime &dateTime) const
+    {
+        for (int index = 0; index < sc->ArraySize; ++index)
+        {
+            if (sc->BaseDataEndDateTime[index].GetAsDouble() == dateTime.ToTimeT())
+            {
+                return BarAtIndexUnlocked(index);
+            }
+        }
+        return std::nullopt;
+    }
+
+    DateTime CurrentPlatformTimeUnlocked(bool getBasedOnBar) const
+    {
+        if (getBasedOnBar)
+        {
+            // Returns the current time of the last bar.
+            return DateTime(sc->BaseDataEndDateTime[sc->Index].ToUNIXTime());
+        }
+        return DateTime(sc->GetCurrentDateTime().ToUNIXTime());
+    }
+
+    // Data retrieval functions may be called from several threads at once (see ITradingPlatform). Plain reads of sc's
+    // arrays and fields share the lock; calls into ACSIL functions, which Sierra Chart does not document as safe to
+    // call concurrently, and anything that changes sc or this object take it exclusively.
+    mutable std::shared_mutex scMutex;
     double lastClosePrice = 0;
     int lastBarIndexProcessed = -1;
     ContextType tradePlatformContext_;
     UpdateIntervalType updateIntervalType_;
+    MarketUpdateNotifier marketUpdateNotifier_;
+    Calculations::IndicatorCache indicatorCache_;
     s_sc *sc;
 };
 
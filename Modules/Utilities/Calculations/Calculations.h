@@ -9,6 +9,7 @@
 #include <tuple>
 #include <optional>
 #include "CommonTypes.h"
+#include "StreamingIndicators.h"
 
 namespace Calculations {
 
@@ -154,7 +155,7 @@ namespace Calculations {
      * @param long_length The period length for the long EMA.
      * @param signal_length The period length for the signal line EMA.
      * @return A pair containing the MACD value and the signal line value.
-     * @throws std::invalid_argument If the period lengths are invalid.
+     * @throws std::invalid_argument If the period lengths are invalid, `short_length` is not less than `long_length` or `data` is too short.
      * 
      * @details The MACD is used to identify changes in the strength, direction, momentum, and duration of a trend. It is a trend-following momentum indicator that shows the relationship between two moving averages of a security’s price.
      */
@@ -162,14 +163,19 @@ namespace Calculations {
         if (short_length <= 0 || long_length <= 0 || signal_length <= 0 || data.size() < long_length) {
             throw std::invalid_argument("Invalid lengths for MACD calculation.");
         }
-        float short_ema = CalculateEMA(data, short_length);
-        float long_ema = CalculateEMA(data, long_length);
-        float macd = short_ema - long_ema;
-        std::vector<float> macd_line(data.size() - long_length + 1);
-        for (size_t i = long_length - 1; i < data.size(); ++i) {
-            macd_line[i - long_length + 1] = CalculateEMA(std::vector<float>(data.begin() + i - long_length + 1, data.begin() + i + 1), short_length) - CalculateEMA(std::vector<float>(data.begin() + i - long_length + 1, data.begin() + i + 1), long_length);
+        if (short_length >= long_length) {
+            throw std::invalid_argument("MACD short length must be less than its long length.");
         }
-        float signal_line = CalculateEMA(macd_line, signal_length);
+        if (data.size() - long_length + 1 < static_cast<size_t>(signal_length)) {
+            throw std::invalid_argument("Not enough data for the MACD signal length.");
+        }
+        // One pass: each MACD line value comes from the O(1) windowed EMAs instead of recomputing both EMAs per element
+        StreamingMACD streamingMacd(short_length, long_length, signal_length);
+        for (float value : data) {
+            streamingMacd.Update(value);
+        }
+        float macd = static_cast<float>(streamingMacd.Macd());
+        float signal_line = static_cast<float>(streamingMacd.Signal());
         return std::make_pair(macd, signal_line);
     }
 
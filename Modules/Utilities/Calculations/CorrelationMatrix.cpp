@@ -0,0 +1,301 @@
+#include "CorrelationMatrix.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace Calculations {
+
+    CorrelationMatrix::CorrelationMatrix(std::vector<std::string> instruments, const CorrelationMatrixConfig& config)
+        : instruments_(std::move(instruments)), config_(config), count_(instruments_.size()) {
+        if (count_ == 0) {
+            throw std::invalid_argument("A correlation matrix needs at least one instrument.");
+        }
+        if (config_.weighting == CorrelationWeighting::Exponential && (config_.lambda <= 0.0 || config_.lambda >= 1.0)) {
+            throw std::invalid_argument("Exponential decay must be between 0 and 1.");
+        }
+        if (config_.weighting == CorrelationWeighting::Window && config_.windowLength < 2) {
+            throw std::invalid_argument("Correlation window must hold at least two bars.");
+        }
+
+        means_.assign(count_, 0.0);
+        moments_.assign(count_ * (count_ + 1) / 2, 0.0);
+        deviations_.assign(count_, 0.0);
+        priceReturns_.assign(count_, 0.0);
+        if (config_.weighting == CorrelationWeighting::Window) {
+            window_.assign(static_cast<size_t>(config_.windowLength) * count_, 0.0);
+        }
+    }
+
+    void CorrelationMatrix::UpdateReturns(const std::vector<double>& returns) {
+        if (returns.size() != count_) {
+            throw std::invalid_argument("Expected one return per instrument in the correlation matrix.");
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (config_.weighting == CorrelationWeighting::Exponential) {
+            UpdateExponential(returns.data());
+        } else {
+            UpdateWindow(returns.data());
+        }
+    }
+
+    void CorrelationMatrix::UpdatePrices(const std::vector<double>& prices) {
+        if (prices.size() != count_) {
+            throw std::invalid_argument("Expected one price per instrument in the correlation matrix.");
+        }
+        if (std::any_of(prices.begin(), prices.end(), [](double price) { return !(price > 0.0); })) {
+            throw std::invalid_argument("Prices must be positive to compute log returns.");
+        }
+
+        if (lastPrices_.empty()) {
+            lastPrices_ = prices;
+            return;
+        }
+        for (size_t i = 0; i < count_; ++i) {
+            priceReturns_[i] = std::log(prices[i] / lastPrices_[i]);
+        }
+        lastPrices_ = prices;
+        UpdateReturns(priceReturns_);
+    }
+
+    std::optional<size_t> CorrelationMatrix::IndexOf(const std::string& instrument) const {
+        auto it = std::find(instruments_.begin(), instruments_.end(), instrument);
+        if (it == instruments_.end()) {
+            return std::nullopt;
+        }
+        return static_cast<size_t>(it - instruments_.begin());
+    }
+
+    bool CorrelationMatrix::IsReady() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return IsReadyLocked();
+    }
+
+    uint64_t CorrelationMatrix::GetObservationCount() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return observations_;
+    }
+
+    std::optional<double> CorrelationMatrix::GetMean(size_t instrument) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (instrument >= count_ || !IsReadyLocked()) {
+            return std::nullopt;
+        }
+        return MeanLocked(instrument);
+    }
+
+    std::optional<double> CorrelationMatrix::GetCovariance(size_t first, size_t second) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (first >= count_ || second >= count_ || !IsReadyLocked()) {
+            return std::nullopt;
+        }
+        return CovarianceLocked(first, second);
+    }
+
+    std::optional<double> CorrelationMatrix::GetVolatility(size_t instrument) const {
+        auto variance = GetCovariance(instrument, instrument);
+        if (!variance.has_value()) {
+            return std::nullopt;
+        }
+        return std::sqrt(std::max(variance.value(), 0.0));
+    }
+
+    std::optional<double> CorrelationMatrix::GetCorrelation(size_t first, size_t second) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (first >= count_ || second >= count_ || !IsReadyLocked()) {
+            return std::nullopt;
+        }
+        double denominator = std::sqrt(CovarianceLocked(first, first) * CovarianceLocked(second, second));
+        if (!(denominator > 0.0)) {
+            return std::nullopt;
+        }
+        return std::clamp(CovarianceLocked(first, second) / denominator, -1.0, 1.0);
+    }
+
+    std::optional<double> CorrelationMatrix::GetBeta(size_t instrument, size_t benchmark) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (instrument >= count_ || benchmark >= count_ || !IsReadyLocked()) {
+            return std::nullopt;
+        }
+        double benchmarkVariance = CovarianceLocked(benchmark, benchmark);
+        if (!(benchmarkVariance > 0.0)) {
+            return std::nullopt;
+        }
+        return CovarianceLocked(instrument, benchmark) / benchmarkVariance;
+    }
+
+    std::optional<double> CorrelationMatrix::GetAlpha(size_t instrument, size_t benchmark) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (instrument >= count_ || benchmark >= count_ || !IsReadyLocked()) {
+            return std::nullopt;
+        }
+        double benchmarkVariance = CovarianceLocked(benchmark, benchmark);
+        if (!(benchmarkVariance > 0.0)) {
+            return std::nullopt;
+        }
+        double beta = CovarianceLocked(instrument, benchmark) / benchmarkVariance;
+        return MeanLocked(instrument) - beta * MeanLocked(benchmark);
+    }
+
+    std::vector<double> CorrelationMatrix::GetCorrelationMatrix() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::vector<double> matrix;
+        if (!IsReadyLocked()) {
+            return matrix;
+        }
+
+        std::vector<double> deviations(count_);
+        for (size_t i = 0; i < count_; ++i) {
+            deviations[i] = std::sqrt(std::max(CovarianceLocked(i, i), 0.0));
+        }
+        matrix.assign(count_ * count_, 0.0);
+        for (size_t i = 0; i < count_; ++i) {
+            matrix[i * count_ + i] = 1.0;
+            for (size_t j = i + 1; j < count_; ++j) {
+                double denominator = deviations[i] * deviations[j];
+                double correlation = denominator > 0.0 ? std::clamp(CovarianceLocked(i, j) / denominator, -1.0, 1.0) : 0.0;
+                matrix[i * count_ + j] = correlation;
+                matrix[j * count_ + i] = correlation;
+            }
+        }
+        return matrix;
+    }
+
+    bool CorrelationMatrix::ApplyTo(RiskAssessment& assessment, const std::string& instrument, const std::string& benchmark) const {
+        auto instrumentIndex = IndexOf(instrument);
+        auto benchmarkIndex = IndexOf(benchmark);
+        if (!instrumentIndex.has_value() || !benchmarkIndex.has_value()) {
+            return false;
+        }
+
+        auto beta = GetBeta(instrumentIndex.value(), benchmarkIndex.value());
+        auto alpha = GetAlpha(instrumentIndex.value(), benchmarkIndex.value());
+        auto correlation = GetCorrelation(instrumentIndex.value(), benchmarkIndex.value());
+        auto volatility = GetVolatility(instrumentIndex.value());
+        if (!beta.has_value() || !alpha.has_value() || !correlation.has_value() || !volatility.has_value()) {
+            return false;
+        }
+
+        assessment.beta = beta.value();
+        assessment.alpha = alpha.value();
+        assessment.correlation = correlation.value();
+        assessment.volatility = volatility.value();
+        return true;
+    }
+
+    void CorrelationMatrix::Reset() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        observations_ = 0;
+        std::fill(means_.begin(), means_.end(), 0.0);
+        std::fill(moments_.begin(), moments_.end(), 0.0);
+        std::fill(window_.begin(), window_.end(), 0.0);
+        windowHead_ = 0;
+        sinceResync_ = 0;
+        lastPrices_.clear();
+    }
+
+    size_t CorrelationMatrix::PairIndex(size_t first, size_t second) const {
+        if (first > second) {
+            std::swap(first, second);
+        }
+        // Row `first` of the packed upper triangle starts after first rows of decreasing length
+        return first * count_ - first * (first - 1) / 2 + (second - first);
+    }
+
+    bool CorrelationMatrix::IsReadyLocked() const {
+        if (config_.weighting == CorrelationWeighting::Window) {
+            return observations_ >= static_cast<uint64_t>(config_.windowLength);
+        }
+        return observations_ >= static_cast<uint64_t>(std::max(config_.minimumObservations, 2));
+    }
+
+    double CorrelationMatrix::MeanLocked(size_t instrument) const {
+        if (config_.weighting == CorrelationWeighting::Exponential) {
+            return means_[instrument];
+        }
+        double observed = static_cast<double>(std::min<uint64_t>(observations_, static_cast<uint64_t>(config_.windowLength)));
+        return means_[instrument] / observed;
+    }
+
+    double CorrelationMatrix::CovarianceLocked(size_t first, size_t second) const {
+        double moment = moments_[PairIndex(first, second)];
+        if (config_.weighting == CorrelationWeighting::Exponential) {
+            return moment;
+        }
+        double observed = static_cast<double>(std::min<uint64_t>(observations_, static_cast<uint64_t>(config_.windowLength)));
+        return (moment - means_[first] * means_[second] / observed) / (observed - 1.0);
+    }
+
+    void CorrelationMatrix::UpdateExponential(const double* returns) {
+        if (observations_ == 0) {
+            std::copy(returns, returns + count_, means_.begin());
+            ++observations_;
+            return;
+        }
+
+        // West's incremental weighted covariance: C = lambda * (C + alpha * d_i * d_j) with d taken before the mean moves
+        const double alpha = 1.0 - config_.lambda;
+        const double lambda = config_.lambda;
+        for (size_t i = 0; i < count_; ++i) {
+            deviations_[i] = returns[i] - means_[i];
+            means_[i] += alpha * deviations_[i];
+        }
+        double* moment = moments_.data();
+        for (size_t i = 0; i < count_; ++i) {
+            const double scaled = alpha * deviations_[i];
+            const double* deviations = deviations_.data();
+            for (size_t j = i; j < count_; ++j) {
+                *moment = lambda * (*moment + scaled * deviations[j]);
+                ++moment;
+            }
+        }
+        ++observations_;
+    }
+
+    void CorrelationMatrix::UpdateWindow(const double* returns) {
+        const size_t length = static_cast<size_t>(config_.windowLength);
+        double* row = &window_[windowHead_ * count_];
+        const bool evicting = observations_ >= length;
+        if (!evicting) {
+            std::fill(row, row + count_, 0.0);
+        }
+
+        // Add the new bar's products and subtract the evicted bar's in the same pass; before the window fills the row is zero
+        double* moment = moments_.data();
+        for (size_t i = 0; i < count_; ++i) {
+            means_[i] += returns[i] - row[i];
+            const double incoming = returns[i];
+            const double outgoing = row[i];
+            for (size_t j = i; j < count_; ++j) {
+                *moment += incoming * returns[j] - outgoing * row[j];
+                ++moment;
+            }
+        }
+        std::copy(returns, returns + count_, row);
+        windowHead_ = (windowHead_ + 1) % length;
+        ++observations_;
+
+        if (++sinceResync_ >= length) {
+            ResyncWindowSums();
+        }
+    }
+
+    void CorrelationMatrix::ResyncWindowSums() {
+        const size_t rows = static_cast<size_t>(std::min<uint64_t>(observations_, static_cast<uint64_t>(config_.windowLength)));
+        std::fill(means_.begin(), means_.end(), 0.0);
+        std::fill(moments_.begin(), moments_.end(), 0.0);
+        for (size_t r = 0; r < rows; ++r) {
+            const double* row = &window_[r * count_];
+            double* moment = moments_.data();
+            for (size_t i = 0; i < count_; ++i) {
+                means_[i] += row[i];
+                for (size_t j = i; j < count_; ++j) {
+                    *moment += row[i] * row[j];
+                    ++moment;
+                }
+            }
+        }
+        sinceResync_ = 0;
+    }
+
+} // namespace Calculations
@@ -0,0 +1,121 @@
+#ifndef CORRELATION_MATRIX_H
+#define CORRELATION_MATRIX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "CommonTypes.h"
+
+namespace Calculations {
+
+    enum class CorrelationWeighting {
+        Exponential, // exponentially weighted moments with decay `lambda`
+        Window       // equally weighted moments over the last `windowLength` bars
+    };
+
+    struct CorrelationMatrixConfig {
+        CorrelationWeighting weighting = CorrelationWeighting::Exponential;
+        double lambda = 0.97;          // weight of the previous estimate per bar, in (0, 1)
+        int windowLength = 300;
+        int minimumObservations = 30;  // bars before estimates are reported (a full window for Window weighting)
+    };
+
+    /**
+     * @brief Rolling covariance, correlation and beta between instruments, updated once per synchronized bar.
+     *
+     * @details Each update takes one return per instrument and touches each pair once, so it costs O(pairs) regardless of
+     * the window. Co-moments are kept as a packed upper triangle so the update streams through contiguous memory.
+     * The fixed-window variant keeps running sums and the window's returns to subtract the bar that leaves it, and
+     * recomputes the sums from the window once per window length to bound rounding drift.
+     *
+     * Reads may come from other threads than the single thread feeding updates: updates take an exclusive lock, reads a
+     * shared one.
+     */
+    class CorrelationMatrix {
+    public:
+        CorrelationMatrix(std::vector<std::string> instruments, const CorrelationMatrixConfig& config = CorrelationMatrixConfig());
+
+        CorrelationMatrix(const CorrelationMatrix&) = delete;
+        CorrelationMatrix& operator=(const CorrelationMatrix&) = delete;
+
+        /**
+         * @brief Adds one bar of returns, ordered like the instruments passed at construction.
+         * @throws std::invalid_argument If the number of returns does not match the number of instruments.
+         */
+        void UpdateReturns(const std::vector<double>& returns);
+
+        /**
+         * @brief Adds one bar of prices; log returns against the previous bar's prices are fed to UpdateReturns.
+         * @throws std::invalid_argument If the count does not match or a price is not positive.
+         */
+        void UpdatePrices(const std::vector<double>& prices);
+
+        const std::vector<std::string>& GetInstruments() const { return instruments_; }
+        std::optional<size_t> IndexOf(const std::string& instrument) const;
+
+        bool IsReady() const;
+        uint64_t GetObservationCount() const;
+
+        std::optional<double> GetMean(size_t instrument) const;
+        std::optional<double> GetCovariance(size_t first, size_t second) const;
+        std::optional<double> GetVolatility(size_t instrument) const;
+        std::optional<double> GetCorrelation(size_t first, size_t second) const;
+
+        /**
+         * @brief Sensitivity of an instrument's returns to a benchmark's: cov(instrument, benchmark) / var(benchmark).
+         */
+        std::optional<double> GetBeta(size_t instrument, size_t benchmark) const;
+
+        /**
+         * @brief Per-bar mean return of an instrument not explained by the benchmark: mean - beta * benchmark mean.
+         */
+        std::optional<double> GetAlpha(size_t instrument, size_t benchmark) const;
+
+        /**
+         * @brief Full correlation matrix, row-major, with ones on the diagonal. Empty until ready.
+         */
+        std::vector<double> GetCorrelationMatrix() const;
+
+        /**
+         * @brief Fills beta, alpha, correlation and volatility of an instrument against a benchmark.
+         * @return False if either instrument is unknown or the estimates are not ready; the assessment is left untouched.
+         */
+        bool ApplyTo(RiskAssessment& assessment, const std::string& instrument, const std::string& benchmark) const;
+
+        void Reset();
+
+    private:
+        size_t PairIndex(size_t first, size_t second) const;
+        bool IsReadyLocked() const;
+        double CovarianceLocked(size_t first, size_t second) const;
+        double MeanLocked(size_t instrument) const;
+        void UpdateExponential(const double* returns);
+        void UpdateWindow(const double* returns);
+        void ResyncWindowSums();
+
+        std::vector<std::string> instruments_;
+        CorrelationMatrixConfig config_;
+        size_t count_;
+
+        mutable std::shared_mutex mutex_;
+        uint64_t observations_ = 0;
+
+        // Exponential: means and co-moments; Window: running sums and sums of products
+        std::vector<double> means_;
+        std::vector<double> moments_; // packed upper triangle, row by row
+        std::vector<double> deviations_;
+
+        std::vector<double> window_;  // windowLength rows of count_ returns, used as a ring
+        size_t windowHead_ = 0;
+        size_t sinceResync_ = 0;
+
+        std::vector<double> lastPrices_;
+        std::vector<double> priceReturns_;
+    };
+
+} // namespace Calculations
+
+#endif // CORRELATION_MATRIX_H
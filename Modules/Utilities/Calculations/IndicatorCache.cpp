@@ -0,0 +1,207 @@
+#include "IndicatorCache.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Calculations {
+
+    void IndicatorCache::Entry::Reset() {
+        committed.Reset();
+        values.clear();
+        committedThrough = -1;
+        provisionalBar = -1;
+        provisionalValue.reset();
+    }
+
+    void IndicatorCache::RegisterSeries(const std::string& series, SeriesSource source) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        series_[series] = std::make_shared<const SeriesSource>(std::move(source));
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (it->first.series == series) {
+                it = entries_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    bool IndicatorCache::HasSeries(const std::string& series) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return series_.find(series) != series_.end();
+    }
+
+    void IndicatorCache::OnMarketUpdate(int currentBarIndex) {
+        int previous = currentBarIndex_.exchange(currentBarIndex, std::memory_order_acq_rel);
+        if (currentBarIndex < previous) {
+            Clear();
+        }
+        epoch_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    std::optional<double> IndicatorCache::Get(const IndicatorKey& key, int barIndex) {
+        int currentBarIndex = currentBarIndex_.load(std::memory_order_acquire);
+        uint64_t epoch = epoch_.load(std::memory_order_acquire);
+        if (barIndex < 0 || barIndex > currentBarIndex) {
+            return std::nullopt;
+        }
+
+        std::shared_ptr<Entry> entry;
+        std::shared_ptr<const SeriesSource> source;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto seriesIt = series_.find(key.series);
+            if (seriesIt == series_.end()) {
+                return std::nullopt;
+            }
+            source = seriesIt->second;
+            auto entryIt = entries_.find(key);
+            if (entryIt != entries_.end()) {
+                entry = entryIt->second;
+            }
+        }
+        if (!entry) {
+            entry = FindOrCreateEntry(key);
+        }
+
+        // Fast path: closed bars and an up-to-date forming bar are plain reads
+        {
+            std::shared_lock<std::shared_mutex> lock(entry->mutex);
+            if (barIndex <= entry->committedThrough) {
+                return entry->values[barIndex];
+            }
+            if (barIndex == currentBarIndex && entry->provisionalBar == currentBarIndex && entry->provisionalEpoch == epoch) {
+                return entry->provisionalValue;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(entry->mutex);
+
+        // Feed closed bars the entry has not seen yet; only bars that closed since the last request are computed
+        int lastClosedBar = std::min(barIndex, currentBarIndex - 1);
+        while (entry->committedThrough < lastClosedBar) {
+            int nextBar = entry->committedThrough + 1;
+            auto value = (*source)(nextBar);
+            if (value.has_value()) {
+                entry->committed.Update(value.value());
+            }
+            entry->values.push_back(value.has_value() ? CurrentValue(entry->committed, entry->handle) : std::nullopt);
+            entry->committedThrough = nextBar;
+        }
+        if (barIndex <= entry->committedThrough) {
+            return entry->values[barIndex];
+        }
+
+        // Forming bar: apply its latest value to a copy so the committed state stays at the last closed bar
+        if (entry->provisionalBar != currentBarIndex || entry->provisionalEpoch != epoch) {
+            auto value = (*source)(currentBarIndex);
+            entry->provisionalValue.reset();
+            if (value.has_value()) {
+                IndicatorSet forming = entry->committed;
+                forming.Update(value.value());
+                entry->provisionalValue = CurrentValue(forming, entry->handle);
+            }
+            entry->provisionalBar = currentBarIndex;
+            entry->provisionalEpoch = epoch;
+        }
+        return entry->provisionalValue;
+    }
+
+    std::optional<double> IndicatorCache::GetSMA(const std::string& series, int length, int barIndex) {
+        return Get(IndicatorKey{series, IndicatorSet::IndicatorType::SMA, {static_cast<double>(length)}}, barIndex);
+    }
+
+    std::optional<double> IndicatorCache::GetEMA(const std::string& series, int length, int barIndex) {
+        return Get(IndicatorKey{series, IndicatorSet::IndicatorType::EMA, {static_cast<double>(length)}}, barIndex);
+    }
+
+    std::optional<double> IndicatorCache::GetStandardDeviation(const std::string& series, int length, int barIndex) {
+        return Get(IndicatorKey{series, IndicatorSet::IndicatorType::StandardDeviation, {static_cast<double>(length)}}, barIndex);
+    }
+
+    std::optional<double> IndicatorCache::GetRSI(const std::string& series, int length, int barIndex) {
+        return Get(IndicatorKey{series, IndicatorSet::IndicatorType::RSI, {static_cast<double>(length)}}, barIndex);
+    }
+
+    void IndicatorCache::Invalidate(const std::string& series, int fromBarIndex) {
+        std::vector<std::shared_ptr<Entry>> affected;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            for (const auto& [key, entry] : entries_) {
+                if (key.series == series) {
+                    affected.push_back(entry);
+                }
+            }
+        }
+
+        for (const auto& entry : affected) {
+            std::unique_lock<std::shared_mutex> lock(entry->mutex);
+            if (entry->committedThrough >= fromBarIndex || entry->provisionalBar >= fromBarIndex) {
+                entry->Reset();
+            }
+        }
+    }
+
+    void IndicatorCache::Clear() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    size_t IndicatorCache::EntryCount() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    std::shared_ptr<IndicatorCache::Entry> IndicatorCache::FindOrCreateEntry(const IndicatorKey& key) {
+        // Validate and register outside the map lock; Register throws on bad parameters
+        auto entry = std::make_shared<Entry>();
+        entry->handle = Register(entry->committed, key);
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        // Another thread may have created the entry meanwhile; emplace keeps the existing one
+        return entries_.emplace(key, entry).first->second;
+    }
+
+    IndicatorSet::Handle IndicatorCache::Register(IndicatorSet& set, const IndicatorKey& key) {
+        auto parameter = [&key](size_t index) {
+            if (index >= key.parameters.size()) {
+                throw std::invalid_argument("Missing parameter for cached indicator on series " + key.series + ".");
+            }
+            return key.parameters[index];
+        };
+        auto length = [&parameter](size_t index) {
+            double value = parameter(index);
+            if (value <= 0 || value != static_cast<int>(value)) {
+                throw std::invalid_argument("Indicator lengths must be positive integers.");
+            }
+            return static_cast<int>(value);
+        };
+
+        switch (key.type) {
+        case IndicatorSet::IndicatorType::SMA:
+            return set.AddSMA(length(0));
+        case IndicatorSet::IndicatorType::EMA:
+            return set.AddEMA(length(0));
+        case IndicatorSet::IndicatorType::Variance:
+            return set.AddVariance(length(0));
+        case IndicatorSet::IndicatorType::StandardDeviation:
+            return set.AddStandardDeviation(length(0));
+        case IndicatorSet::IndicatorType::BollingerBands:
+            return set.AddBollingerBands(length(0), parameter(1));
+        case IndicatorSet::IndicatorType::RSI:
+            return set.AddRSI(length(0));
+        case IndicatorSet::IndicatorType::MACD:
+            return set.AddMACD(length(0), length(1), length(2));
+        case IndicatorSet::IndicatorType::VWAP:
+            // Series sources carry a single value per bar, so there is no volume to weight by
+            throw std::invalid_argument("VWAP cannot be cached on a single-value series.");
+        }
+        throw std::invalid_argument("Unknown indicator type.");
+    }
+
+    std::optional<double> IndicatorCache::CurrentValue(const IndicatorSet& set, IndicatorSet::Handle handle) {
+        if (!set.IsReady(handle)) {
+            return std::nullopt;
+        }
+        return set.Value(handle);
+    }
+
+} // namespace Calculations
@@ -0,0 +1,138 @@
+#ifndef INDICATOR_CACHE_H
+#define INDICATOR_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "IndicatorSet.h"
+
+namespace Calculations {
+
+    /**
+     * @brief Identifies a cached indicator: the series it reads, its type and its parameters.
+     *
+     * @details Parameters follow the IndicatorSet registration order: {length} for most indicators, {length, numStdDev}
+     * for Bollinger Bands and {shortLength, longLength, signalLength} for MACD. The cached value is the indicator's
+     * primary value (IndicatorSet::Value).
+     */
+    struct IndicatorKey {
+        std::string series;
+        IndicatorSet::IndicatorType type;
+        std::vector<double> parameters;
+
+        bool operator==(const IndicatorKey& other) const {
+            return series == other.series && type == other.type && parameters == other.parameters;
+        }
+    };
+
+    struct IndicatorKeyHash {
+        size_t operator()(const IndicatorKey& key) const {
+            size_t hash = std::hash<std::string>()(key.series);
+            hash ^= std::hash<int>()(static_cast<int>(key.type)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            for (double parameter : key.parameters) {
+                hash ^= std::hash<double>()(parameter) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            }
+            return hash;
+        }
+    };
+
+    /**
+     * @brief Cache of indicator values shared by the generators of one chart.
+     *
+     * @details Each ITradingPlatform owns one (GetIndicatorCache), so trade systems on different charts in the same process
+     * keep their own series and bar indexes. Values are computed lazily on first request and kept per bar index. Bars before the current bar are closed,
+     * so their values are final and later requests are plain lookups; a new bar only costs the streaming update for that bar.
+     * The forming bar's value is recomputed at most once per OnMarketUpdate, from a copy of the state after the last closed bar.
+     *
+     * Reads of cached values take shared locks, so parallel generators do not serialize on each other. Computing an entry
+     * locks only that entry.
+     */
+    class IndicatorCache {
+    public:
+        // Returns the value of a series at a bar index, or nullopt if the bar does not exist.
+        using SeriesSource = std::function<std::optional<double>(int barIndex)>;
+
+        IndicatorCache() = default;
+
+        IndicatorCache(const IndicatorCache&) = delete;
+        IndicatorCache& operator=(const IndicatorCache&) = delete;
+
+        /**
+         * @brief Registers or replaces a series. Replacing a series drops its cached indicators.
+         */
+        void RegisterSeries(const std::string& series, SeriesSource source);
+
+        bool HasSeries(const std::string& series) const;
+
+        /**
+         * @brief Called once per market update with the index of the forming bar.
+         * If the index moves backwards the chart has been reloaded, and every cached value is dropped.
+         */
+        void OnMarketUpdate(int currentBarIndex);
+
+        int GetCurrentBarIndex() const { return currentBarIndex_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Returns the indicator value at barIndex, computing it if needed.
+         * @return nullopt if the series is unknown, barIndex is beyond the forming bar or the indicator is not ready yet.
+         * @throws std::invalid_argument If the key's parameters are invalid for its indicator type.
+         */
+        std::optional<double> Get(const IndicatorKey& key, int barIndex);
+
+        /**
+         * @brief Returns the indicator value at the forming bar.
+         */
+        std::optional<double> GetCurrent(const IndicatorKey& key) { return Get(key, GetCurrentBarIndex()); }
+
+        std::optional<double> GetSMA(const std::string& series, int length, int barIndex);
+        std::optional<double> GetEMA(const std::string& series, int length, int barIndex);
+        std::optional<double> GetStandardDeviation(const std::string& series, int length, int barIndex);
+        std::optional<double> GetRSI(const std::string& series, int length, int barIndex);
+
+        /**
+         * @brief Drops cached values of a series from fromBarIndex on, e.g. after a bar was corrected.
+         * Streaming state cannot be rewound, so affected entries are rebuilt lazily from the start of the series.
+         */
+        void Invalidate(const std::string& series, int fromBarIndex);
+
+        void Clear();
+
+        size_t EntryCount() const;
+
+    private:
+        struct Entry {
+            std::shared_mutex mutex;
+            IndicatorSet committed;                 // state after the last closed bar fed so far
+            IndicatorSet::Handle handle = 0;
+            std::vector<std::optional<double>> values; // final values for closed bars, indexed by bar
+            int committedThrough = -1;
+
+            int provisionalBar = -1;               // forming bar the provisional value belongs to
+            uint64_t provisionalEpoch = 0;
+            std::optional<double> provisionalValue;
+
+            void Reset();
+        };
+
+        std::shared_ptr<Entry> FindOrCreateEntry(const IndicatorKey& key);
+        static IndicatorSet::Handle Register(IndicatorSet& set, const IndicatorKey& key);
+        static std::optional<double> CurrentValue(const IndicatorSet& set, IndicatorSet::Handle handle);
+
+        mutable std::shared_mutex mutex_;
+        std::unordered_map<std::string, std::shared_ptr<const SeriesSource>> series_;
+        std::unordered_map<IndicatorKey, std::shared_ptr<Entry>, IndicatorKeyHash> entries_;
+
+        std::atomic<int> currentBarIndex_{-1};
+        std::atomic<uint64_t> epoch_{0};
+    };
+
+} // namespace Calculations
+
+#endif // INDICATOR_CACHE_H
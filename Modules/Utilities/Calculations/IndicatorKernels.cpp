@@ -0,0 +1,490 @@
+#include "IndicatorKernels.h"
+#include "IndicatorKernelsImpl.h"
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define INDICATOR_KERNELS_X86
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INDICATOR_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(INDICATOR_KERNELS_X86)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace Calculations {
+namespace Kernels {
+
+namespace {
+
+    struct ScalarVec {
+        static constexpr size_t Width = 1;
+        using Type = double;
+
+        static Type Load(const double* p) { return *p; }
+        static void Store(double* p, Type v) { *p = v; }
+        static Type Set1(double value) { return value; }
+        static Type Add(Type a, Type b) { return a + b; }
+        static Type Sub(Type a, Type b) { return a - b; }
+        static Type Mul(Type a, Type b) { return a * b; }
+        static Type Div(Type a, Type b) { return a / b; }
+        static Type Max(Type a, Type b) { return a > b ? a : b; }
+        static Type Sqrt(Type a) { return std::sqrt(a); }
+    };
+
+#ifdef INDICATOR_KERNELS_SSE2
+    struct Sse2Vec {
+        static constexpr size_t Width = 2;
+        using Type = __m128d;
+
+        static Type Load(const double* p) { return _mm_loadu_pd(p); }
+        static void Store(double* p, Type v) { _mm_storeu_pd(p, v); }
+        static Type Set1(double value) { return _mm_set1_pd(value); }
+        static Type Add(Type a, Type b) { return _mm_add_pd(a, b); }
+        static Type Sub(Type a, Type b) { return _mm_sub_pd(a, b); }
+        static Type Mul(Type a, Type b) { return _mm_mul_pd(a, b); }
+        static Type Div(Type a, Type b) { return _mm_div_pd(a, b); }
+        static Type Max(Type a, Type b) { return _mm_max_pd(a, b); }
+        static Type Sqrt(Type a) { return _mm_sqrt_pd(a); }
+    };
+#endif
+
+    const Detail::KernelTable& ScalarTable() {
+        static const Detail::KernelTable table = Detail::MakeKernelTable<ScalarVec>();
+        return table;
+    }
+
+    const Detail::KernelTable* Sse2Table() {
+#ifdef INDICATOR_KERNELS_SSE2
+        static const Detail::KernelTable table = Detail::MakeKernelTable<Sse2Vec>();
+        return &table;
+#else
+        return nullptr;
+#endif
+    }
+
+    bool CpuSupportsAvx2() {
+#if defined(_MSC_VER) && defined(INDICATOR_KERNELS_X86)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        // The OS must also save the YMM registers on context switches
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) && defined(INDICATOR_KERNELS_X86)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+        return false;
+#endif
+    }
+
+    const Detail::KernelTable* TableFor(KernelIsa isa) {
+        switch (isa) {
+        case KernelIsa::Scalar:
+            return &ScalarTable();
+        case KernelIsa::SSE2:
+            return Sse2Table();
+        case KernelIsa::AVX2:
+            return CpuSupportsAvx2() ? Detail::GetAvx2KernelTable() : nullptr;
+        }
+        return nullptr;
+    }
+
+    struct ActiveKernels {
+        std::atomic<const Detail::KernelTable*> table;
+        std::atomic<KernelIsa> isa;
+
+        ActiveKernels() {
+            KernelIsa best = DetectBestKernelIsa();
+            table = TableFor(best);
+            isa = best;
+        }
+    };
+
+    ActiveKernels& Active() {
+        static ActiveKernels active;
+        return active;
+    }
+
+    const Detail::KernelTable& Table() {
+        return *Active().table.load(std::memory_order_acquire);
+    }
+
+    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    void ValidateLength(int length, const char* message) {
+        if (length <= 0) {
+            throw std::invalid_argument(message);
+        }
+    }
+
+    // Double-precision view of an input column; float columns are widened once.
+    template <typename T>
+    class InputColumn {
+    public:
+        InputColumn(const T* data, size_t count) {
+            if constexpr (std::is_same_v<T, double>) {
+                data_ = data;
+            } else {
+                storage_.assign(data, data + count);
+                data_ = storage_.data();
+            }
+        }
+
+        const double* Data() const { return data_; }
+
+    private:
+        const double* data_ = nullptr;
+        std::vector<double> storage_;
+    };
+
+    // Double-precision output buffer; double columns are written in place, float columns are narrowed on Commit.
+    template <typename T>
+    class OutputColumn {
+    public:
+        OutputColumn(T* output, size_t count) : output_(output), count_(count) {
+            if constexpr (std::is_same_v<T, double>) {
+                data_ = output;
+            } else {
+                storage_.resize(count);
+                data_ = storage_.data();
+            }
+        }
+
+        double* Data() { return data_; }
+
+        void Commit() {
+            if constexpr (!std::is_same_v<T, double>) {
+                for (size_t i = 0; i < count_; ++i) {
+                    output_[i] = static_cast<T>(storage_[i]);
+                }
+            }
+        }
+
+    private:
+        T* output_;
+        size_t count_;
+        double* data_ = nullptr;
+        std::vector<double> storage_;
+    };
+
+    void FillNaN(double* out, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            out[i] = NaN;
+        }
+    }
+
+    // prefix[i] = sum of (x[j] - shift) for j < i. Shifting by a representative value keeps the sums small, which
+    // avoids cancellation when window sums are differenced.
+    void BuildPrefixSums(const double* x, size_t count, double shift, std::vector<double>& prefix, std::vector<double>* prefixSquares) {
+        prefix.resize(count + 1);
+        prefix[0] = 0.0;
+        if (prefixSquares) {
+            prefixSquares->resize(count + 1);
+            (*prefixSquares)[0] = 0.0;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            double value = x[i] - shift;
+            prefix[i + 1] = prefix[i] + value;
+            if (prefixSquares) {
+                (*prefixSquares)[i + 1] = (*prefixSquares)[i] + value * value;
+            }
+        }
+    }
+
+    void SmaInto(const double* x, size_t count, int length, double* out) {
+        size_t window = static_cast<size_t>(length);
+        if (count < window) {
+            FillNaN(out, 0, count);
+            return;
+        }
+        FillNaN(out, 0, window - 1);
+        std::vector<double> prefix;
+        BuildPrefixSums(x, count, x[0], prefix, nullptr);
+        Table().windowMean(prefix.data(), window, 1.0 / length, x[0], out + window - 1, count - window + 1);
+    }
+
+    void VarianceInto(const double* x, size_t count, int length, double* out) {
+        size_t window = static_cast<size_t>(length);
+        if (count < window) {
+            FillNaN(out, 0, count);
+            return;
+        }
+        FillNaN(out, 0, window - 1);
+        std::vector<double> prefix;
+        std::vector<double> prefixSquares;
+        BuildPrefixSums(x, count, x[0], prefix, &prefixSquares);
+        Table().windowVariance(prefix.data(), prefixSquares.data(), window, out + window - 1, count - window + 1);
+    }
+
+    void StandardDeviationInto(const double* x, size_t count, int length, double* out) {
+        VarianceInto(x, count, length, out);
+        size_t window = static_cast<size_t>(length);
+        if (count >= window) {
+            Table().sqrt(out + window - 1, out + window - 1, count - window + 1);
+        }
+    }
+
+    // Windowed EMA matching CalculateEMA, via the sliding recurrence described on StreamingEMA.
+    // Sequential by nature, so it runs scalar on every instruction set.
+    void EmaInto(const double* x, size_t count, int length, double* out) {
+        size_t window = static_cast<size_t>(length);
+        double alpha = 2.0 / (length + 1);
+        double decay = 1.0 - alpha;
+        double decayPowLength = std::pow(decay, length);
+        double weightedSum = 0.0;
+
+        for (size_t i = 0; i < count; ++i) {
+            weightedSum = decay * weightedSum + x[i];
+            if (i >= window) {
+                weightedSum -= decayPowLength * x[i - window];
+            }
+            out[i] = i + 1 >= window ? alpha * weightedSum + decayPowLength * x[i + 1 - window] : NaN;
+        }
+    }
+
+    template <typename T>
+    void Sma(const T* input, size_t count, int length, T* output) {
+        ValidateLength(length, "Invalid length for SMA calculation.");
+        InputColumn<T> in(input, count);
+        OutputColumn<T> out(output, count);
+        SmaInto(in.Data(), count, length, out.Data());
+        out.Commit();
+    }
+
+    template <typename T>
+    void Ema(const T* input, size_t count, int length, T* output) {
+        ValidateLength(length, "Invalid length for EMA calculation.");
+        InputColumn<T> in(input, count);
+        OutputColumn<T> out(output, count);
+        EmaInto(in.Data(), count, length, out.Data());
+        out.Commit();
+    }
+
+    template <typename T>
+    void Variance(const T* input, size_t count, int length, T* output) {
+        ValidateLength(length, "Invalid length for variance calculation.");
+        InputColumn<T> in(input, count);
+        OutputColumn<T> out(output, count);
+        VarianceInto(in.Data(), count, length, out.Data());
+        out.Commit();
+    }
+
+    template <typename T>
+    void StandardDeviation(const T* input, size_t count, int length, T* output) {
+        ValidateLength(length, "Invalid length for variance calculation.");
+        InputColumn<T> in(input, count);
+        OutputColumn<T> out(output, count);
+        StandardDeviationInto(in.Data(), count, length, out.Data());
+        out.Commit();
+    }
+
+    template <typename T>
+    void BollingerBands(const T* input, size_t count, int length, double numStdDev, T* upper, T* middle, T* lower) {
+        ValidateLength(length, "Invalid length for SMA calculation.");
+        InputColumn<T> in(input, count);
+        OutputColumn<T> upperOut(upper, count);
+        OutputColumn<T> middleOut(middle, count);
+        OutputColumn<T> lowerOut(lower, count);
+
+        std::vector<double> stdDev(count);
+        SmaInto(in.Data(), count, length, middleOut.Data());
+        StandardDeviationInto(in.Data(), count, length, stdDev.data());
+
+        size_t window = static_cast<size_t>(length);
+        size_t warmUp = count < window ? count : window - 1;
+        FillNaN(upperOut.Data(), 0, warmUp);
+        FillNaN(lowerOut.Data(), 0, warmUp);
+        if (count >= window) {
+            size_t valid = count - warmUp;
+            Table().axpby(1.0, middleOut.Data() + warmUp, numStdDev, stdDev.data() + warmUp, upperOut.Data() + warmUp, valid);
+            Table().axpby(1.0, middleOut.Data() + warmUp, -numStdDev, stdDev.data() + warmUp, lowerOut.Data() + warmUp, valid);
+        }
+
+        upperOut.Commit();
+        middleOut.Commit();
+        lowerOut.Commit();
+    }
+
+    template <typename T>
+    void Rsi(const T* prices, size_t count, int length, T* output) {
+        ValidateLength(length, "Invalid length or data size for RSI calculation.");
+        InputColumn<T> in(prices, count);
+        OutputColumn<T> out(output, count);
+        size_t window = static_cast<size_t>(length);
+
+        if (count <= window) {
+            FillNaN(out.Data(), 0, count);
+            out.Commit();
+            return;
+        }
+        FillNaN(out.Data(), 0, window);
+
+        // changes[k] is the move from prices[k] to prices[k + 1]
+        size_t changes = count - 1;
+        std::vector<double> gains(changes);
+        std::vector<double> losses(changes);
+        Table().splitChanges(in.Data(), gains.data(), losses.data(), changes);
+
+        std::vector<double> gainPrefix;
+        std::vector<double> lossPrefix;
+        BuildPrefixSums(gains.data(), changes, 0.0, gainPrefix, nullptr);
+        BuildPrefixSums(losses.data(), changes, 0.0, lossPrefix, nullptr);
+
+        size_t valid = changes - window + 1;
+        std::vector<double> gainMean(valid);
+        std::vector<double> lossMean(valid);
+        Table().windowMean(gainPrefix.data(), window, 1.0 / length, 0.0, gainMean.data(), valid);
+        Table().windowMean(lossPrefix.data(), window, 1.0 / length, 0.0, lossMean.data(), valid);
+        Table().rsi(gainMean.data(), lossMean.data(), out.Data() + window, valid);
+        out.Commit();
+    }
+
+    template <typename T>
+    void Macd(const T* input, size_t count, int shortLength, int longLength, int signalLength, T* macd, T* signal) {
+        if (shortLength <= 0 || longLength <= 0 || signalLength <= 0) {
+            throw std::invalid_argument("Invalid lengths for MACD calculation.");
+        }
+        InputColumn<T> in(input, count);
+        OutputColumn<T> macdOut(macd, count);
+        OutputColumn<T> signalOut(signal, count);
+
+        size_t longWindow = static_cast<size_t>(longLength);
+        if (count < longWindow) {
+            FillNaN(macdOut.Data(), 0, count);
+            FillNaN(signalOut.Data(), 0, count);
+            macdOut.Commit();
+            signalOut.Commit();
+            return;
+        }
+
+        std::vector<double> shortEma(count);
+        std::vector<double> longEma(count);
+        EmaInto(in.Data(), count, shortLength, shortEma.data());
+        EmaInto(in.Data(), count, longLength, longEma.data());
+
+        size_t first = longWindow - 1;
+        size_t valid = count - first;
+        FillNaN(macdOut.Data(), 0, first);
+        Table().axpby(1.0, shortEma.data() + first, -1.0, longEma.data() + first, macdOut.Data() + first, valid);
+
+        FillNaN(signalOut.Data(), 0, first);
+        EmaInto(macdOut.Data() + first, valid, signalLength, signalOut.Data() + first);
+
+        macdOut.Commit();
+        signalOut.Commit();
+    }
+
+    template <typename T>
+    void Vwap(const T* prices, const T* volumes, size_t count, T* output) {
+        InputColumn<T> priceIn(prices, count);
+        InputColumn<T> volumeIn(volumes, count);
+        OutputColumn<T> out(output, count);
+        if (count == 0) {
+            return;
+        }
+
+        std::vector<double> priceVolume(count);
+        Table().multiply(priceIn.Data(), volumeIn.Data(), priceVolume.data(), count);
+
+        std::vector<double> cumulativePriceVolume;
+        std::vector<double> cumulativeVolume;
+        BuildPrefixSums(priceVolume.data(), count, 0.0, cumulativePriceVolume, nullptr);
+        BuildPrefixSums(volumeIn.Data(), count, 0.0, cumulativeVolume, nullptr);
+        Table().divide(cumulativePriceVolume.data() + 1, cumulativeVolume.data() + 1, out.Data(), count);
+        out.Commit();
+    }
+
+} // namespace
+
+    KernelIsa DetectBestKernelIsa() {
+        if (TableFor(KernelIsa::AVX2)) {
+            return KernelIsa::AVX2;
+        }
+        if (TableFor(KernelIsa::SSE2)) {
+            return KernelIsa::SSE2;
+        }
+        return KernelIsa::Scalar;
+    }
+
+    bool IsKernelIsaSupported(KernelIsa isa) {
+        return TableFor(isa) != nullptr;
+    }
+
+    KernelIsa GetActiveKernelIsa() {
+        return Active().isa.load();
+    }
+
+    bool SetActiveKernelIsa(KernelIsa isa) {
+        const Detail::KernelTable* table = TableFor(isa);
+        if (!table) {
+            return false;
+        }
+        Active().table.store(table, std::memory_order_release);
+        Active().isa.store(isa);
+        return true;
+    }
+
+    const char* ToString(KernelIsa isa) {
+        switch (isa) {
+        case KernelIsa::Scalar:
+            return "Scalar";
+        case KernelIsa::SSE2:
+            return "SSE2";
+        case KernelIsa::AVX2:
+            return "AVX2";
+        }
+        return "Unknown";
+    }
+
+    void ComputeSMA(const float* input, size_t count, int length, float* output) { Sma(input, count, length, output); }
+    void ComputeSMA(const double* input, size_t count, int length, double* output) { Sma(input, count, length, output); }
+
+    void ComputeEMA(const float* input, size_t count, int length, float* output) { Ema(input, count, length, output); }
+    void ComputeEMA(const double* input, size_t count, int length, double* output) { Ema(input, count, length, output); }
+
+    void ComputeVariance(const float* input, size_t count, int length, float* output) { Variance(input, count, length, output); }
+    void ComputeVariance(const double* input, size_t count, int length, double* output) { Variance(input, count, length, output); }
+
+    void ComputeStandardDeviation(const float* input, size_t count, int length, float* output) { StandardDeviation(input, count, length, output); }
+    void ComputeStandardDeviation(const double* input, size_t count, int length, double* output) { StandardDeviation(input, count, length, output); }
+
+    void ComputeBollingerBands(const float* input, size_t count, int length, double numStdDev, float* upper, float* middle, float* lower) {
+        BollingerBands(input, count, length, numStdDev, upper, middle, lower);
+    }
+    void ComputeBollingerBands(const double* input, size_t count, int length, double numStdDev, double* upper, double* middle, double* lower) {
+        BollingerBands(input, count, length, numStdDev, upper, middle, lower);
+    }
+
+    void ComputeRSI(const float* prices, size_t count, int length, float* output) { Rsi(prices, count, length, output); }
+    void ComputeRSI(const double* prices, size_t count, int length, double* output) { Rsi(prices, count, length, output); }
+
+    void ComputeMACD(const float* input, size_t count, int shortLength, int longLength, int signalLength, float* macd, float* signal) {
+        Macd(input, count, shortLength, longLength, signalLength, macd, signal);
+    }
+    void ComputeMACD(const double* input, size_t count, int shortLength, int longLength, int signalLength, double* macd, double* signal) {
+        Macd(input, count, shortLength, longLength, signalLength, macd, signal);
+    }
+
+    void ComputeVWAP(const float* prices, const float* volumes, size_t count, float* output) { Vwap(prices, volumes, count, output); }
+    void ComputeVWAP(const double* prices, const double* volumes, size_t count, double* output) { Vwap(prices, volumes, count, output); }
+
+} // namespace Kernels
+} // namespace Calculations
@@ -0,0 +1,102 @@
+#ifndef INDICATOR_KERNELS_H
+#define INDICATOR_KERNELS_H
+
+#include <cstddef>
+
+namespace Calculations {
+namespace Kernels {
+
+    /**
+     * @brief Instruction sets the batch kernels can run on.
+     */
+    enum class KernelIsa {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * @brief Returns the best instruction set supported by this CPU and build.
+     */
+    KernelIsa DetectBestKernelIsa();
+
+    /**
+     * @brief Returns true if `isa` can be used on this CPU and build.
+     */
+    bool IsKernelIsaSupported(KernelIsa isa);
+
+    /**
+     * @brief Returns the instruction set the kernels currently dispatch to. Defaults to DetectBestKernelIsa().
+     */
+    KernelIsa GetActiveKernelIsa();
+
+    /**
+     * @brief Forces the kernels onto a specific instruction set, e.g. to compare against the scalar path.
+     * @return False, leaving the active instruction set unchanged, if `isa` is not supported.
+     */
+    bool SetActiveKernelIsa(KernelIsa isa);
+
+    const char* ToString(KernelIsa isa);
+
+    // Whole-history indicator kernels
+    //
+    // Each kernel fills `output[i]` with the value the matching Calculations function would return for `input[0..i]`,
+    // for every i at once. Entries before the first full window are NaN. Work is done in double precision regardless of
+    // the column type. Rolling windows come from prefix sums so the per-element work is a few vectorized operations;
+    // the EMA recurrences are inherently sequential and run scalar.
+    //
+    // All functions throw std::invalid_argument for non-positive lengths, like their Calculations counterparts.
+
+    /**
+     * @brief Simple moving average over each trailing window of `length` values.
+     */
+    void ComputeSMA(const float* input, size_t count, int length, float* output);
+    void ComputeSMA(const double* input, size_t count, int length, double* output);
+
+    /**
+     * @brief Windowed EMA matching CalculateEMA: seeded with the oldest value of each trailing window of `length` values.
+     */
+    void ComputeEMA(const float* input, size_t count, int length, float* output);
+    void ComputeEMA(const double* input, size_t count, int length, double* output);
+
+    /**
+     * @brief Rolling population variance, matching Variance.
+     */
+    void ComputeVariance(const float* input, size_t count, int length, float* output);
+    void ComputeVariance(const double* input, size_t count, int length, double* output);
+
+    /**
+     * @brief Rolling population standard deviation, matching StandardDeviation.
+     */
+    void ComputeStandardDeviation(const float* input, size_t count, int length, float* output);
+    void ComputeStandardDeviation(const double* input, size_t count, int length, double* output);
+
+    /**
+     * @brief Bollinger Bands, matching CalculateBollingerBands.
+     */
+    void ComputeBollingerBands(const float* input, size_t count, int length, double numStdDev, float* upper, float* middle, float* lower);
+    void ComputeBollingerBands(const double* input, size_t count, int length, double numStdDev, double* upper, double* middle, double* lower);
+
+    /**
+     * @brief RSI from a price column. Gains and losses are the positive and negative price changes, averaged with simple
+     * means over `length` changes as in CalculateRSI, so the first value is at index `length`.
+     */
+    void ComputeRSI(const float* prices, size_t count, int length, float* output);
+    void ComputeRSI(const double* prices, size_t count, int length, double* output);
+
+    /**
+     * @brief MACD line and signal line, matching CalculateMACD.
+     */
+    void ComputeMACD(const float* input, size_t count, int shortLength, int longLength, int signalLength, float* macd, float* signal);
+    void ComputeMACD(const double* input, size_t count, int shortLength, int longLength, int signalLength, double* macd, double* signal);
+
+    /**
+     * @brief Cumulative VWAP from price and volume columns. Pass typical or OHLC-average prices to match CalculateVWAP.
+     */
+    void ComputeVWAP(const float* prices, const float* volumes, size_t count, float* output);
+    void ComputeVWAP(const double* prices, const double* volumes, size_t count, double* output);
+
+} // namespace Kernels
+} // namespace Calculations
+
+#endif // INDICATOR_KERNELS_H
@@ -0,0 +1,52 @@
+// Compiled with AVX2 enabled (see CMakeLists.txt). Only reached after IndicatorKernels.cpp has confirmed CPU support.
+#include "IndicatorKernelsImpl.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace Calculations {
+namespace Kernels {
+namespace Detail {
+namespace {
+
+    struct Avx2Vec {
+        static constexpr size_t Width = 4;
+        using Type = __m256d;
+
+        static Type Load(const double* p) { return _mm256_loadu_pd(p); }
+        static void Store(double* p, Type v) { _mm256_storeu_pd(p, v); }
+        static Type Set1(double value) { return _mm256_set1_pd(value); }
+        static Type Add(Type a, Type b) { return _mm256_add_pd(a, b); }
+        static Type Sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+        static Type Mul(Type a, Type b) { return _mm256_mul_pd(a, b); }
+        static Type Div(Type a, Type b) { return _mm256_div_pd(a, b); }
+        static Type Max(Type a, Type b) { return _mm256_max_pd(a, b); }
+        static Type Sqrt(Type a) { return _mm256_sqrt_pd(a); }
+    };
+
+} // namespace
+
+    const KernelTable* GetAvx2KernelTable() {
+        static const KernelTable table = MakeKernelTable<Avx2Vec>();
+        return &table;
+    }
+
+} // namespace Detail
+} // namespace Kernels
+} // namespace Calculations
+
+#else
+
+namespace Calculations {
+namespace Kernels {
+namespace Detail {
+
+    const KernelTable* GetAvx2KernelTable() {
+        return nullptr;
+    }
+
+} // namespace Detail
+} // namespace Kernels
+} // namespace Calculations
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef INDICATOR_KERNELS_IMPL_H
+#define INDICATOR_KERNELS_IMPL_H
+
+// Internal to the Calculations module. Included by each instruction-set translation unit, which instantiates the kernels
+// with its own vector wrapper. Everything below lives in an anonymous namespace so instantiations compiled with different
+// instruction sets are never merged by the linker.
+
+#include <cmath>
+#include <cstddef>
+
+namespace Calculations {
+namespace Kernels {
+namespace Detail {
+
+    // Element-wise building blocks the public kernels are composed from. Each operates on `count` elements of
+    // already-offset pointers.
+    struct KernelTable {
+        // out[k] = (prefix[k + length] - prefix[k]) * scale + offset
+        void (*windowMean)(const double* prefix, size_t length, double scale, double offset, double* out, size_t count);
+        // out[k] = max(mean(squares) - mean^2, 0) over the window ending at k + length
+        void (*windowVariance)(const double* prefix, const double* prefixSquares, size_t length, double* out, size_t count);
+        // out[k] = a * x[k] + b * y[k]
+        void (*axpby)(double a, const double* x, double b, const double* y, double* out, size_t count);
+        // out[k] = x[k] * y[k]
+        void (*multiply)(const double* x, const double* y, double* out, size_t count);
+        // out[k] = x[k] / y[k]
+        void (*divide)(const double* x, const double* y, double* out, size_t count);
+        // out[k] = sqrt(x[k])
+        void (*sqrt)(const double* x, double* out, size_t count);
+        // gains[k] = max(p[k + 1] - p[k], 0), losses[k] = max(p[k] - p[k + 1], 0)
+        void (*splitChanges)(const double* prices, double* gains, double* losses, size_t count);
+        // out[k] = 100 - 100 / (1 + gainMean[k] / lossMean[k])
+        void (*rsi)(const double* gainMean, const double* lossMean, double* out, size_t count);
+    };
+
+namespace {
+
+    inline double MaxScalar(double a, double b) {
+        return a > b ? a : b;
+    }
+
+    template <typename V>
+    void WindowMean(const double* prefix, size_t length, double scale, double offset, double* out, size_t count) {
+        const auto vScale = V::Set1(scale);
+        const auto vOffset = V::Set1(offset);
+        size_t k = 0;
+        for (; k + V::Width <= count; k += V::Width) {
+            auto diff = V::Sub(V::Load(prefix + k + length), V::Load(prefix + k));
+            V::Store(out + k, V::Add(V::Mul(diff, vScale), vOffset));
+        }
+        for (; k < count; ++k) {
+            out[k] = (prefix[k + length] - prefix[k]) * scale + offset;
+        }
+    }
+
+    template <typename V>
+    void WindowVariance(const double* prefix, const double* prefixSquares, size_t length, double* out, size_t count) {
+        const double inverseLength = 1.0 / static_cast<double>(length);
+        const auto vInverseLength = V::Set1(inverseLength);
+        const auto vZero = V::Set1(0.0);
+        size_t k = 0;
+        for (; k + V::Width <= count; k += V::Width) {
+            auto mean = V::Mul(V::Sub(V::Load(prefix + k + length), V::Load(prefix + k)), vInverseLength);
+            auto meanSquares = V::Mul(V::Sub(V::Load(prefixSquares + k + length), V::Load(prefixSquares + k)), vInverseLength);
+            V::Store(out + k, V::Max(V::Sub(meanSquares, V::Mul(mean, mean)), vZero));
+        }
+        for (; k < count; ++k) {
+            double mean = (prefix[k + length] - prefix[k]) * inverseLength;
+            double meanSquares = (prefixSquares[k + length] - prefixSquares[k]) * inverseLength;
+            out[k] = MaxScalar(meanSquares - mean * mean, 0.0);
+        }
+    }
+
+    template <typename V>
+    void Axpby(double a, const double* x, double b, const double* y, double* out, size_t count) {
+        const auto vA = V::Set1(a);
+        const auto vB = V::Set1(b);
+        size_t k = 0;
+        for (; k + V::Width <= count; k += V::Width) {
+            V::Store(out + k, V::Add(V::Mul(vA, V::Load(x + k)), V::Mul(vB, V::Load(y + k))));
+        }
+        for (; k < count; ++k) {
+            out[k] = a * x[k] + b * y[k];
+        }
+    }
+
+    template <typename V>
+    void Multiply(const double* x, const double* y, double* out, size_t count) {
+        size_t k = 0;
+        for (; k + V::Width <= count; k += V::Width) {
+            V::Store(out + k, V::Mul(V::Load(x + k), V::Load(y + k)));
+        }
+        for (; k < count; ++k) {
+            out[k] = x[k] * y[k];
+        }
+    }
+
+    template <typename V>
+    void Divide(const double* x, const double* y, double* out, size_t count) {
+        size_t k = 0;
+        for (; k + V::Width <= count; k += V::Width) {
+            V::Store(out + k, V::Div(V::Load(x + k), V::Load(y + k)));
+        }
+        for (; k < count; ++k) {
+            out[k] = x[k] / y[k];
+        }
+    }
+
+    template <typename V>
+    void Sqrt(const double* x, double* out, size_t count) {
+        size_t k = 0;
+        for (; k + V::Width <= count; k += V::Width) {
+            V::Store(out + k, V::Sqrt(V::Load(x + k)));
+        }
+        for (; k < count; ++k) {
+            out[k] = std::sqrt(x[k]);
+        }
+    }
+
+    template <typename V>
+    void SplitChanges(const double* prices, double* gains, double* losses, size_t count) {
+        const auto vZero = V::Set1(0.0);
+        size_t k = 0;
+        for (; k + V::Width <= count; k += V::Width) {
+            auto previous = V::Load(prices + k);
+            auto current = V::Load(prices + k + 1);
+            V::Store(gains + k, V::Max(V::Sub(current, previous), vZero));
+            V::Store(losses + k, V::Max(V::Sub(previous, current), vZero));
+        }
+        for (; k < count; ++k) {
+            gains[k] = MaxScalar(prices[k + 1] - prices[k], 0.0);
+            losses[k] = MaxScalar(prices[k] - prices[k + 1], 0.0);
+        }
+    }
+
+    template <typename V>
+    void Rsi(const double* gainMean, const double* lossMean, double* out, size_t count) {
+        const auto vOne = V::Set1(1.0);
+        const auto vHundred = V::Set1(100.0);
+        size_t k = 0;
+        for (; k + V::Width <= count; k += V::Width) {
+            auto rs = V::Div(V::Load(gainMean + k), V::Load(lossMean + k));
+            V::Store(out + k, V::Sub(vHundred, V::Div(vHundred, V::Add(vOne, rs))));
+        }
+        for (; k < count; ++k) {
+            double rs = gainMean[k] / lossMean[k];
+            out[k] = 100.0 - (100.0 / (1.0 + rs));
+        }
+    }
+
+    template <typename V>
+    KernelTable MakeKernelTable() {
+        KernelTable table;
+        table.windowMean = &WindowMean<V>;
+        table.windowVariance = &WindowVariance<V>;
+        table.axpby = &Axpby<V>;
+        table.multiply = &Multiply<V>;
+        table.divide = &Divide<V>;
+        table.sqrt = &Sqrt<V>;
+        table.splitChanges = &SplitChanges<V>;
+        table.rsi = &Rsi<V>;
+        return table;
+    }
+
+} // namespace
+
+    // Defined in IndicatorKernelsAvx2.cpp; returns nullptr when the build has no AVX2 support.
+    const KernelTable* GetAvx2KernelTable();
+
+} // namespace Detail
+} // namespace Kernels
+} // namespace Calculations
+
+#endif // INDICATOR_KERNELS_IMPL_H
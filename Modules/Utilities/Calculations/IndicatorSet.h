@@ -0,0 +1,338 @@
+#ifndef INDICATOR_SET_H
+#define INDICATOR_SET_H
+
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "CommonTypes.h"
+#include "StreamingIndicators.h"
+#include "Calculations.h"
+
+namespace Calculations {
+
+    /**
+     * @brief A declarative set of indicators over one series, updated together in a single pass.
+     *
+     * @details Register indicators once, then call Update for each new bar (or UpdateHistory over a whole series).
+     * Intermediate state is shared between indicators that need it: SMA, Variance, StandardDeviation and Bollinger Bands
+     * of the same length read one rolling window and its running moments, MACD reuses the EMAs of its short and long
+     * lengths, and registering the same indicator twice returns the existing handle. Each value is therefore visited
+     * once per distinct window rather than once per indicator.
+     *
+     * Not thread-safe; one set belongs to one series and is updated from one thread.
+     */
+    class IndicatorSet {
+    public:
+        using Handle = size_t;
+
+        enum class IndicatorType {
+            SMA,
+            EMA,
+            Variance,
+            StandardDeviation,
+            BollingerBands,
+            RSI,
+            MACD,
+            VWAP
+        };
+
+        Handle AddSMA(int length) { return Register(IndicatorType::SMA, length, 0, 0, 0.0); }
+        Handle AddEMA(int length) { return Register(IndicatorType::EMA, length, 0, 0, 0.0); }
+        Handle AddVariance(int length) { return Register(IndicatorType::Variance, length, 0, 0, 0.0); }
+        Handle AddStandardDeviation(int length) { return Register(IndicatorType::StandardDeviation, length, 0, 0, 0.0); }
+        Handle AddBollingerBands(int length, double numStdDev) { return Register(IndicatorType::BollingerBands, length, 0, 0, numStdDev); }
+        Handle AddRSI(int length) { return Register(IndicatorType::RSI, length, 0, 0, 0.0); }
+        Handle AddMACD(int shortLength, int longLength, int signalLength) { return Register(IndicatorType::MACD, shortLength, longLength, signalLength, 0.0); }
+        Handle AddVWAP() { return Register(IndicatorType::VWAP, 0, 0, 0, 0.0); }
+
+        /**
+         * @brief Feeds one value (and its volume, used by VWAP) to every registered indicator.
+         */
+        void Update(double value, double volume = 0.0) {
+            Update(value, value, volume);
+        }
+
+        /**
+         * @brief Feeds a bar: its close to the price indicators and its OHLC average to VWAP, as CalculateVWAP does.
+         */
+        void Update(const BarData& bar) {
+            Update(bar.close, CalculateOHLCAvg(bar), bar.volume.value_or(0.0));
+        }
+
+        /**
+         * @brief Runs the whole series through the set in one pass. `volumes` may be null when no VWAP is registered.
+         */
+        void UpdateHistory(const double* values, const double* volumes, size_t count) {
+            UpdateHistory(values, volumes, count, [](size_t) {});
+        }
+
+        /**
+         * @brief Runs the whole series through the set in one pass, calling `onBar(index)` after each value so callers can
+         * read per-bar indicator values without a second pass.
+         */
+        template <typename OnBar>
+        void UpdateHistory(const double* values, const double* volumes, size_t count, OnBar&& onBar) {
+            for (size_t i = 0; i < count; ++i) {
+                Update(values[i], volumes ? volumes[i] : 0.0);
+                onBar(i);
+            }
+        }
+
+        bool IsReady(Handle handle) const {
+            const Indicator& indicator = Get(handle);
+            switch (indicator.type) {
+            case IndicatorType::SMA:
+            case IndicatorType::Variance:
+            case IndicatorType::StandardDeviation:
+            case IndicatorType::BollingerBands:
+                return windows_[indicator.state].moments.IsReady();
+            case IndicatorType::EMA:
+                return emas_[indicator.state].ema.IsReady();
+            case IndicatorType::RSI:
+                return rsis_[indicator.state].rsi.IsReady();
+            case IndicatorType::MACD:
+                return macds_[indicator.state].signal.IsReady();
+            case IndicatorType::VWAP:
+                return cumulativeVolume_ > 0.0;
+            }
+            return false;
+        }
+
+        /**
+         * @brief The primary value of an indicator: the middle band for Bollinger Bands and the MACD line for MACD.
+         */
+        double Value(Handle handle) const {
+            const Indicator& indicator = Get(handle);
+            switch (indicator.type) {
+            case IndicatorType::SMA:
+            case IndicatorType::BollingerBands:
+                return windows_[indicator.state].moments.Mean();
+            case IndicatorType::Variance:
+                return windows_[indicator.state].moments.Variance();
+            case IndicatorType::StandardDeviation:
+                return windows_[indicator.state].moments.StandardDeviation();
+            case IndicatorType::EMA:
+                return emas_[indicator.state].ema.Value();
+            case IndicatorType::RSI:
+                return rsis_[indicator.state].rsi.Value();
+            case IndicatorType::MACD:
+                return MacdLine(macds_[indicator.state]);
+            case IndicatorType::VWAP:
+                return cumulativePriceVolume_ / cumulativeVolume_;
+            }
+            return 0.0;
+        }
+
+        /**
+         * @return A tuple containing the upper band, middle band (SMA), and lower band values.
+         */
+        std::tuple<double, double, double> BollingerBands(Handle handle) const {
+            const Indicator& indicator = Get(handle, IndicatorType::BollingerBands);
+            const auto& moments = windows_[indicator.state].moments;
+            double sma = moments.Mean();
+            double stdDev = moments.StandardDeviation();
+            return std::make_tuple(sma + indicator.numStdDev * stdDev, sma, sma - indicator.numStdDev * stdDev);
+        }
+
+        /**
+         * @return A pair containing the MACD value and the signal line value.
+         */
+        std::pair<double, double> MACD(Handle handle) const {
+            const Indicator& indicator = Get(handle, IndicatorType::MACD);
+            const auto& macd = macds_[indicator.state];
+            return std::make_pair(MacdLine(macd), macd.signal.Value());
+        }
+
+        size_t IndicatorCount() const { return indicators_.size(); }
+        size_t BarCount() const { return barCount_; }
+
+        /**
+         * @brief Clears all indicator state but keeps the registrations, e.g. at a session boundary.
+         */
+        void Reset() {
+            for (auto& window : windows_) {
+                window.moments.Reset();
+            }
+            for (auto& ema : emas_) {
+                ema.ema.Reset();
+            }
+            for (auto& macd : macds_) {
+                macd.signal.Reset();
+            }
+            for (auto& rsi : rsis_) {
+                rsi.rsi.Reset();
+            }
+            hasLastValue_ = false;
+            cumulativePriceVolume_ = 0.0;
+            cumulativeVolume_ = 0.0;
+            barCount_ = 0;
+        }
+
+    private:
+        // VWAP weighs vwapPrice, every other indicator reads value
+        void Update(double value, double vwapPrice, double volume) {
+            for (auto& window : windows_) {
+                window.moments.Update(value);
+            }
+            for (auto& ema : emas_) {
+                ema.ema.Update(value);
+            }
+            for (auto& macd : macds_) {
+                if (emas_[macd.longEma].ema.IsReady()) {
+                    macd.signal.Update(emas_[macd.shortEma].ema.Value() - emas_[macd.longEma].ema.Value());
+                }
+            }
+            if (hasLastValue_) {
+                double change = value - lastValue_;
+                double gain = std::max(change, 0.0);
+                double loss = std::max(-change, 0.0);
+                for (auto& rsi : rsis_) {
+                    rsi.rsi.Update(gain, loss);
+                }
+            }
+            lastValue_ = value;
+            hasLastValue_ = true;
+
+            cumulativePriceVolume_ += vwapPrice * volume;
+            cumulativeVolume_ += volume;
+            ++barCount_;
+        }
+
+        struct Indicator {
+            IndicatorType type;
+            int length;
+            int longLength;
+            int signalLength;
+            double numStdDev;
+            size_t state; // index into the shared state vector for the type
+        };
+
+        struct SharedWindow {
+            int length;
+            StreamingVariance moments; // one ring buffer, running mean and M2 for SMA/Variance/StdDev/Bollinger
+        };
+
+        struct SharedEma {
+            int length;
+            StreamingEMA ema;
+        };
+
+        struct SharedRsi {
+            int length;
+            StreamingRSI rsi;
+        };
+
+        struct MacdState {
+            size_t shortEma;
+            size_t longEma;
+            StreamingEMA signal;
+        };
+
+        Handle Register(IndicatorType type, int length, int longLength, int signalLength, double numStdDev) {
+            if (barCount_ > 0) {
+                throw std::logic_error("Indicators must be registered before the first update.");
+            }
+            for (size_t i = 0; i < indicators_.size(); ++i) {
+                const Indicator& existing = indicators_[i];
+                if (existing.type == type && existing.length == length && existing.longLength == longLength &&
+                    existing.signalLength == signalLength && existing.numStdDev == numStdDev) {
+                    return i;
+                }
+            }
+
+            Indicator indicator{type, length, longLength, signalLength, numStdDev, 0};
+            switch (type) {
+            case IndicatorType::SMA:
+            case IndicatorType::Variance:
+            case IndicatorType::StandardDeviation:
+            case IndicatorType::BollingerBands:
+                indicator.state = WindowFor(length);
+                break;
+            case IndicatorType::EMA:
+                indicator.state = EmaFor(length);
+                break;
+            case IndicatorType::RSI:
+                indicator.state = RsiFor(length);
+                break;
+            case IndicatorType::MACD:
+                if (longLength <= 0 || signalLength <= 0) {
+                    throw std::invalid_argument("Invalid lengths for MACD calculation.");
+                }
+                macds_.push_back(MacdState{EmaFor(length), EmaFor(longLength), StreamingEMA(signalLength)});
+                indicator.state = macds_.size() - 1;
+                break;
+            case IndicatorType::VWAP:
+                break;
+            }
+
+            indicators_.push_back(indicator);
+            return indicators_.size() - 1;
+        }
+
+        size_t WindowFor(int length) {
+            for (size_t i = 0; i < windows_.size(); ++i) {
+                if (windows_[i].length == length) {
+                    return i;
+                }
+            }
+            windows_.push_back(SharedWindow{length, StreamingVariance(length)});
+            return windows_.size() - 1;
+        }
+
+        size_t EmaFor(int length) {
+            for (size_t i = 0; i < emas_.size(); ++i) {
+                if (emas_[i].length == length) {
+                    return i;
+                }
+            }
+            emas_.push_back(SharedEma{length, StreamingEMA(length)});
+            return emas_.size() - 1;
+        }
+
+        size_t RsiFor(int length) {
+            for (size_t i = 0; i < rsis_.size(); ++i) {
+                if (rsis_[i].length == length) {
+                    return i;
+                }
+            }
+            rsis_.push_back(SharedRsi{length, StreamingRSI(length)});
+            return rsis_.size() - 1;
+        }
+
+        const Indicator& Get(Handle handle) const {
+            if (handle >= indicators_.size()) {
+                throw std::out_of_range("Unknown indicator handle.");
+            }
+            return indicators_[handle];
+        }
+
+        const Indicator& Get(Handle handle, IndicatorType expectedType) const {
+            const Indicator& indicator = Get(handle);
+            if (indicator.type != expectedType) {
+                throw std::invalid_argument("Indicator handle refers to a different indicator type.");
+            }
+            return indicator;
+        }
+
+        double MacdLine(const MacdState& macd) const {
+            return emas_[macd.shortEma].ema.Value() - emas_[macd.longEma].ema.Value();
+        }
+
+        std::vector<Indicator> indicators_;
+        std::vector<SharedWindow> windows_;
+        std::vector<SharedEma> emas_;
+        std::vector<SharedRsi> rsis_;
+        std::vector<MacdState> macds_;
+
+        double lastValue_ = 0.0;
+        bool hasLastValue_ = false;
+        double cumulativePriceVolume_ = 0.0;
+        double cumulativeVolume_ = 0.0;
+        size_t barCount_ = 0;
+    };
+
+} // namespace Calculations
+
+#endif // INDICATOR_SET_H
@@ -0,0 +1,270 @@
+#include "OrderFlow.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Calculations {
+
+    OrderFlowEngine::OrderFlowEngine(const OrderFlowConfig& config) : config_(config) {
+        if (config_.tickSize <= 0.0) {
+            throw std::invalid_argument("Tick size must be greater than zero for order flow.");
+        }
+        if (config_.levelsPerBar <= 0 || config_.maxBars <= 0) {
+            throw std::invalid_argument("Footprint levels per bar and bar capacity must be greater than zero.");
+        }
+        if (config_.imbalanceRatio <= 0.0) {
+            throw std::invalid_argument("Imbalance ratio must be greater than zero.");
+        }
+        slots_.resize(static_cast<size_t>(config_.maxBars));
+        levels_.resize(static_cast<size_t>(config_.maxBars) * static_cast<size_t>(config_.levelsPerBar));
+    }
+
+    void OrderFlowEngine::UpdateQuote(double bid, double ask) {
+        if (bid > 0.0) {
+            bid_ = bid;
+        }
+        if (ask > 0.0) {
+            ask_ = ask;
+        }
+    }
+
+    AggressorSide OrderFlowEngine::Classify(double price) const {
+        if (ask_.has_value() && price >= ask_.value()) {
+            return AggressorSide::Buy;
+        }
+        if (bid_.has_value() && price <= bid_.value()) {
+            return AggressorSide::Sell;
+        }
+        if (bid_.has_value() && ask_.has_value()) {
+            double midpoint = (bid_.value() + ask_.value()) / 2.0;
+            if (price > midpoint) {
+                return AggressorSide::Buy;
+            }
+            if (price < midpoint) {
+                return AggressorSide::Sell;
+            }
+        }
+
+        // Tick rule: an uptick is a buy, a downtick a sell, and an unchanged price keeps the previous side
+        if (lastTradePrice_.has_value()) {
+            if (price > lastTradePrice_.value()) {
+                return AggressorSide::Buy;
+            }
+            if (price < lastTradePrice_.value()) {
+                return AggressorSide::Sell;
+            }
+            return lastSide_;
+        }
+        return AggressorSide::Unknown;
+    }
+
+    std::optional<ClassifiedTrade> OrderFlowEngine::OnTimeAndSales(const TimeAndSales& record, int barIndex) {
+        if (record.type == TimeAndSalesType::Marker) {
+            return std::nullopt;
+        }
+        if (record.type == TimeAndSalesType::BidAskValues) {
+            UpdateQuote(record.bid, record.ask);
+            return std::nullopt;
+        }
+        if (record.volume <= 0) {
+            return std::nullopt;
+        }
+
+        // Trade records carry the quote they traded against
+        UpdateQuote(record.bid, record.ask);
+        AggressorSide side = Classify(record.price);
+        if (side == AggressorSide::Unknown) {
+            side = record.type == TimeAndSalesType::Ask ? AggressorSide::Buy : AggressorSide::Sell;
+        }
+        return Record(record.price, static_cast<uint32_t>(record.volume), side, barIndex);
+    }
+
+    ClassifiedTrade OrderFlowEngine::AddTrade(double price, uint32_t volume, int barIndex) {
+        return Record(price, volume, Classify(price), barIndex);
+    }
+
+    ClassifiedTrade OrderFlowEngine::Record(double price, uint32_t volume, AggressorSide side, int barIndex) {
+        if (barIndex < 0) {
+            throw std::invalid_argument("Bar index must not be negative.");
+        }
+
+        int64_t tick = ToTick(price);
+        BarSlot& slot = OpenBar(barIndex, tick);
+        FootprintLevel* levels = LevelsOf(barIndex);
+        int level = LevelFor(slot, levels, tick);
+        FootprintBarSummary& summary = slot.summary;
+
+        if (slot.baseTick + level != tick) {
+            summary.clippedVolume += volume;
+        }
+        slot.lowTick = std::min(slot.lowTick, tick);
+        slot.highTick = std::max(slot.highTick, tick);
+        summary.low = ToPrice(slot.lowTick);
+        summary.high = ToPrice(slot.highTick);
+        ++summary.tradeCount;
+
+        bool isLarge = volume >= config_.largeTradeVolume;
+        int64_t signedVolume = 0;
+        if (side == AggressorSide::Buy) {
+            levels[level].askVolume += volume;
+            summary.askVolume += volume;
+            signedVolume = volume;
+            if (isLarge) {
+                ++summary.largeBuyCount;
+                summary.largeBuyVolume += volume;
+            }
+        } else if (side == AggressorSide::Sell) {
+            levels[level].bidVolume += volume;
+            summary.bidVolume += volume;
+            signedVolume = -static_cast<int64_t>(volume);
+            if (isLarge) {
+                ++summary.largeSellCount;
+                summary.largeSellVolume += volume;
+            }
+        }
+
+        summary.delta += signedVolume;
+        summary.minimumDelta = std::min(summary.minimumDelta, summary.delta);
+        summary.maximumDelta = std::max(summary.maximumDelta, summary.delta);
+        cumulativeDelta_ += signedVolume;
+        summary.cumulativeDelta = cumulativeDelta_;
+
+        lastTradePrice_ = price;
+        if (side != AggressorSide::Unknown) {
+            lastSide_ = side;
+        }
+        return ClassifiedTrade{price, volume, side, isLarge};
+    }
+
+    bool OrderFlowEngine::HasBar(int barIndex) const {
+        return barIndex >= 0 && slots_[SlotOf(barIndex)].summary.barIndex == barIndex;
+    }
+
+    std::optional<FootprintBarSummary> OrderFlowEngine::GetBarSummary(int barIndex) const {
+        if (!HasBar(barIndex)) {
+            return std::nullopt;
+        }
+        return slots_[SlotOf(barIndex)].summary;
+    }
+
+    FootprintLevel OrderFlowEngine::GetLevel(int barIndex, double price) const {
+        if (!HasBar(barIndex)) {
+            return FootprintLevel();
+        }
+        int64_t level = ToTick(price) - slots_[SlotOf(barIndex)].baseTick;
+        if (level < 0 || level >= config_.levelsPerBar) {
+            return FootprintLevel();
+        }
+        return LevelsOf(barIndex)[level];
+    }
+
+    std::optional<double> OrderFlowEngine::GetBarImbalanceRatio(int barIndex) const {
+        auto summary = GetBarSummary(barIndex);
+        if (!summary.has_value() || summary->bidVolume == 0) {
+            return std::nullopt;
+        }
+        return static_cast<double>(summary->askVolume) / static_cast<double>(summary->bidVolume);
+    }
+
+    std::vector<FootprintImbalance> OrderFlowEngine::GetImbalances(int barIndex) const {
+        std::vector<FootprintImbalance> imbalances;
+        if (!HasBar(barIndex)) {
+            return imbalances;
+        }
+
+        const BarSlot& slot = slots_[SlotOf(barIndex)];
+        const FootprintLevel* levels = LevelsOf(barIndex);
+        // An empty opposing level counts as one contract so the ratio stays finite
+        auto ratio = [](uint32_t volume, uint32_t opposing) {
+            return static_cast<double>(volume) / static_cast<double>(std::max<uint32_t>(opposing, 1));
+        };
+
+        for (int i = 0; i < config_.levelsPerBar; ++i) {
+            const FootprintLevel& level = levels[i];
+            if (i > 0 && level.askVolume >= config_.minimumImbalanceVolume) {
+                double buyRatio = ratio(level.askVolume, levels[i - 1].bidVolume);
+                if (buyRatio >= config_.imbalanceRatio) {
+                    imbalances.push_back(FootprintImbalance{ToPrice(slot.baseTick + i), AggressorSide::Buy, buyRatio});
+                }
+            }
+            if (i + 1 < config_.levelsPerBar && level.bidVolume >= config_.minimumImbalanceVolume) {
+                double sellRatio = ratio(level.bidVolume, levels[i + 1].askVolume);
+                if (sellRatio >= config_.imbalanceRatio) {
+                    imbalances.push_back(FootprintImbalance{ToPrice(slot.baseTick + i), AggressorSide::Sell, sellRatio});
+                }
+            }
+        }
+        return imbalances;
+    }
+
+    void OrderFlowEngine::ResetBar(int barIndex) {
+        if (!HasBar(barIndex)) {
+            return;
+        }
+        BarSlot& slot = slots_[SlotOf(barIndex)];
+        cumulativeDelta_ -= slot.summary.delta;
+        std::fill_n(LevelsOf(barIndex), config_.levelsPerBar, FootprintLevel());
+        slot = BarSlot();
+    }
+
+    void OrderFlowEngine::Reset() {
+        std::fill(slots_.begin(), slots_.end(), BarSlot());
+        std::fill(levels_.begin(), levels_.end(), FootprintLevel());
+        cumulativeDelta_ = 0;
+        bid_.reset();
+        ask_.reset();
+        lastTradePrice_.reset();
+        lastSide_ = AggressorSide::Unknown;
+    }
+
+    int64_t OrderFlowEngine::ToTick(double price) const {
+        return static_cast<int64_t>(std::llround(price / config_.tickSize));
+    }
+
+    OrderFlowEngine::BarSlot& OrderFlowEngine::OpenBar(int barIndex, int64_t tick) {
+        BarSlot& slot = slots_[SlotOf(barIndex)];
+        if (slot.summary.barIndex != barIndex) {
+            // First trade of the bar: reuse the slot, centering the window on the opening price
+            std::fill_n(LevelsOf(barIndex), config_.levelsPerBar, FootprintLevel());
+            slot = BarSlot();
+            slot.summary.barIndex = barIndex;
+            slot.baseTick = tick - config_.levelsPerBar / 2;
+            slot.lowTick = tick;
+            slot.highTick = tick;
+            slot.summary.cumulativeDelta = cumulativeDelta_;
+        }
+        return slot;
+    }
+
+    int OrderFlowEngine::LevelFor(BarSlot& slot, FootprintLevel* levels, int64_t tick) {
+        const int64_t count = config_.levelsPerBar;
+        int64_t level = tick - slot.baseTick;
+        if (level >= 0 && level < count) {
+            return static_cast<int>(level);
+        }
+
+        int64_t low = std::min(slot.lowTick, tick);
+        int64_t high = std::max(slot.highTick, tick);
+        int64_t range = high - low + 1;
+        if (range > count) {
+            // The bar outgrew its window; fold the trade into the nearest edge level
+            return level < 0 ? 0 : static_cast<int>(count - 1);
+        }
+
+        // Re-center the window on the bar's range; every traded level stays inside it
+        int64_t newBase = low - (count - range) / 2;
+        int64_t shift = slot.baseTick - newBase;
+        if (shift > 0) {
+            for (int64_t i = count - 1; i >= 0; --i) {
+                levels[i] = i - shift >= 0 ? levels[i - shift] : FootprintLevel();
+            }
+        } else {
+            for (int64_t i = 0; i < count; ++i) {
+                levels[i] = i - shift < count ? levels[i - shift] : FootprintLevel();
+            }
+        }
+        slot.baseTick = newBase;
+        return static_cast<int>(tick - newBase);
+    }
+
+} // namespace Calculations
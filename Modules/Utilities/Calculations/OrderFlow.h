@@ -0,0 +1,186 @@
+#ifndef ORDER_FLOW_H
+#define ORDER_FLOW_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "CommonTypes.h"
+
+namespace Calculations {
+
+    enum class AggressorSide {
+        Unknown,
+        Buy,  // lifted the offer
+        Sell  // hit the bid
+    };
+
+    struct OrderFlowConfig {
+        double tickSize = 0.25;
+        int levelsPerBar = 64;          // price ticks tracked per footprint bar
+        int maxBars = 2048;             // bars kept before the oldest slot is reused
+        double imbalanceRatio = 3.0;    // diagonal ratio at which a level counts as imbalanced
+        uint32_t minimumImbalanceVolume = 1;
+        uint32_t largeTradeVolume = 50; // trades at or above this size are flagged as large
+    };
+
+    struct ClassifiedTrade {
+        double price;
+        uint32_t volume;
+        AggressorSide side;
+        bool isLarge;
+    };
+
+    /**
+     * @brief Bid-traded and ask-traded volume at one price of a footprint bar.
+     */
+    struct FootprintLevel {
+        uint32_t bidVolume = 0;
+        uint32_t askVolume = 0;
+    };
+
+    /**
+     * @brief Per-bar order-flow totals.
+     */
+    struct FootprintBarSummary {
+        int barIndex = -1;
+        int64_t bidVolume = 0;
+        int64_t askVolume = 0;
+        int64_t delta = 0;             // askVolume - bidVolume
+        int64_t minimumDelta = 0;      // intrabar extremes of the running delta
+        int64_t maximumDelta = 0;
+        int64_t cumulativeDelta = 0;   // session cumulative delta at the bar's last trade
+        uint32_t tradeCount = 0;
+        uint32_t largeBuyCount = 0;
+        uint32_t largeSellCount = 0;
+        int64_t largeBuyVolume = 0;
+        int64_t largeSellVolume = 0;
+        int64_t clippedVolume = 0;     // volume folded into the edge levels because the bar outgrew levelsPerBar
+        std::optional<double> high;
+        std::optional<double> low;
+    };
+
+    struct FootprintImbalance {
+        double price;
+        AggressorSide side; // Buy: ask volume at price vs bid volume one tick below; Sell: bid volume vs ask one tick above
+        double ratio;
+    };
+
+    /**
+     * @brief Incremental order-flow engine over time and sales: aggressor classification, cumulative delta, per-bar
+     * footprints, diagonal imbalances and large-trade detection.
+     *
+     * @details Trades are classified against the prevailing quote: at or above the ask is a buy, at or below the bid is a
+     * sell, and prices inside the spread go to the nearer side, falling back to the tick rule at the midpoint.
+     *
+     * Footprints live in one contiguous array of `maxBars * levelsPerBar` levels allocated up front, with bars stored in a
+     * ring by bar index. A trade is one classification and one array increment; nothing is allocated after construction
+     * and reading a bar never touches raw time and sales again.
+     *
+     * Not thread-safe; an engine is fed from the thread that reads time and sales.
+     */
+    class OrderFlowEngine {
+    public:
+        explicit OrderFlowEngine(const OrderFlowConfig& config = OrderFlowConfig());
+
+        /**
+         * @brief Records the prevailing quote used to classify later trades.
+         */
+        void UpdateQuote(double bid, double ask);
+
+        /**
+         * @brief Feeds one time and sales record belonging to barIndex. Quote records update the prevailing quote and
+         * markers are ignored.
+         * @return The classified trade, or nullopt if the record carried no trade.
+         */
+        std::optional<ClassifiedTrade> OnTimeAndSales(const TimeAndSales& record, int barIndex);
+
+        /**
+         * @brief Feeds a trade whose aggressor has not been classified yet.
+         */
+        ClassifiedTrade AddTrade(double price, uint32_t volume, int barIndex);
+
+        /**
+         * @brief Classifies a trade against the prevailing quote without recording it.
+         */
+        AggressorSide Classify(double price) const;
+
+        int64_t GetCumulativeDelta() const { return cumulativeDelta_; }
+
+        bool HasBar(int barIndex) const;
+        std::optional<FootprintBarSummary> GetBarSummary(int barIndex) const;
+        FootprintLevel GetLevel(int barIndex, double price) const;
+
+        /**
+         * @brief Ask volume over bid volume, or nullopt if the bar has no bid volume.
+         */
+        std::optional<double> GetBarImbalanceRatio(int barIndex) const;
+
+        /**
+         * @brief Diagonal imbalances of a bar: ask volume at a price against bid volume one tick below (buying) and bid
+         * volume at a price against ask volume one tick above (selling), at or beyond the configured ratio.
+         */
+        std::vector<FootprintImbalance> GetImbalances(int barIndex) const;
+
+        /**
+         * @brief Visits a bar's levels with volume, from low to high, as f(price, const FootprintLevel&).
+         */
+        template <typename F>
+        void ForEachLevel(int barIndex, F&& f) const {
+            if (!HasBar(barIndex)) {
+                return;
+            }
+            const BarSlot& slot = slots_[SlotOf(barIndex)];
+            const FootprintLevel* levels = LevelsOf(barIndex);
+            for (int i = 0; i < config_.levelsPerBar; ++i) {
+                if (levels[i].bidVolume > 0 || levels[i].askVolume > 0) {
+                    f(ToPrice(slot.baseTick + i), levels[i]);
+                }
+            }
+        }
+
+        /**
+         * @brief Discards a bar so it can be rebuilt from its time and sales; its delta is removed from the cumulative delta.
+         */
+        void ResetBar(int barIndex);
+
+        /**
+         * @brief Clears all bars, the cumulative delta and the prevailing quote, e.g. at a session boundary.
+         */
+        void Reset();
+
+        const OrderFlowConfig& GetConfig() const { return config_; }
+
+    private:
+        struct BarSlot {
+            FootprintBarSummary summary;
+            int64_t baseTick = 0;  // tick of level 0
+            int64_t lowTick = 0;
+            int64_t highTick = 0;
+        };
+
+        size_t SlotOf(int barIndex) const { return static_cast<size_t>(barIndex % config_.maxBars); }
+        FootprintLevel* LevelsOf(int barIndex) { return &levels_[SlotOf(barIndex) * static_cast<size_t>(config_.levelsPerBar)]; }
+        const FootprintLevel* LevelsOf(int barIndex) const { return &levels_[SlotOf(barIndex) * static_cast<size_t>(config_.levelsPerBar)]; }
+
+        int64_t ToTick(double price) const;
+        double ToPrice(int64_t tick) const { return static_cast<double>(tick) * config_.tickSize; }
+
+        ClassifiedTrade Record(double price, uint32_t volume, AggressorSide side, int barIndex);
+        BarSlot& OpenBar(int barIndex, int64_t tick);
+        // Returns the level index for tick, re-centering the bar's window if its range still fits
+        int LevelFor(BarSlot& slot, FootprintLevel* levels, int64_t tick);
+
+        OrderFlowConfig config_;
+        std::vector<BarSlot> slots_;
+        std::vector<FootprintLevel> levels_;
+
+        int64_t cumulativeDelta_ = 0;
+        std::optional<double> bid_;
+        std::optional<double> ask_;
+        std::optional<double> lastTradePrice_;
+        AggressorSide lastSide_ = AggressorSide::Unknown;
+    };
+
+} // namespace Calculations
+
+#endif // ORDER_FLOW_H
@@ -0,0 +1,191 @@
+#include "PerformanceMetrics.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Calculations {
+
+    namespace {
+        void UpdateRatios(PerformanceSummary& summary, double returnM2, double downsideSquares, const PerformanceMetricsConfig& config) {
+            double annualization = std::sqrt(config.periodsPerYear);
+            double excessReturn = summary.meanReturn - config.riskFreeReturn;
+
+            summary.returnStandardDeviation = summary.periods > 1 ? std::sqrt(returnM2 / static_cast<double>(summary.periods - 1)) : 0.0;
+            summary.downsideDeviation = summary.periods > 0 ? std::sqrt(downsideSquares / static_cast<double>(summary.periods)) : 0.0;
+            summary.sharpeRatio = summary.returnStandardDeviation > 0.0 ? excessReturn / summary.returnStandardDeviation * annualization : 0.0;
+            summary.sortinoRatio = summary.downsideDeviation > 0.0 ? excessReturn / summary.downsideDeviation * annualization : 0.0;
+            summary.calmarRatio = summary.maxDrawdown > 0.0 ? summary.meanReturn * config.periodsPerYear / summary.maxDrawdown : 0.0;
+        }
+
+        void RecordTrade(PerformanceSummary& summary, double profitLoss, int& consecutiveWins, int& consecutiveLosses) {
+            ++summary.totalTrades;
+            if (profitLoss > 0.0) {
+                ++summary.winningTrades;
+                summary.grossProfit += profitLoss;
+                summary.largestWin = std::max(summary.largestWin, profitLoss);
+                ++consecutiveWins;
+                consecutiveLosses = 0;
+            } else if (profitLoss < 0.0) {
+                ++summary.losingTrades;
+                summary.grossLoss += profitLoss;
+                summary.largestLoss = std::min(summary.largestLoss, profitLoss);
+                ++consecutiveLosses;
+                consecutiveWins = 0;
+            } else {
+                consecutiveWins = 0;
+                consecutiveLosses = 0;
+            }
+            summary.maxConsecutiveWins = std::max(summary.maxConsecutiveWins, consecutiveWins);
+            summary.maxConsecutiveLosses = std::max(summary.maxConsecutiveLosses, consecutiveLosses);
+        }
+
+        void ValidateConfig(const PerformanceMetricsConfig& config) {
+            if (config.periodsPerYear <= 0.0) {
+                throw std::invalid_argument("Periods per year must be greater than zero.");
+            }
+            if (config.equityCurveCapacity < 2) {
+                throw std::invalid_argument("Equity curve capacity must be at least two points.");
+            }
+        }
+    }
+
+    void PerformanceSummary::ApplyTo(TradeStatistics& stats) const {
+        stats.maxDrawdown = -maxDrawdown;
+        stats.maximumRunup = maxRunup;
+        stats.sharpeRatio = sharpeRatio;
+        stats.sortinoRatio = sortinoRatio;
+        stats.calmarRatio = calmarRatio;
+
+        if (totalTrades > 0) {
+            stats.largestWin = largestWin;
+            stats.largestLoss = largestLoss;
+            stats.profitFactor = ProfitFactor();
+            stats.maxConsecutiveWins = maxConsecutiveWins;
+            stats.maxConsecutiveLosses = maxConsecutiveLosses;
+            stats.maxConsecutiveWinners = maxConsecutiveWins;
+            stats.maxConsecutiveLosers = maxConsecutiveLosses;
+        }
+    }
+
+    PerformanceMetrics::PerformanceMetrics(const PerformanceMetricsConfig& config) : config_(config) {
+        ValidateConfig(config_);
+        Reset();
+    }
+
+    void PerformanceMetrics::AddEquity(double equity) {
+        double periodReturn = equity - summary_.equity;
+        ++summary_.periods;
+
+        double delta = periodReturn - summary_.meanReturn;
+        summary_.meanReturn += delta / static_cast<double>(summary_.periods);
+        returnM2_ += delta * (periodReturn - summary_.meanReturn);
+        double downside = std::min(periodReturn - config_.riskFreeReturn, 0.0);
+        downsideSquares_ += downside * downside;
+
+        summary_.equity = equity;
+        summary_.netProfit = equity - config_.initialEquity;
+        summary_.peakEquity = std::max(summary_.peakEquity, equity);
+        summary_.currentDrawdown = summary_.peakEquity - equity;
+        summary_.maxDrawdown = std::max(summary_.maxDrawdown, summary_.currentDrawdown);
+        troughEquity_ = std::min(troughEquity_, equity);
+        summary_.maxRunup = std::max(summary_.maxRunup, equity - troughEquity_);
+
+        UpdateRatios(summary_, returnM2_, downsideSquares_, config_);
+
+        if (summary_.periods % curveStride_ == 0) {
+            equityCurve_.push_back(equity);
+            if (equityCurve_.size() > config_.equityCurveCapacity) {
+                // Keep the points on the doubled stride; index 0 is the starting equity
+                size_t kept = 0;
+                for (size_t i = 0; i < equityCurve_.size(); i += 2) {
+                    equityCurve_[kept++] = equityCurve_[i];
+                }
+                equityCurve_.resize(kept);
+                curveStride_ *= 2;
+            }
+        }
+    }
+
+    void PerformanceMetrics::AddTrade(double profitLoss) {
+        RecordTrade(summary_, profitLoss, consecutiveWins_, consecutiveLosses_);
+        AddEquity(summary_.equity + profitLoss);
+    }
+
+    void PerformanceMetrics::Reset() {
+        summary_ = PerformanceSummary();
+        summary_.equity = config_.initialEquity;
+        summary_.peakEquity = config_.initialEquity;
+        troughEquity_ = config_.initialEquity;
+        returnM2_ = 0.0;
+        downsideSquares_ = 0.0;
+        consecutiveWins_ = 0;
+        consecutiveLosses_ = 0;
+
+        equityCurve_.clear();
+        equityCurve_.reserve(config_.equityCurveCapacity + 1);
+        equityCurve_.push_back(config_.initialEquity);
+        curveStride_ = 1;
+    }
+
+    PerformanceSummary CalculatePerformance(const std::vector<double>& equityCurve, const PerformanceMetricsConfig& config) {
+        ValidateConfig(config);
+        PerformanceSummary summary;
+        if (equityCurve.empty()) {
+            summary.equity = config.initialEquity;
+            summary.peakEquity = config.initialEquity;
+            return summary;
+        }
+
+        const double* equity = equityCurve.data();
+        const size_t count = equityCurve.size();
+        double peak = equity[0];
+        double trough = equity[0];
+        double sum = 0.0;
+        for (size_t i = 1; i < count; ++i) {
+            sum += equity[i] - equity[i - 1];
+            peak = std::max(peak, equity[i]);
+            trough = std::min(trough, equity[i]);
+            summary.maxDrawdown = std::max(summary.maxDrawdown, peak - equity[i]);
+            summary.maxRunup = std::max(summary.maxRunup, equity[i] - trough);
+        }
+
+        summary.periods = count - 1;
+        summary.meanReturn = summary.periods > 0 ? sum / static_cast<double>(summary.periods) : 0.0;
+
+        // Second pass for the deviations, which is more accurate than accumulating squares in the first
+        double returnM2 = 0.0;
+        double downsideSquares = 0.0;
+        for (size_t i = 1; i < count; ++i) {
+            double periodReturn = equity[i] - equity[i - 1];
+            double deviation = periodReturn - summary.meanReturn;
+            double downside = std::min(periodReturn - config.riskFreeReturn, 0.0);
+            returnM2 += deviation * deviation;
+            downsideSquares += downside * downside;
+        }
+
+        summary.equity = equity[count - 1];
+        summary.netProfit = equity[count - 1] - equity[0];
+        summary.peakEquity = peak;
+        summary.currentDrawdown = peak - equity[count - 1];
+        UpdateRatios(summary, returnM2, downsideSquares, config);
+        return summary;
+    }
+
+    PerformanceSummary CalculateTradePerformance(const std::vector<double>& tradeProfits, const PerformanceMetricsConfig& config) {
+        std::vector<double> equityCurve(tradeProfits.size() + 1);
+        equityCurve[0] = config.initialEquity;
+        for (size_t i = 0; i < tradeProfits.size(); ++i) {
+            equityCurve[i + 1] = equityCurve[i] + tradeProfits[i];
+        }
+
+        PerformanceSummary summary = CalculatePerformance(equityCurve, config);
+        summary.netProfit = summary.equity - config.initialEquity;
+        int consecutiveWins = 0;
+        int consecutiveLosses = 0;
+        for (double profitLoss : tradeProfits) {
+            RecordTrade(summary, profitLoss, consecutiveWins, consecutiveLosses);
+        }
+        return summary;
+    }
+
+} // namespace Calculations
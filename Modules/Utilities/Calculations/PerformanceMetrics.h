@@ -0,0 +1,118 @@
+#ifndef PERFORMANCE_METRICS_H
+#define PERFORMANCE_METRICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CommonTypes.h"
+
+namespace Calculations {
+
+    struct PerformanceMetricsConfig {
+        double initialEquity = 0.0;
+        double riskFreeReturn = 0.0;   // per period, in the same units as the equity changes
+        double periodsPerYear = 252.0; // annualizes Sharpe, Sortino and Calmar; use 1 to keep them per period
+        size_t equityCurveCapacity = 4096;
+    };
+
+    /**
+     * @brief Risk and trade metrics of an equity stream.
+     *
+     * @details Returns are per-period equity changes in account currency, which suits futures P&L better than percentages.
+     * Drawdown and run-up are positive magnitudes.
+     */
+    struct PerformanceSummary {
+        double equity = 0.0;
+        double netProfit = 0.0;
+        double peakEquity = 0.0;
+        double maxDrawdown = 0.0;
+        double currentDrawdown = 0.0;
+        double maxRunup = 0.0;
+        double meanReturn = 0.0;
+        double returnStandardDeviation = 0.0;
+        double downsideDeviation = 0.0;
+        double sharpeRatio = 0.0;
+        double sortinoRatio = 0.0;
+        double calmarRatio = 0.0;
+        uint64_t periods = 0;
+
+        int totalTrades = 0;
+        int winningTrades = 0;
+        int losingTrades = 0;
+        double grossProfit = 0.0;
+        double grossLoss = 0.0;  // negative
+        double largestWin = 0.0;
+        double largestLoss = 0.0; // negative
+        int maxConsecutiveWins = 0;
+        int maxConsecutiveLosses = 0;
+
+        double ProfitFactor() const { return grossLoss < 0.0 ? grossProfit / -grossLoss : 0.0; }
+        double WinRate() const { return totalTrades > 0 ? static_cast<double>(winningTrades) / totalTrades * 100.0 : 0.0; }
+
+        /**
+         * @brief Writes the risk metrics into trade statistics. Drawdowns are written as negative values, following the
+         * platform's convention for TradeStatistics.
+         */
+        void ApplyTo(TradeStatistics& stats) const;
+    };
+
+    /**
+     * @brief Streaming performance metrics: drawdown, run-up, Sharpe, Sortino and Calmar with O(1) updates.
+     *
+     * @details Mean and variance of returns use Welford's method and drawdown tracks the running peak, so no history is
+     * needed for the ratios. The equity curve is kept for display in bounded memory: once it reaches its capacity, every
+     * other point is dropped and the sampling stride doubles, so it always spans the whole session.
+     *
+     * Not thread-safe.
+     */
+    class PerformanceMetrics {
+    public:
+        explicit PerformanceMetrics(const PerformanceMetricsConfig& config = PerformanceMetricsConfig());
+
+        /**
+         * @brief Records the equity at the end of a period; the change from the previous equity is the period's return.
+         */
+        void AddEquity(double equity);
+
+        /**
+         * @brief Records a closed trade's profit or loss, updating the trade statistics and the equity by one period.
+         */
+        void AddTrade(double profitLoss);
+
+        const PerformanceSummary& GetSummary() const { return summary_; }
+        void ApplyTo(TradeStatistics& stats) const { summary_.ApplyTo(stats); }
+
+        const std::vector<double>& GetEquityCurve() const { return equityCurve_; }
+        // Number of periods between consecutive points of the equity curve
+        uint64_t GetEquityCurveStride() const { return curveStride_; }
+
+        void Reset();
+
+    private:
+        PerformanceMetricsConfig config_;
+        PerformanceSummary summary_;
+        double troughEquity_ = 0.0;
+        double returnM2_ = 0.0;
+        double downsideSquares_ = 0.0;
+        int consecutiveWins_ = 0;
+        int consecutiveLosses_ = 0;
+
+        std::vector<double> equityCurve_;
+        uint64_t curveStride_ = 1;
+    };
+
+    /**
+     * @brief Metrics of a completed equity curve, e.g. the output of a backtest.
+     * @details The first point is the starting equity. Results match a PerformanceMetrics started at that equity and fed the
+     * remaining points.
+     */
+    PerformanceSummary CalculatePerformance(const std::vector<double>& equityCurve, const PerformanceMetricsConfig& config = PerformanceMetricsConfig());
+
+    /**
+     * @brief Metrics of a completed list of trade results, treating each trade as one period.
+     */
+    PerformanceSummary CalculateTradePerformance(const std::vector<double>& tradeProfits, const PerformanceMetricsConfig& config = PerformanceMetricsConfig());
+
+} // namespace Calculations
+
+#endif // PERFORMANCE_METRICS_H
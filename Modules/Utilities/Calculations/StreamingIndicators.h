@@ -0,0 +1,368 @@
+#ifndef STREAMING_INDICATORS_H
+#define STREAMING_INDICATORS_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace Calculations {
+
+    namespace Detail {
+        inline size_t ValidateWindowLength(int length, const char* message) {
+            if (length <= 0) {
+                throw std::invalid_argument(message);
+            }
+            return static_cast<size_t>(length);
+        }
+    }
+
+    /**
+     * @brief Fixed-capacity ring buffer holding the most recent `capacity` values of a series.
+     *
+     * @details Backing storage is allocated once, so pushing a value on every tick never allocates. Index 0 is the oldest value.
+     */
+    template <typename T>
+    class RingBuffer {
+    public:
+        explicit RingBuffer(size_t capacity) : buffer_(capacity) {
+            if (capacity == 0) {
+                throw std::invalid_argument("Ring buffer capacity must be greater than zero.");
+            }
+        }
+
+        /**
+         * @brief Appends a value, overwriting the oldest one once the buffer is full.
+         * @return The value that was overwritten, or a default-constructed T if the buffer was not yet full.
+         */
+        T Push(const T& value) {
+            T evicted{};
+            if (size_ == buffer_.size()) {
+                evicted = buffer_[head_];
+            } else {
+                ++size_;
+            }
+            buffer_[head_] = value;
+            head_ = (head_ + 1) % buffer_.size();
+            return evicted;
+        }
+
+        const T& operator[](size_t index) const {
+            return buffer_[(head_ + buffer_.size() - size_ + index) % buffer_.size()];
+        }
+
+        const T& Oldest() const { return (*this)[0]; }
+        const T& Newest() const { return (*this)[size_ - 1]; }
+
+        size_t Size() const { return size_; }
+        size_t Capacity() const { return buffer_.size(); }
+        bool Full() const { return size_ == buffer_.size(); }
+
+        void Clear() {
+            size_ = 0;
+            head_ = 0;
+        }
+
+    private:
+        std::vector<T> buffer_;
+        size_t head_ = 0;
+        size_t size_ = 0;
+    };
+
+    /**
+     * @brief Streaming counterpart of CalculateSMA: the mean of the last `length` values, updated in O(1).
+     *
+     * @details Keeps a running sum over the window. The sum is recomputed from the buffer once every max(length, 1024) updates,
+     * which bounds floating point drift while keeping the amortized cost constant.
+     */
+    class StreamingSMA {
+    public:
+        explicit StreamingSMA(int length) : window_(Detail::ValidateWindowLength(length, "Invalid length for SMA calculation.")) {}
+
+        void Update(double value) {
+            double evicted = window_.Push(value);
+            sum_ += value - evicted;
+            if (++updatesSinceResync_ >= ResyncInterval()) {
+                Resync();
+            }
+        }
+
+        bool IsReady() const { return window_.Full(); }
+        double Value() const { return window_.Size() == 0 ? 0.0 : sum_ / window_.Size(); }
+        double Sum() const { return sum_; }
+        int Length() const { return static_cast<int>(window_.Capacity()); }
+
+        void Reset() {
+            window_.Clear();
+            sum_ = 0.0;
+            updatesSinceResync_ = 0;
+        }
+
+    private:
+        size_t ResyncInterval() const { return std::max<size_t>(window_.Capacity(), 1024); }
+
+        void Resync() {
+            sum_ = 0.0;
+            for (size_t i = 0; i < window_.Size(); ++i) {
+                sum_ += window_[i];
+            }
+            updatesSinceResync_ = 0;
+        }
+
+        RingBuffer<double> window_;
+        double sum_ = 0.0;
+        size_t updatesSinceResync_ = 0;
+    };
+
+    /**
+     * @brief Streaming counterpart of CalculateEMA: the EMA seeded with the oldest of the last `length` values, updated in O(1).
+     *
+     * @details CalculateEMA restarts from the oldest value in the window on every call, so it is not the usual unbounded EMA.
+     * With a = 2 / (length + 1), b = 1 - a and the window x[0] (oldest) .. x[L-1], that windowed EMA expands to
+     * a * S + b^L * x[0], where S = sum(b^(L-1-i) * x[i]). Sliding the window gives S' = b * S + x_new - b^L * x_old,
+     * so each update is constant time. Rounding errors in S are scaled by b < 1 on every update and therefore decay.
+     */
+    class StreamingEMA {
+    public:
+        explicit StreamingEMA(int length)
+            : window_(Detail::ValidateWindowLength(length, "Invalid length for EMA calculation.")),
+              alpha_(2.0 / (length + 1)),
+              decay_(1.0 - alpha_),
+              decayPowLength_(std::pow(1.0 - alpha_, length)) {}
+
+        void Update(double value) {
+            bool wasFull = window_.Full();
+            double evicted = window_.Push(value);
+            weightedSum_ = decay_ * weightedSum_ + value - (wasFull ? decayPowLength_ * evicted : 0.0);
+        }
+
+        bool IsReady() const { return window_.Full(); }
+
+        double Value() const {
+            if (window_.Size() == 0) {
+                return 0.0;
+            }
+            if (!window_.Full()) {
+                // Partial window: seed with the oldest value seen so far, as CalculateEMA would over fewer values
+                double decayPowSize = std::pow(decay_, static_cast<double>(window_.Size()));
+                return alpha_ * weightedSum_ + decayPowSize * window_.Oldest();
+            }
+            return alpha_ * weightedSum_ + decayPowLength_ * window_.Oldest();
+        }
+
+        int Length() const { return static_cast<int>(window_.Capacity()); }
+
+        void Reset() {
+            window_.Clear();
+            weightedSum_ = 0.0;
+        }
+
+    private:
+        RingBuffer<double> window_;
+        double alpha_;
+        double decay_;
+        double decayPowLength_;
+        double weightedSum_ = 0.0;
+    };
+
+    /**
+     * @brief Streaming counterpart of Variance and StandardDeviation over the last `length` values, updated in O(1).
+     *
+     * @details Uses Welford's running mean and sum of squared deviations (M2), adjusted for the value leaving the window.
+     * Like Variance, the result is the population variance (divided by `length`). M2 is recomputed from the buffer
+     * once every max(length, 1024) updates to bound drift.
+     */
+    class StreamingVariance {
+    public:
+        explicit StreamingVariance(int length)
+            : window_(Detail::ValidateWindowLength(length, "Invalid length for variance calculation.")) {}
+
+        void Update(double value) {
+            if (!window_.Full()) {
+                window_.Push(value);
+                double n = static_cast<double>(window_.Size());
+                double delta = value - mean_;
+                mean_ += delta / n;
+                m2_ += delta * (value - mean_);
+            } else {
+                double evicted = window_.Push(value);
+                double oldMean = mean_;
+                mean_ += (value - evicted) / static_cast<double>(window_.Size());
+                m2_ += (value - evicted) * (value - mean_ + evicted - oldMean);
+                m2_ = std::max(m2_, 0.0);
+            }
+
+            if (++updatesSinceResync_ >= std::max<size_t>(window_.Capacity(), 1024)) {
+                Resync();
+            }
+        }
+
+        bool IsReady() const { return window_.Full(); }
+        double Mean() const { return mean_; }
+        double Variance() const { return window_.Size() == 0 ? 0.0 : m2_ / window_.Size(); }
+        double StandardDeviation() const { return std::sqrt(Variance()); }
+        double Value() const { return Variance(); }
+
+        void Reset() {
+            window_.Clear();
+            mean_ = 0.0;
+            m2_ = 0.0;
+            updatesSinceResync_ = 0;
+        }
+
+    private:
+        void Resync() {
+            double sum = 0.0;
+            for (size_t i = 0; i < window_.Size(); ++i) {
+                sum += window_[i];
+            }
+            mean_ = sum / window_.Size();
+            m2_ = 0.0;
+            for (size_t i = 0; i < window_.Size(); ++i) {
+                double deviation = window_[i] - mean_;
+                m2_ += deviation * deviation;
+            }
+            updatesSinceResync_ = 0;
+        }
+
+        RingBuffer<double> window_;
+        double mean_ = 0.0;
+        double m2_ = 0.0;
+        size_t updatesSinceResync_ = 0;
+    };
+
+    /**
+     * @brief Streaming standard deviation over the last `length` values; see StreamingVariance.
+     */
+    class StreamingStandardDeviation {
+    public:
+        explicit StreamingStandardDeviation(int length) : variance_(length) {}
+
+        void Update(double value) { variance_.Update(value); }
+        bool IsReady() const { return variance_.IsReady(); }
+        double Value() const { return variance_.StandardDeviation(); }
+        void Reset() { variance_.Reset(); }
+
+    private:
+        StreamingVariance variance_;
+    };
+
+    /**
+     * @brief Streaming counterpart of CalculateBollingerBands, updated in O(1).
+     *
+     * @details The middle band is the window mean and the bands are `numStdDev` population standard deviations either side,
+     * both taken from a single StreamingVariance.
+     */
+    class StreamingBollingerBands {
+    public:
+        StreamingBollingerBands(int length, double numStdDev) : variance_(length), numStdDev_(numStdDev) {}
+
+        void Update(double value) { variance_.Update(value); }
+        bool IsReady() const { return variance_.IsReady(); }
+
+        /**
+         * @return A tuple containing the upper band, middle band (SMA), and lower band values.
+         */
+        std::tuple<double, double, double> Value() const {
+            double sma = variance_.Mean();
+            double stdDev = variance_.StandardDeviation();
+            return std::make_tuple(sma + numStdDev_ * stdDev, sma, sma - numStdDev_ * stdDev);
+        }
+
+        void Reset() { variance_.Reset(); }
+
+    private:
+        StreamingVariance variance_;
+        double numStdDev_;
+    };
+
+    /**
+     * @brief Streaming counterpart of CalculateRSI, updated in O(1).
+     *
+     * @details Like CalculateRSI, averages the last `length` gains and losses with simple means. Feed either explicit
+     * gain/loss pairs through Update, or raw prices through UpdatePrice, which derives them from the previous price.
+     */
+    class StreamingRSI {
+    public:
+        explicit StreamingRSI(int length) : gains_(length), losses_(length) {}
+
+        void Update(double gain, double loss) {
+            gains_.Update(gain);
+            losses_.Update(loss);
+        }
+
+        void UpdatePrice(double price) {
+            if (hasLastPrice_) {
+                double change = price - lastPrice_;
+                Update(std::max(change, 0.0), std::max(-change, 0.0));
+            }
+            lastPrice_ = price;
+            hasLastPrice_ = true;
+        }
+
+        bool IsReady() const { return gains_.IsReady(); }
+
+        double Value() const {
+            double rs = gains_.Value() / losses_.Value();
+            return 100.0 - (100.0 / (1.0 + rs));
+        }
+
+        void Reset() {
+            gains_.Reset();
+            losses_.Reset();
+            hasLastPrice_ = false;
+        }
+
+    private:
+        StreamingSMA gains_;
+        StreamingSMA losses_;
+        double lastPrice_ = 0.0;
+        bool hasLastPrice_ = false;
+    };
+
+    /**
+     * @brief Streaming counterpart of CalculateMACD, updated in O(1).
+     *
+     * @details The MACD line is the difference of the short and long windowed EMAs. Once the long EMA is ready each MACD value
+     * feeds a windowed EMA of length `signalLength`, which yields the same signal line CalculateMACD builds from its MACD history.
+     */
+    class StreamingMACD {
+    public:
+        StreamingMACD(int shortLength, int longLength, int signalLength)
+            : shortEma_(shortLength), longEma_(longLength), signalEma_(signalLength) {}
+
+        void Update(double value) {
+            shortEma_.Update(value);
+            longEma_.Update(value);
+            if (longEma_.IsReady()) {
+                signalEma_.Update(Macd());
+            }
+        }
+
+        bool IsReady() const { return signalEma_.IsReady(); }
+
+        double Macd() const { return shortEma_.Value() - longEma_.Value(); }
+        double Signal() const { return signalEma_.Value(); }
+
+        /**
+         * @return A pair containing the MACD value and the signal line value.
+         */
+        std::pair<double, double> Value() const { return std::make_pair(Macd(), Signal()); }
+
+        void Reset() {
+            shortEma_.Reset();
+            longEma_.Reset();
+            signalEma_.Reset();
+        }
+
+    private:
+        StreamingEMA shortEma_;
+        StreamingEMA longEma_;
+        StreamingEMA signalEma_;
+    };
+
+} // namespace Calculations
+
+#endif // STREAMING_INDICATORS_H
@@ -0,0 +1,274 @@
+#include "VolumeProfile.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Calculations {
+
+    namespace {
+        constexpr int64_t MinimumHeadroom = 64;
+    }
+
+    VolumeProfile::VolumeProfile(double tickSize) : tickSize_(tickSize) {
+        if (tickSize <= 0.0) {
+            throw std::invalid_argument("Tick size must be greater than zero for a volume profile.");
+        }
+    }
+
+    void VolumeProfile::AddTrade(double price, double volume) {
+        if (volume <= 0.0) {
+            return;
+        }
+        int64_t tick = ToTick(price);
+        size_t index = EnsureTick(tick);
+        volume_[index] += volume;
+        totalVolume_ += volume;
+        ExtendRange(tick);
+
+        if (!volumePocTick_.has_value() || volume_[index] > volume_[IndexOf(volumePocTick_.value()).value()]) {
+            volumePocTick_ = tick;
+        }
+    }
+
+    void VolumeProfile::AddTrade(const TimeAndSales& trade) {
+        if (trade.type == TimeAndSalesType::Marker || trade.type == TimeAndSalesType::BidAskValues) {
+            return;
+        }
+        AddTrade(trade.price, static_cast<double>(trade.volume));
+    }
+
+    void VolumeProfile::AddTpoPeriod(double low, double high) {
+        int64_t lowTick = ToTick(std::min(low, high));
+        int64_t highTick = ToTick(std::max(low, high));
+        EnsureTick(lowTick);
+        EnsureTick(highTick);
+
+        uint32_t pocTpos = tpoPocTick_.has_value() ? tpos_[IndexOf(tpoPocTick_.value()).value()] : 0;
+        for (int64_t tick = lowTick; tick <= highTick; ++tick) {
+            size_t index = static_cast<size_t>(tick - baseTick_);
+            ++tpos_[index];
+            if (tpos_[index] > pocTpos) {
+                pocTpos = tpos_[index];
+                tpoPocTick_ = tick;
+            }
+        }
+        totalTpos_ += static_cast<uint64_t>(highTick - lowTick + 1);
+        ExtendRange(lowTick);
+        ExtendRange(highTick);
+    }
+
+    void VolumeProfile::Merge(const VolumeProfile& other) {
+        if (std::abs(other.tickSize_ - tickSize_) > 1e-12) {
+            throw std::invalid_argument("Cannot merge volume profiles with different tick sizes.");
+        }
+        if (!other.hasData_) {
+            return;
+        }
+
+        EnsureTick(other.lowTick_);
+        EnsureTick(other.highTick_);
+        for (int64_t tick = other.lowTick_; tick <= other.highTick_; ++tick) {
+            size_t source = static_cast<size_t>(tick - other.baseTick_);
+            size_t target = static_cast<size_t>(tick - baseTick_);
+            volume_[target] += other.volume_[source];
+            tpos_[target] += other.tpos_[source];
+        }
+        totalVolume_ += other.totalVolume_;
+        totalTpos_ += other.totalTpos_;
+        ExtendRange(other.lowTick_);
+        ExtendRange(other.highTick_);
+
+        // One pass over the merged range re-establishes both points of control
+        volumePocTick_.reset();
+        tpoPocTick_.reset();
+        double pocVolume = 0.0;
+        uint32_t pocTpos = 0;
+        for (int64_t tick = lowTick_; tick <= highTick_; ++tick) {
+            size_t index = static_cast<size_t>(tick - baseTick_);
+            if (volume_[index] > pocVolume) {
+                pocVolume = volume_[index];
+                volumePocTick_ = tick;
+            }
+            if (tpos_[index] > pocTpos) {
+                pocTpos = tpos_[index];
+                tpoPocTick_ = tick;
+            }
+        }
+    }
+
+    VolumeProfile VolumeProfile::Composite(const std::vector<const VolumeProfile*>& profiles) {
+        if (profiles.empty() || !profiles.front()) {
+            throw std::invalid_argument("A composite profile needs at least one profile.");
+        }
+        VolumeProfile composite(profiles.front()->tickSize_);
+        for (const auto* profile : profiles) {
+            if (profile) {
+                composite.Merge(*profile);
+            }
+        }
+        return composite;
+    }
+
+    void VolumeProfile::Clear() {
+        volume_.clear();
+        tpos_.clear();
+        baseTick_ = 0;
+        hasData_ = false;
+        lowTick_ = 0;
+        highTick_ = 0;
+        totalVolume_ = 0.0;
+        totalTpos_ = 0;
+        volumePocTick_.reset();
+        tpoPocTick_.reset();
+    }
+
+    double VolumeProfile::GetVolumeAtPrice(double price) const {
+        auto index = IndexOf(ToTick(price));
+        return index.has_value() ? volume_[index.value()] : 0.0;
+    }
+
+    uint32_t VolumeProfile::GetTposAtPrice(double price) const {
+        auto index = IndexOf(ToTick(price));
+        return index.has_value() ? tpos_[index.value()] : 0;
+    }
+
+    std::optional<double> VolumeProfile::GetHigh() const {
+        return hasData_ ? std::optional<double>(ToPrice(highTick_)) : std::nullopt;
+    }
+
+    std::optional<double> VolumeProfile::GetLow() const {
+        return hasData_ ? std::optional<double>(ToPrice(lowTick_)) : std::nullopt;
+    }
+
+    std::optional<double> VolumeProfile::GetPointOfControl() const {
+        return volumePocTick_.has_value() ? std::optional<double>(ToPrice(volumePocTick_.value())) : std::nullopt;
+    }
+
+    std::optional<double> VolumeProfile::GetTpoPointOfControl() const {
+        return tpoPocTick_.has_value() ? std::optional<double>(ToPrice(tpoPocTick_.value())) : std::nullopt;
+    }
+
+    std::optional<ValueArea> VolumeProfile::GetValueArea(double fraction) const {
+        if (!volumePocTick_.has_value()) {
+            return std::nullopt;
+        }
+        return BuildValueArea(volume_, volumePocTick_.value(), totalVolume_, fraction);
+    }
+
+    std::optional<ValueArea> VolumeProfile::GetTpoValueArea(double fraction) const {
+        if (!tpoPocTick_.has_value()) {
+            return std::nullopt;
+        }
+        return BuildValueArea(tpos_, tpoPocTick_.value(), static_cast<double>(totalTpos_), fraction);
+    }
+
+    template <typename T>
+    std::optional<ValueArea> VolumeProfile::BuildValueArea(const std::vector<T>& counts, int64_t pointOfControlTick, double total, double fraction) const {
+        size_t lowest = static_cast<size_t>(lowTick_ - baseTick_);
+        size_t highest = static_cast<size_t>(highTick_ - baseTick_);
+        size_t low = static_cast<size_t>(pointOfControlTick - baseTick_);
+        size_t high = low;
+        double covered = static_cast<double>(counts[low]);
+        double target = total * fraction;
+
+        // Grow towards whichever neighbour holds more; ties extend upwards
+        while (covered < target && (low > lowest || high < highest)) {
+            double above = high < highest ? static_cast<double>(counts[high + 1]) : -1.0;
+            double below = low > lowest ? static_cast<double>(counts[low - 1]) : -1.0;
+            if (above >= below) {
+                ++high;
+                covered += above;
+            } else {
+                --low;
+                covered += below;
+            }
+        }
+
+        return ValueArea{ToPrice(pointOfControlTick), ToPrice(baseTick_ + static_cast<int64_t>(high)), ToPrice(baseTick_ + static_cast<int64_t>(low)), covered};
+    }
+
+    VolumeNodes VolumeProfile::GetVolumeNodes(int smoothingTicks, double minimumShareOfPeak) const {
+        VolumeNodes nodes;
+        if (!volumePocTick_.has_value()) {
+            return nodes;
+        }
+
+        size_t first = static_cast<size_t>(lowTick_ - baseTick_);
+        size_t count = static_cast<size_t>(highTick_ - lowTick_ + 1);
+        size_t radius = static_cast<size_t>(std::max(smoothingTicks, 0));
+
+        // Centered moving average via prefix sums, with the window clipped at the profile's edges
+        std::vector<double> prefix(count + 1, 0.0);
+        for (size_t i = 0; i < count; ++i) {
+            prefix[i + 1] = prefix[i] + volume_[first + i];
+        }
+        std::vector<double> smoothed(count);
+        double largest = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            size_t begin = i >= radius ? i - radius : 0;
+            size_t end = std::min(count, i + radius + 1);
+            smoothed[i] = (prefix[end] - prefix[begin]) / static_cast<double>(end - begin);
+            largest = std::max(largest, smoothed[i]);
+        }
+
+        std::vector<size_t> peaks;
+        for (size_t i = 0; i < count; ++i) {
+            bool risesFromLeft = i == 0 || smoothed[i] > smoothed[i - 1];
+            bool notBelowRight = i + 1 == count || smoothed[i] >= smoothed[i + 1];
+            if (risesFromLeft && notBelowRight && smoothed[i] >= largest * minimumShareOfPeak) {
+                peaks.push_back(i);
+            }
+        }
+
+        for (size_t p = 0; p < peaks.size(); ++p) {
+            nodes.highVolumeNodes.push_back(ToPrice(lowTick_ + static_cast<int64_t>(peaks[p])));
+            if (p + 1 < peaks.size()) {
+                auto trough = std::min_element(smoothed.begin() + peaks[p], smoothed.begin() + peaks[p + 1] + 1);
+                nodes.lowVolumeNodes.push_back(ToPrice(lowTick_ + static_cast<int64_t>(trough - smoothed.begin())));
+            }
+        }
+        return nodes;
+    }
+
+    int64_t VolumeProfile::ToTick(double price) const {
+        return static_cast<int64_t>(std::llround(price / tickSize_));
+    }
+
+    size_t VolumeProfile::EnsureTick(int64_t tick) {
+        if (volume_.empty()) {
+            baseTick_ = tick - MinimumHeadroom;
+            volume_.assign(static_cast<size_t>(2 * MinimumHeadroom + 1), 0.0);
+            tpos_.assign(volume_.size(), 0);
+        } else if (tick < baseTick_) {
+            int64_t grow = (baseTick_ - tick) + std::max<int64_t>(MinimumHeadroom, static_cast<int64_t>(volume_.size() / 2));
+            volume_.insert(volume_.begin(), static_cast<size_t>(grow), 0.0);
+            tpos_.insert(tpos_.begin(), static_cast<size_t>(grow), 0);
+            baseTick_ -= grow;
+        } else if (tick >= baseTick_ + static_cast<int64_t>(volume_.size())) {
+            int64_t needed = tick - baseTick_ + 1;
+            size_t newSize = static_cast<size_t>(needed + std::max<int64_t>(MinimumHeadroom, static_cast<int64_t>(volume_.size() / 2)));
+            volume_.resize(newSize, 0.0);
+            tpos_.resize(newSize, 0);
+        }
+        return static_cast<size_t>(tick - baseTick_);
+    }
+
+    std::optional<size_t> VolumeProfile::IndexOf(int64_t tick) const {
+        if (volume_.empty() || tick < baseTick_ || tick >= baseTick_ + static_cast<int64_t>(volume_.size())) {
+            return std::nullopt;
+        }
+        return static_cast<size_t>(tick - baseTick_);
+    }
+
+    void VolumeProfile::ExtendRange(int64_t tick) {
+        if (!hasData_) {
+            lowTick_ = tick;
+            highTick_ = tick;
+            hasData_ = true;
+            return;
+        }
+        lowTick_ = std::min(lowTick_, tick);
+        highTick_ = std::max(highTick_, tick);
+    }
+
+} // namespace Calculations
@@ -0,0 +1,154 @@
+#ifndef VOLUME_PROFILE_H
+#define VOLUME_PROFILE_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "CommonTypes.h"
+
+namespace Calculations {
+
+    /**
+     * @brief Price range holding a given share of a profile's volume (or TPOs), grown outwards from the point of control.
+     */
+    struct ValueArea {
+        double pointOfControl;
+        double high;
+        double low;
+        double volume; // volume (or TPO count) inside the area
+    };
+
+    /**
+     * @brief Local extremes of a smoothed profile: high-volume nodes (peaks) and low-volume nodes (troughs between peaks).
+     */
+    struct VolumeNodes {
+        std::vector<double> highVolumeNodes;
+        std::vector<double> lowVolumeNodes;
+    };
+
+    /**
+     * @brief Incremental volume-at-price and TPO profile on a tick-indexed histogram.
+     *
+     * @details Each trade is one array increment at its tick, and the volume point of control is maintained as trades arrive,
+     * so building a profile never rescans the session. Value area, node detection and merges walk the price levels once,
+     * so their cost depends on the session's range in ticks rather than its trade count.
+     *
+     * Not thread-safe; a profile is owned by the generator that feeds it.
+     */
+    class VolumeProfile {
+    public:
+        explicit VolumeProfile(double tickSize);
+
+        /**
+         * @brief Adds traded volume at a price. O(1) amortized.
+         */
+        void AddTrade(double price, double volume);
+
+        /**
+         * @brief Adds a time and sales record. Markers and quote-only records carry no traded volume and are ignored.
+         */
+        void AddTrade(const TimeAndSales& trade);
+
+        /**
+         * @brief Adds one TPO at every tick in [low, high], i.e. one time period of a market profile.
+         */
+        void AddTpoPeriod(double low, double high);
+
+        /**
+         * @brief Adds a bar's range as one TPO period. Volume is not added, since a bar's volume has no price distribution;
+         * feed trades through AddTrade for volume.
+         */
+        void AddBar(const BarData& bar) { AddTpoPeriod(bar.low, bar.high); }
+
+        /**
+         * @brief Adds another profile into this one, e.g. to build a composite from session profiles. O(levels).
+         * @throws std::invalid_argument If the tick sizes differ.
+         */
+        void Merge(const VolumeProfile& other);
+
+        static VolumeProfile Composite(const std::vector<const VolumeProfile*>& profiles);
+
+        void Clear();
+
+        bool Empty() const { return totalVolume_ <= 0.0 && totalTpos_ == 0; }
+        double GetTickSize() const { return tickSize_; }
+        double GetTotalVolume() const { return totalVolume_; }
+        uint64_t GetTotalTpos() const { return totalTpos_; }
+
+        double GetVolumeAtPrice(double price) const;
+        uint32_t GetTposAtPrice(double price) const;
+
+        std::optional<double> GetHigh() const;
+        std::optional<double> GetLow() const;
+
+        /**
+         * @brief Price with the most volume. O(1).
+         */
+        std::optional<double> GetPointOfControl() const;
+
+        /**
+         * @brief Price with the most TPOs. O(1).
+         */
+        std::optional<double> GetTpoPointOfControl() const;
+
+        /**
+         * @brief Volume value area: starting from the point of control, the larger neighbouring level is added until
+         * `fraction` of the total volume is covered. O(levels).
+         */
+        std::optional<ValueArea> GetValueArea(double fraction = 0.7) const;
+
+        /**
+         * @brief TPO value area, built the same way from TPO counts.
+         */
+        std::optional<ValueArea> GetTpoValueArea(double fraction = 0.7) const;
+
+        /**
+         * @brief Peaks and troughs of the volume histogram after a moving-average smoothing of +/- `smoothingTicks`. O(levels).
+         * @param minimumShareOfPeak Peaks below this share of the largest smoothed level are ignored as noise.
+         */
+        VolumeNodes GetVolumeNodes(int smoothingTicks = 2, double minimumShareOfPeak = 0.1) const;
+
+        /**
+         * @brief Visits each price with volume or TPOs, from low to high, as f(price, volume, tpos).
+         */
+        template <typename F>
+        void ForEachLevel(F&& f) const {
+            for (size_t i = 0; i < volume_.size(); ++i) {
+                if (volume_[i] > 0.0 || tpos_[i] > 0) {
+                    f(ToPrice(baseTick_ + static_cast<int64_t>(i)), volume_[i], tpos_[i]);
+                }
+            }
+        }
+
+    private:
+        int64_t ToTick(double price) const;
+        double ToPrice(int64_t tick) const { return static_cast<double>(tick) * tickSize_; }
+
+        // Makes tick addressable, growing the histogram with headroom on the side that ran out; returns its index
+        size_t EnsureTick(int64_t tick);
+        std::optional<size_t> IndexOf(int64_t tick) const;
+        void ExtendRange(int64_t tick);
+
+        template <typename T>
+        std::optional<ValueArea> BuildValueArea(const std::vector<T>& counts, int64_t pointOfControlTick, double total, double fraction) const;
+
+        double tickSize_;
+        int64_t baseTick_ = 0; // tick of index 0
+        std::vector<double> volume_;
+        std::vector<uint32_t> tpos_;
+
+        // Range of ticks that actually hold data
+        bool hasData_ = false;
+        int64_t lowTick_ = 0;
+        int64_t highTick_ = 0;
+
+        double totalVolume_ = 0.0;
+        uint64_t totalTpos_ = 0;
+        // Points of control are kept as ticks since growing the histogram downwards shifts indexes
+        std::optional<int64_t> volumePocTick_;
+        std::optional<int64_t> tpoPocTick_;
+    };
+
+} // namespace Calculations
+
+#endif // VOLUME_PROFILE_H
@@ -0,0 +1,201 @@
+#include "BinaryLog.h"
+#include <charconv>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+#include "CommonTypes.h"
+
+namespace BinaryLog {
+
+    namespace {
+        constexpr char FileMagic[8] = {'S', 'F', 'B', 'L', 'O', 'G', '0', '1'};
+        constexpr uint8_t FormatEntry = 'F';
+        constexpr uint8_t RecordEntry = 'R';
+
+        template <typename T>
+        T Read(const uint8_t*& in) {
+            T value;
+            std::memcpy(&value, in, sizeof(T));
+            in += sizeof(T);
+            return value;
+        }
+
+        template <typename T>
+        void AppendNumber(std::string& out, T value) {
+            char buffer[32];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, result.ptr);
+        }
+
+        // Appends the argument at `in` and advances past it; returns false on a malformed argument
+        bool AppendArgument(std::string& out, const uint8_t*& in, const uint8_t* end) {
+            if (in >= end) {
+                return false;
+            }
+            ArgType type = static_cast<ArgType>(*in++);
+            switch (type) {
+            case ArgType::Int64:
+                if (end - in < 8) return false;
+                AppendNumber(out, Read<int64_t>(in));
+                return true;
+            case ArgType::UInt64:
+                if (end - in < 8) return false;
+                AppendNumber(out, Read<uint64_t>(in));
+                return true;
+            case ArgType::Double:
+                if (end - in < 8) return false;
+                AppendNumber(out, Read<double>(in));
+                return true;
+            case ArgType::Bool:
+                if (end - in < 1) return false;
+                out += Read<uint8_t>(in) ? "true" : "false";
+                return true;
+            case ArgType::Char:
+                if (end - in < 1) return false;
+                out += Read<char>(in);
+                return true;
+            case ArgType::String: {
+                if (end - in < 4) return false;
+                uint32_t length = Read<uint32_t>(in);
+                if (static_cast<size_t>(end - in) < length) return false;
+                out.append(reinterpret_cast<const char*>(in), length);
+                in += length;
+                return true;
+            }
+            }
+            return false;
+        }
+
+        template <typename T>
+        void WriteValue(std::ofstream& file, const T& value) {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        bool ReadValue(std::istream& in, T& value) {
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+    }
+
+    void AppendFormatted(std::string& out, std::string_view format, const uint8_t* args, size_t argsSize) {
+        const uint8_t* in = args;
+        const uint8_t* end = args + argsSize;
+        size_t position = 0;
+        while (position < format.size()) {
+            size_t placeholder = format.find("{}", position);
+            if (placeholder == std::string_view::npos) {
+                out.append(format.substr(position));
+                break;
+            }
+            out.append(format.substr(position, placeholder - position));
+            if (!AppendArgument(out, in, end)) {
+                out += "{}";
+            }
+            position = placeholder + 2;
+        }
+        while (in < end) {
+            out += ' ';
+            if (!AppendArgument(out, in, end)) {
+                break;
+            }
+        }
+    }
+
+    const std::string& TimestampFormatter::Format(int64_t timestampNs) {
+        int64_t second = timestampNs >= 0 ? timestampNs / 1000000000 : (timestampNs - 999999999) / 1000000000;
+        if (second != second_) {
+            auto timePoint = std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(second)));
+            text_ = DateTime(timePoint).ToString();
+            second_ = second;
+        }
+        return text_;
+    }
+
+    bool BinaryLogWriter::Open(const std::string& path) {
+        Close();
+        file_.open(path, std::ios::binary | std::ios::trunc);
+        if (!file_.is_open()) {
+            return false;
+        }
+        file_.write(FileMagic, sizeof(FileMagic));
+        return static_cast<bool>(file_);
+    }
+
+    void BinaryLogWriter::Write(const uint8_t* record, size_t size, std::string_view format, int level) {
+        if (!file_.is_open() || size < sizeof(RecordHeader)) {
+            return;
+        }
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+        if (writtenFormats_.insert(header.formatId).second) {
+            WriteValue(file_, FormatEntry);
+            WriteValue(file_, header.formatId);
+            WriteValue(file_, static_cast<uint8_t>(level));
+            WriteValue(file_, static_cast<uint32_t>(format.size()));
+            file_.write(format.data(), static_cast<std::streamsize>(format.size()));
+        }
+        WriteValue(file_, RecordEntry);
+        file_.write(reinterpret_cast<const char*>(record), static_cast<std::streamsize>(size));
+    }
+
+    void BinaryLogWriter::Close() {
+        if (file_.is_open()) {
+            file_.close();
+        }
+        writtenFormats_.clear();
+    }
+
+    long long BinaryLogReader::Decode(std::istream& in, const std::function<void(const DecodedRecord&)>& onRecord) {
+        char magic[sizeof(FileMagic)];
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, FileMagic, sizeof(magic)) != 0) {
+            return -1;
+        }
+
+        struct Format {
+            std::string text;
+            int level;
+        };
+        std::unordered_map<uint32_t, Format> formats;
+        std::vector<uint8_t> record;
+        long long count = 0;
+
+        uint8_t kind;
+        while (ReadValue(in, kind)) {
+            if (kind == FormatEntry) {
+                uint32_t id;
+                uint8_t level;
+                uint32_t length;
+                if (!ReadValue(in, id) || !ReadValue(in, level) || !ReadValue(in, length)) {
+                    break;
+                }
+                std::string text(length, '\0');
+                if (!in.read(text.data(), length)) {
+                    break;
+                }
+                formats[id] = Format{std::move(text), level};
+            } else if (kind == RecordEntry) {
+                RecordHeader header;
+                if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.size < sizeof(header)) {
+                    break;
+                }
+                record.resize(header.size - sizeof(header));
+                if (!in.read(reinterpret_cast<char*>(record.data()), static_cast<std::streamsize>(record.size()))) {
+                    break;
+                }
+                auto format = formats.find(header.formatId);
+                if (format == formats.end()) {
+                    continue;
+                }
+                DecodedRecord decoded{header.timestampNs, format->second.level, std::string()};
+                AppendFormatted(decoded.message, format->second.text, record.data(), record.size());
+                onRecord(decoded);
+                ++count;
+            } else {
+                break; // truncated or corrupt file; keep what was decoded
+            }
+        }
+        return count;
+    }
+
+} // namespace BinaryLog
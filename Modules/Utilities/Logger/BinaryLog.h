@@ -0,0 +1,169 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+// Binary log records: a fixed header followed by the raw, type-tagged arguments of a registered format string.
+// Producers only copy arguments; turning a record into text happens on the logger's thread or offline with
+// BinaryLogReader, which reads the files written by BinaryLogWriter.
+namespace BinaryLog {
+
+    struct RecordHeader {
+        uint32_t size;        // header plus encoded arguments, in bytes
+        uint32_t formatId;
+        int64_t timestampNs;  // system_clock nanoseconds since the epoch
+    };
+
+    enum class ArgType : uint8_t {
+        Int64 = 1,
+        UInt64,
+        Double,
+        Bool,
+        Char,
+        String
+    };
+
+    template <typename T, typename = void>
+    struct HasToString : std::false_type {};
+
+    template <typename T>
+    struct HasToString<T, std::void_t<decltype(std::declval<const T&>().ToString())>> : std::true_type {};
+
+    // Arguments that are not plain values are rendered on the calling thread, since copying the object would not be safe.
+    template <typename T>
+    decltype(auto) Capture(const T& value) {
+        if constexpr (HasToString<T>::value) {
+            return value.ToString();
+        } else {
+            return (value);
+        }
+    }
+
+    template <typename T>
+    constexpr bool IsStringLike() {
+        using U = std::decay_t<T>;
+        return std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view> ||
+            std::is_same_v<U, const char*> || std::is_same_v<U, char*>;
+    }
+
+    // Char arrays and string literals are never null, so only real pointers are checked
+    template <typename T>
+    std::string_view AsStringView(const T& value) {
+        if constexpr (std::is_pointer_v<T>) {
+            return value ? std::string_view(value) : std::string_view("(null)");
+        } else {
+            return std::string_view(value);
+        }
+    }
+
+    template <typename T>
+    size_t EncodedSizeOf(const T& value) {
+        using U = std::decay_t<T>;
+        if constexpr (IsStringLike<T>()) {
+            return 1 + sizeof(uint32_t) + AsStringView(value).size();
+        } else if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, char>) {
+            return 2;
+        } else if constexpr (std::is_arithmetic_v<U> || std::is_enum_v<U>) {
+            return 1 + 8;
+        } else {
+            static_assert(IsStringLike<T>() || std::is_arithmetic_v<U> || std::is_enum_v<U>,
+                "Log arguments must be numbers, enums, strings or types with ToString()");
+            return 0;
+        }
+    }
+
+    template <typename... Args>
+    size_t EncodedSize(const Args&... args) {
+        return (size_t(0) + ... + EncodedSizeOf(args));
+    }
+
+    inline uint8_t* Put(uint8_t* out, ArgType type, const void* data, size_t size) {
+        *out++ = static_cast<uint8_t>(type);
+        std::memcpy(out, data, size);
+        return out + size;
+    }
+
+    template <typename T>
+    uint8_t* EncodeOne(uint8_t* out, const T& value) {
+        using U = std::decay_t<T>;
+        if constexpr (IsStringLike<T>()) {
+            std::string_view text = AsStringView(value);
+            uint32_t length = static_cast<uint32_t>(text.size());
+            out = Put(out, ArgType::String, &length, sizeof(length));
+            std::memcpy(out, text.data(), text.size());
+            return out + text.size();
+        } else if constexpr (std::is_same_v<U, bool>) {
+            uint8_t flag = value ? 1 : 0;
+            return Put(out, ArgType::Bool, &flag, 1);
+        } else if constexpr (std::is_same_v<U, char>) {
+            return Put(out, ArgType::Char, &value, 1);
+        } else if constexpr (std::is_floating_point_v<U>) {
+            double number = static_cast<double>(value);
+            return Put(out, ArgType::Double, &number, sizeof(number));
+        } else if constexpr (std::is_enum_v<U>) {
+            int64_t number = static_cast<int64_t>(value);
+            return Put(out, ArgType::Int64, &number, sizeof(number));
+        } else if constexpr (std::is_unsigned_v<U>) {
+            uint64_t number = static_cast<uint64_t>(value);
+            return Put(out, ArgType::UInt64, &number, sizeof(number));
+        } else {
+            int64_t number = static_cast<int64_t>(value);
+            return Put(out, ArgType::Int64, &number, sizeof(number));
+        }
+    }
+
+    template <typename... Args>
+    uint8_t* Encode(uint8_t* out, const Args&... args) {
+        ((out = EncodeOne(out, args)), ...);
+        return out;
+    }
+
+    // Appends `format` to `out`, replacing each "{}" with the next encoded argument. Surplus arguments are appended
+    // after the message so nothing logged is lost.
+    void AppendFormatted(std::string& out, std::string_view format, const uint8_t* args, size_t argsSize);
+
+    // Renders a nanosecond timestamp the way DateTime::ToString does, reusing the text while the second is unchanged.
+    class TimestampFormatter {
+    public:
+        const std::string& Format(int64_t timestampNs);
+
+    private:
+        int64_t second_ = INT64_MIN;
+        std::string text_;
+    };
+
+    // Writes records to a file for offline decoding. Each format string is written once, before its first record.
+    class BinaryLogWriter {
+    public:
+        bool Open(const std::string& path);
+        bool IsOpen() const { return file_.is_open(); }
+        void Write(const uint8_t* record, size_t size, std::string_view format, int level);
+        void Flush() { file_.flush(); }
+        void Close();
+
+    private:
+        std::ofstream file_;
+        std::unordered_set<uint32_t> writtenFormats_;
+    };
+
+    struct DecodedRecord {
+        int64_t timestampNs;
+        int level;
+        std::string message;
+    };
+
+    // Decodes a file written by BinaryLogWriter. Returns the number of records decoded, or -1 if it is not a binary log.
+    class BinaryLogReader {
+    public:
+        static long long Decode(std::istream& in, const std::function<void(const DecodedRecord&)>& onRecord);
+    };
+
+} // namespace BinaryLog
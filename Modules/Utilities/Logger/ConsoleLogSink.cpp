@@ -0,0 +1,77 @@
+#include "ConsoleLogSink.h"
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+ConsoleLogSink::~ConsoleLogSink() {
+    Flush();
+#ifdef _WIN32
+    // Close the console if it was created by this sink
+    if (consoleCreated_) {
+        FreeConsole();
+    }
+#endif
+}
+
+void ConsoleLogSink::Write(Logger::LogLevel level, int64_t /*timestampNs*/, std::string_view line) {
+    if (!opened_) {
+        OpenConsole();
+    }
+    std::ostream& out = level == Logger::LogLevel::LOG_ERROR ? std::cerr : std::cout;
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    pending_ = true;
+}
+
+void ConsoleLogSink::Poll() {
+    if (pending_) {
+        Flush();
+    }
+}
+
+void ConsoleLogSink::Flush() {
+    std::cout.flush();
+    std::cerr.flush();
+    pending_ = false;
+}
+
+void ConsoleLogSink::OpenConsole() {
+    opened_ = true;
+#ifdef _WIN32
+    // Create a detached console window
+    if (!AllocConsole()) {
+        if (GetLastError() == ERROR_ACCESS_DENIED) {
+            AttachConsole(ATTACH_PARENT_PROCESS);
+        }
+    } else {
+        consoleCreated_ = true;
+    }
+
+    // Set console close handler
+    SetConsoleCtrlHandler([](DWORD event) -> BOOL {
+        if (event == CTRL_CLOSE_EVENT) {
+            // Ignore the close event to keep the application running
+            FreeConsole();
+            return TRUE;
+        }
+        return FALSE;
+    }, TRUE);
+
+    // Disable the close button, since closing the console would end the host process
+    HWND hwnd = GetConsoleWindow();
+    if (hwnd != NULL) {
+        HMENU hMenu = GetSystemMenu(hwnd, FALSE);
+        if (hMenu != NULL) {
+            DeleteMenu(hMenu, SC_CLOSE, MF_BYCOMMAND);
+        }
+    }
+    SetConsoleTitleA("Trade System Logs");
+
+    // Redirect cout and cerr to the console
+    FILE* fp;
+    freopen_s(&fp, "CONOUT$", "w", stdout);
+    freopen_s(&fp, "CONOUT$", "w", stderr);
+#endif
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "ILogSink.h"
+
+// Writes lines to stdout, and errors to stderr, flushing once per batch rather than per line.
+// On Windows the first line opens a detached console window, since the host application has none.
+class ConsoleLogSink : public ILogSink {
+public:
+    ConsoleLogSink() = default;
+    ~ConsoleLogSink() override;
+
+    void Write(Logger::LogLevel level, int64_t timestampNs, std::string_view line) override;
+    void Poll() override;
+    void Flush() override;
+
+private:
+    void OpenConsole();
+
+    bool opened_ = false;
+    bool consoleCreated_ = false;
+    bool pending_ = false;
+};
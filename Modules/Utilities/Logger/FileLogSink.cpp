@@ -0,0 +1,132 @@
+#include "FileLogSink.h"
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+    constexpr int64_t NanosecondsPerDay = 86400LL * 1000000000LL;
+
+    int64_t DayOf(int64_t timestampNs) {
+        return timestampNs >= 0 ? timestampNs / NanosecondsPerDay : (timestampNs + 1) / NanosecondsPerDay - 1;
+    }
+}
+
+FileLogSink::FileLogSink(const FileLogSinkConfig& config) : config_(config), lastWrite_(std::chrono::steady_clock::now()) {
+    buffer_.reserve(config_.bufferSize);
+}
+
+FileLogSink::~FileLogSink() {
+    Flush();
+}
+
+void FileLogSink::Write(Logger::LogLevel /*level*/, int64_t timestampNs, std::string_view line) {
+    int64_t day = config_.rotateDaily ? DayOf(timestampNs) : 0;
+    if (day != currentDay_ || !file_.is_open()) {
+        WriteBuffer();
+        if (!OpenFile(day)) {
+            return;
+        }
+    } else if (config_.maxFileSize > 0 && fileSize_ + line.size() > config_.maxFileSize && fileSize_ > 0) {
+        WriteBuffer();
+        file_.close();
+        ++currentIndex_;
+        if (!OpenFile(day)) {
+            return;
+        }
+    }
+
+    buffer_.append(line.data(), line.size());
+    fileSize_ += line.size();
+    if (buffer_.size() >= config_.bufferSize) {
+        WriteBuffer();
+    }
+}
+
+void FileLogSink::Poll() {
+    if (!buffer_.empty() && std::chrono::steady_clock::now() - lastWrite_ >= config_.flushInterval) {
+        WriteBuffer();
+    }
+}
+
+void FileLogSink::Flush() {
+    WriteBuffer();
+    if (file_.is_open()) {
+        file_.flush();
+    }
+}
+
+void FileLogSink::WriteBuffer() {
+    lastWrite_ = std::chrono::steady_clock::now();
+    if (buffer_.empty()) {
+        return;
+    }
+    if (file_.is_open()) {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    }
+    buffer_.clear();
+}
+
+bool FileLogSink::OpenFile(int64_t day) {
+    auto now = std::chrono::steady_clock::now();
+    if (openFailed_ && currentDay_ == day && now - lastOpenAttempt_ < config_.flushInterval) {
+        return false;
+    }
+    lastOpenAttempt_ = now;
+    if (currentDay_ != day) {
+        currentDay_ = day;
+        currentIndex_ = 0;
+    }
+    file_.close();
+
+    std::error_code error;
+    std::filesystem::create_directories(config_.directory, error);
+
+    // Skip files of the same day that are already full, e.g. from an earlier run
+    std::string path = PathFor(day, currentIndex_);
+    uint64_t existingSize = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+    while (config_.maxFileSize > 0 && existingSize >= config_.maxFileSize) {
+        path = PathFor(day, ++currentIndex_);
+        existingSize = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+    }
+
+    // The sink does its own buffering, so the stream writes straight through
+    file_.rdbuf()->pubsetbuf(nullptr, 0);
+    file_.open(path, std::ios::out | std::ios::app | std::ios::binary);
+    if (!file_.is_open()) {
+        // Reported once until a file opens again; lines are dropped and opening is retried every flushInterval
+        if (!openFailed_) {
+            std::cerr << "FileLogSink: could not open " << path << "\n";
+        }
+        openFailed_ = true;
+        return false;
+    }
+    openFailed_ = false;
+    currentPath_ = path;
+    fileSize_ = existingSize;
+    return true;
+}
+
+std::string FileLogSink::PathFor(int64_t day, int index) const {
+    std::string name = config_.baseName;
+    if (config_.rotateDaily) {
+        name += "_" + FormatDate(day);
+    }
+    if (index > 0) {
+        name += "." + std::to_string(index);
+    }
+    name += ".log";
+    return (std::filesystem::path(config_.directory) / name).string();
+}
+
+std::string FileLogSink::FormatDate(int64_t day) {
+    std::time_t time = static_cast<std::time_t>(day * 86400);
+    std::tm tm;
+#ifdef _WIN32
+    gmtime_s(&tm, &time);
+#else
+    gmtime_r(&time, &tm);
+#endif
+    char date[16];
+    std::strftime(date, sizeof(date), "%Y%m%d", &tm);
+    return date;
+}
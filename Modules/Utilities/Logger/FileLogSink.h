@@ -0,0 +1,51 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "ILogSink.h"
+
+struct FileLogSinkConfig {
+    std::string directory = "logs";
+    std::string baseName = "signal-forge";
+    size_t bufferSize = 256 * 1024;                   // buffered bytes that trigger a write
+    std::chrono::milliseconds flushInterval{1000};    // longest time a line stays buffered
+    uint64_t maxFileSize = 64ull * 1024 * 1024;       // rotate once a file reaches this size; 0 disables
+    bool rotateDaily = true;                          // start a new file for each UTC day
+};
+
+// Writes lines to <directory>/<baseName>_<YYYYMMDD>.log, coalescing them into one write per bufferSize bytes or
+// flushInterval, whichever comes first. Files rotate by size to <baseName>_<YYYYMMDD>.<n>.log and, if enabled, by
+// the UTC day of each record's timestamp; without daily rotation the date is left out of the name.
+// Existing files are appended to.
+// Runs on the logger's background thread, so writes and rotation never block the threads that log.
+class FileLogSink : public ILogSink {
+public:
+    explicit FileLogSink(const FileLogSinkConfig& config = FileLogSinkConfig());
+    ~FileLogSink() override;
+
+    void Write(Logger::LogLevel level, int64_t timestampNs, std::string_view line) override;
+    void Poll() override;
+    void Flush() override;
+
+    // Path of the file being written, empty before the first line.
+    const std::string& GetCurrentPath() const { return currentPath_; }
+
+private:
+    void WriteBuffer();
+    bool OpenFile(int64_t day);
+    std::string PathFor(int64_t day, int index) const;
+    static std::string FormatDate(int64_t day);
+
+    FileLogSinkConfig config_;
+    std::string buffer_;
+    std::chrono::steady_clock::time_point lastWrite_;
+
+    std::ofstream file_;
+    std::string currentPath_;
+    int64_t currentDay_ = -1;
+    int currentIndex_ = 0;
+    uint64_t fileSize_ = 0;   // bytes in the file, including what is still buffered
+    bool openFailed_ = false;
+    std::chrono::steady_clock::time_point lastOpenAttempt_;
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include "Logger.h"
+
+// Destination for formatted log lines. Sinks are only called from the logger's background thread, so they need no
+// locking of their own and may block on I/O without stalling the threads that log.
+class ILogSink {
+public:
+    virtual ~ILogSink() = default;
+
+    // `line` is a complete line including its trailing newline.
+    virtual void Write(Logger::LogLevel level, int64_t timestampNs, std::string_view line) = 0;
+
+    // Called after every pass over the logging threads' buffers, idle or not; used for time-based flushing.
+    virtual void Poll() {}
+
+    // Pushes everything written so far to its destination; called for Logger::Flush, on removal and at shutdown.
+    virtual void Flush() = 0;
+};
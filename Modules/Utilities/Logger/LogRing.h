@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+// Single-producer single-consumer byte ring holding variable-sized log records.
+// Each logging thread owns one ring and the logger's background thread is its only consumer, so a record costs a bounds
+// check, a memcpy of its arguments and one release store; there are no locks or allocations on the producer side.
+// Records are 8-byte aligned and never straddle the end of the buffer: a zero size word tells the consumer to wrap.
+class LogRing {
+public:
+    static constexpr size_t Alignment = 8;
+
+    explicit LogRing(size_t capacity) : capacity_(RoundUpToPowerOfTwo(capacity)), mask_(capacity_ - 1),
+        buffer_(new uint8_t[capacity_]) {}
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    // Producer: returns space for a record of `size` bytes, or nullptr if the ring is full or the record is larger than
+    // MaxRecordSize (the record is dropped and counted). The first four bytes of the record must hold its size.
+    // Publish it with Commit.
+    uint8_t* Reserve(size_t size) {
+        size_t needed = AlignUp(size);
+        if (needed > MaxRecordSize()) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        size_t offset = static_cast<size_t>(head & mask_);
+        size_t padding = offset + needed > capacity_ ? capacity_ - offset : 0;
+
+        if (head + padding + needed - cachedTail_ > capacity_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head + padding + needed - cachedTail_ > capacity_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+
+        if (padding > 0) {
+            uint32_t wrapMarker = 0;
+            std::memcpy(buffer_.get() + offset, &wrapMarker, sizeof(wrapMarker));
+            head += padding;
+            offset = 0;
+        }
+        pendingHead_ = head + needed;
+        return buffer_.get() + offset;
+    }
+
+    void Commit() {
+        head_.store(pendingHead_, std::memory_order_release);
+    }
+
+    // Consumer: calls f(record, size) for every published record, then releases their space.
+    template <typename F>
+    size_t Drain(F&& f) {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (tail < head) {
+            size_t offset = static_cast<size_t>(tail & mask_);
+            uint32_t size = 0;
+            std::memcpy(&size, buffer_.get() + offset, sizeof(size));
+            if (size == 0) {
+                tail += capacity_ - offset;
+                continue;
+            }
+            f(buffer_.get() + offset, static_cast<size_t>(size));
+            tail += AlignUp(size);
+            ++count;
+        }
+        tail_.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    bool Empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    // Number of records dropped because the ring was full; reading resets the count.
+    uint64_t TakeDroppedCount() { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+    // Set by the owning thread on exit; the consumer frees the ring once it has drained it.
+    void Close() { closed_.store(true, std::memory_order_release); }
+    bool IsClosed() const { return closed_.load(std::memory_order_acquire); }
+
+    size_t Capacity() const { return capacity_; }
+    size_t MaxRecordSize() const { return capacity_ / 2; }
+
+private:
+    static size_t AlignUp(size_t size) { return (size + Alignment - 1) & ~(Alignment - 1); }
+
+    static size_t RoundUpToPowerOfTwo(size_t value) {
+        size_t result = 64;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<uint8_t[]> buffer_;
+
+    // Producer and consumer positions sit on separate cache lines; both only ever grow
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t pendingHead_ = 0;
+    uint64_t cachedTail_ = 0;
+    std::atomic<uint64_t> dropped_{0};
+
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    std::atomic<bool> closed_{false};
+};
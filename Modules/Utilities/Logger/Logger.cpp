@@ -1,142 +1,404 @@
 #include "Logger.h"
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <fstream>
 #include "CommonTypes.h"
+#include "ConsoleLogSink.h"
 
-std::atomic<bool> Logger::consoleCreated = false;
+namespace {
+    // Owns the calling thread's ring; the background thread frees it once the thread has exited and the ring is drained
+    struct ThreadRingHolder {
+        std::shared_ptr<LogRing> ring;
+
+        ~ThreadRingHolder() {
+            if (ring) {
+                ring->Close();
+            }
+        }
+    };
+
+    thread_local ThreadRingHolder threadRing;
+
+    constexpr std::chrono::milliseconds MinimumIdleWait{1};
+    constexpr std::chrono::milliseconds MaximumIdleWait{10};
+
+    constexpr std::string_view TruncatedMarker = " ... [truncated]";
+}
 
 Logger::Logger() : running(false), initialized(false), currentLogLevel(LogLevel::LOG_INFO) {
+    for (LogLevel level : {LogLevel::LOG_DEBUG, LogLevel::LOG_INFO, LogLevel::LOG_WARNING, LogLevel::LOG_ERROR}) {
+        plainFormatIds_[static_cast<size_t>(level)] = AddFormat("{}", level);
+    }
+    sinks_.push_back(std::make_shared<ConsoleLogSink>());
     Start();
 }
 
 Logger::~Logger() {
     Stop();
+    {
+        std::lock_guard<std::mutex> lock(sinksMutex_);
+        sinks_.clear();
+    }
+    std::lock_guard<std::mutex> lock(captureMutex_);
+    binaryCapture_.Close();
 }
 
 void Logger::Start() {
     if (!initialized.exchange(true)) {
         running.store(true);
 
-        CreateDetachedConsole();
-        DisableConsoleCloseButton();
-        SetConsoleTitleA("Trade System Logs");
-
-        // Redirect cout and cerr to the console
-        FILE* fp;
-        freopen_s(&fp, "CONOUT$", "w", stdout);
-        freopen_s(&fp, "CONOUT$", "w", stderr);
-
         // Start the dedicated thread for processing log messages
         processingThread_ = std::thread(&Logger::ProcessMessages, this);
     }
 }
 
 void Logger::Stop() {
-    running.store(false);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        running.store(false);
+    }
+    wakeCondition_.notify_all();
     if (processingThread_.joinable()) {
         processingThread_.join();
     }
+}
 
-    // Close the console if it was created by the logger
-    if (consoleCreated) {
-        FreeConsole();
+const char* Logger::LevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::LOG_DEBUG:
+            return "DEBUG";
+        case LogLevel::LOG_INFO:
+            return "INFO";
+        case LogLevel::LOG_WARNING:
+            return "WARNING";
+        case LogLevel::LOG_ERROR:
+            return "ERROR";
     }
+    return "UNKNOWN";
 }
 
-void Logger::LogMessage(const std::string& message, LogLevel level) {
-    if (!initialized.load()) {
-        Start();
+std::optional<Logger::LogLevel> Logger::ParseLevel(std::string_view name) {
+    std::string upper(name);
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    for (LogLevel level : {LogLevel::LOG_DEBUG, LogLevel::LOG_INFO, LogLevel::LOG_WARNING, LogLevel::LOG_ERROR}) {
+        if (upper == LevelName(level)) {
+            return level;
+        }
     }
+    return std::nullopt;
+}
 
-    LogEntry* entry = new LogEntry{message, level, DateTime()}; // Include timestamp
-    while (!messageQueue.push(entry)) {
-        // If the queue is full, you might want to add a backoff strategy here
+void Logger::SetLogLevel(LogLevel level) {
+    std::lock_guard<std::mutex> lock(modulesMutex_);
+    currentLogLevel.store(level, std::memory_order_relaxed);
+    for (LogModule& module : modules_) {
+        if (!module.hasOwnLevel) {
+            module.threshold.store(level, std::memory_order_relaxed);
+        }
     }
 }
 
-void Logger::ProcessMessages() {
-    LogEntry* entry;
-    while (running.load() || !messageQueue.empty()) {        
-        if (messageQueue.pop(entry)) {
-            std::lock_guard<std::mutex> lock(logMutex);
-            if (entry->level < currentLogLevel) {
-                delete entry;
-                continue;
-            }
+void Logger::SetModuleLevel(const std::string& module, LogLevel level) {
+    std::lock_guard<std::mutex> lock(modulesMutex_);
+    LogModule& entry = FindOrAddModule(module);
+    entry.hasOwnLevel = true;
+    entry.threshold.store(level, std::memory_order_relaxed);
+}
+
+void Logger::ResetModuleLevel(const std::string& module) {
+    std::lock_guard<std::mutex> lock(modulesMutex_);
+    LogModule& entry = FindOrAddModule(module);
+    entry.hasOwnLevel = false;
+    entry.threshold.store(currentLogLevel.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
 
-            std::string timestamp = entry->timestamp.ToString(); // Get timestamp string
-            std::string tradeSystem = GetTradeSystemName();
-
-            switch (entry->level) {
-                case LogLevel::LOG_INFO:
-                    std::cout << tradeSystem + ": " << timestamp << " INFO: " << entry->message << std::endl;
-                    break;
-                case LogLevel::LOG_WARNING:
-                    std::cout << tradeSystem + ": " << timestamp << " WARNING: " << entry->message << std::endl;
-                    break;
-                case LogLevel::LOG_ERROR:
-                    std::cerr << tradeSystem + ": " << timestamp << " ERROR: " << entry->message << std::endl;
-                    break;
+Logger::LogLevel Logger::GetModuleLevel(const std::string& module) const {
+    std::lock_guard<std::mutex> lock(modulesMutex_);
+    for (const LogModule& entry : modules_) {
+        if (entry.name == module) {
+            return entry.threshold.load(std::memory_order_relaxed);
+        }
+    }
+    return currentLogLevel.load(std::memory_order_relaxed);
+}
+
+bool Logger::ApplyLevelConfig(const nlohmann::json& config) {
+    std::optional<LogLevel> defaultLevel;
+    std::vector<std::pair<std::string, LogLevel>> moduleLevels;
+    try {
+        if (config.contains("level")) {
+            defaultLevel = ParseLevel(config.at("level").get<std::string>());
+            if (!defaultLevel) {
+                Log("Unknown log level in configuration: " + config.at("level").get<std::string>(), LogLevel::LOG_ERROR);
+                return false;
+            }
+        }
+        if (config.contains("modules")) {
+            for (const auto& [module, value] : config.at("modules").items()) {
+                std::optional<LogLevel> level = ParseLevel(value.get<std::string>());
+                if (!level) {
+                    Log("Unknown log level for module " + module + ": " + value.get<std::string>(), LogLevel::LOG_ERROR);
+                    return false;
+                }
+                moduleLevels.emplace_back(module, *level);
             }
-            delete entry;
-        } else {
-            // Prevent busy waiting
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
+    } catch (const nlohmann::json::exception& e) {
+        Log("Invalid log level configuration: " + std::string(e.what()), LogLevel::LOG_ERROR);
+        return false;
     }
 
-    // Ensure all remaining messages are processed before exiting
-    while (messageQueue.pop(entry)) {
-        std::lock_guard<std::mutex> lock(logMutex);
-        if (entry->level < currentLogLevel) {
-            delete entry;
-            continue;
+    if (defaultLevel) {
+        SetLogLevel(*defaultLevel);
+    }
+    for (const auto& [module, level] : moduleLevels) {
+        SetModuleLevel(module, level);
+    }
+    return true;
+}
+
+void Logger::AddSink(std::shared_ptr<ILogSink> sink) {
+    if (!sink) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sinksMutex_);
+    sinks_.push_back(std::move(sink));
+}
+
+void Logger::RemoveSink(const std::shared_ptr<ILogSink>& sink) {
+    std::lock_guard<std::mutex> lock(sinksMutex_);
+    auto it = std::find(sinks_.begin(), sinks_.end(), sink);
+    if (it != sinks_.end()) {
+        (*it)->Flush();
+        sinks_.erase(it);
+    }
+}
+
+void Logger::ClearSinks() {
+    std::lock_guard<std::mutex> lock(sinksMutex_);
+    for (const auto& sink : sinks_) {
+        sink->Flush();
+    }
+    sinks_.clear();
+}
+
+bool Logger::EnableBinaryCapture(const std::string& path) {
+    // Writes out what is already queued, so the capture starts with records logged after this call
+    Flush();
+    std::lock_guard<std::mutex> lock(captureMutex_);
+    return binaryCapture_.Open(path);
+}
+
+void Logger::DisableBinaryCapture() {
+    std::lock_guard<std::mutex> lock(captureMutex_);
+    binaryCapture_.Close();
+}
+
+void Logger::Flush() {
+    if (!running.load() || std::this_thread::get_id() == processingThread_.get_id()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    uint64_t request = ++flushRequested_;
+    wakeCondition_.notify_all();
+    wakeCondition_.wait(lock, [this, request] { return flushCompleted_ >= request || !running.load(); });
+}
+
+LogRing& Logger::ThreadRing() {
+    if (!threadRing.ring) {
+        threadRing.ring = std::make_shared<LogRing>(ThreadRingCapacity);
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        newRings_.push_back(threadRing.ring);
+        hasNewRings_.store(true, std::memory_order_release);
+    }
+    return *threadRing.ring;
+}
+
+void Logger::WriteTruncated(uint32_t formatId, const uint8_t* args, size_t argsSize) {
+    LogFormatInfo format;
+    {
+        std::lock_guard<std::mutex> lock(formatsMutex_);
+        if (formatId >= formats_.size()) {
+            return;
         }
+        format = formats_[formatId];
+    }
+
+    std::string text;
+    BinaryLog::AppendFormatted(text, format.format, args, argsSize);
+    size_t limit = ThreadRing().MaxRecordSize() - sizeof(BinaryLog::RecordHeader) - BinaryLog::EncodedSizeOf(std::string_view());
+    if (text.size() > limit) {
+        text.resize(limit - TruncatedMarker.size());
+        text += TruncatedMarker;
+    }
+    Write(plainFormatIds_[static_cast<size_t>(format.level)], text);
+}
+
+uint32_t Logger::AddFormat(const std::string& format, LogLevel level) {
+    std::lock_guard<std::mutex> lock(formatsMutex_);
+    formats_.push_back(LogFormatInfo{format, level});
+    return static_cast<uint32_t>(formats_.size() - 1);
+}
 
-        std::string timestamp = entry->timestamp.ToString(); // Get timestamp string
+const std::atomic<Logger::LogLevel>* Logger::RegisterSite(LogSite& site) {
+    std::lock_guard<std::mutex> lock(modulesMutex_);
+    const std::atomic<LogLevel>* threshold = site.threshold_.load(std::memory_order_relaxed);
+    if (threshold != nullptr) {
+        return threshold; // another thread registered it first
+    }
+    site.formatId_.store(AddFormat(site.format_, site.level_), std::memory_order_relaxed);
+    threshold = &FindOrAddModule(ModuleFromPath(site.file_)).threshold;
+    // Publishes formatId_ to threads that see the threshold
+    site.threshold_.store(threshold, std::memory_order_release);
+    return threshold;
+}
 
-        switch (entry->level) {
-            case LogLevel::LOG_INFO:
-                std::cout << timestamp << " INFO: " << entry->message << std::endl;
-                break;
-            case LogLevel::LOG_WARNING:
-                std::cout << timestamp << " WARNING: " << entry->message << std::endl;
-                break;
-            case LogLevel::LOG_ERROR:
-                std::cerr << timestamp << " ERROR: " << entry->message << std::endl;
-                break;
+Logger::LogModule& Logger::FindOrAddModule(const std::string& name) {
+    for (LogModule& module : modules_) {
+        if (module.name == name) {
+            return module;
         }
-        delete entry;
     }
+    return modules_.emplace_back(name, currentLogLevel.load(std::memory_order_relaxed));
 }
 
-void Logger::CreateDetachedConsole() {
-    // Create a detached console window
-    if (!AllocConsole()) {
-        if (GetLastError() == ERROR_ACCESS_DENIED) {
-            AttachConsole(ATTACH_PARENT_PROCESS);
+std::string Logger::ModuleFromPath(std::string_view path) {
+    size_t fileStart = path.find_last_of("/\\");
+    if (fileStart == std::string_view::npos) {
+        // No directory in __FILE__; fall back to the file name without its extension
+        return std::string(path.substr(0, path.find('.')));
+    }
+    std::string_view directory = path.substr(0, fileStart);
+    size_t directoryStart = directory.find_last_of("/\\");
+    return std::string(directoryStart == std::string_view::npos ? directory : directory.substr(directoryStart + 1));
+}
+
+void Logger::FlushOutputs() {
+    {
+        std::lock_guard<std::mutex> lock(sinksMutex_);
+        for (const auto& sink : sinks_) {
+            sink->Flush();
         }
-    } else {
-        consoleCreated = true;
     }
+    std::lock_guard<std::mutex> lock(captureMutex_);
+    binaryCapture_.Flush();
+}
+
+void Logger::ProcessMessages() {
+    auto idleWait = MinimumIdleWait;
+    while (true) {
+        uint64_t flushTarget;
+        bool flushPending;
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            flushTarget = flushRequested_;
+            flushPending = flushRequested_ != flushCompleted_;
+        }
+        bool stopping = !running.load();
+
+        // One pass drains everything committed before it started, which is what a pending Flush waits for
+        size_t processed = DrainRings();
+
+        // Sinks flush on their own thresholds from Poll; everything is flushed for a Flush call and at shutdown
+        if (flushPending || (stopping && processed == 0)) {
+            FlushOutputs();
+        } else if (processed == 0) {
+            std::lock_guard<std::mutex> lock(captureMutex_);
+            binaryCapture_.Flush();
+        }
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            flushCompleted_ = flushTarget;
+        }
+        wakeCondition_.notify_all();
 
-    // Set console close handler
-    SetConsoleCtrlHandler([](DWORD event) -> BOOL {
-        if (event == CTRL_CLOSE_EVENT) {
-            // Ignore the close event to keep the application running
-            FreeConsole();
-            return TRUE;
+        if (processed > 0) {
+            idleWait = MinimumIdleWait;
+            continue;
         }
-        return FALSE;
-    }, TRUE);
+        if (stopping) {
+            break;
+        }
+
+        // Producers never signal, so the hot path stays free of syscalls; the wait backs off while the logger is idle
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeCondition_.wait_for(lock, idleWait, [this] { return flushRequested_ != flushCompleted_ || !running.load(); });
+        idleWait = std::min(idleWait * 2, MaximumIdleWait);
+    }
 }
 
-void Logger::DisableConsoleCloseButton() {
-    HWND hwnd = GetConsoleWindow();
-    if (hwnd != NULL) {
-        HMENU hMenu = GetSystemMenu(hwnd, FALSE);
-        if (hMenu != NULL) {
-            DeleteMenu(hMenu, SC_CLOSE, MF_BYCOMMAND);
+size_t Logger::DrainRings() {
+    if (hasNewRings_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings_.insert(rings_.end(), newRings_.begin(), newRings_.end());
+        newRings_.clear();
+        hasNewRings_.store(false, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> sinksLock(sinksMutex_);
+    size_t processed = 0;
+    bool hasClosedRings = false;
+    for (const auto& ring : rings_) {
+        hasClosedRings = hasClosedRings || ring->IsClosed();
+        processed += ring->Drain([this](const uint8_t* record, size_t size) { HandleRecord(record, size); });
+
+        uint64_t dropped = ring->TakeDroppedCount();
+        if (dropped > 0) {
+            droppedCount_.fetch_add(dropped, std::memory_order_relaxed);
+            std::cerr << "Logger: " << dropped << " log messages dropped because a thread's log buffer was full\n";
         }
     }
+
+    if (hasClosedRings) {
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+            [](const std::shared_ptr<LogRing>& ring) { return ring->IsClosed() && ring->Empty(); }), rings_.end());
+    }
+    if (processed > 0) {
+        // Looked up once per batch rather than per message
+        tradeSystemName_.clear();
+    }
+    for (const auto& sink : sinks_) {
+        sink->Poll();
+    }
+    return processed;
+}
+
+void Logger::HandleRecord(const uint8_t* record, size_t size) {
+    BinaryLog::RecordHeader header;
+    std::memcpy(&header, record, sizeof(header));
+
+    if (header.formatId >= formatCache_.size()) {
+        std::lock_guard<std::mutex> lock(formatsMutex_);
+        formatCache_.insert(formatCache_.end(), formats_.begin() + formatCache_.size(), formats_.end());
+    }
+    if (header.formatId >= formatCache_.size()) {
+        return;
+    }
+    const LogFormatInfo& format = formatCache_[header.formatId];
+
+    {
+        std::lock_guard<std::mutex> lock(captureMutex_);
+        if (binaryCapture_.IsOpen()) {
+            binaryCapture_.Write(record, size, format.format, static_cast<int>(format.level));
+        }
+    }
+
+    if (tradeSystemName_.empty()) {
+        tradeSystemName_ = GetTradeSystemName();
+    }
+
+    line_.clear();
+    line_ += tradeSystemName_;
+    line_ += ": ";
+    line_ += timestampFormatter_.Format(header.timestampNs);
+    line_ += ' ';
+    line_ += LevelName(format.level);
+    line_ += ": ";
+    BinaryLog::AppendFormatted(line_, format.format, record + sizeof(header), size - sizeof(header));
+    line_ += '\n';
+
+    for (const auto& sink : sinks_) {
+        sink->Write(format.level, header.timestampNs, line_);
+    }
 }
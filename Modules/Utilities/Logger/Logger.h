@@ -1,29 +1,149 @@
 #pragma once
 #include <string>
 #include <atomic>
-#include <boost/lockfree/queue.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <Windows.h>
+#include <optional>
+#include <string_view>
 #include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "BinaryLog.h"
+#include "LogRing.h"
 #include "CommonTypes.h" // Include the DateTime structure
 
+class ILogSink;
+
+// Lowest level compiled into the LOG_* macros: 0 debug, 1 info, 2 warning, 3 error.
+// Release builds drop debug and info call sites entirely unless the build overrides it.
+#ifndef LOGGER_MIN_LEVEL
+#ifdef NDEBUG
+#define LOGGER_MIN_LEVEL 2
+#else
+#define LOGGER_MIN_LEVEL 0
+#endif
+#endif
+
+// Asynchronous logger. Callers copy a format id and raw arguments into a ring owned by their thread; timestamps,
+// formatting and output happen on the logger's background thread. Records keep their order within a thread.
+// Formatted lines go to the installed sinks, a ConsoleLogSink by default.
 class Logger {
 public:
     enum class LogLevel {
+        LOG_DEBUG,
         LOG_INFO,
         LOG_WARNING,
         LOG_ERROR
     };
 
+    // Bytes of ring buffer per logging thread; records that do not fit while the ring is full are dropped and counted.
+    // A single record larger than half of it is truncated instead.
+    static constexpr size_t ThreadRingCapacity = 64 * 1024;
+
+    // State of one LOG_* call site. It is constant-initialized, so checking it costs no static guard; the first check
+    // registers its format and resolves its module's threshold, before any argument is evaluated.
+    class LogSite {
+    public:
+        static constexpr uint32_t Unregistered = UINT32_MAX;
+
+        constexpr LogSite(const char* file, const char* format, LogLevel level)
+            : file_(file), format_(format), level_(level) {}
+
+        LogSite(const LogSite&) = delete;
+        LogSite& operator=(const LogSite&) = delete;
+
+        bool IsEnabled() {
+            const std::atomic<LogLevel>* threshold = threshold_.load(std::memory_order_acquire);
+            if (threshold == nullptr) {
+                threshold = Instance().RegisterSite(*this);
+            }
+            return level_ >= threshold->load(std::memory_order_relaxed);
+        }
+
+    private:
+        friend class Logger;
+
+        const char* file_;
+        const char* format_;
+        LogLevel level_;
+        std::atomic<const std::atomic<LogLevel>*> threshold_{nullptr};
+        std::atomic<uint32_t> formatId_{Unregistered};
+    };
+
     static Logger& Instance() {
         static Logger instance;
         return instance;
     }
 
     static void Log(const std::string& message, LogLevel level) {
-        Instance().LogMessage(message, level);
+        Logger& logger = Instance();
+        if (logger.IsEnabled(level)) {
+            logger.Write(logger.plainFormatIds_[static_cast<size_t>(level)], message);
+        }
     }
 
+    // Registers a format string whose "{}" placeholders are filled from the arguments of LogFormat.
+    // Call sites register once and keep the id, e.g. in a function-local static.
+    static uint32_t RegisterFormat(const char* format, LogLevel level) {
+        return Instance().AddFormat(format, level);
+    }
+
+    // Logs a registered format. Arguments are copied in binary form: numbers, enums, bools, chars and strings;
+    // other types with ToString() are converted on the calling thread.
+    template <typename... Args>
+    static void LogFormat(uint32_t formatId, LogLevel level, const Args&... args) {
+        Logger& logger = Instance();
+        if (!logger.IsEnabled(level)) {
+            return;
+        }
+        logger.Write(formatId, BinaryLog::Capture(args)...);
+    }
+
+    // Logs through a call site of the LOG_* macros, which have already checked site.IsEnabled() and so registered it.
+    template <typename... Args>
+    static void LogAt(LogSite& site, const Args&... args) {
+        Instance().Write(site.formatId_.load(std::memory_order_relaxed), BinaryLog::Capture(args)...);
+    }
+
+    bool IsEnabled(LogLevel level) const {
+        return level >= currentLogLevel.load(std::memory_order_relaxed);
+    }
+
+    // Sets the default level, which applies to Log, LogFormat and every module without a level of its own.
+    void SetLogLevel(LogLevel level);
+
+    // Modules are named after the directory of the source file holding the LOG_* call, e.g. "Networking".
+    void SetModuleLevel(const std::string& module, LogLevel level);
+    void ResetModuleLevel(const std::string& module);
+    LogLevel GetModuleLevel(const std::string& module) const;
+
+    // Applies {"level": "INFO", "modules": {"Networking": "DEBUG"}}; both keys are optional.
+    // Returns false, leaving the levels untouched, if a level name is not recognized.
+    bool ApplyLevelConfig(const nlohmann::json& config);
+
+    static std::optional<LogLevel> ParseLevel(std::string_view name);
+
+    // Sinks receive every line from the background thread. Removing a sink flushes it; it is not called afterwards.
+    void AddSink(std::shared_ptr<ILogSink> sink);
+    void RemoveSink(const std::shared_ptr<ILogSink>& sink);
+    void ClearSinks();
+
+    // Also writes every record logged from now on, unformatted, to a binary file that BinaryLog::BinaryLogReader can
+    // decode offline. Records still queued when it is called are output first and are not captured.
+    bool EnableBinaryCapture(const std::string& path);
+    void DisableBinaryCapture();
+
+    // Blocks until every record logged before the call has been written and the sinks have been flushed.
+    void Flush();
+
+    uint64_t GetDroppedCount() const { return droppedCount_.load(std::memory_order_relaxed); }
+
+    static const char* LevelName(LogLevel level);
+
     ~Logger();
 
 private:
@@ -31,28 +151,111 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    struct LogEntry {
-        std::string message;
+    struct LogFormatInfo {
+        std::string format;
         LogLevel level;
-        DateTime timestamp; // Add timestamp to log entry
     };
 
-    void LogMessage(const std::string& message, LogLevel level);
+    struct LogModule {
+        LogModule(std::string moduleName, LogLevel level) : name(std::move(moduleName)), threshold(level) {}
+
+        std::string name;
+        std::atomic<LogLevel> threshold;
+        bool hasOwnLevel = false;
+    };
+
+    // Callers check the level; records reaching Write are always output.
+    template <typename... Args>
+    void Write(uint32_t formatId, const Args&... args) {
+        size_t size = sizeof(BinaryLog::RecordHeader) + BinaryLog::EncodedSize(args...);
+        LogRing& ring = ThreadRing();
+        if (size > ring.MaxRecordSize()) {
+            std::vector<uint8_t> encoded(size - sizeof(BinaryLog::RecordHeader));
+            BinaryLog::Encode(encoded.data(), args...);
+            WriteTruncated(formatId, encoded.data(), encoded.size());
+            return;
+        }
+        uint8_t* record = ring.Reserve(size);
+        if (record == nullptr) {
+            return;
+        }
+        BinaryLog::RecordHeader header{static_cast<uint32_t>(size), formatId, NowNanoseconds()};
+        std::memcpy(record, &header, sizeof(header));
+        BinaryLog::Encode(record + sizeof(header), args...);
+        ring.Commit();
+    }
+
+    // A record too large for the ring is formatted here and logged as plain text, cut to fit and marked as truncated.
+    void WriteTruncated(uint32_t formatId, const uint8_t* args, size_t argsSize);
+
+    static int64_t NowNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    LogRing& ThreadRing();
+    uint32_t AddFormat(const std::string& format, LogLevel level);
+    const std::atomic<LogLevel>* RegisterSite(LogSite& site);
+    LogModule& FindOrAddModule(const std::string& name);
+    static std::string ModuleFromPath(std::string_view path);
+    size_t DrainRings();
+    void HandleRecord(const uint8_t* record, size_t size);
+    void FlushOutputs();
     void ProcessMessages();
     void Start();
     void Stop();
-    void CreateDetachedConsole();
-    void DisableConsoleCloseButton();
 
-    boost::lockfree::queue<LogEntry*> messageQueue{1024};
     std::atomic<bool> running;
     std::atomic<bool> initialized;
-    std::mutex logMutex;
-    LogLevel currentLogLevel;
+    std::atomic<LogLevel> currentLogLevel;
+    std::atomic<uint64_t> droppedCount_{0};
+
+    // Rings created by producer threads, handed to the background thread on its next pass
+    std::mutex ringsMutex_;
+    std::vector<std::shared_ptr<LogRing>> newRings_;
+    std::atomic<bool> hasNewRings_{false};
+    std::vector<std::shared_ptr<LogRing>> rings_; // background thread only
 
-    HWND hwndConsole;
-    static std::atomic<bool> consoleCreated;
+    std::mutex formatsMutex_;
+    std::vector<LogFormatInfo> formats_;
+    std::vector<LogFormatInfo> formatCache_; // background thread's copy of formats_
+    uint32_t plainFormatIds_[4] = {};
+
+    // Entries are never removed, so call sites keep pointers to their module's threshold
+    mutable std::mutex modulesMutex_;
+    std::deque<LogModule> modules_;
+
+    // Background thread state
+    std::string line_;
+    std::string tradeSystemName_;
+    BinaryLog::TimestampFormatter timestampFormatter_;
+    std::mutex captureMutex_;
+    BinaryLog::BinaryLogWriter binaryCapture_;
+
+    // Held by the background thread for each pass, so sinks are never called concurrently or after removal
+    std::mutex sinksMutex_;
+    std::vector<std::shared_ptr<ILogSink>> sinks_;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+    uint64_t flushRequested_ = 0;
+    uint64_t flushCompleted_ = 0;
 
     std::thread processingThread_;
 };
 
+#define LOGGER_LOG_AT(level, format, ...)                                                       \
+    do {                                                                                        \
+        if constexpr (static_cast<int>(level) >= LOGGER_MIN_LEVEL) {                           \
+            static Logger::LogSite loggerSite(__FILE__, format, level);                        \
+            if (loggerSite.IsEnabled()) {                                                      \
+                Logger::LogAt(loggerSite, ##__VA_ARGS__);                                      \
+            }                                                                                  \
+        }                                                                                      \
+    } while (0)
+
+// Arguments are evaluated only when the call site's module is enabled at that level; below LOGGER_MIN_LEVEL the call
+// is not compiled at all. The format string must be a literal with a "{}" per argument, as for RegisterFormat.
+#define LOG_DEBUG(format, ...) LOGGER_LOG_AT(Logger::LogLevel::LOG_DEBUG, format, ##__VA_ARGS__)
+#define LOG_INFO(format, ...) LOGGER_LOG_AT(Logger::LogLevel::LOG_INFO, format, ##__VA_ARGS__)
+#define LOG_WARNING(format, ...) LOGGER_LOG_AT(Logger::LogLevel::LOG_WARNING, format, ##__VA_ARGS__)
+#define LOG_ERROR(format, ...) LOGGER_LOG_AT(Logger::LogLevel::LOG_ERROR, format, ##__VA_ARGS__)
@@ -1,13 +1,12 @@
 #include "HttpClient.h"
 #include "Logger.h"
-#include "ThreadPool.h"
-#include "CommonTypes.h"
-#include "ParameterManager.h"
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/beast/version.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/ip/tcp.hpp>
-#include <boost/asio/strand.hpp>
+#include <algorithm>
 #include <future>
 
 
@@ -16,91 +15,418 @@ namespace http = beast::http;
 namespace net = boost::asio;
 using tcp = net::ip::tcp;
 
-HttpClient::HttpClient()
-    : running_(true),
-      processingThread_(&HttpClient::ProcessRequests, this) {}
+namespace {
+    // Requests the server may receive twice without a different outcome (RFC 9110, section 9.2.2)
+    bool IsIdempotent(http::verb method) {
+        switch (method) {
+        case http::verb::get:
+        case http::verb::head:
+        case http::verb::put:
+        case http::verb::delete_:
+        case http::verb::options:
+        case http::verb::trace:
+            return true;
+        default:
+            return false;
+        }
+    }
 
-HttpClient::~HttpClient() {
-    running_ = false;
+    // True if the peer closed an idle connection (or sent something unasked), so nothing should be written to it
+    bool PeerClosed(tcp::socket& socket) {
+        beast::error_code ec;
+        char byte;
+        bool wasNonBlocking = socket.non_blocking();
+        socket.non_blocking(true, ec);
+        socket.receive(net::buffer(&byte, 1), tcp::socket::message_peek, ec);
+        beast::error_code ignored;
+        socket.non_blocking(wasNonBlocking, ignored);
+        return ec != net::error::would_block;
+    }
+}
+
+struct HttpRequestHandle::State {
+    State(HttpClient* client, net::io_context& ioc) : client(client), timer(ioc) {}
+
+    HttpClient* client;
+    HttpRequest request;
+    std::function<void(HttpResponse)> callback;
+    net::steady_timer timer;
+    std::weak_ptr<HttpClient::Connection> connection; // set once handed to a connection
+    bool retried = false;
+    bool writeStarted = false;                        // some of it may have reached the server
+    bool completed = false;                           // io thread only
+    std::atomic<bool> done{false};                    // mirrors completed for other threads
+};
+
+struct HttpClient::Connection {
+    explicit Connection(net::io_context& ioc) : stream(ioc) {}
+
+    beast::tcp_stream stream;
+    beast::flat_buffer buffer;
+    std::deque<std::shared_ptr<PendingRequest>> inFlight; // in the order they were (or will be) written
+    size_t written = 0;                                   // leading entries of inFlight already written
+    http::request<http::string_body> request;
+    http::response<http::string_body> response;
+    bool connected = false;
+    bool writing = false;
+    bool reading = false;
+    bool reused = false;                                  // has delivered a response
+    bool closed = false;
+    std::chrono::steady_clock::time_point lastUsed;
+};
+
+void HttpRequestHandle::Cancel() {
+    auto state = state_.lock();
+    if (!state || state->done.load()) {
+        return;
+    }
+    HttpClient* client = state->client;
+    net::post(state->timer.get_executor(), [client, state]() {
+        client->Abort(state, "Cancelled");
+        client->Pump();
+    });
+}
 
-    // Optionally push a dummy request to unblock the Pop in ProcessRequests
-    requestQueue_.Push(std::make_tuple("", "", nullptr, http::verb::get));
+bool HttpRequestHandle::IsDone() const {
+    auto state = state_.lock();
+    return !state || state->done.load();
+}
+
+HttpClient::HttpClient(HttpClientConfig config)
+    : config_(std::move(config)), work_(net::make_work_guard(ioc_)), resolver_(ioc_), shutdownTimer_(ioc_) {
+    config_.maxConnections = std::max<size_t>(config_.maxConnections, 1);
+    config_.maxPipelineDepth = std::max<size_t>(config_.maxPipelineDepth, 1);
+    ioThread_ = std::thread([this]() { ioc_.run(); });
+}
 
-    if (processingThread_.joinable()) {
-        processingThread_.join();
+HttpClient::~HttpClient() {
+    net::post(ioc_, [this]() {
+        stopping_ = true;
+        shutdownTimer_.expires_after(config_.shutdownTimeout);
+        shutdownTimer_.async_wait([this](beast::error_code ec) {
+            if (ec) {
+                return; // everything finished first
+            }
+            std::vector<std::shared_ptr<PendingRequest>> outstanding(queue_.begin(), queue_.end());
+            for (const auto& connection : connections_) {
+                outstanding.insert(outstanding.end(), connection->inFlight.begin(), connection->inFlight.end());
+            }
+            for (const auto& request : outstanding) {
+                Abort(request, "Shutdown: no response within " + std::to_string(config_.shutdownTimeout.count()) + " ms");
+            }
+            Pump();
+        });
+        FinishIfStopping();
+    });
+    if (ioThread_.joinable()) {
+        ioThread_.join();
     }
 }
 
-void HttpClient::SendRequest(const std::string& url, const std::string& body, const std::function<void(HttpResponse)>& callback, 
-                             http::verb method, std::promise<HttpResponse>* promise) {
-    requestQueue_.Push(std::make_tuple(url, body, [callback, promise](HttpResponse response) {
+HttpRequestHandle HttpClient::Send(HttpRequest request, std::function<void(HttpResponse)> callback) {
+    auto state = std::make_shared<PendingRequest>(this, ioc_);
+    state->request = std::move(request);
+    state->callback = std::move(callback);
+    HttpRequestHandle handle(state);
+    net::post(ioc_, [this, state]() { Enqueue(state); });
+    return handle;
+}
+
+std::future<HttpResponse> HttpClient::Send(HttpRequest request) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    auto future = promise->get_future();
+    Send(std::move(request), [promise](HttpResponse response) { promise->set_value(std::move(response)); });
+    return future;
+}
+
+HttpRequestHandle HttpClient::SendRequest(const std::string& url, const std::string& body, const std::function<void(HttpResponse)>& callback,
+                                          http::verb method, std::promise<HttpResponse>* promise) {
+    HttpRequest request;
+    request.url = url;
+    request.body = body;
+    request.method = method;
+    return Send(std::move(request), [callback, promise](HttpResponse response) {
         if (callback) {
             callback(response);
         }
         if (promise) {
             promise->set_value(response);
         }
-    }, method));
+    });
 }
 
-void HttpClient::ProcessRequests() {
-    while (running_ || !requestQueue_.Empty()) {
-        std::tuple<std::string, std::string, std::function<void(HttpResponse)>, http::verb> request;
-
-        // Try to pop a request, but return immediately if running_ is false and the queue is empty
-        if (!requestQueue_.Pop(request)) {
-            if (!running_) {
-                break;
+void HttpClient::Enqueue(const std::shared_ptr<PendingRequest>& request) {
+    auto timeout = request->request.timeout.count() > 0 ? request->request.timeout : config_.requestTimeout;
+    if (timeout.count() > 0) {
+        request->timer.expires_after(timeout);
+        request->timer.async_wait([this, request, timeout](beast::error_code ec) {
+            if (ec) {
+                return; // completed first
             }
+            Abort(request, "Timeout: no response within " + std::to_string(timeout.count()) + " ms");
+            Pump();
+        });
+    }
+    queue_.push_back(request);
+    Pump();
+}
+
+void HttpClient::Pump() {
+    while (!queue_.empty()) {
+        auto request = queue_.front();
+        if (request->completed) {
+            queue_.pop_front();
             continue;
         }
+        auto connection = PickConnection();
+        if (!connection) {
+            break;
+        }
+        queue_.pop_front();
+        request->connection = connection;
+        connection->inFlight.push_back(request);
+        if (connection->connected) {
+            StartWrite(connection);
+        }
+    }
+    FinishIfStopping();
+}
 
-        auto [url, body, callback, method] = request;
-        if (url.empty()) {
-            continue; // Ignore dummy request
-        }
-
-        ThreadPool::Instance().Enqueue([url, body, callback, method] {
-            try {
-                net::io_context ioc;
-                tcp::resolver resolver(ioc);                     
-
-                auto defaultServerInfo = DataProcessingServer();
-                defaultServerInfo.host = "localhost";
-                defaultServerInfo.port = 5000;
-
-                auto serverInfoValue = defaultServerInfo;            
-                auto endpoints = resolver.resolve(serverInfoValue.host, std::to_string(serverInfoValue.port));
-                beast::tcp_stream stream(ioc);
-                stream.connect(endpoints);
-
-                // Set up HTTP request
-                http::request<http::string_body> req{method, url, 11};
-                req.set(http::field::host, "localhost");
-                if (method == http::verb::post) {
-                    req.set(http::field::content_type, "application/json");
-                    req.body() = body;
-                    req.prepare_payload();
-                }
-
-                // Send HTTP request
-                http::write(stream, req);
-
-                // Read HTTP response
-                beast::flat_buffer buffer;
-                http::response<http::string_body> res;
-                http::read(stream, buffer, res);
-
-                if (res.result() == http::status::ok) {
-                    callback(HttpResponse{res.body(), true});
-                } else {
-                    std::string errorMessage = "Error: Received response with status " + std::to_string(res.result_int()) + ", message: " + res.body();
-                    callback(HttpResponse{errorMessage, false});
-                }
-            } catch (const std::exception& e) {
-                Logger::Log("Error sending HTTP request: " + std::string(e.what()), Logger::LogLevel::LOG_ERROR);
-                callback(HttpResponse{"Exception: " + std::string(e.what()), false});
+std::shared_ptr<HttpClient::Connection> HttpClient::PickConnection() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<Connection>> stale;
+    for (const auto& connection : connections_) {
+        if (connection->connected && connection->inFlight.empty()
+            && (now - connection->lastUsed > config_.idleTimeout || PeerClosed(connection->stream.socket()))) {
+            stale.push_back(connection);
+        }
+    }
+    for (const auto& connection : stale) {
+        Drop(connection, "");
+    }
+
+    std::shared_ptr<Connection> leastBusy;
+    for (const auto& connection : connections_) {
+        if (connection->inFlight.size() < config_.maxPipelineDepth
+            && (!leastBusy || connection->inFlight.size() < leastBusy->inFlight.size())) {
+            leastBusy = connection;
+        }
+    }
+
+    // An idle connection first, then a new one, and only then pipelining behind another request
+    if (leastBusy && leastBusy->inFlight.empty()) {
+        return leastBusy;
+    }
+    if (connections_.size() < config_.maxConnections) {
+        return OpenConnection();
+    }
+    return leastBusy;
+}
+
+std::shared_ptr<HttpClient::Connection> HttpClient::OpenConnection() {
+    auto connection = std::make_shared<Connection>(ioc_);
+    connections_.push_back(connection);
+    openedConnections_.fetch_add(1, std::memory_order_relaxed);
+
+    auto now = std::chrono::steady_clock::now();
+    if (!resolved_.empty() && now - resolvedAt_ <= config_.resolveCacheDuration) {
+        Connect(connection, resolved_);
+        return connection;
+    }
+    resolver_.async_resolve(config_.host, std::to_string(config_.port),
+        [this, connection](beast::error_code ec, tcp::resolver::results_type results) {
+            if (connection->closed) {
+                return;
+            }
+            if (ec) {
+                Drop(connection, ec.message());
+                Pump();
+                return;
             }
+            resolved_ = results;
+            resolvedAt_ = std::chrono::steady_clock::now();
+            Connect(connection, results);
         });
+    return connection;
+}
+
+void HttpClient::Connect(const std::shared_ptr<Connection>& connection, const tcp::resolver::results_type& endpoints) {
+    connection->stream.async_connect(endpoints, [this, connection](beast::error_code ec, const tcp::endpoint&) {
+        if (connection->closed) {
+            return;
+        }
+        if (ec) {
+            resolved_ = tcp::resolver::results_type();
+            Drop(connection, ec.message());
+            Pump();
+            return;
+        }
+        connection->connected = true;
+        connection->lastUsed = std::chrono::steady_clock::now();
+        connection->stream.socket().set_option(tcp::no_delay(true), ec);
+        StartWrite(connection);
+    });
+}
+
+void HttpClient::StartWrite(const std::shared_ptr<Connection>& connection) {
+    if (connection->writing || connection->closed || connection->written >= connection->inFlight.size()) {
+        return;
+    }
+    const HttpRequest& request = connection->inFlight[connection->written]->request;
+    connection->request = http::request<http::string_body>{request.method, request.url, 11};
+    connection->request.set(http::field::host, config_.host + ":" + std::to_string(config_.port));
+    connection->request.set(http::field::accept, AcceptHeaderFor(config_.format));
+    connection->request.keep_alive(true);
+    if (request.method == http::verb::post || !request.body.empty()) {
+        connection->request.set(http::field::content_type, request.contentType.empty() ? ContentTypeOf(WireFormat::Json) : request.contentType);
+        connection->request.body() = request.body;
+    }
+    connection->request.prepare_payload();
+
+    connection->inFlight[connection->written]->writeStarted = true;
+    connection->writing = true;
+    http::async_write(connection->stream, connection->request, [this, connection](beast::error_code ec, size_t) {
+        connection->writing = false;
+        if (connection->closed) {
+            return;
+        }
+        if (ec) {
+            Drop(connection, ec.message());
+            Pump();
+            return;
+        }
+        ++connection->written;
+        StartRead(connection);
+        StartWrite(connection);
+    });
+}
+
+void HttpClient::StartRead(const std::shared_ptr<Connection>& connection) {
+    if (connection->reading || connection->closed || connection->written == 0) {
+        return;
+    }
+    connection->response = {};
+    connection->reading = true;
+    http::async_read(connection->stream, connection->buffer, connection->response, [this, connection](beast::error_code ec, size_t) {
+        connection->reading = false;
+        if (connection->closed) {
+            return;
+        }
+        if (ec) {
+            Drop(connection, ec.message());
+            Pump();
+            return;
+        }
+
+        auto request = connection->inFlight.front();
+        connection->inFlight.pop_front();
+        --connection->written;
+        connection->reused = true;
+        connection->lastUsed = std::chrono::steady_clock::now();
+
+        auto& res = connection->response;
+        bool keepAlive = res.keep_alive();
+        if (res.result() == http::status::ok) {
+            HttpResponse response{std::move(res.body()), true, static_cast<int>(res.result_int())};
+            response.contentType = std::string(res[http::field::content_type]);
+            Complete(request, std::move(response));
+        } else {
+            std::string errorMessage = "Error: Received response with status " + std::to_string(res.result_int()) + ", message: " + res.body();
+            Complete(request, HttpResponse{errorMessage, false, static_cast<int>(res.result_int())});
+        }
+
+        // The server will not answer the rest on this connection; they go out again on a new one
+        if (!keepAlive) {
+            Drop(connection, "");
+        } else {
+            StartRead(connection);
+        }
+        Pump();
+    });
+}
+
+void HttpClient::Drop(const std::shared_ptr<Connection>& connection, const std::string& error) {
+    if (connection->closed) {
+        return;
+    }
+    connection->closed = true;
+    beast::error_code ec;
+    connection->stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+    connection->stream.close();
+    connections_.erase(std::remove(connections_.begin(), connections_.end(), connection), connections_.end());
+
+    if (!error.empty()) {
+        LOG_ERROR("Error sending HTTP request: {}", error);
+    }
+
+    // Unanswered requests go back to the front of the queue, in order, when the connection was closed on purpose or
+    // when a kept-alive connection failed (the server may have closed it while idle); otherwise they fail.
+    // One the server may already have acted on is only sent again if repeating it is harmless.
+    for (auto it = connection->inFlight.rbegin(); it != connection->inFlight.rend(); ++it) {
+        const auto& request = *it;
+        if (request->completed) {
+            continue;
+        }
+        bool safeToResend = !request->writeStarted || IsIdempotent(request->request.method);
+        if (!safeToResend) {
+            Complete(request, HttpResponse{"Exception: connection closed before the response arrived" + (error.empty() ? std::string() : ": " + error), false});
+        } else if (error.empty()) {
+            queue_.push_front(request);
+        } else if (connection->reused && !request->retried) {
+            request->retried = true;
+            queue_.push_front(request);
+        } else {
+            Complete(request, HttpResponse{"Exception: " + error, false});
+        }
+    }
+    connection->inFlight.clear();
+    connection->written = 0;
+}
+
+void HttpClient::Abort(const std::shared_ptr<PendingRequest>& request, const std::string& reason) {
+    if (request->completed) {
+        return;
+    }
+    Complete(request, HttpResponse{reason, false});
+
+    // Later responses on the connection would no longer line up with their requests
+    auto connection = request->connection.lock();
+    if (connection && std::find(connection->inFlight.begin(), connection->inFlight.end(), request) != connection->inFlight.end()) {
+        Drop(connection, "");
+    }
+}
+
+void HttpClient::Complete(const std::shared_ptr<PendingRequest>& request, HttpResponse response) {
+    if (request->completed) {
+        return;
+    }
+    request->completed = true;
+    request->done.store(true);
+    request->timer.cancel();
+    if (!request->callback) {
+        return;
+    }
+    try {
+        request->callback(std::move(response));
+    } catch (const std::exception& e) {
+        LOG_ERROR("HTTP response callback threw: {}", e.what());
+    }
+}
+
+void HttpClient::FinishIfStopping() {
+    if (!stopping_ || !queue_.empty()) {
+        return;
+    }
+    for (const auto& connection : connections_) {
+        if (!connection->inFlight.empty()) {
+            return;
+        }
+    }
+    while (!connections_.empty()) {
+        auto connection = connections_.back();
+        Drop(connection, "");
     }
+    resolver_.cancel();
+    shutdownTimer_.cancel();
+    work_.reset();
 }
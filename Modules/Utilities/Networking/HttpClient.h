@@ -1,37 +1,132 @@
 #pragma once
 
 #include <string>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <atomic>
-#include "ThreadSafeQueue.h"
+#include <vector>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <future>
+#include "WireFormat.h"
 
 
 class HttpResponse {
 public:
     std::string content;
     bool success;
-    HttpResponse(std::string c, bool s) : content(c), success(s) {}
+    int status;    // HTTP status code; 0 if no response arrived
+    std::string contentType;
+    HttpResponse(std::string c, bool s, int st = 0) : content(c), success(s), status(st) {}
 };
 
+struct HttpClientConfig {
+    std::string host = "localhost";
+    int port = 5000;
+    size_t maxConnections = 8;                        // kept-alive connections open at once
+    size_t maxPipelineDepth = 1;                      // requests written ahead of their responses on one connection
+    std::chrono::milliseconds idleTimeout{4000};      // reconnect rather than reuse a connection idle this long
+    std::chrono::milliseconds requestTimeout{30000};  // default for requests that do not set one; 0 waits forever
+    std::chrono::milliseconds shutdownTimeout{30000}; // longest the destructor waits for outstanding requests
+    std::chrono::seconds resolveCacheDuration{60};
+    WireFormat format = WireFormat::Json;             // asked of the server for responses, with JSON as the fallback
+};
+
+struct HttpRequest {
+    std::string url;
+    std::string body;
+    boost::beast::http::verb method = boost::beast::http::verb::post;
+    std::chrono::milliseconds timeout{0}; // 0 uses HttpClientConfig::requestTimeout
+    std::string contentType;              // application/json if empty
+};
+
+class HttpClient;
+
+// Refers to a request sent through HttpClient. Must not be used once the client is destroyed.
+class HttpRequestHandle {
+public:
+    HttpRequestHandle() = default;
+
+    // The callback runs with a "Cancelled" failure unless the request already completed.
+    void Cancel();
+    bool IsDone() const;
+
+private:
+    friend class HttpClient;
+    struct State;
+
+    explicit HttpRequestHandle(std::weak_ptr<State> state) : state_(std::move(state)) {}
+
+    std::weak_ptr<State> state_;
+};
+
+// Asynchronous client for one server. All network work and every callback run on the client's own io_context
+// thread, so any number of requests can be outstanding without tying up other threads; callbacks must therefore
+// not wait for another request of the same client.
+// Connections are kept alive and reused. Servers often drop them after a few idle seconds, hence the short default
+// idleTimeout; a request that fails on a reused connection before its response arrived is sent once more, provided
+// it is idempotent or none of it was written, so the server cannot have acted on it.
 class HttpClient {
 public:
-    HttpClient();
+    explicit HttpClient(HttpClientConfig config = HttpClientConfig());
+
+    // Sends everything still queued before returning. Requests still outstanding after shutdownTimeout, or their own
+    // timeout if that is shorter, fail with a "Shutdown" error.
     ~HttpClient();
 
-    void SendRequest(const std::string& url, const std::string& body, const std::function<void(HttpResponse)>& callback, 
-                 boost::beast::http::verb method = boost::beast::http::verb::post, 
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    HttpRequestHandle Send(HttpRequest request, std::function<void(HttpResponse)> callback);
+    std::future<HttpResponse> Send(HttpRequest request);
+
+    HttpRequestHandle SendRequest(const std::string& url, const std::string& body, const std::function<void(HttpResponse)>& callback,
+                 boost::beast::http::verb method = boost::beast::http::verb::post,
                  std::promise<HttpResponse>* promise = nullptr);
 
+    const HttpClientConfig& GetConfig() const { return config_; }
+    uint64_t GetOpenedConnections() const { return openedConnections_.load(std::memory_order_relaxed); }
+
 private:
-    void ProcessRequests();
-    std::atomic<bool> running_;
-    std::thread processingThread_;
+    friend class HttpRequestHandle;
+    using PendingRequest = HttpRequestHandle::State;
+    struct Connection;
+
+    // Everything below runs on the io_context thread
+    void Enqueue(const std::shared_ptr<PendingRequest>& request);
+    void Pump();
+    std::shared_ptr<Connection> PickConnection();
+    std::shared_ptr<Connection> OpenConnection();
+    void Connect(const std::shared_ptr<Connection>& connection, const boost::asio::ip::tcp::resolver::results_type& endpoints);
+    void StartWrite(const std::shared_ptr<Connection>& connection);
+    void StartRead(const std::shared_ptr<Connection>& connection);
+    void Drop(const std::shared_ptr<Connection>& connection, const std::string& error);
+    void Abort(const std::shared_ptr<PendingRequest>& request, const std::string& reason);
+    void Complete(const std::shared_ptr<PendingRequest>& request, HttpResponse response);
+    void FinishIfStopping();
+
+    HttpClientConfig config_;
+    std::atomic<uint64_t> openedConnections_{0};
+
+    boost::asio::io_context ioc_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_;
+    boost::asio::ip::tcp::resolver resolver_;
+    boost::asio::steady_timer shutdownTimer_;
+    boost::asio::ip::tcp::resolver::results_type resolved_;
+    std::chrono::steady_clock::time_point resolvedAt_;
+
+    std::deque<std::shared_ptr<PendingRequest>> queue_;
+    std::vector<std::shared_ptr<Connection>> connections_;
+    bool stopping_ = false;
 
-    ThreadSafeQueue<std::tuple<std::string, std::string, std::function<void(HttpResponse)>, boost::beast::http::verb>> requestQueue_;
+    std::thread ioThread_;
 };
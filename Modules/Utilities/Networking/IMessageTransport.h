@@ -0,0 +1,22 @@
+#ifndef IMESSAGE_TRANSPORT_H
+#define IMESSAGE_TRANSPORT_H
+
+#include <functional>
+#include <string_view>
+
+// Two-way link to a peer process carrying opaque messages, e.g. JSON text.
+class IMessageTransport {
+public:
+    // The view is only valid for the duration of the call.
+    using MessageCallback = std::function<void(std::string_view)>;
+
+    virtual ~IMessageTransport() = default;
+
+    // Returns false if the message could not be queued for the peer.
+    virtual bool Send(std::string_view message) = 0;
+
+    // Callbacks run on the transport's receiving thread, in the order messages arrive.
+    virtual void Subscribe(MessageCallback callback) = 0;
+};
+
+#endif // IMESSAGE_TRANSPORT_H
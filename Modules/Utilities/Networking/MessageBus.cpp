@@ -0,0 +1,109 @@
+#include "MessageBus.h"
+
+namespace {
+    // Upper bound on a dispatch thread's sleep, should a wakeup ever be missed
+    constexpr std::chrono::milliseconds IdleWait{100};
+}
+
+void BusWakeup::Notify() {
+    // Pairs with the fence in Wait: either the dispatcher sees the new message or this sees it sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        NotifyAlways();
+    }
+}
+
+void BusWakeup::NotifyAlways() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    condition_.notify_one();
+}
+
+void BusWakeup::Wait(const std::function<bool()>& hasWork, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!hasWork()) {
+        condition_.wait_for(lock, timeout);
+    }
+    sleeping_.store(false, std::memory_order_relaxed);
+}
+
+MessageBus::MessageBus(Mode mode, size_t maxBatchSize)
+    : mode_(mode), maxBatchSize_(maxBatchSize > 0 ? maxBatchSize : 1), wakeup_(std::make_shared<BusWakeup>()) {
+    if (mode_ == Mode::Asynchronous) {
+        running_.store(true);
+        dispatchThread_ = std::thread(&MessageBus::Run, this);
+    }
+}
+
+MessageBus::~MessageBus() {
+    running_.store(false);
+    wakeup_->NotifyAlways();
+    if (dispatchThread_.joinable()) {
+        dispatchThread_.join();
+    }
+}
+
+size_t MessageBus::DispatchPending() {
+    size_t delivered = 0;
+    for (const auto& topic : SnapshotTopics()) {
+        size_t count;
+        while ((count = topic->Dispatch(maxBatchSize_)) > 0) {
+            delivered += count;
+        }
+    }
+    return delivered;
+}
+
+std::vector<TopicStats> MessageBus::GetStats() const {
+    std::vector<TopicStats> stats;
+    for (const auto& topic : SnapshotTopics()) {
+        stats.push_back(topic->GetStats());
+    }
+    return stats;
+}
+
+std::vector<std::shared_ptr<MessageTopicBase>> MessageBus::SnapshotTopics() const {
+    std::lock_guard<std::mutex> lock(topicsMutex_);
+    return topicList_;
+}
+
+void MessageBus::Run() {
+    std::vector<std::shared_ptr<MessageTopicBase>> topics;
+    uint64_t topicsVersion = UINT64_MAX;
+
+    while (true) {
+        bool stopping = !running_.load();
+        uint64_t version = topicsVersion_.load(std::memory_order_acquire);
+        if (version != topicsVersion) {
+            topics = SnapshotTopics();
+            topicsVersion = version;
+        }
+
+        // Round-robin so one busy topic cannot starve the others
+        size_t delivered = 0;
+        for (const auto& topic : topics) {
+            delivered += topic->Dispatch(maxBatchSize_);
+        }
+
+        if (delivered > 0) {
+            continue;
+        }
+        if (stopping) {
+            break; // everything published before the bus was destroyed has been delivered
+        }
+        wakeup_->Wait([this, &topics, topicsVersion] {
+            if (!running_.load() || topicsVersion_.load(std::memory_order_acquire) != topicsVersion) {
+                return true;
+            }
+            for (const auto& topic : topics) {
+                if (topic->HasPending()) {
+                    return true;
+                }
+            }
+            return false;
+        }, IdleWait);
+    }
+}
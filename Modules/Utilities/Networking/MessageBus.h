@@ -0,0 +1,556 @@
+#ifndef MESSAGE_BUS_H
+#define MESSAGE_BUS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "CommonTypes.h"
+#include "Logger.h"
+#include "MpmcRing.h"
+#include "ThreadPool.h"
+
+// Where a subscriber's callback runs.
+enum class DeliveryThread {
+    Dispatcher,  // on the bus's dispatch thread (the publishing thread in synchronous mode), in publish order
+    ThreadPool,  // as a task on ThreadPool::Instance(); batches of one topic may then run concurrently
+    Polled       // queued until the subscriber calls Poll() from a thread of its choosing
+};
+
+// What Publish does when a topic's queue is full.
+enum class OverflowPolicy {
+    DropNewest,    // rejects the message being published
+    DropOldest,    // discards the oldest queued message to make room
+    Block,         // waits up to blockTimeout for room, then rejects; a synchronous bus delivers the queue first instead
+    CoalesceByKey  // replaces a queued message with the same key; rejects only when `capacity` distinct keys are queued
+};
+
+template <typename T>
+struct TopicConfig {
+    size_t capacity = 1024;
+    OverflowPolicy overflow = OverflowPolicy::DropNewest;
+    std::chrono::milliseconds blockTimeout{1000};
+    std::function<std::string(const T&)> coalesceKey; // required by CoalesceByKey
+    size_t maxBatchSize = 0;                          // messages per delivery; 0 uses the bus's maxBatchSize
+};
+
+// Counters of one topic since it was created. Latency runs from Publish to the start of the delivering dispatch.
+struct TopicStats {
+    std::string name;
+    size_t depth = 0;
+    size_t maxDepth = 0;
+    uint64_t published = 0;  // messages accepted, including those later discarded or coalesced
+    uint64_t delivered = 0;
+    uint64_t batches = 0;
+    uint64_t dropped = 0;    // rejected by Publish or discarded by DropOldest
+    uint64_t coalesced = 0;  // replaced by a newer message with the same key before delivery
+    double meanLatencyMicroseconds = 0.0;
+    double maxLatencyMicroseconds = 0.0;
+};
+
+// Lets publishers wake the dispatch thread without touching its mutex unless it is actually asleep.
+class BusWakeup {
+public:
+    void Notify();
+    void NotifyAlways();
+
+    // Sleeps until notified or `timeout` passes, unless `hasWork` already holds once the sleeping flag is visible.
+    void Wait(const std::function<bool()>& hasWork, std::chrono::milliseconds timeout);
+
+private:
+    std::atomic<bool> sleeping_{false};
+    std::mutex mutex_;
+    std::condition_variable condition_;
+};
+
+class MessageTopicBase {
+public:
+    explicit MessageTopicBase(std::string name) : name_(std::move(name)) {}
+    virtual ~MessageTopicBase() = default;
+
+    const std::string& GetName() const { return name_; }
+
+    // Delivers up to `maxBatch` queued messages, or the topic's own maxBatchSize if it has one. Returns the number
+    // delivered, 0 if none were queued or another thread is already dispatching this topic.
+    virtual size_t Dispatch(size_t maxBatch) = 0;
+    virtual bool HasPending() const = 0;
+    virtual TopicStats GetStats() const = 0;
+
+private:
+    std::string name_;
+};
+
+// Named channel of messages of type T. Any number of threads may publish; messages are moved through a lock-free
+// ring, so move-only types work and nothing is serialized. Subscribers receive batches of everything queued since
+// the previous delivery, as one shared read-only vector. Coalescing topics keep their queue in a keyed map under a
+// mutex instead of the ring.
+template <typename T>
+class MessageTopic : public MessageTopicBase {
+public:
+    using Batch = std::vector<T>;
+    using BatchCallback = std::function<void(const Batch&)>;
+
+    class Subscription {
+    public:
+        Subscription(BatchCallback callback, DeliveryThread thread, size_t inboxCapacity)
+            : callback_(std::move(callback)), thread_(thread),
+              inbox_(thread == DeliveryThread::Polled ? std::make_unique<MpmcRing<std::shared_ptr<const Batch>>>(inboxCapacity) : nullptr) {}
+
+        // Polled subscriptions: runs the callback for every queued batch on the calling thread.
+        // Returns the number of messages delivered.
+        size_t Poll() {
+            size_t delivered = 0;
+            if (!inbox_) {
+                return delivered;
+            }
+            while (auto batch = inbox_->TryPop()) {
+                Invoke(**batch);
+                delivered += (*batch)->size();
+            }
+            return delivered;
+        }
+
+        // Stops deliveries; a callback already running finishes.
+        void Cancel() { cancelled_.store(true, std::memory_order_release); }
+        bool IsCancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+        DeliveryThread GetDeliveryThread() const { return thread_; }
+
+        // Batches lost because a polled subscriber fell behind by more than its inbox holds.
+        uint64_t GetDroppedBatches() const { return droppedBatches_.load(std::memory_order_relaxed); }
+
+    private:
+        friend class MessageTopic;
+
+        void Invoke(const Batch& batch) {
+            if (IsCancelled()) {
+                return;
+            }
+            try {
+                callback_(batch);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Message subscriber threw: {}", e.what());
+            }
+        }
+
+        BatchCallback callback_;
+        DeliveryThread thread_;
+        std::unique_ptr<MpmcRing<std::shared_ptr<const Batch>>> inbox_;
+        std::atomic<bool> cancelled_{false};
+        std::atomic<uint64_t> droppedBatches_{0};
+    };
+
+    static constexpr size_t DefaultInboxCapacity = 256;
+
+    // `wakeup` is null for a synchronous bus, in which case Publish delivers on the calling thread.
+    // @throws std::invalid_argument If CoalesceByKey is requested without a coalesceKey.
+    MessageTopic(std::string name, TopicConfig<T> config, std::shared_ptr<BusWakeup> wakeup)
+        : MessageTopicBase(std::move(name)), config_(std::move(config)),
+          ring_(config_.overflow == OverflowPolicy::CoalesceByKey ? 2 : config_.capacity), wakeup_(std::move(wakeup)),
+          subscriptions_(std::make_shared<const std::vector<std::shared_ptr<Subscription>>>()) {
+        if (config_.overflow == OverflowPolicy::CoalesceByKey && !config_.coalesceKey) {
+            throw std::invalid_argument("Topic '" + GetName() + "' coalesces by key but has no coalesceKey");
+        }
+    }
+
+    // Returns false if the message was rejected under the topic's overflow policy. A message that replaced a queued
+    // one with the same key counts as accepted.
+    bool Publish(T message) {
+        Envelope envelope{std::move(message), NowNanoseconds()};
+        bool accepted = config_.overflow == OverflowPolicy::CoalesceByKey
+            ? PushCoalesced(std::move(envelope))
+            : ring_.TryPush(std::move(envelope)) || PushWhenFull(envelope);
+        if (!accepted) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        published_.fetch_add(1, std::memory_order_relaxed);
+        RecordDepth(GetPendingCount());
+
+        if (wakeup_) {
+            wakeup_->Notify();
+        } else {
+            DispatchAll();
+        }
+        return true;
+    }
+
+    std::shared_ptr<Subscription> Subscribe(BatchCallback callback, DeliveryThread thread = DeliveryThread::Dispatcher,
+                                            size_t inboxCapacity = DefaultInboxCapacity) {
+        auto subscription = std::make_shared<Subscription>(std::move(callback), thread, inboxCapacity);
+        std::lock_guard<std::mutex> lock(subscriptionsMutex_);
+        auto updated = std::make_shared<std::vector<std::shared_ptr<Subscription>>>();
+        for (const auto& existing : *subscriptions_) {
+            if (!existing->IsCancelled()) {
+                updated->push_back(existing);
+            }
+        }
+        updated->push_back(subscription);
+        subscriptions_ = std::move(updated);
+        return subscription;
+    }
+
+    // Convenience for subscribers that handle one message at a time.
+    std::shared_ptr<Subscription> SubscribeEach(std::function<void(const T&)> callback, DeliveryThread thread = DeliveryThread::Dispatcher,
+                                                size_t inboxCapacity = DefaultInboxCapacity) {
+        return Subscribe([callback = std::move(callback)](const Batch& batch) {
+            for (const T& message : batch) {
+                callback(message);
+            }
+        }, thread, inboxCapacity);
+    }
+
+    size_t GetPendingCount() const {
+        return config_.overflow == OverflowPolicy::CoalesceByKey ? coalescedDepth_.load(std::memory_order_acquire) : ring_.Size();
+    }
+
+    bool HasPending() const override { return GetPendingCount() > 0; }
+
+    // Publishers currently waiting for room under OverflowPolicy::Block.
+    int GetBlockedPublisherCount() const { return blockedPublishers_.load(std::memory_order_relaxed); }
+
+    const TopicConfig<T>& GetConfig() const { return config_; }
+
+    TopicStats GetStats() const override {
+        TopicStats stats;
+        stats.name = GetName();
+        stats.depth = GetPendingCount();
+        stats.maxDepth = maxDepth_.load(std::memory_order_relaxed);
+        stats.published = published_.load(std::memory_order_relaxed);
+        stats.delivered = delivered_.load(std::memory_order_relaxed);
+        stats.batches = batches_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        stats.coalesced = coalesced_.load(std::memory_order_relaxed);
+        if (stats.delivered > 0) {
+            stats.meanLatencyMicroseconds = latencyTotalNs_.load(std::memory_order_relaxed) / 1000.0 / stats.delivered;
+        }
+        stats.maxLatencyMicroseconds = latencyMaxNs_.load(std::memory_order_relaxed) / 1000.0;
+        return stats;
+    }
+
+    size_t Dispatch(size_t maxBatch) override {
+        DispatchGuard guard(dispatching_);
+        if (!guard.acquired) {
+            return 0;
+        }
+
+        if (config_.maxBatchSize > 0) {
+            maxBatch = config_.maxBatchSize;
+        }
+        int64_t dispatchNs = NowNanoseconds();
+        int64_t latencyTotalNs = 0;
+        int64_t latencyMaxNs = 0;
+        auto take = [&](Envelope& envelope) {
+            int64_t latencyNs = dispatchNs - envelope.publishedNs;
+            latencyTotalNs += latencyNs;
+            latencyMaxNs = std::max(latencyMaxNs, latencyNs);
+            batch_.push_back(std::move(envelope.message));
+        };
+
+        batch_.clear();
+        if (config_.overflow == OverflowPolicy::CoalesceByKey) {
+            std::lock_guard<std::mutex> lock(coalesceMutex_);
+            while (batch_.size() < maxBatch && !coalesceQueue_.empty()) {
+                take(coalesceQueue_.front().envelope);
+                coalesceIndex_.erase(coalesceQueue_.front().key);
+                coalesceQueue_.pop_front();
+                ++coalescedBase_;
+            }
+            coalescedDepth_.store(coalesceQueue_.size(), std::memory_order_release);
+        } else {
+            while (batch_.size() < maxBatch) {
+                std::optional<Envelope> envelope = ring_.TryPop();
+                if (!envelope) {
+                    break;
+                }
+                take(*envelope);
+            }
+        }
+        if (batch_.empty()) {
+            return 0;
+        }
+        if (config_.overflow == OverflowPolicy::Block) {
+            WakeBlockedPublishers();
+        }
+        size_t count = batch_.size();
+
+        // Only this thread writes the latency counters, which the guard serializes
+        delivered_.fetch_add(count, std::memory_order_relaxed);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        latencyTotalNs_.store(latencyTotalNs_.load(std::memory_order_relaxed) + latencyTotalNs, std::memory_order_relaxed);
+        if (latencyMaxNs > latencyMaxNs_.load(std::memory_order_relaxed)) {
+            latencyMaxNs_.store(latencyMaxNs, std::memory_order_relaxed);
+        }
+
+        std::shared_ptr<const std::vector<std::shared_ptr<Subscription>>> subscriptions;
+        {
+            std::lock_guard<std::mutex> subscriptionsLock(subscriptionsMutex_);
+            subscriptions = subscriptions_;
+        }
+
+        // Dispatcher-only topics reuse one buffer; otherwise the batch is shared with the other threads
+        bool shared = false;
+        for (const auto& subscription : *subscriptions) {
+            shared = shared || subscription->thread_ != DeliveryThread::Dispatcher;
+        }
+        std::shared_ptr<const Batch> sharedBatch;
+        if (shared) {
+            sharedBatch = std::make_shared<const Batch>(std::move(batch_));
+            batch_ = Batch();
+        }
+        const Batch& batch = shared ? *sharedBatch : batch_;
+
+        for (const auto& subscription : *subscriptions) {
+            if (subscription->IsCancelled()) {
+                continue;
+            }
+            switch (subscription->thread_) {
+                case DeliveryThread::Dispatcher:
+                    subscription->Invoke(batch);
+                    break;
+                case DeliveryThread::ThreadPool:
+                    ThreadPool::Instance().Enqueue([subscription, sharedBatch] { subscription->Invoke(*sharedBatch); });
+                    break;
+                case DeliveryThread::Polled:
+                    if (!subscription->inbox_->TryPush(sharedBatch)) {
+                        subscription->droppedBatches_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+            }
+        }
+        return count;
+    }
+
+private:
+    struct Envelope {
+        T message;
+        int64_t publishedNs;
+    };
+
+    struct CoalescedEntry {
+        std::string key;
+        Envelope envelope;
+    };
+
+    // A flag rather than a mutex, since a callback publishing to its own topic re-enters on the same thread
+    struct DispatchGuard {
+        explicit DispatchGuard(std::atomic<bool>& flag) : flag(flag), acquired(!flag.exchange(true, std::memory_order_acquire)) {}
+        ~DispatchGuard() {
+            if (acquired) {
+                flag.store(false, std::memory_order_release);
+            }
+        }
+
+        std::atomic<bool>& flag;
+        bool acquired;
+    };
+
+    static int64_t NowNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Called once the ring has refused `envelope`, which is still intact
+    bool PushWhenFull(Envelope& envelope) {
+        switch (config_.overflow) {
+            case OverflowPolicy::DropOldest:
+                while (!ring_.TryPush(std::move(envelope))) {
+                    if (ring_.TryPop()) {
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                return true;
+            case OverflowPolicy::Block:
+                return PushBlocking(envelope);
+            default:
+                return false;
+        }
+    }
+
+    bool PushBlocking(Envelope& envelope) {
+        if (!wakeup_) {
+            // Nobody else drains a synchronous topic; from inside one of its callbacks this returns at once
+            DispatchAll();
+            return ring_.TryPush(std::move(envelope));
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + config_.blockTimeout;
+        std::unique_lock<std::mutex> lock(spaceMutex_);
+        blockedPublishers_.fetch_add(1, std::memory_order_relaxed);
+        bool pushed = false;
+        while (true) {
+            // Pairs with the fence in WakeBlockedPublishers: either this push sees the freed slot or the dispatcher
+            // sees a blocked publisher
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            pushed = ring_.TryPush(std::move(envelope));
+            if (pushed || std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+            wakeup_->Notify();
+            spaceCondition_.wait_until(lock, deadline);
+        }
+        blockedPublishers_.fetch_sub(1, std::memory_order_relaxed);
+        return pushed;
+    }
+
+    void WakeBlockedPublishers() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (blockedPublishers_.load(std::memory_order_relaxed) > 0) {
+            {
+                std::lock_guard<std::mutex> lock(spaceMutex_);
+            }
+            spaceCondition_.notify_all();
+        }
+    }
+
+    // Entries keep their place in the queue when replaced, so a key updated continuously is still delivered
+    bool PushCoalesced(Envelope envelope) {
+        std::string key = config_.coalesceKey(envelope.message);
+        std::lock_guard<std::mutex> lock(coalesceMutex_);
+        auto it = coalesceIndex_.find(key);
+        if (it != coalesceIndex_.end()) {
+            coalesceQueue_[it->second - coalescedBase_].envelope.message = std::move(envelope.message);
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (coalesceQueue_.size() >= config_.capacity) {
+            return false;
+        }
+        coalesceIndex_.emplace(key, coalescedBase_ + coalesceQueue_.size());
+        coalesceQueue_.push_back(CoalescedEntry{std::move(key), std::move(envelope)});
+        coalescedDepth_.store(coalesceQueue_.size(), std::memory_order_release);
+        return true;
+    }
+
+    void RecordDepth(size_t depth) {
+        size_t maxDepth = maxDepth_.load(std::memory_order_relaxed);
+        while (depth > maxDepth && !maxDepth_.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Synchronous delivery. A publish from inside a callback, or racing another thread's dispatch, is picked up by
+    // the dispatch already running rather than recursing.
+    // The fences pair a publisher that found the flag taken with the dispatcher releasing it: one of them sees the
+    // other's message.
+    void DispatchAll() {
+        do {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while (Dispatch(std::numeric_limits<size_t>::max()) > 0) {
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (dispatching_.load(std::memory_order_acquire)) {
+                return;
+            }
+        } while (HasPending());
+    }
+
+    const TopicConfig<T> config_;
+    MpmcRing<Envelope> ring_;
+    std::shared_ptr<BusWakeup> wakeup_;
+
+    // CoalesceByKey queue; the index holds each key's position counted from the first entry ever queued
+    std::mutex coalesceMutex_;
+    std::deque<CoalescedEntry> coalesceQueue_;
+    std::unordered_map<std::string, uint64_t> coalesceIndex_;
+    uint64_t coalescedBase_ = 0;
+    std::atomic<size_t> coalescedDepth_{0};
+
+    // Block policy
+    std::mutex spaceMutex_;
+    std::condition_variable spaceCondition_;
+    std::atomic<int> blockedPublishers_{0};
+
+    std::mutex subscriptionsMutex_;
+    std::shared_ptr<const std::vector<std::shared_ptr<Subscription>>> subscriptions_; // replaced, never modified
+
+    std::atomic<bool> dispatching_{false};
+    Batch batch_;
+
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<size_t> maxDepth_{0};
+    std::atomic<int64_t> latencyTotalNs_{0};
+    std::atomic<int64_t> latencyMaxNs_{0};
+};
+
+/**
+ * Typed publish/subscribe bus. Topics are created on first use by name and message type; each has its own bounded
+ * queue and overflow policy. In asynchronous mode one dispatch thread drains the topics round-robin, up to
+ * maxBatchSize messages per topic per pass, and hands each batch to the subscribers on the thread they asked for.
+ * In synchronous mode there is no thread and Publish delivers before returning.
+ */
+class MessageBus {
+public:
+    explicit MessageBus(Mode mode = Mode::Asynchronous, size_t maxBatchSize = 64);
+    ~MessageBus();
+
+    MessageBus(const MessageBus&) = delete;
+    MessageBus& operator=(const MessageBus&) = delete;
+
+    /**
+     * Returns the topic called `name`, creating it with `config` if it does not exist yet; an existing topic keeps
+     * the configuration it was created with.
+     * @throws std::invalid_argument If the topic exists with a different message type, or `config` is invalid.
+     */
+    template <typename T>
+    std::shared_ptr<MessageTopic<T>> GetTopic(const std::string& name, TopicConfig<T> config = TopicConfig<T>()) {
+        std::lock_guard<std::mutex> lock(topicsMutex_);
+        auto it = topics_.find(name);
+        if (it != topics_.end()) {
+            auto topic = std::dynamic_pointer_cast<MessageTopic<T>>(it->second);
+            if (!topic) {
+                throw std::invalid_argument("Topic '" + name + "' already exists with a different message type");
+            }
+            return topic;
+        }
+        auto topic = std::make_shared<MessageTopic<T>>(name, std::move(config), mode_ == Mode::Asynchronous ? wakeup_ : nullptr);
+        topics_.emplace(name, topic);
+        topicList_.push_back(topic);
+        topicsVersion_.fetch_add(1, std::memory_order_release);
+        return topic;
+    }
+
+    template <typename T>
+    std::shared_ptr<MessageTopic<T>> GetTopic(const std::string& name, size_t capacity) {
+        TopicConfig<T> config;
+        config.capacity = capacity;
+        return GetTopic<T>(name, std::move(config));
+    }
+
+    // Delivers everything queued on the calling thread; mainly for shutdown and tests.
+    size_t DispatchPending();
+
+    Mode GetMode() const { return mode_; }
+
+    // Counters of every topic, in creation order.
+    std::vector<TopicStats> GetStats() const;
+
+private:
+    void Run();
+    std::vector<std::shared_ptr<MessageTopicBase>> SnapshotTopics() const;
+
+    Mode mode_;
+    size_t maxBatchSize_;
+    std::shared_ptr<BusWakeup> wakeup_;
+
+    mutable std::mutex topicsMutex_;
+    std::unordered_map<std::string, std::shared_ptr<MessageTopicBase>> topics_;
+    std::vector<std::shared_ptr<MessageTopicBase>> topicList_;
+    std::atomic<uint64_t> topicsVersion_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread dispatchThread_;
+};
+
+#endif // MESSAGE_BUS_H
@@ -18,15 +18,21 @@ void Messaging::Subscribe(std::function<void(const std::string&)> callback) {
     subscribers_.push_back(callback);
 }
 
-void Messaging::PushRequest(const std::string& request) {
+bool Messaging::PushRequest(const std::string& request) {
+    bool pushed;
     {
         std::lock_guard<std::mutex> lock(mtx_);
-        request_queue_.push(request);
+        pushed = request_queue_.push(request);
+    }
+    if (!pushed) {
+        LOG_ERROR("Messaging queue full; request dropped: {}", request);
+        return false;
     }
     cv_.notify_one();
     if (mode_ == Mode::Synchronous) {
         ProcessRequestsSynchronously();  // Process immediately if in synchronous mode
     }
+    return true;
 }
 
 bool Messaging::PopRequest(std::string& request) {
@@ -52,7 +58,7 @@ void Messaging::ProcessRequests() {
             for (const auto& callback : subscribers_) {
                 callback(request);
             }
-            Logger::Log("Processed request: " + request, Logger::LogLevel::LOG_INFO);
+            LOG_INFO("Processed request: {}", request);
         }
     }
 }
@@ -64,7 +70,7 @@ void Messaging::ProcessRequestsSynchronously() {
         for (const auto& callback : subscribers_) {
             callback(request);
         }
-        Logger::Log("Processed request: " + request, Logger::LogLevel::LOG_INFO);
+        LOG_INFO("Processed request: {}", request);
     }
 }
 
@@ -18,7 +18,9 @@ public:
     Messaging(Mode mode = Mode::Asynchronous);  // Add mode parameter to constructor
     ~Messaging();
 
-    void PushRequest(const std::string& request);
+    // Returns false, dropping the request, if the queue is full. New code should use a MessageBus topic, which
+    // has configurable overflow policies.
+    bool PushRequest(const std::string& request);
     bool PopRequest(std::string& request);
 
     void Subscribe(std::function<void(const std::string&)> callback);
@@ -0,0 +1,288 @@
+#include "Outbox.h"
+#include "Logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+using json = nlohmann::json;
+
+Outbox::Outbox(std::shared_ptr<HttpClient> client, OutboxConfig config)
+    : client_(std::move(client)), config_(std::move(config)), format_(client_->GetConfig().format) {
+    config_.maxBatchSize = std::max<size_t>(config_.maxBatchSize, 1);
+    spilling_ = HasSpillFile();
+    nextAttempt_ = std::chrono::steady_clock::now();
+    thread_ = std::thread(&Outbox::Run, this);
+}
+
+Outbox::~Outbox() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void Outbox::Post(json record, const std::string& key) {
+    posted_.fetch_add(1, std::memory_order_relaxed);
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!key.empty()) {
+            auto it = pendingIndex_.find(key);
+            if (it != pendingIndex_.end()) {
+                pending_[it->second].record = std::move(record);
+                coalesced_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            pendingIndex_.emplace(key, pending_.size());
+        }
+        pending_.push_back(Pending{key, std::move(record)});
+        full = pending_.size() >= config_.maxBatchSize;
+    }
+    if (full) {
+        wake_.notify_one();
+    }
+}
+
+void Outbox::Flush() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flushRequested_ = true;
+    }
+    wake_.notify_one();
+}
+
+OutboxStats Outbox::GetStats() const {
+    OutboxStats stats;
+    stats.posted = posted_.load(std::memory_order_relaxed);
+    stats.coalesced = coalesced_.load(std::memory_order_relaxed);
+    stats.sent = sent_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.spilled = spilled_.load(std::memory_order_relaxed);
+    stats.replayed = replayed_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Outbox::Run() {
+    bool stopping = false;
+    while (!stopping) {
+        std::vector<Pending> taken;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait_for(lock, config_.flushInterval, [this] {
+                return !running_ || flushRequested_ || pending_.size() >= config_.maxBatchSize;
+            });
+            flushRequested_ = false;
+            taken.swap(pending_);
+            pendingIndex_.clear();
+            stopping = !running_;
+        }
+
+        // Spilled records go out before anything newer. On shutdown a server already known to be down is not retried
+        if (spilling_ && !stopping && std::chrono::steady_clock::now() >= nextAttempt_) {
+            spilling_ = !Replay();
+        }
+
+        std::vector<json> records;
+        records.reserve(std::min(taken.size(), config_.maxBatchSize));
+        for (auto& pending : taken) {
+            records.push_back(std::move(pending.record));
+            if (records.size() == config_.maxBatchSize) {
+                SendOrSpill(records);
+            }
+        }
+        SendOrSpill(records);
+    }
+}
+
+void Outbox::SendOrSpill(std::vector<json>& records) {
+    if (records.empty()) {
+        return;
+    }
+    if (!spilling_) {
+        Delivery delivery = Deliver(records);
+        size_t answered = delivery.accepted + delivery.rejected;
+        if (answered == records.size()) {
+            records.clear();
+            return;
+        }
+        records.erase(records.begin(), records.begin() + static_cast<std::ptrdiff_t>(answered));
+        if (!config_.spillPath.empty()) {
+            spilling_ = true;
+            nextAttempt_ = std::chrono::steady_clock::now() + config_.retryInterval;
+        }
+    }
+    Spill(records);
+    records.clear();
+}
+
+Outbox::Delivery Outbox::Deliver(const std::vector<json>& records) {
+    Delivery delivery;
+    if (!perRecord_) {
+        HttpResponse response = Send(config_.route, json(records));
+        bool missingRoute = response.status == 404 || response.status == 405;
+        if (!missingRoute || config_.recordRoute.empty()) {
+            Tally(response, records.size(), config_.route, delivery);
+            return delivery;
+        }
+        LOG_WARNING("Server has no {}; sending records one at a time to {}", config_.route, config_.recordRoute);
+        perRecord_ = true;
+    }
+
+    for (const auto& record : records) {
+        if (!Tally(Send(config_.recordRoute, record), 1, config_.recordRoute, delivery)) {
+            break;
+        }
+    }
+    return delivery;
+}
+
+HttpResponse Outbox::Send(const std::string& route, const json& body) {
+    HttpRequest request;
+    request.url = route;
+    request.body = EncodeWire(body, format_);
+    request.contentType = ContentTypeOf(format_);
+    request.timeout = config_.requestTimeout;
+    HttpResponse response = client_->Send(std::move(request)).get();
+
+    if (response.status == 415 && format_ != WireFormat::Json) {
+        LOG_WARNING("{} does not accept {}; sending JSON", route, ContentTypeOf(format_));
+        format_ = WireFormat::Json;
+        return Send(route, body);
+    }
+    return response;
+}
+
+bool Outbox::Tally(const HttpResponse& response, size_t count, const std::string& route, Delivery& delivery) {
+    if (response.success) {
+        delivery.accepted += count;
+        sent_.fetch_add(count, std::memory_order_relaxed);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        if (config_.onResponse) {
+            try {
+                config_.onResponse(response);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Outbox response handler for {} threw: {}", route, e.what());
+            }
+        }
+        return true;
+    }
+
+    // A missing route is kept for later too: the server may be an older build about to be replaced
+    if (response.status == 0 || response.status >= 500 || response.status == 404 || response.status == 405) {
+        LOG_WARNING("Outbox could not reach {}: {}", route, response.content);
+        return false;
+    }
+
+    // Sending the same records again would be rejected again
+    LOG_ERROR("Server rejected {} records for {}: {}", count, route, response.content);
+    dropped_.fetch_add(count, std::memory_order_relaxed);
+    delivery.rejected += count;
+    return true;
+}
+
+bool Outbox::Replay() {
+    std::vector<std::string> lines;
+    {
+        std::ifstream file(config_.spillPath, std::ios::binary);
+        if (!file.is_open()) {
+            return true;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty()) {
+                lines.push_back(std::move(line));
+            }
+        }
+    }
+
+    size_t next = 0;
+    while (next < lines.size()) {
+        size_t end = std::min(lines.size(), next + config_.maxBatchSize);
+        std::vector<json> records;
+        std::vector<size_t> recordLines;
+        std::vector<size_t> unreadableLines;
+        for (size_t i = next; i < end; ++i) {
+            try {
+                records.push_back(json::parse(lines[i]));
+                recordLines.push_back(i);
+            } catch (const std::exception& e) {
+                // A line torn by a crash while spilling
+                LOG_WARNING("Skipping unreadable record in {}: {}", config_.spillPath, e.what());
+                unreadableLines.push_back(i);
+            }
+        }
+        Delivery delivery = records.empty() ? Delivery() : Deliver(records);
+        replayed_.fetch_add(delivery.accepted, std::memory_order_relaxed);
+        size_t answered = delivery.accepted + delivery.rejected;
+        size_t stop = answered < records.size() ? recordLines[answered] : end;
+
+        // Unreadable lines are counted once they leave the file
+        dropped_.fetch_add(std::lower_bound(unreadableLines.begin(), unreadableLines.end(), stop) - unreadableLines.begin(), std::memory_order_relaxed);
+        next = stop;
+        if (answered < records.size()) {
+            break;
+        }
+    }
+
+    std::error_code ec;
+    if (next == lines.size()) {
+        std::filesystem::remove(config_.spillPath, ec);
+        if (ec) {
+            LOG_ERROR("Failed to remove {} after replaying it: {}", config_.spillPath, ec.message());
+        }
+        if (!lines.empty()) {
+            LOG_INFO("Replayed {} spilled records to {}", lines.size(), config_.route);
+        }
+        return true;
+    }
+
+    // Keep only what is left, so nothing is sent twice
+    if (next > 0) {
+        std::string tempPath = config_.spillPath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            for (size_t i = next; i < lines.size(); ++i) {
+                file << lines[i] << '\n';
+            }
+        }
+        std::filesystem::rename(tempPath, config_.spillPath, ec);
+        if (ec) {
+            LOG_ERROR("Failed to rewrite {}; replayed records will be sent again: {}", config_.spillPath, ec.message());
+        }
+    }
+    nextAttempt_ = std::chrono::steady_clock::now() + config_.retryInterval;
+    return false;
+}
+
+void Outbox::Spill(const std::vector<json>& records) {
+    if (config_.spillPath.empty()) {
+        LOG_ERROR("Dropped {} undeliverable records for {}", records.size(), config_.route);
+        dropped_.fetch_add(records.size(), std::memory_order_relaxed);
+        return;
+    }
+
+    std::ofstream file(config_.spillPath, std::ios::binary | std::ios::app);
+    for (const auto& record : records) {
+        file << record.dump() << '\n';
+    }
+    file.flush();
+    if (!file) {
+        LOG_ERROR("Failed to spill {} records to {}", records.size(), config_.spillPath);
+        dropped_.fetch_add(records.size(), std::memory_order_relaxed);
+        return;
+    }
+    spilled_.fetch_add(records.size(), std::memory_order_relaxed);
+}
+
+bool Outbox::HasSpillFile() const {
+    if (config_.spillPath.empty()) {
+        return false;
+    }
+    std::error_code ec;
+    return std::filesystem::file_size(config_.spillPath, ec) > 0 && !ec;
+}
@@ -0,0 +1,115 @@
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "HttpClient.h"
+#include "nlohmann/json.hpp"
+
+struct OutboxConfig {
+    std::string route;                                    // receives a JSON array of records per POST
+    std::string recordRoute;                              // receives one record per POST if the server lacks route
+    size_t maxBatchSize = 100;
+    std::chrono::milliseconds flushInterval{500};         // longest a record waits for its batch to fill
+    std::chrono::milliseconds requestTimeout{5000};
+    std::chrono::milliseconds retryInterval{5000};        // between attempts to reach the server while spilling
+    std::string spillPath;                                // empty drops what cannot be delivered
+    std::function<void(const HttpResponse&)> onResponse;  // called on the outbox thread for each accepted batch
+};
+
+struct OutboxStats {
+    uint64_t posted = 0;
+    uint64_t coalesced = 0; // replaced by a later record with the same key before being sent
+    uint64_t sent = 0;
+    uint64_t batches = 0;
+    uint64_t spilled = 0;
+    uint64_t replayed = 0;
+    uint64_t dropped = 0;   // rejected by the server, or undeliverable with nowhere to spill
+};
+
+/**
+ * Delivers JSON records to one route of the server in batches, from its own thread. Records posted under the same
+ * key replace each other while they wait, so only the latest state is sent.
+ * Batches are encoded in the client's WireFormat, switching to JSON for good if the server answers 415 to it.
+ * A server answering 404 or 405 to the batch route is sent each record to recordRoute instead, also for good.
+ * While the server is unreachable (no response, a 5xx, or a 404 or 405 with nowhere else to send) batches are appended
+ * to spillPath, one JSON record per line, and once it answers again the file is replayed in order before anything
+ * newer is sent. A file left by an earlier run is replayed the same way.
+ */
+class Outbox {
+public:
+    Outbox(std::shared_ptr<HttpClient> client, OutboxConfig config);
+
+    // Sends what is still pending, spilling it if the server does not answer.
+    ~Outbox();
+
+    Outbox(const Outbox&) = delete;
+    Outbox& operator=(const Outbox&) = delete;
+
+    // An empty key is never coalesced.
+    void Post(nlohmann::json record, const std::string& key = "");
+
+    // Sends pending records now rather than when the batch fills or flushInterval passes.
+    void Flush();
+
+    OutboxStats GetStats() const;
+
+private:
+    struct Pending {
+        std::string key;
+        nlohmann::json record;
+    };
+
+    // Leading records the server answered; the rest were not sent because it could not be reached
+    struct Delivery {
+        size_t accepted = 0;
+        size_t rejected = 0;
+    };
+
+    void Run();
+    void SendOrSpill(std::vector<nlohmann::json>& records);
+    Delivery Deliver(const std::vector<nlohmann::json>& records);
+    HttpResponse Send(const std::string& route, const nlohmann::json& body);
+    // Counts `count` records answered by `response`; false if the server could not be reached
+    bool Tally(const HttpResponse& response, size_t count, const std::string& route, Delivery& delivery);
+    bool Replay();                                            // true once the spill file is empty
+    void Spill(const std::vector<nlohmann::json>& records);
+    bool HasSpillFile() const;
+
+    std::shared_ptr<HttpClient> client_;
+    OutboxConfig config_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<Pending> pending_;
+    std::unordered_map<std::string, size_t> pendingIndex_; // key to position in pending_
+    bool flushRequested_ = false;
+    bool running_ = true;
+
+    // Outbox thread only
+    WireFormat format_;      // the client's format, until the server answers 415 to it
+    bool perRecord_ = false; // set once the server turns out not to have the batch route
+    bool spilling_ = false;
+    std::chrono::steady_clock::time_point nextAttempt_;
+
+    std::atomic<uint64_t> posted_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> spilled_{0};
+    std::atomic<uint64_t> replayed_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::thread thread_;
+};
+
+#endif // OUTBOX_H
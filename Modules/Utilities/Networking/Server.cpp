@@ -1,9 +1,10 @@
 #include "Server.h"
 #include "Logger.h"
 
-Server::Server(net::io_context& ioc, std::optional<tcp::endpoint> endpoint, std::shared_ptr<Messaging> messaging)
-    : ioc_(ioc), messaging_(messaging), running_(true), 
-      acceptor_(ioc)  // Initialize the acceptor with io_context
+Server::Server(net::io_context& ioc, std::optional<tcp::endpoint> endpoint, std::shared_ptr<MessageBus> bus)
+    : bus_(bus), ioc_(ioc),
+      acceptor_(ioc),  // Initialize the acceptor with io_context
+      running_(true)
 {
     tcp::endpoint resolved_endpoint;
 
@@ -49,7 +50,7 @@ Server::Server(net::io_context& ioc, std::optional<tcp::endpoint> endpoint, std:
 
 Server::~Server() {
     Stop();
-    messaging_.reset();
+    bus_.reset();
 }
 
 void Server::Start() {
@@ -94,3 +95,23 @@ void Server::Accept() {
 void Server::HandleRequest(tcp::socket socket) {
     // Base implementation (could be empty or generic)
 }
+
+std::optional<nlohmann::json> Server::ReadBody(beast::tcp_stream& stream, const http::request<http::string_body>& req) {
+    std::optional<WireFormat> format = WireFormatFromContentType(std::string(req[http::field::content_type]));
+    if (!format) {
+        WriteResponse(stream, req, http::status::unsupported_media_type, {{"status", "Unsupported content type"}});
+        return std::nullopt;
+    }
+    return DecodeWire(req.body(), *format);
+}
+
+void Server::WriteResponse(beast::tcp_stream& stream, const http::request<http::string_body>& req, http::status status,
+                           const nlohmann::json& body) {
+    WireFormat format = NegotiateWireFormat(std::string(req[http::field::accept]));
+    http::response<http::string_body> res{status, req.version()};
+    res.set(http::field::server, "Boost.Beast");
+    res.set(http::field::content_type, ContentTypeOf(format));
+    res.body() = EncodeWire(body, format);
+    res.prepare_payload();
+    http::write(stream, res);
+}
@@ -8,8 +8,10 @@
 #include <boost/asio/strand.hpp>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
-#include "Messaging.h"
+#include "MessageBus.h"
+#include "WireFormat.h"
 #include "ThreadPool.h"
 
 namespace beast = boost::beast;
@@ -19,14 +21,23 @@ using tcp = net::ip::tcp;
 
 class Server {
 public:
-    Server(net::io_context& ioc, std::optional<tcp::endpoint> endpoint, std::shared_ptr<Messaging> messaging);
+    Server(net::io_context& ioc, std::optional<tcp::endpoint> endpoint, std::shared_ptr<MessageBus> bus);
     virtual ~Server();
     void Start();
     void Stop();
 
 protected:
     virtual void HandleRequest(tcp::socket socket);
-    std::shared_ptr<Messaging> messaging_;
+
+    // Decodes the request body in the format its Content-Type names. Answers 415 and returns nullopt for a format
+    // that is not supported; throws nlohmann::json::exception on a malformed body.
+    static std::optional<nlohmann::json> ReadBody(beast::tcp_stream& stream, const http::request<http::string_body>& req);
+
+    // Responds in the format the request's Accept header prefers, JSON if it names none we support.
+    static void WriteResponse(beast::tcp_stream& stream, const http::request<http::string_body>& req, http::status status,
+                              const nlohmann::json& body);
+
+    std::shared_ptr<MessageBus> bus_;
 
 private:
     void Accept();
@@ -0,0 +1,375 @@
+#include "SharedMemoryRing.h"
+#include "Logger.h"
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+struct SharedMemoryRing::Header {
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint64_t capacity;
+    uint32_t ownerPid;
+    alignas(64) std::atomic<uint64_t> writePosition;
+    alignas(64) std::atomic<uint64_t> readPosition;
+    alignas(64) std::atomic<uint32_t> dataSignal;
+    std::atomic<uint32_t> readerWaiting;
+};
+
+namespace {
+    constexpr uint32_t Magic = 0x42524653; // "SFRB"
+    constexpr uint32_t Version = 1;
+    constexpr size_t DataOffset = 256;
+    constexpr uint32_t PaddingMarker = 0xFFFFFFFF;
+    constexpr size_t FrameAlignment = 8;
+
+    size_t PaddedSize(size_t payloadSize) {
+        return (sizeof(uint32_t) + payloadSize + FrameAlignment - 1) & ~(FrameAlignment - 1);
+    }
+
+    size_t RoundUpToPowerOfTwo(size_t value) {
+        size_t result = 64;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+#ifdef _WIN32
+    std::string SegmentName(const std::string& name) { return "Local\\" + name; }
+    std::string EventName(const std::string& name) { return "Local\\" + name + ".signal"; }
+
+    uint32_t CurrentProcessId() { return static_cast<uint32_t>(GetCurrentProcessId()); }
+#else
+    std::string SegmentName(const std::string& name) { return "/" + name; }
+
+    uint32_t CurrentProcessId() { return static_cast<uint32_t>(getpid()); }
+#endif
+}
+
+// Both processes map the header, so its atomics must not rely on a process-local lock
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "Shared memory rings need lock-free 32 and 64-bit atomics");
+
+SharedMemoryRing::SharedMemoryRing(std::string name, bool owner) : name_(std::move(name)), owner_(owner) {}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(const std::string& name, size_t capacity) {
+    static_assert(sizeof(Header) <= DataOffset, "Ring header overlaps the data");
+    std::unique_ptr<SharedMemoryRing> ring(new SharedMemoryRing(name, true));
+    size_t dataCapacity = RoundUpToPowerOfTwo(capacity);
+    if (!ring->Map(DataOffset + dataCapacity, true)) {
+        return nullptr;
+    }
+
+    // The mapping starts zeroed; the peer checks the magic, written last, before trusting the rest
+    ring->header_ = new (ring->mapping_) Header();
+    ring->header_->version = Version;
+    ring->header_->capacity = dataCapacity;
+    ring->header_->ownerPid = CurrentProcessId();
+    ring->header_->magic.store(Magic, std::memory_order_release);
+
+    ring->data_ = ring->mapping_ + DataOffset;
+    ring->capacity_ = dataCapacity;
+    ring->mask_ = dataCapacity - 1;
+    return ring;
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(const std::string& name) {
+    std::unique_ptr<SharedMemoryRing> ring(new SharedMemoryRing(name, false));
+    if (!ring->Map(0, false)) {
+        return nullptr;
+    }
+
+    auto* header = reinterpret_cast<Header*>(ring->mapping_);
+    if (ring->mappedSize_ >= DataOffset && header->magic.load(std::memory_order_acquire) == 0) {
+        return nullptr; // still being created
+    }
+    if (ring->mappedSize_ < DataOffset || header->magic.load(std::memory_order_acquire) != Magic ||
+        header->version != Version || header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0 ||
+        DataOffset + header->capacity > ring->mappedSize_) {
+        LOG_ERROR("Shared memory segment '{}' is not a compatible ring", name);
+        return nullptr;
+    }
+
+    ring->header_ = header;
+    ring->data_ = ring->mapping_ + DataOffset;
+    ring->capacity_ = static_cast<size_t>(header->capacity);
+    ring->mask_ = ring->capacity_ - 1;
+    return ring;
+}
+
+#ifdef _WIN32
+
+bool SharedMemoryRing::Map(size_t size, bool create) {
+    std::string segment = SegmentName(name_);
+    if (create) {
+        fileMapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                          static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                          static_cast<DWORD>(size & 0xFFFFFFFF), segment.c_str());
+        // Windows removes a segment with its last handle, so an existing one belongs to a live process
+        if (fileMapping_ != nullptr && GetLastError() == ERROR_ALREADY_EXISTS) {
+            LOG_ERROR("Shared memory segment '{}' is already in use", name_);
+            return false;
+        }
+        signalEvent_ = CreateEventA(nullptr, FALSE, FALSE, EventName(name_).c_str());
+    } else {
+        fileMapping_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, segment.c_str());
+        if (fileMapping_ == nullptr) {
+            return false;
+        }
+        signalEvent_ = OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, EventName(name_).c_str());
+    }
+    if (fileMapping_ == nullptr || signalEvent_ == nullptr) {
+        DWORD error = GetLastError(); // the log call may overwrite it
+        LOG_ERROR("Failed to create shared memory segment '{}', error {}", name_, error);
+        return false;
+    }
+
+    mapping_ = static_cast<unsigned char*>(MapViewOfFile(fileMapping_, FILE_MAP_ALL_ACCESS, 0, 0, create ? size : 0));
+    if (mapping_ == nullptr) {
+        DWORD error = GetLastError();
+        LOG_ERROR("Failed to map shared memory segment '{}', error {}", name_, error);
+        return false;
+    }
+    MEMORY_BASIC_INFORMATION info;
+    mappedSize_ = VirtualQuery(mapping_, &info, sizeof(info)) != 0 ? info.RegionSize : size;
+    return true;
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+    if (mapping_ != nullptr) {
+        UnmapViewOfFile(mapping_);
+    }
+    if (signalEvent_ != nullptr) {
+        CloseHandle(signalEvent_);
+    }
+    if (fileMapping_ != nullptr) {
+        CloseHandle(fileMapping_);
+    }
+}
+
+void SharedMemoryRing::PlatformWait(uint32_t, std::chrono::milliseconds timeout) {
+    // Auto-reset, so a SetEvent that raced ahead of this wait is not lost
+    WaitForSingleObject(signalEvent_, static_cast<DWORD>(timeout.count()));
+}
+
+void SharedMemoryRing::PlatformWake() {
+    SetEvent(signalEvent_);
+}
+
+#else
+
+bool SharedMemoryRing::Map(size_t size, bool create) {
+    std::string segment = SegmentName(name_);
+    if (create) {
+        // Segments outlive a process that crashes, so an existing one may be stale rather than in use
+        fd_ = shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd_ < 0 && errno == EEXIST) {
+            if (!UnlinkIfStale(segment)) {
+                LOG_ERROR("Shared memory segment '{}' is already in use", name_);
+                return false;
+            }
+            fd_ = shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        }
+        if (fd_ >= 0 && ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            int error = errno; // the log call may overwrite it
+            LOG_ERROR("Failed to size shared memory segment '{}': {}", name_, std::strerror(error));
+            return false;
+        }
+    } else {
+        fd_ = shm_open(segment.c_str(), O_RDWR, 0600);
+        struct stat status;
+        if (fd_ >= 0 && fstat(fd_, &status) == 0) {
+            size = static_cast<size_t>(status.st_size);
+        }
+    }
+    if (fd_ < 0) {
+        if (create) {
+            int error = errno;
+            LOG_ERROR("Failed to create shared memory segment '{}': {}", name_, std::strerror(error));
+        }
+        return false;
+    }
+    if (size == 0) {
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        int error = errno;
+        LOG_ERROR("Failed to map shared memory segment '{}': {}", name_, std::strerror(error));
+        return false;
+    }
+    mapping_ = static_cast<unsigned char*>(mapping);
+    mappedSize_ = size;
+    return true;
+}
+
+bool SharedMemoryRing::UnlinkIfStale(const std::string& segment) const {
+    int fd = shm_open(segment.c_str(), O_RDONLY, 0600);
+    if (fd < 0) {
+        return errno == ENOENT; // removed in the meantime
+    }
+
+    // A segment too small for a header, or without the magic, is still being created by its owner
+    uint32_t ownerPid = 0;
+    struct stat status;
+    if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= DataOffset) {
+        void* mapping = mmap(nullptr, DataOffset, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping != MAP_FAILED) {
+            const auto* header = static_cast<const Header*>(mapping);
+            if (header->magic.load(std::memory_order_acquire) == Magic) {
+                ownerPid = header->ownerPid;
+            }
+            munmap(mapping, DataOffset);
+        }
+    }
+    close(fd);
+
+    if (ownerPid == 0 || kill(static_cast<pid_t>(ownerPid), 0) == 0 || errno != ESRCH) {
+        return false;
+    }
+    LOG_WARNING("Replacing shared memory segment '{}' left behind by process {}", name_, ownerPid);
+    return shm_unlink(segment.c_str()) == 0 || errno == ENOENT;
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mappedSize_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+    if (owner_ && fd_ >= 0) {
+        shm_unlink(SegmentName(name_).c_str()); // the peer's mapping stays valid until it unmaps
+    }
+}
+
+#ifdef __linux__
+
+// A shared (not FUTEX_PRIVATE) futex, so it wakes waiters in other processes mapping the same page
+void SharedMemoryRing::PlatformWait(uint32_t signal, std::chrono::milliseconds timeout) {
+    timespec relative{static_cast<time_t>(timeout.count() / 1000), static_cast<long>(timeout.count() % 1000) * 1000000};
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->dataSignal), FUTEX_WAIT, signal, &relative, nullptr, 0);
+}
+
+void SharedMemoryRing::PlatformWake() {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->dataSignal), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+// No cross-process futex: poll the signal instead
+void SharedMemoryRing::PlatformWait(uint32_t signal, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (header_->dataSignal.load(std::memory_order_acquire) == signal && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+void SharedMemoryRing::PlatformWake() {}
+
+#endif
+#endif
+
+bool SharedMemoryRing::TryWrite(std::string_view frame) {
+    if (frame.size() > MaxFrameSize()) {
+        return false;
+    }
+
+    // Only this side moves the write position
+    uint64_t write = header_->writePosition.load(std::memory_order_relaxed);
+    uint64_t read = header_->readPosition.load(std::memory_order_acquire);
+    size_t frameSize = PaddedSize(frame.size());
+    size_t offset = static_cast<size_t>(write & mask_);
+    size_t contiguous = capacity_ - offset;
+    size_t needed = frameSize <= contiguous ? frameSize : contiguous + frameSize;
+    if (capacity_ - static_cast<size_t>(write - read) < needed) {
+        return false;
+    }
+
+    if (frameSize > contiguous) {
+        std::memcpy(data_ + offset, &PaddingMarker, sizeof(PaddingMarker));
+        write += contiguous;
+        offset = 0;
+    }
+    uint32_t length = static_cast<uint32_t>(frame.size());
+    std::memcpy(data_ + offset, &length, sizeof(length));
+    std::memcpy(data_ + offset + sizeof(length), frame.data(), frame.size());
+    header_->writePosition.store(write + frameSize, std::memory_order_release);
+
+    // Pairs with the fence in WaitReadable: either the reader sees this frame or this sees it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->readerWaiting.load(std::memory_order_relaxed) != 0) {
+        WakeReader();
+    }
+    return true;
+}
+
+size_t SharedMemoryRing::Read(const std::function<void(std::string_view)>& onFrame, size_t maxFrames) {
+    uint64_t read = header_->readPosition.load(std::memory_order_relaxed);
+    uint64_t write = header_->writePosition.load(std::memory_order_acquire);
+    size_t frames = 0;
+    while (read != write && frames < maxFrames) {
+        size_t offset = static_cast<size_t>(read & mask_);
+        uint32_t length;
+        std::memcpy(&length, data_ + offset, sizeof(length));
+        if (length == PaddingMarker) {
+            read += capacity_ - offset;
+            header_->readPosition.store(read, std::memory_order_release);
+            continue;
+        }
+        if (length > MaxFrameSize() || PaddedSize(length) > write - read) {
+            // Written by a peer that does not follow the layout; nothing after this point can be trusted
+            LOG_ERROR("Corrupt frame in shared memory ring '{}'; discarding unread data", name_);
+            header_->readPosition.store(write, std::memory_order_release);
+            break;
+        }
+
+        onFrame(std::string_view(reinterpret_cast<const char*>(data_ + offset + sizeof(length)), length));
+        read += PaddedSize(length);
+        header_->readPosition.store(read, std::memory_order_release);
+        ++frames;
+    }
+    return frames;
+}
+
+bool SharedMemoryRing::HasData() const {
+    return header_->writePosition.load(std::memory_order_acquire) != header_->readPosition.load(std::memory_order_relaxed);
+}
+
+bool SharedMemoryRing::WaitReadable(std::chrono::milliseconds timeout) {
+    if (HasData()) {
+        return true;
+    }
+
+    uint32_t signal = header_->dataSignal.load(std::memory_order_acquire);
+    header_->readerWaiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!HasData()) {
+        PlatformWait(signal, timeout);
+    }
+    header_->readerWaiting.store(0, std::memory_order_relaxed);
+    return HasData();
+}
+
+void SharedMemoryRing::WakeReader() {
+    header_->dataSignal.fetch_add(1, std::memory_order_release);
+    PlatformWake();
+}
@@ -0,0 +1,89 @@
+#ifndef SHARED_MEMORY_RING_H
+#define SHARED_MEMORY_RING_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * One-directional ring of length-prefixed frames in named shared memory, for one writer and one reader that may be
+ * in different processes on the same host. Frames are read in place, so receiving copies nothing.
+ *
+ * Layout, for peers written in other languages (native byte order, offsets in bytes):
+ *   0    uint32 magic "SFRB", 4 uint32 version, 8 uint64 data capacity (a power of two), 16 uint32 creator process id
+ *   64   uint64 write position, 128 uint64 read position; both count bytes since creation
+ *   192  uint32 data signal (the futex word), 196 uint32 reader-waiting flag
+ *   256  data. A frame is a uint32 length and the payload, padded to 8 bytes; a length of 0xFFFFFFFF skips to the end
+ *        of the buffer, and frames continue at offset 0.
+ * The writer advances the write position after copying a frame in, and bumps the data signal and wakes the reader
+ * only while the waiting flag is set, so a peer that cannot wait on a futex or event may simply poll.
+ */
+class SharedMemoryRing {
+public:
+    static constexpr size_t DefaultCapacity = 1 << 20;
+
+    // Creates the segment. One left behind by a run that exited without cleaning up is replaced, but one whose
+    // creator is still running is not. Returns null, logging why, on failure.
+    static std::unique_ptr<SharedMemoryRing> Create(const std::string& name, size_t capacity = DefaultCapacity);
+
+    // Opens a segment created by the peer. Returns null if it does not exist (yet) or is not a ring.
+    static std::unique_ptr<SharedMemoryRing> Open(const std::string& name);
+
+    ~SharedMemoryRing();
+
+    SharedMemoryRing(const SharedMemoryRing&) = delete;
+    SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+    // Writer side. Returns false if the frame does not fit in the free space, or is larger than MaxFrameSize.
+    bool TryWrite(std::string_view frame);
+
+    // Reader side. Passes up to `maxFrames` frames to `onFrame`, freeing each one's space once the call returns.
+    size_t Read(const std::function<void(std::string_view)>& onFrame, size_t maxFrames = std::numeric_limits<size_t>::max());
+
+    // Reader side. Returns true once a frame is readable, false if `timeout` passed or WakeReader was called first.
+    bool WaitReadable(std::chrono::milliseconds timeout);
+
+    // Interrupts WaitReadable, e.g. for shutdown; may be called from either process.
+    void WakeReader();
+
+    bool HasData() const;
+    size_t Capacity() const { return capacity_; }
+    size_t MaxFrameSize() const { return capacity_ / 2 - sizeof(uint32_t); } // always fits once the reader catches up
+    const std::string& GetName() const { return name_; }
+
+private:
+    struct Header;
+
+    SharedMemoryRing(std::string name, bool owner);
+
+    bool Map(size_t size, bool create);
+#ifndef _WIN32
+    // Unlinks the existing segment if it is a ring whose creator process no longer exists.
+    bool UnlinkIfStale(const std::string& segment) const;
+#endif
+    void PlatformWait(uint32_t signal, std::chrono::milliseconds timeout);
+    void PlatformWake();
+
+    std::string name_;
+    bool owner_;
+    unsigned char* mapping_ = nullptr;
+    size_t mappedSize_ = 0;
+    Header* header_ = nullptr;
+    unsigned char* data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+
+#ifdef _WIN32
+    void* fileMapping_ = nullptr;
+    void* signalEvent_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+#endif // SHARED_MEMORY_RING_H
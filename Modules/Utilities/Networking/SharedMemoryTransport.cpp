@@ -0,0 +1,102 @@
+#include "SharedMemoryTransport.h"
+#include "Logger.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHARED_MEMORY_TRANSPORT_PAUSE() _mm_pause()
+#else
+#define SHARED_MEMORY_TRANSPORT_PAUSE() std::this_thread::yield()
+#endif
+
+namespace {
+    // Upper bound on a receiving thread's sleep, so it notices shutdown even if the wake-up is lost
+    constexpr std::chrono::milliseconds IdleWait{100};
+}
+
+SharedMemoryTransport::SharedMemoryTransport(const std::string& name, Role role, size_t capacity, uint32_t spinIterations)
+    : spinIterations_(spinIterations), subscribers_(std::make_shared<const std::vector<MessageCallback>>()) {
+    std::string toPeer = name + "-to-peer";
+    std::string toHost = name + "-to-host";
+    if (role == Role::Host) {
+        outgoing_ = SharedMemoryRing::Create(toPeer, capacity);
+        incoming_ = SharedMemoryRing::Create(toHost, capacity);
+    } else {
+        outgoing_ = SharedMemoryRing::Open(toHost);
+        incoming_ = SharedMemoryRing::Open(toPeer);
+    }
+
+    if (!IsOpen()) {
+        outgoing_.reset();
+        incoming_.reset();
+        return;
+    }
+    running_.store(true);
+    receiveThread_ = std::thread(&SharedMemoryTransport::ReceiveLoop, this);
+}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+    {
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        running_.store(false);
+    }
+    subscribed_.notify_all();
+    if (incoming_) {
+        incoming_->WakeReader();
+    }
+    if (receiveThread_.joinable()) {
+        receiveThread_.join();
+    }
+}
+
+bool SharedMemoryTransport::Send(std::string_view message) {
+    bool sent = false;
+    if (outgoing_) {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        sent = outgoing_->TryWrite(message);
+    }
+    if (!sent) {
+        failedSends_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return sent;
+}
+
+void SharedMemoryTransport::Subscribe(MessageCallback callback) {
+    std::lock_guard<std::mutex> lock(subscribersMutex_);
+    auto updated = std::make_shared<std::vector<MessageCallback>>(*subscribers_);
+    updated->push_back(std::move(callback));
+    subscribers_ = std::move(updated);
+    subscribed_.notify_all();
+}
+
+void SharedMemoryTransport::ReceiveLoop() {
+    {
+        std::unique_lock<std::mutex> lock(subscribersMutex_);
+        subscribed_.wait(lock, [this] { return !running_.load() || !subscribers_->empty(); });
+    }
+
+    while (running_.load()) {
+        bool readable = incoming_->HasData();
+        for (uint32_t i = 0; i < spinIterations_ && !readable; ++i) {
+            SHARED_MEMORY_TRANSPORT_PAUSE();
+            readable = incoming_->HasData();
+        }
+        if (!readable && !incoming_->WaitReadable(IdleWait)) {
+            continue;
+        }
+
+        std::shared_ptr<const std::vector<MessageCallback>> subscribers;
+        {
+            std::lock_guard<std::mutex> lock(subscribersMutex_);
+            subscribers = subscribers_;
+        }
+        incoming_->Read([&subscribers](std::string_view message) {
+            for (const auto& callback : *subscribers) {
+                try {
+                    callback(message);
+                } catch (const std::exception& e) {
+                    LOG_ERROR("Shared memory subscriber threw: {}", e.what());
+                }
+            }
+        });
+    }
+}
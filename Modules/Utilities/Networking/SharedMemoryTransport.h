@@ -0,0 +1,62 @@
+#ifndef SHARED_MEMORY_TRANSPORT_H
+#define SHARED_MEMORY_TRANSPORT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "IMessageTransport.h"
+#include "SharedMemoryRing.h"
+
+/**
+ * IMessageTransport over a pair of shared memory rings, for a peer on the same host. The host creates
+ * "<name>-to-peer" and "<name>-to-host"; the peer opens them, so the host has to start first.
+ * Messages are delivered to subscribers straight out of the ring on a receiving thread, which spins for
+ * `spinIterations` before sleeping on the ring's futex (a named event on Windows). Nothing is read until
+ * the first Subscribe, so early messages wait in the ring.
+ */
+class SharedMemoryTransport : public IMessageTransport {
+public:
+    enum class Role {
+        Host,
+        Peer
+    };
+
+    SharedMemoryTransport(const std::string& name, Role role, size_t capacity = SharedMemoryRing::DefaultCapacity,
+                          uint32_t spinIterations = 0);
+    ~SharedMemoryTransport() override;
+
+    SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+    SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+    // False if the rings could not be created or, for a peer, the host has not created them.
+    bool IsOpen() const { return outgoing_ && incoming_; }
+
+    // Returns false if the transport is not open, the message is too large, or the peer has fallen a full ring behind.
+    bool Send(std::string_view message) override;
+    void Subscribe(MessageCallback callback) override;
+
+    uint64_t GetFailedSends() const { return failedSends_.load(std::memory_order_relaxed); }
+
+private:
+    void ReceiveLoop();
+
+    uint32_t spinIterations_;
+    std::unique_ptr<SharedMemoryRing> outgoing_;
+    std::unique_ptr<SharedMemoryRing> incoming_;
+    std::mutex sendMutex_; // a ring has a single writer
+
+    std::mutex subscribersMutex_;
+    std::shared_ptr<const std::vector<MessageCallback>> subscribers_; // replaced, never modified
+    std::condition_variable subscribed_;
+
+    std::atomic<uint64_t> failedSends_{0};
+    std::atomic<bool> running_{false};
+    std::thread receiveThread_;
+};
+
+#endif // SHARED_MEMORY_TRANSPORT_H
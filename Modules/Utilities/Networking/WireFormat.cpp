@@ -0,0 +1,131 @@
+#include "WireFormat.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+    std::string_view Trim(std::string_view value) {
+        while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) {
+            value.remove_suffix(1);
+        }
+        return value;
+    }
+
+    bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+            return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+        });
+    }
+
+    // Media type without parameters
+    std::string_view MediaType(std::string_view value) {
+        return Trim(value.substr(0, value.find(';')));
+    }
+
+    std::optional<WireFormat> FromMediaType(std::string_view type) {
+        if (EqualsIgnoreCase(type, "application/json")) {
+            return WireFormat::Json;
+        }
+        if (EqualsIgnoreCase(type, "application/msgpack") || EqualsIgnoreCase(type, "application/x-msgpack")) {
+            return WireFormat::MessagePack;
+        }
+        if (EqualsIgnoreCase(type, "application/cbor")) {
+            return WireFormat::Cbor;
+        }
+        return std::nullopt;
+    }
+}
+
+const char* ContentTypeOf(WireFormat format) {
+    switch (format) {
+        case WireFormat::MessagePack:
+            return "application/msgpack";
+        case WireFormat::Cbor:
+            return "application/cbor";
+        case WireFormat::Json:
+        default:
+            return "application/json";
+    }
+}
+
+std::optional<WireFormat> WireFormatFromContentType(std::string_view contentType) {
+    std::string_view type = MediaType(contentType);
+    if (type.empty()) {
+        return WireFormat::Json;
+    }
+    return FromMediaType(type);
+}
+
+std::string AcceptHeaderFor(WireFormat preferred) {
+    if (preferred == WireFormat::Json) {
+        return "application/json";
+    }
+    return std::string(ContentTypeOf(preferred)) + ", application/json;q=0.5";
+}
+
+WireFormat NegotiateWireFormat(std::string_view accept) {
+    WireFormat best = WireFormat::Json;
+    double bestQuality = 0.0;
+    while (!accept.empty()) {
+        size_t comma = accept.find(',');
+        std::string_view range = accept.substr(0, comma);
+        accept = comma == std::string_view::npos ? std::string_view() : accept.substr(comma + 1);
+
+        double quality = 1.0;
+        for (size_t semicolon = range.find(';'); semicolon != std::string_view::npos;) {
+            size_t next = range.find(';', semicolon + 1);
+            std::string_view parameter = Trim(range.substr(semicolon + 1, next == std::string_view::npos ? std::string_view::npos : next - semicolon - 1));
+            if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+                quality = std::atof(std::string(parameter.substr(2)).c_str());
+            }
+            semicolon = next;
+        }
+
+        std::string_view type = MediaType(range);
+        std::optional<WireFormat> format = FromMediaType(type);
+        if (!format && (type == "*/*" || EqualsIgnoreCase(type, "application/*"))) {
+            format = WireFormat::Json;
+        }
+        if (format && quality > bestQuality) {
+            best = *format;
+            bestQuality = quality;
+        }
+    }
+    return best;
+}
+
+std::string EncodeWire(const nlohmann::json& document, WireFormat format) {
+    std::string body;
+    switch (format) {
+        case WireFormat::MessagePack:
+            nlohmann::json::to_msgpack(document, body);
+            break;
+        case WireFormat::Cbor:
+            nlohmann::json::to_cbor(document, body);
+            break;
+        case WireFormat::Json:
+        default:
+            body = document.dump();
+            break;
+    }
+    return body;
+}
+
+nlohmann::json DecodeWire(std::string_view body, WireFormat format) {
+    switch (format) {
+        case WireFormat::MessagePack:
+            return nlohmann::json::from_msgpack(body.begin(), body.end());
+        case WireFormat::Cbor:
+            return nlohmann::json::from_cbor(body.begin(), body.end());
+        case WireFormat::Json:
+        default:
+            return nlohmann::json::parse(body.begin(), body.end());
+    }
+}
+
+nlohmann::json DecodeWire(std::string_view body, std::string_view contentType) {
+    return DecodeWire(body, WireFormatFromContentType(contentType).value_or(WireFormat::Json));
+}
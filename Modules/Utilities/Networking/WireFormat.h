@@ -0,0 +1,38 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include "nlohmann/json.hpp"
+
+// Encodings of the JSON documents exchanged with the data and tuning servers. The binary ones carry the same
+// documents, so either end can fall back to JSON; they are smaller and much faster to encode and parse, which
+// matters for large DataBlobs.
+enum class WireFormat {
+    Json,
+    MessagePack,
+    Cbor
+};
+
+const char* ContentTypeOf(WireFormat format);
+
+// Format named by a Content-Type header, ignoring parameters such as charset. JSON if the header is empty,
+// nullopt if it names anything else.
+std::optional<WireFormat> WireFormatFromContentType(std::string_view contentType);
+
+// Accept header asking for `preferred`, with JSON as the fallback.
+std::string AcceptHeaderFor(WireFormat preferred);
+
+// The format an Accept header ranks highest (earliest on ties) among those supported; JSON if it names none of them.
+WireFormat NegotiateWireFormat(std::string_view accept);
+
+std::string EncodeWire(const nlohmann::json& document, WireFormat format);
+
+// Throws nlohmann::json::exception on a malformed body, like json::parse.
+nlohmann::json DecodeWire(std::string_view body, WireFormat format);
+
+// Decodes a body in the format its Content-Type names, assuming JSON for an unknown one.
+nlohmann::json DecodeWire(std::string_view body, std::string_view contentType);
+
+#endif // WIRE_FORMAT_H
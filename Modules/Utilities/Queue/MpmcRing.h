@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+// Bounded lock-free queue that any number of threads may push to and pop from.
+// Each slot carries a sequence number telling producers and consumers whose turn it is, so a push or pop is one CAS on
+// the shared position plus one release store on the slot (D. Vyukov's bounded MPMC queue). Values are moved in and out,
+// so move-only types are supported; the capacity is rounded up to a power of two.
+template <typename T>
+class MpmcRing {
+public:
+    explicit MpmcRing(size_t capacity)
+        : capacity_(RoundUpToPowerOfTwo(capacity)), mask_(capacity_ - 1), cells_(new Cell[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpmcRing() {
+        // No other thread may use the ring by now
+        size_t tail = dequeuePosition_.load(std::memory_order_relaxed);
+        size_t head = enqueuePosition_.load(std::memory_order_relaxed);
+        for (; tail != head; ++tail) {
+            cells_[tail & mask_].Value()->~T();
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    // Returns false, leaving `value` untouched, if the ring is full.
+    template <typename U>
+    bool TryPush(U&& value) {
+        size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[position & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->storage) T(std::forward<U>(value));
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns std::nullopt if the ring is empty.
+    std::optional<T> TryPop() {
+        size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[position & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (difference == 0) {
+                if (dequeuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return std::nullopt;
+            } else {
+                position = dequeuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+        T* value = cell->Value();
+        std::optional<T> result(std::move(*value));
+        value->~T();
+        cell->sequence.store(position + capacity_, std::memory_order_release);
+        return result;
+    }
+
+    // Approximate while other threads are pushing or popping.
+    size_t Size() const {
+        size_t head = enqueuePosition_.load(std::memory_order_acquire);
+        size_t tail = dequeuePosition_.load(std::memory_order_acquire);
+        return head >= tail ? head - tail : 0;
+    }
+
+    bool Empty() const { return Size() == 0; }
+    size_t Capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* Value() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    static size_t RoundUpToPowerOfTwo(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    // Producers and consumers contend on different cache lines
+    alignas(64) std::atomic<size_t> enqueuePosition_{0};
+    alignas(64) std::atomic<size_t> dequeuePosition_{0};
+};
@@ -10,6 +10,9 @@ class ThreadPool
 {
 public:
     static ThreadPool &Instance(size_t numThreads = 8); // Default to 8 threads
+
+    // Components whose tasks must not wait behind unrelated work on the shared instance own a pool of their own
+    explicit ThreadPool(size_t numThreads);
     ~ThreadPool();
 
     ThreadPool(const ThreadPool &) = delete;
@@ -21,8 +24,6 @@ public:
     void Join();
 
 private:
-    ThreadPool(size_t numThreads);
-
     static std::unique_ptr<ThreadPool> instance;
     static std::once_flag initFlag;
 
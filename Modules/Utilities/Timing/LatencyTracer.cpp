@@ -0,0 +1,76 @@
+#include "LatencyTracer.h"
+
+LatencyTracer& LatencyTracer::Instance() {
+    static LatencyTracer instance;
+    return instance;
+}
+
+void LatencyTracer::Record(const TraceContext& trace) {
+    if (!trace.IsActive()) {
+        return;
+    }
+
+    uint64_t index = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[index & (Capacity - 1)];
+
+    // Claim the slot so a writer that has lapped the ring never interleaves with another one on the same slot;
+    // the trace is dropped if the slot is still being written or already holds a newer trace.
+    uint64_t current = slot.version.load(std::memory_order_relaxed);
+    do {
+        if ((current & 1) != 0 || current > 2 * index) {
+            return;
+        }
+    } while (!slot.version.compare_exchange_weak(current, 2 * index + 1, std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.iteration.store(trace.iteration, std::memory_order_relaxed);
+    slot.processStartNs.store(trace.processStartNs, std::memory_order_relaxed);
+    for (size_t i = 0; i < TraceContext::StageCount; ++i) {
+        slot.stageTimestampsNs[i].store(trace.stageTimestampsNs[i], std::memory_order_relaxed);
+    }
+
+    slot.version.store(2 * index + 2, std::memory_order_release);
+}
+
+std::vector<TraceContext> LatencyTracer::Snapshot() const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t start = head > Capacity ? head - Capacity : 0;
+
+    std::vector<TraceContext> traces;
+    traces.reserve(static_cast<size_t>(head - start));
+
+    for (uint64_t index = start; index < head; ++index) {
+        const Slot& slot = slots_[index & (Capacity - 1)];
+        uint64_t expectedVersion = 2 * index + 2;
+
+        if (slot.version.load(std::memory_order_acquire) != expectedVersion) {
+            continue; // still being written, or already overwritten
+        }
+
+        TraceContext trace;
+        trace.iteration = slot.iteration.load(std::memory_order_relaxed);
+        trace.processStartNs = slot.processStartNs.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < TraceContext::StageCount; ++i) {
+            trace.stageTimestampsNs[i] = slot.stageTimestampsNs[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) == expectedVersion) {
+            traces.push_back(trace);
+        }
+    }
+
+    return traces;
+}
+
+std::string LatencyTracer::ExportJson() const {
+    nlohmann::json spans = nlohmann::json::array();
+    for (const auto& trace : Snapshot()) {
+        spans.push_back(trace.ToJson());
+    }
+    return spans.dump();
+}
+
+uint64_t LatencyTracer::GetRecordedCount() const {
+    return head_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "CommonTypes.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Fixed-size, lock-free ring of completed signal-to-order traces.
+// Writers never block: each Record claims the next slot and overwrites the oldest entry once the ring is full.
+// Slots are versioned so Snapshot can skip entries that were being overwritten while it read them; a writer that
+// finds its slot still being written by one a full lap behind drops its trace instead of mixing the two.
+class LatencyTracer {
+public:
+    static constexpr size_t Capacity = 4096; // must be a power of two
+
+    static LatencyTracer& Instance();
+
+    void Record(const TraceContext& trace);
+
+    // Returns the traces currently held in the ring, oldest first.
+    std::vector<TraceContext> Snapshot() const;
+
+    // Serializes Snapshot() as a JSON array for export.
+    std::string ExportJson() const;
+
+    uint64_t GetRecordedCount() const;
+
+private:
+    LatencyTracer() = default;
+    LatencyTracer(const LatencyTracer&) = delete;
+    LatencyTracer& operator=(const LatencyTracer&) = delete;
+
+    struct Slot {
+        std::atomic<uint64_t> version{0}; // odd while being written, 2 * (index + 1) once complete
+        std::atomic<uint64_t> iteration{0};
+        std::atomic<int64_t> processStartNs{0};
+        std::array<std::atomic<int64_t>, TraceContext::StageCount> stageTimestampsNs{};
+    };
+
+    static_assert((Capacity & (Capacity - 1)) == 0, "LatencyTracer capacity must be a power of two");
+
+    std::array<Slot, Capacity> slots_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
@@ -0,0 +1,804 @@
+#include <gtest/gtest.h>
+#include "Calculations.h"
+#include "StreamingIndicators.h"
+#include "IndicatorKernels.h"
+#include "IndicatorSet.h"
+#include "IndicatorCache.h"
+#include "VolumeProfile.h"
+#include "OrderFlow.h"
+#include "PerformanceMetrics.h"
+#include "CorrelationMatrix.h"
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace {
+    std::vector<float> RandomWalk(size_t count, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::normal_distribution<float> step(0.0f, 0.25f);
+        std::vector<float> prices;
+        prices.reserve(count);
+        float price = 4500.0f;
+        for (size_t i = 0; i < count; ++i) {
+            price += step(rng);
+            prices.push_back(price);
+        }
+        return prices;
+    }
+
+    std::vector<float> Prefix(const std::vector<float>& data, size_t count) {
+        return std::vector<float>(data.begin(), data.begin() + count);
+    }
+
+    // The original quadratic MACD definition: every MACD line value recomputes both EMAs over its trailing window
+    std::pair<float, float> ReferenceMACD(const std::vector<float>& data, int shortLength, int longLength, int signalLength) {
+        std::vector<float> macdLine;
+        for (size_t i = longLength - 1; i < data.size(); ++i) {
+            std::vector<float> window(data.begin() + i - longLength + 1, data.begin() + i + 1);
+            macdLine.push_back(Calculations::CalculateEMA(window, shortLength) - Calculations::CalculateEMA(window, longLength));
+        }
+        return std::make_pair(macdLine.back(), Calculations::CalculateEMA(macdLine, signalLength));
+    }
+
+    // Relative tolerance: the batch functions accumulate in float, the streaming ones in double
+    void ExpectClose(double expected, double actual, double relative = 1e-5) {
+        EXPECT_NEAR(expected, actual, std::max(1e-4, std::abs(expected) * relative));
+    }
+}
+
+TEST(StreamingIndicatorsTest, RingBufferEvictsOldest) {
+    Calculations::RingBuffer<int> buffer(3);
+    EXPECT_EQ(buffer.Push(1), 0);
+    EXPECT_EQ(buffer.Push(2), 0);
+    EXPECT_EQ(buffer.Push(3), 0);
+    EXPECT_TRUE(buffer.Full());
+    EXPECT_EQ(buffer.Push(4), 1);
+    EXPECT_EQ(buffer.Oldest(), 2);
+    EXPECT_EQ(buffer.Newest(), 4);
+}
+
+TEST(StreamingIndicatorsTest, SMAMatchesBatch) {
+    const int length = 20;
+    auto prices = RandomWalk(500, 1);
+    Calculations::StreamingSMA sma(length);
+    for (size_t i = 0; i < prices.size(); ++i) {
+        sma.Update(prices[i]);
+        if (i + 1 >= length) {
+            ExpectClose(Calculations::CalculateSMA(Prefix(prices, i + 1), length), sma.Value());
+        }
+    }
+}
+
+TEST(StreamingIndicatorsTest, EMAMatchesBatch) {
+    const int length = 14;
+    auto prices = RandomWalk(500, 2);
+    Calculations::StreamingEMA ema(length);
+    for (size_t i = 0; i < prices.size(); ++i) {
+        ema.Update(prices[i]);
+        if (i + 1 >= length) {
+            ASSERT_TRUE(ema.IsReady());
+            ExpectClose(Calculations::CalculateEMA(Prefix(prices, i + 1), length), ema.Value());
+        }
+    }
+}
+
+TEST(StreamingIndicatorsTest, VarianceAndBollingerMatchBatch) {
+    const int length = 20;
+    auto prices = RandomWalk(3000, 3);
+    Calculations::StreamingVariance variance(length);
+    Calculations::StreamingBollingerBands bands(length, 2.0);
+    for (size_t i = 0; i < prices.size(); ++i) {
+        variance.Update(prices[i]);
+        bands.Update(prices[i]);
+        if (i + 1 >= length && i % 7 == 0) {
+            auto window = Prefix(prices, i + 1);
+            // float batch variance of values near 4500 loses precision, so compare standard deviations absolutely
+            EXPECT_NEAR(Calculations::StandardDeviation(window, length), std::sqrt(variance.Value()), 2e-3);
+
+            auto [upper, middle, lower] = Calculations::CalculateBollingerBands(window, length, 2.0f);
+            auto [streamUpper, streamMiddle, streamLower] = bands.Value();
+            EXPECT_NEAR(upper, streamUpper, 5e-3);
+            EXPECT_NEAR(middle, streamMiddle, 5e-3);
+            EXPECT_NEAR(lower, streamLower, 5e-3);
+        }
+    }
+}
+
+TEST(StreamingIndicatorsTest, RSIMatchesBatch) {
+    const int length = 14;
+    auto prices = RandomWalk(300, 4);
+    std::vector<float> gains;
+    std::vector<float> losses;
+    Calculations::StreamingRSI rsi(length);
+    rsi.UpdatePrice(prices[0]);
+    for (size_t i = 1; i < prices.size(); ++i) {
+        float change = prices[i] - prices[i - 1];
+        gains.push_back(std::max(change, 0.0f));
+        losses.push_back(std::max(-change, 0.0f));
+        rsi.UpdatePrice(prices[i]);
+        if (gains.size() >= length) {
+            EXPECT_NEAR(Calculations::CalculateRSI(gains, losses, length), rsi.Value(), 0.05);
+        }
+    }
+}
+
+TEST(StreamingIndicatorsTest, MACDMatchesReference) {
+    auto prices = RandomWalk(400, 5);
+    Calculations::StreamingMACD macd(12, 26, 9);
+    for (size_t i = 0; i < prices.size(); ++i) {
+        macd.Update(prices[i]);
+        if (macd.IsReady() && i % 10 == 0) {
+            // The float reference carries roughly 1e-3 of rounding noise at prices near 4500
+            auto window = Prefix(prices, i + 1);
+            auto [referenceMacd, referenceSignal] = ReferenceMACD(window, 12, 26, 9);
+            EXPECT_NEAR(referenceMacd, macd.Macd(), 5e-3);
+            EXPECT_NEAR(referenceSignal, macd.Signal(), 5e-3);
+
+            auto [batchMacd, batchSignal] = Calculations::CalculateMACD(window, 12, 26, 9);
+            EXPECT_NEAR(referenceMacd, batchMacd, 5e-3);
+            EXPECT_NEAR(referenceSignal, batchSignal, 5e-3);
+        }
+    }
+}
+
+TEST(StreamingIndicatorsTest, RejectsInvalidLength) {
+    EXPECT_THROW(Calculations::StreamingSMA(0), std::invalid_argument);
+    EXPECT_THROW(Calculations::StreamingEMA(-1), std::invalid_argument);
+    EXPECT_THROW(Calculations::StreamingVariance(0), std::invalid_argument);
+
+    std::vector<float> prices(100, 4500.0f);
+    EXPECT_THROW(Calculations::CalculateMACD(prices, 26, 12, 9), std::invalid_argument);
+    EXPECT_THROW(Calculations::CalculateMACD(prices, 12, 12, 9), std::invalid_argument);
+}
+
+namespace {
+    using Calculations::Kernels::KernelIsa;
+
+    std::vector<KernelIsa> SupportedIsas() {
+        std::vector<KernelIsa> isas;
+        for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::SSE2, KernelIsa::AVX2}) {
+            if (Calculations::Kernels::IsKernelIsaSupported(isa)) {
+                isas.push_back(isa);
+            }
+        }
+        return isas;
+    }
+
+    // Restores the detected instruction set when a test finishes
+    struct ScopedKernelIsa {
+        explicit ScopedKernelIsa(KernelIsa isa) : previous(Calculations::Kernels::GetActiveKernelIsa()) {
+            EXPECT_TRUE(Calculations::Kernels::SetActiveKernelIsa(isa));
+        }
+        ~ScopedKernelIsa() { Calculations::Kernels::SetActiveKernelIsa(previous); }
+        KernelIsa previous;
+    };
+
+    std::vector<double> ToDouble(const std::vector<float>& data) {
+        return std::vector<double>(data.begin(), data.end());
+    }
+
+    void ExpectColumnsEqual(const std::vector<double>& expected, const std::vector<double>& actual, double tolerance) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (std::isnan(expected[i])) {
+                EXPECT_TRUE(std::isnan(actual[i])) << "index " << i;
+            } else {
+                EXPECT_NEAR(expected[i], actual[i], tolerance) << "index " << i;
+            }
+        }
+    }
+}
+
+TEST(IndicatorKernelsTest, ScalarIsAlwaysSupported) {
+    EXPECT_TRUE(Calculations::Kernels::IsKernelIsaSupported(KernelIsa::Scalar));
+    EXPECT_TRUE(Calculations::Kernels::IsKernelIsaSupported(Calculations::Kernels::GetActiveKernelIsa()));
+}
+
+TEST(IndicatorKernelsTest, MatchesBatchCalculations) {
+    const int length = 20;
+    auto prices = RandomWalk(600, 6);
+    auto input = ToDouble(prices);
+    size_t count = input.size();
+
+    std::vector<double> sma(count), ema(count), stdDev(count), upper(count), middle(count), lower(count), rsi(count), macd(count), signal(count);
+    Calculations::Kernels::ComputeSMA(input.data(), count, length, sma.data());
+    Calculations::Kernels::ComputeEMA(input.data(), count, length, ema.data());
+    Calculations::Kernels::ComputeStandardDeviation(input.data(), count, length, stdDev.data());
+    Calculations::Kernels::ComputeBollingerBands(input.data(), count, length, 2.0, upper.data(), middle.data(), lower.data());
+    Calculations::Kernels::ComputeRSI(input.data(), count, 14, rsi.data());
+    Calculations::Kernels::ComputeMACD(input.data(), count, 12, 26, 9, macd.data(), signal.data());
+
+    EXPECT_TRUE(std::isnan(sma[length - 2]));
+    EXPECT_TRUE(std::isnan(rsi[13]));
+    EXPECT_TRUE(std::isnan(signal[26 + 9 - 3]));
+
+    std::vector<float> gains;
+    std::vector<float> losses;
+    for (size_t i = 1; i < count; ++i) {
+        float change = prices[i] - prices[i - 1];
+        gains.push_back(std::max(change, 0.0f));
+        losses.push_back(std::max(-change, 0.0f));
+    }
+
+    for (size_t i = length - 1; i < count; i += 13) {
+        auto window = Prefix(prices, i + 1);
+        ExpectClose(Calculations::CalculateSMA(window, length), sma[i]);
+        ExpectClose(Calculations::CalculateEMA(window, length), ema[i]);
+        EXPECT_NEAR(Calculations::StandardDeviation(window, length), stdDev[i], 2e-3);
+
+        auto [batchUpper, batchMiddle, batchLower] = Calculations::CalculateBollingerBands(window, length, 2.0f);
+        EXPECT_NEAR(batchUpper, upper[i], 5e-3);
+        EXPECT_NEAR(batchMiddle, middle[i], 5e-3);
+        EXPECT_NEAR(batchLower, lower[i], 5e-3);
+
+        if (i >= 14) {
+            std::vector<float> gainWindow(gains.begin(), gains.begin() + i);
+            std::vector<float> lossWindow(losses.begin(), losses.begin() + i);
+            EXPECT_NEAR(Calculations::CalculateRSI(gainWindow, lossWindow, 14), rsi[i], 0.05);
+        }
+        if (i >= 26 + 9 - 2) {
+            auto [batchMacd, batchSignal] = Calculations::CalculateMACD(window, 12, 26, 9);
+            EXPECT_NEAR(batchMacd, macd[i], 5e-3);
+            EXPECT_NEAR(batchSignal, signal[i], 5e-3);
+        }
+    }
+}
+
+TEST(IndicatorKernelsTest, SimdPathsAgreeWithScalar) {
+    auto prices = ToDouble(RandomWalk(1003, 7)); // odd length exercises the remainder loops
+    std::vector<double> volumes(prices.size());
+    for (size_t i = 0; i < volumes.size(); ++i) {
+        volumes[i] = 1.0 + static_cast<double>((i * 37) % 101);
+    }
+    size_t count = prices.size();
+
+    auto computeAll = [&](KernelIsa isa) {
+        ScopedKernelIsa scoped(isa);
+        std::vector<std::vector<double>> columns(9, std::vector<double>(count));
+        Calculations::Kernels::ComputeSMA(prices.data(), count, 21, columns[0].data());
+        Calculations::Kernels::ComputeVariance(prices.data(), count, 21, columns[1].data());
+        Calculations::Kernels::ComputeBollingerBands(prices.data(), count, 21, 2.0, columns[2].data(), columns[3].data(), columns[4].data());
+        Calculations::Kernels::ComputeRSI(prices.data(), count, 14, columns[5].data());
+        Calculations::Kernels::ComputeMACD(prices.data(), count, 12, 26, 9, columns[6].data(), columns[7].data());
+        Calculations::Kernels::ComputeVWAP(prices.data(), volumes.data(), count, columns[8].data());
+        return columns;
+    };
+
+    auto scalar = computeAll(KernelIsa::Scalar);
+    for (KernelIsa isa : SupportedIsas()) {
+        SCOPED_TRACE(Calculations::Kernels::ToString(isa));
+        auto vectorized = computeAll(isa);
+        for (size_t column = 0; column < scalar.size(); ++column) {
+            ExpectColumnsEqual(scalar[column], vectorized[column], 1e-9);
+        }
+    }
+}
+
+TEST(IndicatorKernelsTest, FloatColumnsAndShortInput) {
+    auto prices = RandomWalk(50, 8);
+    std::vector<float> sma(prices.size());
+    Calculations::Kernels::ComputeSMA(prices.data(), prices.size(), 10, sma.data());
+    ExpectClose(Calculations::CalculateSMA(prices, 10), sma.back());
+
+    std::vector<float> shortOutput(5);
+    Calculations::Kernels::ComputeEMA(prices.data(), 5, 10, shortOutput.data());
+    for (float value : shortOutput) {
+        EXPECT_TRUE(std::isnan(value));
+    }
+
+    EXPECT_THROW(Calculations::Kernels::ComputeSMA(prices.data(), prices.size(), 0, sma.data()), std::invalid_argument);
+}
+
+TEST(IndicatorKernelsTest, VWAPMatchesBatch) {
+    std::vector<BarData> bars;
+    std::vector<double> prices;
+    std::vector<double> volumes;
+    auto closes = RandomWalk(40, 9);
+    for (size_t i = 0; i < closes.size(); ++i) {
+        DateTime time(std::chrono::system_clock::now());
+        BarData bar(time, time, closes[i] - 0.25, closes[i] + 0.5, closes[i] - 0.5, closes[i], 100.0 + static_cast<double>(i));
+        bars.push_back(bar);
+        prices.push_back(Calculations::CalculateOHLCAvg(bar));
+        volumes.push_back(bar.volume.value());
+    }
+
+    std::vector<double> vwap(prices.size());
+    Calculations::Kernels::ComputeVWAP(prices.data(), volumes.data(), prices.size(), vwap.data());
+    EXPECT_NEAR(Calculations::CalculateVWAP(bars), vwap.back(), 1e-9);
+}
+
+TEST(IndicatorSetTest, BarVWAPMatchesBatch) {
+    Calculations::IndicatorSet set;
+    auto ema = set.AddEMA(12);
+    auto vwap = set.AddVWAP();
+    Calculations::StreamingEMA expectedEma(12);
+
+    std::vector<BarData> bars;
+    auto closes = RandomWalk(40, 11);
+    for (size_t i = 0; i < closes.size(); ++i) {
+        DateTime time(std::chrono::system_clock::now());
+        BarData bar(time, time, closes[i] - 0.25, closes[i] + 0.5, closes[i] - 0.5, closes[i], 100.0 + static_cast<double>(i));
+        bars.push_back(bar);
+        set.Update(bar);
+        expectedEma.Update(bar.close);
+
+        EXPECT_NEAR(Calculations::CalculateVWAP(bars), set.Value(vwap), 1e-9);
+        EXPECT_NEAR(expectedEma.Value(), set.Value(ema), 1e-9);
+    }
+}
+
+TEST(IndicatorSetTest, MatchesIndividualStreamingIndicators) {
+    Calculations::IndicatorSet set;
+    auto sma = set.AddSMA(20);
+    auto stdDev = set.AddStandardDeviation(20);
+    auto bands = set.AddBollingerBands(20, 2.0);
+    auto ema = set.AddEMA(12);
+    auto rsi = set.AddRSI(14);
+    auto macd = set.AddMACD(12, 26, 9);
+    auto vwap = set.AddVWAP();
+
+    Calculations::StreamingSMA expectedSma(20);
+    Calculations::StreamingStandardDeviation expectedStdDev(20);
+    Calculations::StreamingBollingerBands expectedBands(20, 2.0);
+    Calculations::StreamingEMA expectedEma(12);
+    Calculations::StreamingRSI expectedRsi(14);
+    Calculations::StreamingMACD expectedMacd(12, 26, 9);
+
+    auto prices = ToDouble(RandomWalk(500, 10));
+    std::vector<double> volumes(prices.size(), 2.0);
+    double priceVolume = 0.0;
+    double volume = 0.0;
+
+    set.UpdateHistory(prices.data(), volumes.data(), prices.size(), [&](size_t i) {
+        expectedSma.Update(prices[i]);
+        expectedStdDev.Update(prices[i]);
+        expectedBands.Update(prices[i]);
+        expectedEma.Update(prices[i]);
+        expectedRsi.UpdatePrice(prices[i]);
+        expectedMacd.Update(prices[i]);
+        priceVolume += prices[i] * volumes[i];
+        volume += volumes[i];
+
+        ASSERT_EQ(expectedMacd.IsReady(), set.IsReady(macd));
+        EXPECT_NEAR(expectedSma.Value(), set.Value(sma), 1e-9);
+        EXPECT_NEAR(expectedStdDev.Value(), set.Value(stdDev), 1e-9);
+        EXPECT_NEAR(std::get<0>(expectedBands.Value()), std::get<0>(set.BollingerBands(bands)), 1e-9);
+        EXPECT_NEAR(expectedEma.Value(), set.Value(ema), 1e-9);
+        EXPECT_NEAR(priceVolume / volume, set.Value(vwap), 1e-9);
+        if (expectedRsi.IsReady()) {
+            EXPECT_NEAR(expectedRsi.Value(), set.Value(rsi), 1e-9);
+        }
+        if (expectedMacd.IsReady()) {
+            EXPECT_NEAR(expectedMacd.Macd(), set.MACD(macd).first, 1e-9);
+            EXPECT_NEAR(expectedMacd.Signal(), set.MACD(macd).second, 1e-9);
+        }
+    });
+
+    EXPECT_EQ(prices.size(), set.BarCount());
+}
+
+TEST(IndicatorSetTest, DeduplicatesRegistrations) {
+    Calculations::IndicatorSet set;
+    auto first = set.AddEMA(20);
+    EXPECT_EQ(first, set.AddEMA(20));
+    EXPECT_NE(first, set.AddEMA(21));
+    EXPECT_EQ(2u, set.IndicatorCount());
+
+    set.Update(100.0);
+    EXPECT_THROW(set.AddSMA(5), std::logic_error);
+    EXPECT_THROW(set.MACD(first), std::invalid_argument);
+}
+
+TEST(IndicatorCacheTest, ComputesLazilyAndIncrementally) {
+    Calculations::IndicatorCache cache;
+    auto prices = ToDouble(RandomWalk(200, 11));
+    std::atomic<int> sourceReads{0};
+    cache.RegisterSeries("cache-test-close", [&](int barIndex) -> std::optional<double> {
+        ++sourceReads;
+        if (barIndex < 0 || barIndex >= static_cast<int>(prices.size())) {
+            return std::nullopt;
+        }
+        return prices[barIndex];
+    });
+
+    cache.OnMarketUpdate(99);
+    Calculations::StreamingEMA expected(20);
+    for (int i = 0; i <= 99; ++i) {
+        expected.Update(prices[i]);
+    }
+    auto value = cache.GetEMA("cache-test-close", 20, 99);
+    ASSERT_TRUE(value.has_value());
+    EXPECT_NEAR(expected.Value(), value.value(), 1e-9);
+    EXPECT_FALSE(cache.GetEMA("cache-test-close", 20, 5).has_value()); // still warming up
+    EXPECT_FALSE(cache.GetEMA("cache-test-close", 20, 100).has_value()); // beyond the forming bar
+
+    // Repeated reads of the same update are served from the cache
+    int readsAfterFirst = sourceReads.load();
+    cache.GetEMA("cache-test-close", 20, 99);
+    cache.GetEMA("cache-test-close", 20, 50);
+    EXPECT_EQ(readsAfterFirst, sourceReads.load());
+
+    // A new bar only feeds the bar that closed plus the new forming bar
+    cache.OnMarketUpdate(100);
+    expected.Update(prices[100]);
+    value = cache.GetEMA("cache-test-close", 20, 100);
+    ASSERT_TRUE(value.has_value());
+    EXPECT_NEAR(expected.Value(), value.value(), 1e-9);
+    EXPECT_EQ(readsAfterFirst + 2, sourceReads.load());
+
+    // An intra-bar update to the forming bar is recomputed without disturbing closed bars
+    prices[100] += 1.0;
+    cache.OnMarketUpdate(100);
+    Calculations::StreamingEMA updated(20);
+    for (int i = 0; i <= 100; ++i) {
+        updated.Update(prices[i]);
+    }
+    EXPECT_NEAR(updated.Value(), cache.GetEMA("cache-test-close", 20, 100).value(), 1e-9);
+
+    // Moving backwards means the chart reloaded
+    cache.OnMarketUpdate(10);
+    EXPECT_EQ(0u, cache.EntryCount());
+}
+
+TEST(IndicatorCacheTest, ConcurrentReadersAgree) {
+    Calculations::IndicatorCache cache;
+    auto prices = ToDouble(RandomWalk(1000, 12));
+    cache.RegisterSeries("cache-test-concurrent", [&prices](int barIndex) -> std::optional<double> {
+        return barIndex < static_cast<int>(prices.size()) ? std::optional<double>(prices[barIndex]) : std::nullopt;
+    });
+    cache.OnMarketUpdate(999);
+
+    std::vector<double> results(8);
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < results.size(); ++t) {
+        readers.emplace_back([&cache, &results, t] {
+            results[t] = cache.GetSMA("cache-test-concurrent", 50, 999).value_or(0.0);
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    Calculations::StreamingSMA expected(50);
+    for (double price : prices) {
+        expected.Update(price);
+    }
+    for (double result : results) {
+        EXPECT_NEAR(expected.Value(), result, 1e-9);
+    }
+    EXPECT_THROW(cache.GetSMA("cache-test-concurrent", 0, 999), std::invalid_argument);
+}
+
+TEST(VolumeProfileTest, PointOfControlAndValueArea) {
+    Calculations::VolumeProfile profile(0.25);
+    // Volume by tick from 100.00 to 101.00: 10, 20, 50, 30, 5
+    const double volumes[] = {10, 20, 50, 30, 5};
+    for (int i = 0; i < 5; ++i) {
+        profile.AddTrade(100.0 + 0.25 * i, volumes[i]);
+    }
+
+    EXPECT_DOUBLE_EQ(115.0, profile.GetTotalVolume());
+    EXPECT_DOUBLE_EQ(100.5, profile.GetPointOfControl().value());
+    EXPECT_DOUBLE_EQ(50.0, profile.GetVolumeAtPrice(100.5));
+    EXPECT_DOUBLE_EQ(100.0, profile.GetLow().value());
+    EXPECT_DOUBLE_EQ(101.0, profile.GetHigh().value());
+
+    // 70% of 115 is 80.5: POC (50) + 100.75 (30) = 80 is not enough, then 100.25 (20)
+    auto valueArea = profile.GetValueArea();
+    ASSERT_TRUE(valueArea.has_value());
+    EXPECT_DOUBLE_EQ(100.25, valueArea->low);
+    EXPECT_DOUBLE_EQ(100.75, valueArea->high);
+    EXPECT_DOUBLE_EQ(100.0, valueArea->volume);
+
+    // A trade far below the current range grows the histogram downwards without moving the POC
+    profile.AddTrade(90.0, 1);
+    EXPECT_DOUBLE_EQ(100.5, profile.GetPointOfControl().value());
+    EXPECT_DOUBLE_EQ(90.0, profile.GetLow().value());
+    profile.AddTrade(90.0, 60);
+    EXPECT_DOUBLE_EQ(90.0, profile.GetPointOfControl().value());
+}
+
+TEST(VolumeProfileTest, TradesFromTimeAndSales) {
+    Calculations::VolumeProfile profile(1.0);
+    TimeAndSales trade;
+    trade.price = 10.0;
+    trade.volume = 7;
+    trade.type = TimeAndSalesType::Ask;
+    profile.AddTrade(trade);
+    trade.type = TimeAndSalesType::BidAskValues;
+    profile.AddTrade(trade);
+    EXPECT_DOUBLE_EQ(7.0, profile.GetTotalVolume());
+}
+
+TEST(VolumeProfileTest, TpoProfileAndCompositeMerge) {
+    Calculations::VolumeProfile first(1.0);
+    first.AddTpoPeriod(10, 14);
+    first.AddTpoPeriod(12, 13);
+    first.AddTrade(12, 100);
+
+    Calculations::VolumeProfile second(1.0);
+    second.AddTpoPeriod(13, 20);
+    second.AddTrade(18, 150);
+
+    EXPECT_EQ(7u, first.GetTotalTpos());
+    EXPECT_EQ(2u, first.GetTposAtPrice(12));
+
+    auto composite = Calculations::VolumeProfile::Composite({&first, &second});
+    EXPECT_DOUBLE_EQ(250.0, composite.GetTotalVolume());
+    EXPECT_EQ(15u, composite.GetTotalTpos());
+    EXPECT_DOUBLE_EQ(18.0, composite.GetPointOfControl().value());
+    EXPECT_DOUBLE_EQ(13.0, composite.GetTpoPointOfControl().value());
+    EXPECT_EQ(3u, composite.GetTposAtPrice(13));
+    EXPECT_DOUBLE_EQ(10.0, composite.GetLow().value());
+    EXPECT_DOUBLE_EQ(20.0, composite.GetHigh().value());
+
+    auto tpoValueArea = composite.GetTpoValueArea();
+    ASSERT_TRUE(tpoValueArea.has_value());
+    EXPECT_LE(tpoValueArea->low, 13.0);
+    EXPECT_GE(tpoValueArea->high, 13.0);
+    EXPECT_GE(tpoValueArea->volume, 0.7 * 15);
+
+    Calculations::VolumeProfile other(0.5);
+    EXPECT_THROW(composite.Merge(other), std::invalid_argument);
+}
+
+TEST(VolumeProfileTest, DetectsHighAndLowVolumeNodes) {
+    Calculations::VolumeProfile profile(1.0);
+    // Two bell-shaped clusters around 10 and 30 with a thin area between them
+    for (int price = 0; price <= 40; ++price) {
+        double volume = 1.0 + 100.0 * std::exp(-0.5 * std::pow((price - 10) / 3.0, 2)) + 80.0 * std::exp(-0.5 * std::pow((price - 30) / 3.0, 2));
+        profile.AddTrade(price, volume);
+    }
+
+    auto nodes = profile.GetVolumeNodes(2, 0.2);
+    ASSERT_EQ(2u, nodes.highVolumeNodes.size());
+    ASSERT_EQ(1u, nodes.lowVolumeNodes.size());
+    EXPECT_DOUBLE_EQ(10.0, nodes.highVolumeNodes[0]);
+    EXPECT_DOUBLE_EQ(30.0, nodes.highVolumeNodes[1]);
+    EXPECT_GT(nodes.lowVolumeNodes[0], 15.0);
+    EXPECT_LT(nodes.lowVolumeNodes[0], 25.0);
+
+    profile.Clear();
+    EXPECT_TRUE(profile.Empty());
+    EXPECT_FALSE(profile.GetPointOfControl().has_value());
+}
+
+TEST(OrderFlowTest, ClassifiesAgainstPrevailingQuote) {
+    Calculations::OrderFlowEngine engine;
+    EXPECT_EQ(Calculations::AggressorSide::Unknown, engine.Classify(100.0));
+
+    engine.UpdateQuote(100.0, 100.5);
+    EXPECT_EQ(Calculations::AggressorSide::Buy, engine.Classify(100.5));
+    EXPECT_EQ(Calculations::AggressorSide::Sell, engine.Classify(100.0));
+    EXPECT_EQ(Calculations::AggressorSide::Buy, engine.Classify(100.375));
+    EXPECT_EQ(Calculations::AggressorSide::Sell, engine.Classify(100.125));
+
+    // Midpoint trades fall back to the tick rule
+    engine.AddTrade(100.0, 5, 0);
+    EXPECT_EQ(Calculations::AggressorSide::Buy, engine.Classify(100.25));
+
+    TimeAndSales quote;
+    quote.type = TimeAndSalesType::BidAskValues;
+    quote.bid = 101.0;
+    quote.ask = 101.25;
+    EXPECT_FALSE(engine.OnTimeAndSales(quote, 0).has_value());
+    EXPECT_EQ(Calculations::AggressorSide::Sell, engine.Classify(101.0));
+}
+
+TEST(OrderFlowTest, BuildsFootprintAndCumulativeDelta) {
+    Calculations::OrderFlowConfig config;
+    config.tickSize = 0.25;
+    config.levelsPerBar = 8;
+    config.maxBars = 4;
+    config.largeTradeVolume = 20;
+    Calculations::OrderFlowEngine engine(config);
+    engine.UpdateQuote(100.0, 100.25);
+
+    engine.AddTrade(100.25, 10, 0); // buy
+    engine.AddTrade(100.25, 25, 0); // large buy
+    engine.AddTrade(100.0, 4, 0);   // sell
+
+    auto bar = engine.GetBarSummary(0);
+    ASSERT_TRUE(bar.has_value());
+    EXPECT_EQ(35, bar->askVolume);
+    EXPECT_EQ(4, bar->bidVolume);
+    EXPECT_EQ(31, bar->delta);
+    EXPECT_EQ(35, bar->maximumDelta);
+    EXPECT_EQ(1u, bar->largeBuyCount);
+    EXPECT_EQ(3u, bar->tradeCount);
+    EXPECT_DOUBLE_EQ(100.0, bar->low.value());
+    EXPECT_DOUBLE_EQ(100.25, bar->high.value());
+    EXPECT_EQ(35u, engine.GetLevel(0, 100.25).askVolume);
+    EXPECT_EQ(4u, engine.GetLevel(0, 100.0).bidVolume);
+    EXPECT_DOUBLE_EQ(35.0 / 4.0, engine.GetBarImbalanceRatio(0).value());
+
+    // Ask 35 at 100.25 against bid 4 at 100.00 is a diagonal buying imbalance
+    auto imbalances = engine.GetImbalances(0);
+    ASSERT_EQ(1u, imbalances.size());
+    EXPECT_DOUBLE_EQ(100.25, imbalances[0].price);
+    EXPECT_EQ(Calculations::AggressorSide::Buy, imbalances[0].side);
+
+    engine.UpdateQuote(99.0, 99.25);
+    engine.AddTrade(99.0, 50, 1);
+    EXPECT_EQ(-19, engine.GetCumulativeDelta());
+    EXPECT_EQ(-19, engine.GetBarSummary(1)->cumulativeDelta);
+
+    engine.ResetBar(1);
+    EXPECT_FALSE(engine.HasBar(1));
+    EXPECT_EQ(31, engine.GetCumulativeDelta());
+
+    // The window re-centers while the bar fits, then folds the excess into the edge level
+    engine.AddTrade(101.0, 1, 0);
+    EXPECT_EQ(1u, engine.GetLevel(0, 101.0).askVolume);
+    EXPECT_EQ(35u, engine.GetLevel(0, 100.25).askVolume);
+    EXPECT_EQ(0, engine.GetBarSummary(0)->clippedVolume);
+    engine.AddTrade(110.0, 2, 0);
+    EXPECT_EQ(2, engine.GetBarSummary(0)->clippedVolume);
+
+    // Bars are kept in a ring of maxBars slots
+    engine.AddTrade(100.0, 1, 4);
+    EXPECT_TRUE(engine.HasBar(4));
+    EXPECT_FALSE(engine.HasBar(0));
+}
+
+TEST(PerformanceMetricsTest, StreamingMatchesBatch) {
+    std::mt19937 generator(7);
+    std::normal_distribution<double> returns(5.0, 40.0);
+    std::vector<double> equityCurve{10000.0};
+    for (int i = 0; i < 500; ++i) {
+        equityCurve.push_back(equityCurve.back() + returns(generator));
+    }
+
+    Calculations::PerformanceMetricsConfig config;
+    config.initialEquity = equityCurve.front();
+    config.equityCurveCapacity = 64;
+    Calculations::PerformanceMetrics metrics(config);
+    for (size_t i = 1; i < equityCurve.size(); ++i) {
+        metrics.AddEquity(equityCurve[i]);
+    }
+
+    auto batch = Calculations::CalculatePerformance(equityCurve, config);
+    const auto& streaming = metrics.GetSummary();
+    EXPECT_EQ(batch.periods, streaming.periods);
+    EXPECT_NEAR(batch.maxDrawdown, streaming.maxDrawdown, 1e-9);
+    EXPECT_NEAR(batch.maxRunup, streaming.maxRunup, 1e-9);
+    EXPECT_NEAR(batch.sharpeRatio, streaming.sharpeRatio, 1e-9);
+    EXPECT_NEAR(batch.sortinoRatio, streaming.sortinoRatio, 1e-9);
+    EXPECT_NEAR(batch.calmarRatio, streaming.calmarRatio, 1e-9);
+    EXPECT_NEAR(equityCurve.back() - equityCurve.front(), streaming.netProfit, 1e-9);
+
+    // The bounded curve still spans the whole stream
+    const auto& curve = metrics.GetEquityCurve();
+    EXPECT_LE(curve.size(), config.equityCurveCapacity);
+    EXPECT_DOUBLE_EQ(equityCurve.front(), curve.front());
+    EXPECT_DOUBLE_EQ(equityCurve[(curve.size() - 1) * metrics.GetEquityCurveStride()], curve.back());
+}
+
+TEST(PerformanceMetricsTest, TradeStatisticsAndDrawdown) {
+    Calculations::PerformanceMetricsConfig config;
+    config.periodsPerYear = 1.0;
+    const std::vector<double> trades{100, -50, -80, 200, 30, -10};
+
+    Calculations::PerformanceMetrics metrics(config);
+    for (double trade : trades) {
+        metrics.AddTrade(trade);
+    }
+
+    const auto& summary = metrics.GetSummary();
+    // Equity 100, 50, -30, 170, 200, 190: drawdown from 100 to -30, run-up from -30 to 200
+    EXPECT_DOUBLE_EQ(130.0, summary.maxDrawdown);
+    EXPECT_DOUBLE_EQ(230.0, summary.maxRunup);
+    EXPECT_DOUBLE_EQ(10.0, summary.currentDrawdown);
+    EXPECT_EQ(3, summary.winningTrades);
+    EXPECT_EQ(2, summary.maxConsecutiveLosses);
+    EXPECT_DOUBLE_EQ(330.0 / 140.0, summary.ProfitFactor());
+    EXPECT_DOUBLE_EQ(-80.0, summary.largestLoss);
+
+    double mean = 190.0 / 6.0;
+    double m2 = 0.0;
+    for (double trade : trades) {
+        m2 += (trade - mean) * (trade - mean);
+    }
+    EXPECT_NEAR(mean / std::sqrt(m2 / 5.0), summary.sharpeRatio, 1e-12);
+    EXPECT_NEAR(mean / std::sqrt((50.0 * 50.0 + 80.0 * 80.0 + 10.0 * 10.0) / 6.0), summary.sortinoRatio, 1e-12);
+    EXPECT_NEAR(mean / 130.0, summary.calmarRatio, 1e-12);
+
+    auto batch = Calculations::CalculateTradePerformance(trades, config);
+    EXPECT_EQ(summary.totalTrades, batch.totalTrades);
+    EXPECT_DOUBLE_EQ(summary.maxDrawdown, batch.maxDrawdown);
+    EXPECT_NEAR(summary.sharpeRatio, batch.sharpeRatio, 1e-12);
+
+    TradeStatistics stats;
+    metrics.ApplyTo(stats);
+    EXPECT_DOUBLE_EQ(-130.0, stats.maxDrawdown);
+    EXPECT_DOUBLE_EQ(summary.sortinoRatio, stats.sortinoRatio);
+    EXPECT_EQ(2, stats.maxConsecutiveWins);
+}
+
+namespace {
+    // Reference sample covariance of the last `length` rows
+    double WindowCovariance(const std::vector<std::vector<double>>& rows, size_t length, size_t i, size_t j) {
+        size_t begin = rows.size() - length;
+        double meanI = 0.0;
+        double meanJ = 0.0;
+        for (size_t r = begin; r < rows.size(); ++r) {
+            meanI += rows[r][i];
+            meanJ += rows[r][j];
+        }
+        meanI /= length;
+        meanJ /= length;
+        double sum = 0.0;
+        for (size_t r = begin; r < rows.size(); ++r) {
+            sum += (rows[r][i] - meanI) * (rows[r][j] - meanJ);
+        }
+        return sum / (length - 1);
+    }
+}
+
+TEST(CorrelationMatrixTest, WindowMatchesDirectComputation) {
+    std::mt19937 generator(11);
+    std::normal_distribution<double> noise(0.0, 0.001);
+    Calculations::CorrelationMatrixConfig config;
+    config.weighting = Calculations::CorrelationWeighting::Window;
+    config.windowLength = 50;
+    Calculations::CorrelationMatrix matrix({"ES", "NQ", "CL"}, config);
+
+    std::vector<std::vector<double>> rows;
+    for (int bar = 0; bar < 237; ++bar) {
+        double market = noise(generator);
+        rows.push_back({market + 0.2 * noise(generator), 1.5 * market + 0.5 * noise(generator), noise(generator)});
+        matrix.UpdateReturns(rows.back());
+        EXPECT_EQ(bar + 1 >= config.windowLength, matrix.IsReady());
+    }
+
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_NEAR(WindowCovariance(rows, 50, i, j), matrix.GetCovariance(i, j).value(), 1e-12);
+        }
+    }
+    double expectedBeta = WindowCovariance(rows, 50, 1, 0) / WindowCovariance(rows, 50, 0, 0);
+    EXPECT_NEAR(expectedBeta, matrix.GetBeta(1, 0).value(), 1e-9);
+    EXPECT_GT(matrix.GetCorrelation(0, 1).value(), 0.8);
+    EXPECT_LT(std::abs(matrix.GetCorrelation(0, 2).value()), 0.5);
+
+    auto correlations = matrix.GetCorrelationMatrix();
+    ASSERT_EQ(9u, correlations.size());
+    EXPECT_DOUBLE_EQ(1.0, correlations[4]);
+    EXPECT_DOUBLE_EQ(correlations[1], correlations[3]);
+
+    RiskAssessment assessment;
+    EXPECT_TRUE(matrix.ApplyTo(assessment, "NQ", "ES"));
+    EXPECT_NEAR(expectedBeta, assessment.beta, 1e-9);
+    EXPECT_FALSE(matrix.ApplyTo(assessment, "NQ", "GC"));
+}
+
+TEST(CorrelationMatrixTest, ExponentialWeighting) {
+    Calculations::CorrelationMatrixConfig config;
+    config.lambda = 0.9;
+    config.minimumObservations = 5;
+    Calculations::CorrelationMatrix matrix({"A", "B"}, config);
+
+    // B is exactly twice A, so beta is 2 and correlation 1 under any weighting
+    std::mt19937 generator(3);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    for (int bar = 0; bar < 4; ++bar) {
+        double value = noise(generator);
+        matrix.UpdateReturns({value, 2.0 * value});
+    }
+    EXPECT_FALSE(matrix.GetBeta(1, 0).has_value());
+    for (int bar = 0; bar < 100; ++bar) {
+        double value = noise(generator);
+        matrix.UpdateReturns({value, 2.0 * value});
+    }
+    EXPECT_NEAR(2.0, matrix.GetBeta(1, 0).value(), 1e-9);
+    EXPECT_NEAR(1.0, matrix.GetCorrelation(0, 1).value(), 1e-9);
+    EXPECT_NEAR(0.0, matrix.GetAlpha(1, 0).value(), 1e-12);
+
+    matrix.Reset();
+    matrix.UpdatePrices({100.0, 50.0});
+    matrix.UpdatePrices({101.0, 50.5});
+    EXPECT_EQ(1u, matrix.GetObservationCount());
+    EXPECT_THROW(matrix.UpdateReturns({0.1}), std::invalid_argument);
+    EXPECT_THROW(matrix.UpdatePrices({100.0, 0.0}), std::invalid_argument);
+}
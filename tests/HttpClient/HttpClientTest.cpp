@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include "HttpClient.h"
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    namespace beast = boost::beast;
+    namespace http = beast::http;
+    namespace net = boost::asio;
+    using tcp = net::ip::tcp;
+
+    // Stand-in for the Python data server: echoes the method, target and body of each request, keeping the
+    // connection open unless told to drop it after `closeAfter` responses without saying so. Targets starting
+    // with /slow/<ms> are answered after that many milliseconds, and /drop closes the connection without an answer.
+    class StandInServer {
+    public:
+        explicit StandInServer(size_t closeAfter = 0)
+            : acceptor_(ioc_, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0)), closeAfter_(closeAfter) {
+            thread_ = std::thread([this] { AcceptLoop(); });
+        }
+
+        // Clients are destroyed first, which ends their sessions
+        ~StandInServer() {
+            stopping_ = true;
+            tcp::socket wake(ioc_);
+            beast::error_code ec;
+            wake.connect(acceptor_.local_endpoint(), ec);
+            thread_.join();
+            for (auto& session : sessions_) {
+                session.join();
+            }
+        }
+
+        int Port() const { return acceptor_.local_endpoint().port(); }
+        int Accepted() const { return accepted_.load(); }
+        int Received() const { return received_.load(); }
+        int Dropped() const { return dropped_.load(); }
+
+    private:
+        void AcceptLoop() {
+            while (!stopping_) {
+                tcp::socket socket(ioc_);
+                beast::error_code ec;
+                acceptor_.accept(socket, ec);
+                if (ec || stopping_) {
+                    return;
+                }
+                ++accepted_;
+                sessions_.emplace_back([this, socket = std::move(socket)]() mutable { Serve(std::move(socket)); });
+            }
+        }
+
+        void Serve(tcp::socket socket) {
+            beast::flat_buffer buffer;
+            beast::error_code ec;
+            for (size_t served = 0; closeAfter_ == 0 || served < closeAfter_; ++served) {
+                http::request<http::string_body> req;
+                http::read(socket, buffer, req, ec);
+                if (ec) {
+                    return;
+                }
+                ++received_;
+                std::string target(req.target());
+                if (target == "/drop") {
+                    ++dropped_;
+                    socket.shutdown(tcp::socket::shutdown_both, ec);
+                    return;
+                }
+                if (target.rfind("/slow/", 0) == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(std::stoi(target.substr(6))));
+                }
+                http::response<http::string_body> res{http::status::ok, req.version()};
+                res.body() = std::string(req.method_string()) + " " + std::string(req.target()) + " " + req.body();
+                res.keep_alive(req.keep_alive());
+                res.prepare_payload();
+                http::write(socket, res, ec);
+                if (ec || !req.keep_alive()) {
+                    return;
+                }
+            }
+            socket.shutdown(tcp::socket::shutdown_both, ec);
+        }
+
+        net::io_context ioc_;
+        tcp::acceptor acceptor_;
+        size_t closeAfter_;
+        std::atomic<bool> stopping_{false};
+        std::atomic<int> accepted_{0};
+        std::atomic<int> received_{0};
+        std::atomic<int> dropped_{0};
+        std::thread thread_;
+        std::vector<std::thread> sessions_; // only touched by the accept thread until destruction
+    };
+
+    HttpResponse Send(HttpClient& client, const std::string& url, const std::string& body = "",
+                      http::verb method = http::verb::post) {
+        std::promise<HttpResponse> promise;
+        auto future = promise.get_future();
+        client.SendRequest(url, body, nullptr, method, &promise);
+        return future.get();
+    }
+}
+
+TEST(HttpClientTest, ReusesOneConnectionForSequentialRequests) {
+    StandInServer server;
+    HttpClientConfig config;
+    config.host = "127.0.0.1";
+    config.port = server.Port();
+    config.maxConnections = 1;
+    HttpClient client(config);
+
+    for (int i = 0; i < 50; ++i) {
+        HttpResponse response = Send(client, "/insert-session", "{\"id\":" + std::to_string(i) + "}");
+        ASSERT_TRUE(response.success) << response.content;
+        EXPECT_EQ("POST /insert-session {\"id\":" + std::to_string(i) + "}", response.content);
+    }
+    EXPECT_EQ("GET /get-trading-systems?tradeSystemName=ES ", Send(client, "/get-trading-systems?tradeSystemName=ES", "", http::verb::get).content);
+    EXPECT_EQ(1, server.Accepted());
+    EXPECT_EQ(1u, client.GetOpenedConnections());
+}
+
+TEST(HttpClientTest, PipelinesConcurrentRequestsAndMatchesResponses) {
+    StandInServer server;
+    HttpClientConfig config;
+    config.host = "127.0.0.1";
+    config.port = server.Port();
+    config.maxConnections = 2;
+    config.maxPipelineDepth = 8;
+    HttpClient client(config);
+
+    const int count = 200;
+    std::vector<std::promise<HttpResponse>> promises(count);
+    for (int i = 0; i < count; ++i) {
+        client.SendRequest("/process-data/" + std::to_string(i), "x", nullptr, http::verb::post, &promises[i]);
+    }
+    for (int i = 0; i < count; ++i) {
+        HttpResponse response = promises[i].get_future().get();
+        EXPECT_TRUE(response.success);
+        EXPECT_EQ("POST /process-data/" + std::to_string(i) + " x", response.content);
+    }
+    EXPECT_LE(server.Accepted(), 2);
+}
+
+TEST(HttpClientTest, ReconnectsWhenTheServerDropsAKeptAliveConnection) {
+    StandInServer server(3);
+    HttpClientConfig config;
+    config.host = "127.0.0.1";
+    config.port = server.Port();
+    config.maxConnections = 1;
+    HttpClient client(config);
+
+    // PUT may be repeated, so one written to a connection the server has just closed is sent again
+    for (int i = 0; i < 10; ++i) {
+        HttpResponse response = Send(client, "/update", std::to_string(i), http::verb::put);
+        ASSERT_TRUE(response.success) << response.content;
+        EXPECT_EQ("PUT /update " + std::to_string(i), response.content);
+    }
+    EXPECT_EQ(4, server.Accepted());
+}
+
+TEST(HttpClientTest, ResendsOnlyIdempotentRequestsTheServerMayHaveReceived) {
+    StandInServer server;
+    HttpClientConfig config;
+    config.host = "127.0.0.1";
+    config.port = server.Port();
+    config.maxConnections = 1;
+    HttpClient client(config);
+
+    // Each request goes out on a connection that has already answered one, so a failure there would be retried
+    ASSERT_TRUE(Send(client, "/warm-up").success);
+    HttpResponse post = Send(client, "/drop", "once");
+    EXPECT_FALSE(post.success);
+    EXPECT_EQ(1, server.Dropped());
+
+    ASSERT_TRUE(Send(client, "/warm-up").success);
+    HttpResponse get = Send(client, "/drop", "", http::verb::get);
+    EXPECT_FALSE(get.success);
+    EXPECT_EQ(3, server.Dropped());
+}
+
+TEST(HttpClientTest, BoundsShutdownWhenRequestsHaveNoTimeout) {
+    StandInServer server;
+    HttpClientConfig config;
+    config.host = "127.0.0.1";
+    config.port = server.Port();
+    config.requestTimeout = std::chrono::milliseconds(0);
+    config.shutdownTimeout = std::chrono::milliseconds(100);
+
+    std::future<HttpResponse> pending;
+    auto start = std::chrono::steady_clock::now();
+    {
+        HttpClient client(config);
+        HttpRequest slow;
+        slow.url = "/slow/1500";
+        slow.method = http::verb::get;
+        pending = client.Send(slow);
+        // Shut down only once the request is in flight on the server
+        while (server.Received() == 0) {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+    HttpResponse response = pending.get();
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(0u, response.content.rfind("Shutdown", 0)) << response.content;
+}
+
+TEST(HttpClientTest, ReportsUnreachableServer) {
+    HttpClientConfig config;
+    config.host = "127.0.0.1";
+    {
+        // Bind and release a port so nothing is listening on it
+        net::io_context ioc;
+        tcp::acceptor acceptor(ioc, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+        config.port = acceptor.local_endpoint().port();
+    }
+    HttpClient client(config);
+    HttpResponse response = Send(client, "/process-data", "{}");
+    EXPECT_FALSE(response.success);
+}
+
+TEST(HttpClientTest, KeepsHundredsOfRequestsInFlightOnOneThread) {
+    StandInServer server;
+    HttpClientConfig config;
+    config.host = "127.0.0.1";
+    config.port = server.Port();
+    config.maxConnections = 100;
+    config.maxPipelineDepth = 4;
+    HttpClient client(config);
+
+    const int count = 400;
+    std::vector<std::future<HttpResponse>> futures;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        HttpRequest request;
+        request.url = "/slow/20?i=" + std::to_string(i);
+        request.method = http::verb::get;
+        futures.push_back(client.Send(request));
+    }
+    for (int i = 0; i < count; ++i) {
+        HttpResponse response = futures[i].get();
+        ASSERT_TRUE(response.success) << response.content;
+        EXPECT_EQ("GET /slow/20?i=" + std::to_string(i) + " ", response.content);
+    }
+
+    // One at a time this would take 8 s
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(4));
+    EXPECT_LE(client.GetOpenedConnections(), 100u);
+}
+
+TEST(HttpClientTest, TimesOutASlowRequestWithoutHoldingUpOthers) {
+    StandInServer server;
+    HttpClientConfig config;
+    config.host = "127.0.0.1";
+    config.port = server.Port();
+    config.maxConnections = 2;
+    HttpClient client(config);
+
+    HttpRequest slow;
+    slow.url = "/slow/2000";
+    slow.method = http::verb::get;
+    slow.timeout = std::chrono::milliseconds(100);
+    auto start = std::chrono::steady_clock::now();
+    HttpResponse timedOut = client.Send(slow).get();
+    EXPECT_FALSE(timedOut.success);
+    EXPECT_EQ(0u, timedOut.content.rfind("Timeout", 0)) << timedOut.content;
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1500));
+
+    HttpResponse response = Send(client, "/update", "after");
+    EXPECT_TRUE(response.success) << response.content;
+    EXPECT_EQ("POST /update after", response.content);
+}
+
+TEST(HttpClientTest, CancelsARequest) {
+    StandInServer server;
+    HttpClientConfig config;
+    config.host = "127.0.0.1";
+    config.port = server.Port();
+    HttpClient client(config);
+
+    std::promise<HttpResponse> promise;
+    HttpRequest slow;
+    slow.url = "/slow/2000";
+    slow.method = http::verb::get;
+    HttpRequestHandle handle = client.Send(slow, [&promise](HttpResponse response) { promise.set_value(response); });
+    EXPECT_FALSE(handle.IsDone());
+    handle.Cancel();
+
+    HttpResponse response = promise.get_future().get();
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ("Cancelled", response.content);
+    EXPECT_TRUE(handle.IsDone());
+    handle.Cancel(); // no second callback
+}
@@ -1,6 +1,13 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "Logger.h"
+#include "FileLogSink.h"
+#include "ILogSink.h"
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <thread>
+#include <vector>
 
 // Mock class for Logger
 class MockLogger {
@@ -21,3 +28,247 @@ TEST(LoggerTest, BasicFunctionality) {
     // EXPECT_EQ(mockInstance.someValue(), expectedValue);
 }
 
+
+TEST(BinaryLogTest, EncodesAndFormatsArguments) {
+    std::string symbol = "ESZ4";
+    size_t size = BinaryLog::EncodedSize(3, 4500.25, symbol, true, 'B', "filled", 7u);
+    std::vector<uint8_t> buffer(size);
+    uint8_t* end = BinaryLog::Encode(buffer.data(), 3, 4500.25, symbol, true, 'B', "filled", 7u);
+    ASSERT_EQ(buffer.data() + size, end);
+
+    std::string text;
+    BinaryLog::AppendFormatted(text, "Fill {} @ {} on {} ({}, {}) {}", buffer.data(), buffer.size());
+    EXPECT_EQ("Fill 3 @ 4500.25 on ESZ4 (true, B) filled 7", text);
+}
+
+TEST(LogRingTest, WrapsAndDropsWhenFull) {
+    LogRing ring(256);
+    auto push = [&ring](uint32_t value) {
+        uint8_t* record = ring.Reserve(24);
+        if (record == nullptr) {
+            return false;
+        }
+        uint32_t size = 24;
+        std::memcpy(record, &size, sizeof(size));
+        std::memcpy(record + 8, &value, sizeof(value));
+        ring.Commit();
+        return true;
+    };
+    auto drain = [&ring](std::vector<uint32_t>& values) {
+        return ring.Drain([&values](const uint8_t* record, size_t) {
+            uint32_t value;
+            std::memcpy(&value, record + 8, sizeof(value));
+            values.push_back(value);
+        });
+    };
+
+    // 24-byte records take 24 bytes each, so ten fit in 256 and the eleventh is dropped
+    uint32_t next = 0;
+    while (push(next)) {
+        ++next;
+    }
+    EXPECT_EQ(10u, next);
+    EXPECT_EQ(1u, ring.TakeDroppedCount());
+
+    std::vector<uint32_t> values;
+    EXPECT_EQ(10u, drain(values));
+    // Later records wrap around the end of the buffer without being split
+    for (uint32_t i = 0; i < 50; ++i) {
+        ASSERT_TRUE(push(next++));
+        if (i % 3 == 0) {
+            drain(values);
+        }
+    }
+    drain(values);
+    ASSERT_EQ(next, values.size());
+    for (uint32_t i = 0; i < next; ++i) {
+        EXPECT_EQ(i, values[i]);
+    }
+    EXPECT_TRUE(ring.Empty());
+}
+
+TEST(LoggerTest, CapturesRecordsForOfflineDecoding) {
+    std::string path = (std::filesystem::temp_directory_path() / "logger_capture_test.sflog").string();
+    Logger& logger = Logger::Instance();
+    ASSERT_TRUE(logger.EnableBinaryCapture(path));
+
+    static const uint32_t fillFormat = Logger::RegisterFormat("Fill {} of {} at {}", Logger::LogLevel::LOG_INFO);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 100; ++i) {
+                Logger::LogFormat(fillFormat, Logger::LogLevel::LOG_INFO, t * 100 + i, std::string("ES"), 4500.25);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Logger::Log("plain message", Logger::LogLevel::LOG_WARNING);
+    logger.Flush();
+    logger.DisableBinaryCapture();
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<BinaryLog::DecodedRecord> records;
+    long long decoded = BinaryLog::BinaryLogReader::Decode(in, [&records](const BinaryLog::DecodedRecord& record) {
+        records.push_back(record);
+    });
+    EXPECT_EQ(401, decoded);
+    EXPECT_EQ(0u, logger.GetDroppedCount());
+
+    std::set<std::string> messages;
+    for (const auto& record : records) {
+        messages.insert(record.message);
+    }
+    EXPECT_TRUE(messages.count("Fill 0 of ES at 4500.25"));
+    EXPECT_TRUE(messages.count("Fill 399 of ES at 4500.25"));
+    EXPECT_TRUE(messages.count("plain message"));
+    std::filesystem::remove(path);
+}
+
+namespace {
+    struct CountedArgument {
+        int* conversions;
+        std::string ToString() const {
+            ++*conversions;
+            return "counted";
+        }
+    };
+}
+
+TEST(LoggerTest, MacrosSkipArgumentsBelowModuleLevel) {
+    std::string path = (std::filesystem::temp_directory_path() / "logger_macro_test.sflog").string();
+    Logger& logger = Logger::Instance();
+    ASSERT_TRUE(logger.EnableBinaryCapture(path));
+
+    int conversions = 0;
+    int evaluations = 0;
+    CountedArgument argument{&conversions};
+    // Warning and above are compiled in every build type, so the test does not depend on LOGGER_MIN_LEVEL
+    logger.SetModuleLevel("Logger", Logger::LogLevel::LOG_ERROR);
+    EXPECT_EQ(Logger::LogLevel::LOG_ERROR, logger.GetModuleLevel("Logger"));
+    for (int i = 0; i < 3; ++i) {
+        LOG_WARNING("Skipped {} {}", argument, ++evaluations);
+    }
+    EXPECT_EQ(0, conversions);
+    EXPECT_EQ(0, evaluations); // not even on the first pass, which registers the call site
+
+    ASSERT_TRUE(logger.ApplyLevelConfig(nlohmann::json{{"modules", {{"Logger", "warning"}}}}));
+    LOG_WARNING("Logged {} {}", argument, 7);
+    LOG_ERROR("No arguments");
+    EXPECT_EQ(1, conversions);
+
+    EXPECT_FALSE(logger.ApplyLevelConfig(nlohmann::json{{"level", "VERBOSE"}}));
+    EXPECT_EQ(Logger::LogLevel::LOG_WARNING, logger.GetModuleLevel("Logger"));
+    logger.ResetModuleLevel("Logger");
+    EXPECT_EQ(Logger::LogLevel::LOG_INFO, logger.GetModuleLevel("Logger"));
+
+    logger.Flush();
+    logger.DisableBinaryCapture();
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<std::string> messages;
+    BinaryLog::BinaryLogReader::Decode(in, [&messages](const BinaryLog::DecodedRecord& record) {
+        messages.push_back(record.message);
+    });
+    EXPECT_EQ((std::vector<std::string>{"Logged counted 7", "No arguments", "Unknown log level in configuration: VERBOSE"}), messages);
+    std::filesystem::remove(path);
+}
+
+TEST(FileLogSinkTest, RotatesBySizeAndDay) {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "file_log_sink_test";
+    std::filesystem::remove_all(directory);
+
+    FileLogSinkConfig config;
+    config.directory = directory.string();
+    config.baseName = "test";
+    config.bufferSize = 64;
+    config.maxFileSize = 100;
+    const int64_t day = 19723LL * 86400 * 1000000000; // 2024-01-01 UTC
+    {
+        FileLogSink sink(config);
+        std::string line(30, 'x');
+        line += '\n';
+        for (int i = 0; i < 4; ++i) {
+            sink.Write(Logger::LogLevel::LOG_INFO, day, line);
+        }
+        EXPECT_EQ((directory / "test_20240101.1.log").string(), sink.GetCurrentPath());
+        sink.Write(Logger::LogLevel::LOG_INFO, day + 86400LL * 1000000000, line);
+        EXPECT_EQ((directory / "test_20240102.log").string(), sink.GetCurrentPath());
+    }
+
+    EXPECT_EQ(93u, std::filesystem::file_size(directory / "test_20240101.log"));
+    EXPECT_EQ(31u, std::filesystem::file_size(directory / "test_20240101.1.log"));
+    EXPECT_EQ(31u, std::filesystem::file_size(directory / "test_20240102.log"));
+    std::filesystem::remove_all(directory);
+}
+
+TEST(FileLogSinkTest, ReceivesLoggerOutputOnFlush) {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "file_log_sink_logger_test";
+    std::filesystem::remove_all(directory);
+
+    FileLogSinkConfig config;
+    config.directory = directory.string();
+    config.rotateDaily = false;
+    config.flushInterval = std::chrono::hours(1);
+    auto sink = std::make_shared<FileLogSink>(config);
+    Logger& logger = Logger::Instance();
+    // Other output, such as the test listener's events, is written before the sink is attached or filtered out below
+    logger.Flush();
+    logger.AddSink(sink);
+
+    static const uint32_t format = Logger::RegisterFormat("Sink line {}", Logger::LogLevel::LOG_WARNING);
+    for (int i = 0; i < 10; ++i) {
+        Logger::LogFormat(format, Logger::LogLevel::LOG_WARNING, i);
+    }
+    logger.Flush();
+    logger.RemoveSink(sink);
+
+    std::ifstream in(directory / "signal-forge.log");
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        if (line.find("Sink line ") != std::string::npos) {
+            lines.push_back(line);
+        }
+    }
+    ASSERT_EQ(10u, lines.size());
+    EXPECT_NE(std::string::npos, lines[9].find("WARNING: Sink line 9"));
+    std::filesystem::remove_all(directory);
+}
+
+namespace {
+
+class CollectingSink : public ILogSink {
+public:
+    void Write(Logger::LogLevel, int64_t, std::string_view line) override { lines.emplace_back(line); }
+    void Flush() override {}
+
+    std::vector<std::string> lines;
+};
+
+} // namespace
+
+TEST(LoggerTest, TruncatesRecordsTooLargeForTheRing) {
+    Logger& logger = Logger::Instance();
+    logger.Flush();
+    auto sink = std::make_shared<CollectingSink>();
+    logger.AddSink(sink);
+    uint64_t dropped = logger.GetDroppedCount();
+
+    std::string payload(Logger::ThreadRingCapacity, 'x');
+    LOG_WARNING("Oversized {}", payload);
+    logger.Flush();
+    logger.RemoveSink(sink);
+
+    std::vector<std::string> lines;
+    for (const auto& line : sink->lines) {
+        if (line.find("Oversized xxx") != std::string::npos) {
+            lines.push_back(line);
+        }
+    }
+    ASSERT_EQ(1u, lines.size());
+    EXPECT_NE(std::string::npos, lines[0].find("WARNING: Oversized xxx"));
+    EXPECT_NE(std::string::npos, lines[0].find("xxx ... [truncated]\n"));
+    EXPECT_LT(lines[0].size(), payload.size());
+    EXPECT_EQ(dropped, logger.GetDroppedCount());
+}
@@ -0,0 +1,269 @@
+#include <gtest/gtest.h>
+#include "MessageBus.h"
+#include "MpmcRing.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    struct Fill {
+        int producer;
+        int sequence;
+        std::unique_ptr<double> price; // keeps the message move-only
+    };
+
+    template <typename Predicate>
+    bool WaitFor(Predicate predicate) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST(MpmcRingTest, MovesValuesBetweenManyProducersAndConsumers) {
+    MpmcRing<std::unique_ptr<int>> ring(1000);
+    EXPECT_EQ(1024u, ring.Capacity());
+
+    const int producers = 4;
+    const int perProducer = 20000;
+    std::atomic<long long> sum{0};
+    std::atomic<int> popped{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&ring, p] {
+            for (int i = 1; i <= perProducer; ++i) {
+                auto value = std::make_unique<int>(i);
+                while (!ring.TryPush(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&] {
+            while (popped.load() < producers * perProducer) {
+                if (auto value = ring.TryPop()) {
+                    sum += **value;
+                    ++popped;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(static_cast<long long>(producers) * perProducer * (perProducer + 1) / 2, sum.load());
+    EXPECT_TRUE(ring.Empty());
+
+    MpmcRing<int> small(2);
+    EXPECT_TRUE(small.TryPush(1));
+    EXPECT_TRUE(small.TryPush(2));
+    EXPECT_FALSE(small.TryPush(3));
+    EXPECT_EQ(1, *small.TryPop());
+}
+
+TEST(MessageBusTest, DeliversBatchesInPublishOrderPerProducer) {
+    MessageBus bus(Mode::Asynchronous, 32);
+    auto fills = bus.GetTopic<Fill>("fills", 4096);
+    EXPECT_THROW(bus.GetTopic<int>("fills"), std::invalid_argument);
+    EXPECT_EQ(fills, bus.GetTopic<Fill>("fills"));
+
+    const int producers = 4;
+    const int perProducer = 2000;
+    std::vector<int> lastSequence(producers, -1);
+    std::atomic<int> received{0};
+    bool inOrder = true;
+    size_t largestBatch = 0;
+    fills->Subscribe([&](const std::vector<Fill>& batch) {
+        largestBatch = std::max(largestBatch, batch.size());
+        for (const Fill& fill : batch) {
+            inOrder = inOrder && fill.sequence == lastSequence[fill.producer] + 1 && *fill.price == 4500.25;
+            lastSequence[fill.producer] = fill.sequence;
+        }
+        received += static_cast<int>(batch.size());
+    });
+
+    std::atomic<int> polled{0};
+    auto polledSubscription = fills->Subscribe([&polled](const std::vector<Fill>& batch) {
+        polled += static_cast<int>(batch.size());
+    }, DeliveryThread::Polled, 4096);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&fills, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                while (!fills->Publish(Fill{p, i, std::make_unique<double>(4500.25)})) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_TRUE(WaitFor([&] { return received.load() == producers * perProducer; }));
+    EXPECT_TRUE(inOrder);
+    EXPECT_LE(largestBatch, 32u);
+
+    ASSERT_TRUE(WaitFor([&] { polledSubscription->Poll(); return polled.load() == producers * perProducer; }));
+    EXPECT_EQ(0u, polledSubscription->GetDroppedBatches());
+}
+
+TEST(MessageBusTest, SynchronousBusDeliversBeforePublishReturns) {
+    MessageBus bus(Mode::Synchronous);
+    auto topic = bus.GetTopic<int>("numbers");
+    std::vector<int> seen;
+    auto subscription = topic->SubscribeEach([&](const int& value) {
+        seen.push_back(value);
+        if (value == 1) {
+            topic->Publish(2); // delivered after this callback returns, not recursively
+        }
+    });
+
+    topic->Publish(1);
+    EXPECT_EQ((std::vector<int>{1, 2}), seen);
+
+    subscription->Cancel();
+    topic->Publish(3);
+    EXPECT_EQ(2u, seen.size());
+}
+
+TEST(MessageBusTest, OverflowPoliciesWhileSubscribersAreBehind) {
+    MessageBus bus(Mode::Asynchronous);
+
+    // Holds the dispatch thread inside a callback so the other topics fill up
+    std::atomic<bool> gateEntered{false};
+    std::atomic<bool> gateOpen{false};
+    auto gate = bus.GetTopic<int>("gate");
+    auto gateSubscription = gate->SubscribeEach([&](const int&) {
+        gateEntered = true;
+        while (!gateOpen) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    gate->Publish(0);
+    ASSERT_TRUE(WaitFor([&] { return gateEntered.load(); }));
+
+    struct Received {
+        std::mutex mutex;
+        std::vector<std::string> values;
+        size_t largestBatch = 0;
+    };
+    auto subscribe = [](auto& topic, Received& received, auto toString) {
+        return topic->Subscribe([&received, toString](const auto& batch) {
+            std::lock_guard<std::mutex> lock(received.mutex);
+            received.largestBatch = std::max(received.largestBatch, batch.size());
+            for (const auto& message : batch) {
+                received.values.push_back(toString(message));
+            }
+        });
+    };
+    auto intToString = [](int value) { return std::to_string(value); };
+
+    TopicConfig<int> newestConfig;
+    newestConfig.capacity = 4;
+    newestConfig.maxBatchSize = 3;
+    auto dropNewest = bus.GetTopic<int>("drop-newest", newestConfig);
+    Received newestReceived;
+    auto newestSubscription = subscribe(dropNewest, newestReceived, intToString);
+
+    TopicConfig<int> oldestConfig;
+    oldestConfig.capacity = 4;
+    oldestConfig.overflow = OverflowPolicy::DropOldest;
+    auto dropOldest = bus.GetTopic<int>("drop-oldest", oldestConfig);
+    Received oldestReceived;
+    auto oldestSubscription = subscribe(dropOldest, oldestReceived, intToString);
+
+    for (int i = 1; i <= 6; ++i) {
+        EXPECT_EQ(i <= 4, dropNewest->Publish(i));
+        EXPECT_TRUE(dropOldest->Publish(i));
+    }
+
+    using Quote = std::pair<std::string, int>;
+    TopicConfig<Quote> coalesceConfig;
+    coalesceConfig.capacity = 2;
+    coalesceConfig.overflow = OverflowPolicy::CoalesceByKey;
+    EXPECT_THROW(bus.GetTopic<Quote>("uncoalesced", coalesceConfig), std::invalid_argument);
+    coalesceConfig.coalesceKey = [](const Quote& quote) { return quote.first; };
+    auto coalesce = bus.GetTopic<Quote>("coalesce", coalesceConfig);
+    Received coalesceReceived;
+    auto coalesceSubscription = subscribe(coalesce, coalesceReceived,
+                                          [](const Quote& quote) { return quote.first + std::to_string(quote.second); });
+    EXPECT_TRUE(coalesce->Publish({"ES", 1}));
+    EXPECT_TRUE(coalesce->Publish({"NQ", 1}));
+    EXPECT_TRUE(coalesce->Publish({"ES", 2}));
+    EXPECT_FALSE(coalesce->Publish({"CL", 1}));
+    EXPECT_EQ(2u, coalesce->GetPendingCount());
+
+    TopicConfig<int> blockConfig;
+    blockConfig.capacity = 2;
+    blockConfig.overflow = OverflowPolicy::Block;
+    blockConfig.blockTimeout = std::chrono::milliseconds(20);
+    auto block = bus.GetTopic<int>("block", blockConfig);
+    Received blockReceived;
+    auto blockSubscription = subscribe(block, blockReceived, intToString);
+    EXPECT_TRUE(block->Publish(1));
+    EXPECT_TRUE(block->Publish(2));
+    EXPECT_FALSE(block->Publish(3)); // times out while the dispatcher is held
+
+    // A publisher still waiting when the dispatcher drains the topic gets through
+    TopicConfig<int> patientConfig = blockConfig;
+    patientConfig.blockTimeout = std::chrono::seconds(10);
+    auto patient = bus.GetTopic<int>("patient", patientConfig);
+    Received patientReceived;
+    auto patientSubscription = subscribe(patient, patientReceived, intToString);
+    EXPECT_TRUE(patient->Publish(1));
+    EXPECT_TRUE(patient->Publish(2));
+    std::atomic<bool> patientPublished{false};
+    std::thread publisher([&] { patientPublished = patient->Publish(3); });
+    EXPECT_TRUE(WaitFor([&] { return patient->GetBlockedPublisherCount() > 0; }));
+    gateOpen = true;
+    publisher.join();
+    EXPECT_TRUE(patientPublished.load());
+
+    auto countOf = [](Received& received) {
+        std::lock_guard<std::mutex> lock(received.mutex);
+        return received.values.size();
+    };
+    ASSERT_TRUE(WaitFor([&] {
+        return countOf(newestReceived) == 4 && countOf(oldestReceived) == 4 && countOf(coalesceReceived) == 2 &&
+            countOf(blockReceived) == 2 && countOf(patientReceived) == 3;
+    }));
+    EXPECT_EQ((std::vector<std::string>{"1", "2", "3", "4"}), newestReceived.values);
+    EXPECT_LE(newestReceived.largestBatch, 3u);
+    EXPECT_EQ((std::vector<std::string>{"3", "4", "5", "6"}), oldestReceived.values);
+    EXPECT_EQ((std::vector<std::string>{"ES2", "NQ1"}), coalesceReceived.values);
+    EXPECT_EQ((std::vector<std::string>{"1", "2", "3"}), patientReceived.values);
+
+    TopicStats newestStats = dropNewest->GetStats();
+    EXPECT_EQ("drop-newest", newestStats.name);
+    EXPECT_EQ(4u, newestStats.published);
+    EXPECT_EQ(4u, newestStats.delivered);
+    EXPECT_EQ(2u, newestStats.dropped);
+    EXPECT_EQ(4u, newestStats.maxDepth);
+    EXPECT_EQ(0u, newestStats.depth);
+    EXPECT_GE(newestStats.batches, 2u);
+    EXPECT_GT(newestStats.maxLatencyMicroseconds, 0.0);
+    EXPECT_LE(newestStats.meanLatencyMicroseconds, newestStats.maxLatencyMicroseconds);
+
+    EXPECT_EQ(2u, dropOldest->GetStats().dropped);
+    EXPECT_EQ(6u, dropOldest->GetStats().published);
+    EXPECT_EQ(1u, coalesce->GetStats().coalesced);
+    EXPECT_EQ(1u, coalesce->GetStats().dropped);
+    EXPECT_EQ(1u, block->GetStats().dropped);
+    EXPECT_EQ(0u, patient->GetStats().dropped);
+    EXPECT_EQ(6u, bus.GetStats().size()); // the rejected "uncoalesced" config created nothing
+}
@@ -0,0 +1,349 @@
+#include <gtest/gtest.h>
+#include "Outbox.h"
+#include "WireFormat.h"
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    namespace beast = boost::beast;
+    namespace http = beast::http;
+    namespace net = boost::asio;
+    using tcp = net::ip::tcp;
+
+    // Records the JSON POSTed to it, closing each connection after one response so it never waits on an idle one.
+    // Targets given a status with AnswerWith are answered with it and not recorded.
+    class RecordingServer {
+    public:
+        explicit RecordingServer(unsigned short port = 0, bool acceptsBinary = true)
+            : acceptor_(ioc_, tcp::endpoint(net::ip::make_address("127.0.0.1"), port)), acceptsBinary_(acceptsBinary) {
+            thread_ = std::thread([this] { Run(); });
+        }
+
+        ~RecordingServer() {
+            stopping_ = true;
+            tcp::socket wake(ioc_);
+            beast::error_code ec;
+            wake.connect(acceptor_.local_endpoint(), ec);
+            thread_.join();
+        }
+
+        unsigned short Port() const { return acceptor_.local_endpoint().port(); }
+
+        void AnswerWith(const std::string& target, http::status status) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            statuses_[target] = status;
+        }
+
+        std::vector<std::string> Targets() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return targets_;
+        }
+
+        std::vector<nlohmann::json> Batches() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return batches_;
+        }
+
+        std::vector<std::string> ContentTypes() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return contentTypes_;
+        }
+
+        std::vector<nlohmann::json> Records() {
+            std::vector<nlohmann::json> records;
+            for (const auto& batch : Batches()) {
+                if (batch.is_array()) {
+                    records.insert(records.end(), batch.begin(), batch.end());
+                } else {
+                    records.push_back(batch);
+                }
+            }
+            return records;
+        }
+
+    private:
+        void Run() {
+            while (!stopping_) {
+                tcp::socket socket(ioc_);
+                beast::error_code ec;
+                acceptor_.accept(socket, ec);
+                if (ec || stopping_) {
+                    return;
+                }
+                beast::flat_buffer buffer;
+                http::request<http::string_body> req;
+                http::read(socket, buffer, req, ec);
+                if (ec) {
+                    continue;
+                }
+                std::string contentType(req[http::field::content_type]);
+                http::status status = acceptsBinary_ || WireFormatFromContentType(contentType) == WireFormat::Json
+                    ? http::status::ok : http::status::unsupported_media_type;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    std::string target(req.target());
+                    targets_.push_back(target);
+                    contentTypes_.push_back(contentType);
+                    auto configured = statuses_.find(target);
+                    if (configured != statuses_.end()) {
+                        status = configured->second;
+                    }
+                    if (status == http::status::ok) {
+                        batches_.push_back(DecodeWire(req.body(), contentType));
+                    }
+                }
+                http::response<http::string_body> res{status, req.version()};
+                res.body() = "{}";
+                res.keep_alive(false);
+                res.prepare_payload();
+                http::write(socket, res, ec);
+            }
+        }
+
+        net::io_context ioc_;
+        tcp::acceptor acceptor_;
+        bool acceptsBinary_;
+        std::atomic<bool> stopping_{false};
+        std::mutex mutex_;
+        std::vector<nlohmann::json> batches_;
+        std::vector<std::string> contentTypes_;
+        std::vector<std::string> targets_;
+        std::map<std::string, http::status> statuses_;
+        std::thread thread_;
+    };
+
+    template <typename Predicate>
+    bool WaitFor(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+
+    std::string TempSpillPath(const std::string& name) {
+        std::string path = (std::filesystem::temp_directory_path() / ("sf-outbox-" + name + ".outbox")).string();
+        std::filesystem::remove(path);
+        return path;
+    }
+
+    std::shared_ptr<HttpClient> ClientFor(unsigned short port, WireFormat format = WireFormat::Json) {
+        HttpClientConfig config;
+        config.host = "127.0.0.1";
+        config.port = port;
+        config.format = format;
+        return std::make_shared<HttpClient>(config);
+    }
+}
+
+TEST(OutboxTest, SendsOnlyTheLatestRecordPerKey) {
+    RecordingServer server;
+    auto client = ClientFor(server.Port());
+    OutboxConfig config;
+    config.route = "/insert-sessions";
+    config.flushInterval = std::chrono::hours(1);
+    Outbox outbox(client, config);
+
+    for (int i = 0; i < 10; ++i) {
+        outbox.Post({{"id", "a"}, {"trades", i}}, "a");
+        outbox.Post({{"id", "b"}, {"trades", i * 2}}, "b");
+    }
+    outbox.Post({{"id", "c"}, {"trades", 1}}, "c");
+    outbox.Flush();
+
+    ASSERT_TRUE(WaitFor([&] { return outbox.GetStats().sent == 3; }));
+    ASSERT_EQ(1u, server.Batches().size());
+    auto records = server.Records();
+    ASSERT_EQ(3u, records.size());
+    EXPECT_EQ(9, records[0]["trades"]);
+    EXPECT_EQ(18, records[1]["trades"]);
+    EXPECT_EQ("c", records[2]["id"]);
+
+    OutboxStats stats = outbox.GetStats();
+    EXPECT_EQ(21u, stats.posted);
+    EXPECT_EQ(18u, stats.coalesced);
+    EXPECT_EQ(0u, stats.spilled);
+}
+
+TEST(OutboxTest, SplitsPendingRecordsIntoBatches) {
+    RecordingServer server;
+    auto client = ClientFor(server.Port());
+    OutboxConfig config;
+    config.route = "/process-data-batch";
+    config.maxBatchSize = 2;
+    config.flushInterval = std::chrono::hours(1);
+    Outbox outbox(client, config);
+
+    for (int i = 0; i < 5; ++i) {
+        outbox.Post({{"sequence", i}});
+    }
+    outbox.Flush();
+
+    ASSERT_TRUE(WaitFor([&] { return outbox.GetStats().sent == 5; }));
+    for (const auto& batch : server.Batches()) {
+        EXPECT_LE(batch.size(), 2u);
+    }
+    auto records = server.Records();
+    ASSERT_EQ(5u, records.size());
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(i, records[i]["sequence"]);
+    }
+}
+
+TEST(OutboxTest, SpillsWhileTheServerIsDownAndReplaysInOrder) {
+    unsigned short port;
+    {
+        // Bind and release a port so nothing is listening on it until the server starts
+        net::io_context ioc;
+        tcp::acceptor acceptor(ioc, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+        port = acceptor.local_endpoint().port();
+    }
+    std::string spillPath = (std::filesystem::temp_directory_path() / ("sf-outbox-" + std::to_string(port) + ".outbox")).string();
+    std::filesystem::remove(spillPath);
+
+    auto client = ClientFor(port);
+    OutboxConfig config;
+    config.route = "/process-data-batch";
+    config.maxBatchSize = 3;
+    config.flushInterval = std::chrono::milliseconds(10);
+    config.retryInterval = std::chrono::milliseconds(50);
+    config.spillPath = spillPath;
+
+    {
+        Outbox outbox(client, config);
+        for (int i = 0; i < 5; ++i) {
+            outbox.Post({{"sequence", i}});
+        }
+        ASSERT_TRUE(WaitFor([&] { return outbox.GetStats().spilled == 5; }));
+    }
+    ASSERT_TRUE(std::filesystem::exists(spillPath));
+
+    // A new outbox picks up what the last one spilled, ahead of its own records
+    RecordingServer server(port);
+    {
+        Outbox outbox(client, config);
+        for (int i = 5; i < 8; ++i) {
+            outbox.Post({{"sequence", i}});
+        }
+        ASSERT_TRUE(WaitFor([&] { return outbox.GetStats().sent == 8; }));
+        EXPECT_EQ(5u, outbox.GetStats().replayed);
+    }
+
+    auto records = server.Records();
+    ASSERT_EQ(8u, records.size());
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(i, records[i]["sequence"]);
+    }
+    EXPECT_FALSE(std::filesystem::exists(spillPath));
+}
+
+TEST(OutboxTest, SendsBinaryBatchesAndFallsBackToJson) {
+    OutboxConfig config;
+    config.route = "/process-data-batch";
+    config.flushInterval = std::chrono::milliseconds(10);
+
+    {
+        RecordingServer server;
+        Outbox outbox(ClientFor(server.Port(), WireFormat::MessagePack), config);
+        outbox.Post({{"sequence", 0}});
+        ASSERT_TRUE(WaitFor([&] { return outbox.GetStats().sent == 1; }));
+        EXPECT_EQ(std::vector<std::string>{"application/msgpack"}, server.ContentTypes());
+        EXPECT_EQ(0, server.Records().at(0)["sequence"]);
+    }
+
+    RecordingServer server(0, false);
+    Outbox outbox(ClientFor(server.Port(), WireFormat::Cbor), config);
+    outbox.Post({{"sequence", 1}});
+    ASSERT_TRUE(WaitFor([&] { return outbox.GetStats().sent == 1; }));
+    outbox.Post({{"sequence", 2}});
+    ASSERT_TRUE(WaitFor([&] { return outbox.GetStats().sent == 2; }));
+
+    // Once refused, the binary format is not tried again
+    std::vector<std::string> expected{"application/cbor", "application/json", "application/json"};
+    EXPECT_EQ(expected, server.ContentTypes());
+    auto records = server.Records();
+    ASSERT_EQ(2u, records.size());
+    EXPECT_EQ(2, records[1]["sequence"]);
+    EXPECT_EQ(0u, outbox.GetStats().dropped);
+}
+
+TEST(OutboxTest, SendsRecordsOneAtATimeWhenTheServerHasNoBatchRoute) {
+    RecordingServer server;
+    server.AnswerWith("/insert-sessions", http::status::not_found);
+    OutboxConfig config;
+    config.route = "/insert-sessions";
+    config.recordRoute = "/insert-session";
+    config.flushInterval = std::chrono::hours(1);
+    Outbox outbox(ClientFor(server.Port()), config);
+
+    outbox.Post({{"id", "a"}}, "a");
+    outbox.Post({{"id", "b"}}, "b");
+    outbox.Flush();
+    ASSERT_TRUE(WaitFor([&] { return outbox.GetStats().sent == 2; }));
+    outbox.Post({{"id", "c"}}, "c");
+    outbox.Flush();
+    ASSERT_TRUE(WaitFor([&] { return outbox.GetStats().sent == 3; }));
+
+    // The batch route is not asked again once it turned out to be missing
+    std::vector<std::string> expected{"/insert-sessions", "/insert-session", "/insert-session", "/insert-session"};
+    EXPECT_EQ(expected, server.Targets());
+    auto records = server.Records();
+    ASSERT_EQ(3u, records.size());
+    EXPECT_EQ("a", records[0]["id"]);
+    EXPECT_EQ("c", records[2]["id"]);
+    EXPECT_EQ(0u, outbox.GetStats().dropped);
+}
+
+TEST(OutboxTest, SpillsRatherThanDropsWhenTheRouteIsMissing) {
+    RecordingServer server;
+    server.AnswerWith("/process-data-batch", http::status::method_not_allowed);
+    OutboxConfig config;
+    config.route = "/process-data-batch";
+    config.flushInterval = std::chrono::milliseconds(10);
+    config.retryInterval = std::chrono::hours(1);
+    config.spillPath = TempSpillPath("missing-route");
+
+    {
+        Outbox outbox(ClientFor(server.Port()), config);
+        for (int i = 0; i < 3; ++i) {
+            outbox.Post({{"sequence", i}});
+        }
+        ASSERT_TRUE(WaitFor([&] { return outbox.GetStats().spilled == 3; }));
+        EXPECT_EQ(0u, outbox.GetStats().dropped);
+    }
+    EXPECT_TRUE(std::filesystem::exists(config.spillPath));
+    std::filesystem::remove(config.spillPath);
+}
+
+TEST(OutboxTest, CountsRecordsRejectedOnReplayOnlyAsDropped) {
+    RecordingServer server;
+    server.AnswerWith("/process-data-batch", http::status::bad_request);
+    OutboxConfig config;
+    config.route = "/process-data-batch";
+    config.flushInterval = std::chrono::milliseconds(10);
+    config.spillPath = TempSpillPath("rejected-replay");
+    {
+        std::ofstream file(config.spillPath);
+        file << "{\"sequence\":0}\n{\"sequence\":1}\nnot json\n";
+    }
+
+    Outbox outbox(ClientFor(server.Port()), config);
+    ASSERT_TRUE(WaitFor([&] { return !std::filesystem::exists(config.spillPath); }));
+    OutboxStats stats = outbox.GetStats();
+    EXPECT_EQ(3u, stats.dropped);
+    EXPECT_EQ(0u, stats.replayed);
+    EXPECT_EQ(0u, stats.sent);
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include "SharedMemoryRing.h"
+#include "SharedMemoryTransport.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    std::string UniqueName(const std::string& base) {
+        return "sf-test-" + base + "-" + std::to_string(getpid());
+    }
+
+    template <typename Predicate>
+    bool WaitFor(Predicate predicate) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // Reference peer: answers each message with "echo:" and the message, and stops after "bye".
+    // Returns the number of messages answered.
+    int RunEchoPeer(const std::string& name) {
+        std::unique_ptr<SharedMemoryTransport> peer;
+        WaitFor([&] {
+            peer = std::make_unique<SharedMemoryTransport>(name, SharedMemoryTransport::Role::Peer);
+            return peer->IsOpen();
+        });
+        if (!peer->IsOpen()) {
+            return -1;
+        }
+
+        std::atomic<int> answered{0};
+        std::atomic<bool> done{false};
+        peer->Subscribe([&](std::string_view message) {
+            if (message == "bye") {
+                done = true;
+                return;
+            }
+            std::string reply = "echo:" + std::string(message);
+            while (!peer->Send(reply)) {
+                std::this_thread::yield();
+            }
+            ++answered;
+        });
+        WaitFor([&] { return done.load(); });
+        return answered.load();
+    }
+}
+
+TEST(SharedMemoryRingTest, WrapsFramesAroundTheBuffer) {
+    std::string name = UniqueName("ring");
+    auto writer = SharedMemoryRing::Create(name, 256);
+    ASSERT_NE(nullptr, writer);
+    auto reader = SharedMemoryRing::Open(name);
+    ASSERT_NE(nullptr, reader);
+    EXPECT_EQ(nullptr, SharedMemoryRing::Open(UniqueName("missing")));
+    EXPECT_EQ(256u, reader->Capacity());
+
+    EXPECT_FALSE(writer->TryWrite(std::string(writer->MaxFrameSize() + 1, 'x')));
+    EXPECT_FALSE(reader->WaitReadable(std::chrono::milliseconds(1)));
+
+    // Frame sizes that do not divide the capacity force padding at the end of the buffer
+    std::vector<std::string> written;
+    std::vector<std::string> read;
+    for (int i = 0; i < 200; ++i) {
+        std::string frame(static_cast<size_t>(i % 37), static_cast<char>('a' + i % 26));
+        if (!writer->TryWrite(frame)) {
+            reader->Read([&read](std::string_view message) { read.emplace_back(message); });
+            ASSERT_TRUE(writer->TryWrite(frame));
+        }
+        written.push_back(frame);
+    }
+    ASSERT_TRUE(reader->WaitReadable(std::chrono::milliseconds(100)));
+    EXPECT_EQ(1u, reader->Read([&read](std::string_view message) { read.emplace_back(message); }, 1));
+    reader->Read([&read](std::string_view message) { read.emplace_back(message); });
+    EXPECT_EQ(written, read);
+    EXPECT_FALSE(reader->HasData());
+
+    // Fills up rather than overwriting unread frames
+    std::string large(writer->MaxFrameSize(), 'z');
+    int accepted = 0;
+    while (accepted < 3 && writer->TryWrite(large)) {
+        ++accepted;
+    }
+    EXPECT_GE(accepted, 1);
+    EXPECT_LE(accepted, 2);
+    EXPECT_EQ(static_cast<size_t>(accepted), reader->Read([&large](std::string_view message) { EXPECT_EQ(large, message); }));
+}
+
+TEST(SharedMemoryRingTest, CreateDoesNotTakeOverALiveSegment) {
+    std::string name = UniqueName("owned");
+    auto writer = SharedMemoryRing::Create(name, 256);
+    ASSERT_NE(nullptr, writer);
+    EXPECT_EQ(nullptr, SharedMemoryRing::Create(name, 256));
+
+    // The refused create left the first ring in place
+    auto reader = SharedMemoryRing::Open(name);
+    ASSERT_NE(nullptr, reader);
+    ASSERT_TRUE(writer->TryWrite("still here"));
+    EXPECT_EQ(1u, reader->Read([](std::string_view message) { EXPECT_EQ("still here", message); }));
+}
+
+#ifndef _WIN32
+TEST(SharedMemoryRingTest, CreateReplacesASegmentLeftByAnExitedProcess) {
+    std::string name = UniqueName("stale");
+
+    // The child exits without running destructors, as a crashed process would
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        auto abandoned = SharedMemoryRing::Create(name, 256);
+        _exit(abandoned != nullptr && abandoned->TryWrite("stale") ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    auto leftover = SharedMemoryRing::Open(name);
+    ASSERT_NE(nullptr, leftover);
+    EXPECT_TRUE(leftover->HasData());
+
+    auto writer = SharedMemoryRing::Create(name, 256);
+    ASSERT_NE(nullptr, writer);
+    auto reader = SharedMemoryRing::Open(name);
+    ASSERT_NE(nullptr, reader);
+    EXPECT_FALSE(reader->HasData());
+}
+#endif
+
+TEST(SharedMemoryTransportTest, ExchangesMessagesWithAnotherProcess) {
+    std::string name = UniqueName("transport");
+
+    // Forked before the host starts its receiving thread, so the child cannot inherit a lock that thread holds
+#ifdef _WIN32
+    std::thread peerThread([&name] { RunEchoPeer(name); });
+#else
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        _exit(RunEchoPeer(name) == 1000 ? 0 : 1);
+    }
+#endif
+
+    SharedMemoryTransport host(name, SharedMemoryTransport::Role::Host, 4096, 1000);
+    ASSERT_TRUE(host.IsOpen());
+
+    std::mutex mutex;
+    std::vector<std::string> replies;
+    host.Subscribe([&](std::string_view message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        replies.emplace_back(message);
+    });
+
+    // More data than the rings hold, so both sides also run into a full ring
+    const int count = 1000;
+    for (int i = 0; i < count; ++i) {
+        std::string message = "{\"sequence\":" + std::to_string(i) + "}";
+        ASSERT_TRUE(WaitFor([&] { return host.Send(message); }));
+    }
+    ASSERT_TRUE(WaitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return replies.size() == static_cast<size_t>(count);
+    }));
+    ASSERT_TRUE(WaitFor([&] { return host.Send("bye"); }));
+
+#ifdef _WIN32
+    peerThread.join();
+#else
+    int status = 0;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+#endif
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ("echo:{\"sequence\":" + std::to_string(i) + "}", replies[i]);
+    }
+    EXPECT_GT(host.GetFailedSends(), 0u);
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include "WireFormat.h"
+
+namespace {
+    nlohmann::json SampleInput() {
+        nlohmann::json blob = {{"id", "1"}, {"key", "performance_data"}, {"tradeSystemName", "ES"}};
+        for (int i = 0; i < 1000; ++i) {
+            blob["data"]["prices"].push_back(4500.25 + i * 0.25);
+            blob["data"]["volumes"].push_back(i);
+        }
+        return {{"parameters", nlohmann::json::array()}, {"dataBlobs", {blob}}, {"tradeSystemName", "ES"}};
+    }
+}
+
+TEST(WireFormatTest, RoundTripsEveryFormat) {
+    nlohmann::json input = SampleInput();
+    for (WireFormat format : {WireFormat::Json, WireFormat::MessagePack, WireFormat::Cbor}) {
+        std::string body = EncodeWire(input, format);
+        EXPECT_EQ(input, DecodeWire(body, format));
+        EXPECT_EQ(input, DecodeWire(body, ContentTypeOf(format)));
+    }
+    EXPECT_LT(EncodeWire(input, WireFormat::MessagePack).size(), EncodeWire(input, WireFormat::Json).size());
+    EXPECT_LT(EncodeWire(input, WireFormat::Cbor).size(), EncodeWire(input, WireFormat::Json).size());
+}
+
+TEST(WireFormatTest, ReadsContentTypes) {
+    EXPECT_EQ(WireFormat::Json, WireFormatFromContentType(""));
+    EXPECT_EQ(WireFormat::Json, WireFormatFromContentType("application/json; charset=utf-8"));
+    EXPECT_EQ(WireFormat::MessagePack, WireFormatFromContentType("application/x-msgpack"));
+    EXPECT_EQ(WireFormat::Cbor, WireFormatFromContentType("Application/CBOR"));
+    EXPECT_FALSE(WireFormatFromContentType("text/csv").has_value());
+    EXPECT_THROW(DecodeWire("\xc1", WireFormat::MessagePack), nlohmann::json::exception);
+}
+
+TEST(WireFormatTest, NegotiatesTheHighestRankedSupportedFormat) {
+    EXPECT_EQ(WireFormat::Json, NegotiateWireFormat(""));
+    EXPECT_EQ(WireFormat::Json, NegotiateWireFormat("*/*"));
+    EXPECT_EQ(WireFormat::Json, NegotiateWireFormat("text/html"));
+    EXPECT_EQ(WireFormat::MessagePack, NegotiateWireFormat(AcceptHeaderFor(WireFormat::MessagePack)));
+    EXPECT_EQ(WireFormat::Cbor, NegotiateWireFormat("application/json;q=0.5, application/cbor"));
+    EXPECT_EQ(WireFormat::Json, NegotiateWireFormat("application/msgpack; q=0.2, application/json; q=0.9"));
+    EXPECT_EQ(WireFormat::Json, NegotiateWireFormat("application/cbor;q=0, application/json;q=0.1"));
+    EXPECT_EQ(WireFormat::Cbor, NegotiateWireFormat("application/cbor, application/msgpack"));
+}
@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+#include "LevelManager.h"
+#include "../TradingPlatform/FakeTradingPlatform.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Emits one level at a fixed price on every update, optionally after a delay so generators overlap on the pool.
+class FixedLevelGenerator : public LevelGenerator {
+public:
+    FixedLevelGenerator(std::shared_ptr<ITradingPlatform> platform, double price, std::chrono::milliseconds delay = std::chrono::milliseconds(0))
+        : LevelGenerator(platform), price_(price), delay_(delay) {}
+
+    std::vector<BaseLevel> GenerateLevels(double) override {
+        int running = ++running_;
+        int peak = peakRunning.load();
+        while (running > peak && !peakRunning.compare_exchange_weak(peak, running)) {
+        }
+        std::this_thread::sleep_for(delay_);
+        --running_;
+        ++calls;
+        if (calls > 1) {
+            return {}; // one level per generator keeps the ladder easy to check
+        }
+        return {BaseLevel(price_, "fixed", DateTime())};
+    }
+
+    std::atomic<int> calls{0};
+    // Most generators of this type seen running at once
+    static inline std::atomic<int> peakRunning{0};
+
+private:
+    static inline std::atomic<int> running_{0};
+    double price_;
+    std::chrono::milliseconds delay_;
+};
+
+class ThrowingLevelGenerator : public LevelGenerator {
+public:
+    ThrowingLevelGenerator(std::shared_ptr<ITradingPlatform> platform, bool throwStdException)
+        : LevelGenerator(platform), throwStdException_(throwStdException) {}
+
+    std::vector<BaseLevel> GenerateLevels(double) override {
+        if (throwStdException_) {
+            throw std::runtime_error("generator failure");
+        }
+        throw 42; // not derived from std::exception
+    }
+
+    std::string GetName() const override { return "ThrowingLevelGenerator"; }
+
+private:
+    bool throwStdException_;
+};
+
+// Turns every touch into a signal carrying the touched level's price.
+class TouchSignalProcessor : public LevelProcessor {
+public:
+    using LevelProcessor::LevelProcessor;
+
+    std::vector<TradeSignal> ProcessLevels(const PriceLadder&, const std::vector<LevelTouch>& touches, double) override {
+        std::vector<TradeSignal> signals;
+        for (const auto& touch : touches) {
+            TradeSignal signal;
+            signal.signalKey = "LEVEL_TOUCH";
+            signal.price = touch.level.price;
+            signals.push_back(signal);
+        }
+        return signals;
+    }
+
+    std::vector<BaseLevel> GetLevelsToClear(const PriceLadder&, double) override { return {}; }
+};
+
+} // namespace
+
+TEST(LevelManagerTest, MergesLevelsFromEveryGeneratorRunInParallel) {
+    auto platform = std::make_shared<FakeTradingPlatform>();
+    std::vector<std::shared_ptr<LevelGenerator>> generators;
+    for (int i = 0; i < 4; ++i) {
+        generators.push_back(std::make_shared<FixedLevelGenerator>(platform, 100.0 + i, std::chrono::milliseconds(20)));
+    }
+    LevelManager manager(generators, std::make_shared<TouchSignalProcessor>(platform), platform);
+
+    platform->PublishPrice(99.0);
+    FixedLevelGenerator::peakRunning = 0;
+    manager.ProcessLevelsAndGenerateSignals();
+
+    std::vector<BaseLevel> levels = manager.GetLevelsInRange(101.5, 2.0);
+    ASSERT_EQ(4u, levels.size());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_DOUBLE_EQ(100.0 + i, levels[i].price);
+    }
+    // One generator runs on the calling thread while the others run on the pool
+    EXPECT_GE(FixedLevelGenerator::peakRunning.load(), 2);
+}
+
+TEST(LevelManagerTest, GeneratesWhileTheSharedThreadPoolIsBusy) {
+    // Occupy every worker of the shared pool; generators run on the manager's own workers, so the pass still completes
+    constexpr int Workers = 8;
+    std::atomic<int> blocked{0};
+    std::atomic<int> finished{0};
+    std::atomic<bool> release{false};
+    for (int i = 0; i < Workers; ++i) {
+        ThreadPool::Instance().Enqueue([&blocked, &finished, &release] {
+            ++blocked;
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            ++finished;
+        });
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (blocked < Workers && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    int blockedDuringPass = blocked.load();
+
+    auto platform = std::make_shared<FakeTradingPlatform>();
+    std::vector<std::shared_ptr<LevelGenerator>> generators;
+    for (int i = 0; i < 3; ++i) {
+        generators.push_back(std::make_shared<FixedLevelGenerator>(platform, 100.0 + i));
+    }
+    LevelManager manager(generators, std::make_shared<TouchSignalProcessor>(platform), platform);
+
+    platform->PublishPrice(99.0);
+    manager.ProcessLevelsAndGenerateSignals();
+    release = true;
+
+    EXPECT_EQ(Workers, blockedDuringPass);
+    EXPECT_EQ(3u, manager.GetLevelsInRange(101.0, 1.0).size());
+
+    // The blocking tasks reference this frame, so they must be done before it unwinds
+    while (finished < blocked) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+TEST(LevelManagerTest, KeepsTheOtherGeneratorsWhenOneThrows) {
+    auto platform = std::make_shared<FakeTradingPlatform>();
+    auto survivor = std::make_shared<FixedLevelGenerator>(platform, 100.0);
+    std::vector<std::shared_ptr<LevelGenerator>> generators{
+        std::make_shared<ThrowingLevelGenerator>(platform, false), // runs inline
+        std::make_shared<ThrowingLevelGenerator>(platform, true),
+        std::make_shared<ThrowingLevelGenerator>(platform, false), // runs on the pool
+        survivor,
+    };
+    LevelManager manager(generators, std::make_shared<TouchSignalProcessor>(platform), platform);
+
+    platform->PublishPrice(99.0);
+    manager.ProcessLevelsAndGenerateSignals();
+
+    EXPECT_EQ(1, survivor->calls.load());
+    std::vector<BaseLevel> levels = manager.GetLevelsInRange(100.0, 1.0);
+    ASSERT_EQ(1u, levels.size());
+    EXPECT_DOUBLE_EQ(100.0, levels[0].price);
+}
+
+TEST(LevelManagerTest, PublishesASignalForEachLevelTheMarketCrosses) {
+    auto platform = std::make_shared<FakeTradingPlatform>();
+    std::vector<std::shared_ptr<LevelGenerator>> generators{
+        std::make_shared<FixedLevelGenerator>(platform, 100.0),
+        std::make_shared<FixedLevelGenerator>(platform, 101.0),
+    };
+    LevelManager manager(generators, std::make_shared<TouchSignalProcessor>(platform), platform);
+
+    std::vector<TradeSignal> received;
+    manager.SubscribeToSignals([&received](const TradeSignal& signal) { received.push_back(signal); });
+
+    // Levels created by an update are not touched by that same update
+    platform->PublishPrice(100.5);
+    manager.ProcessLevelsAndGenerateSignals();
+    EXPECT_TRUE(received.empty());
+
+    // The synchronous manager delivers signals before processing returns
+    platform->PublishPrice(99.0);
+    manager.ProcessLevelsAndGenerateSignals();
+    ASSERT_EQ(1u, received.size());
+    EXPECT_DOUBLE_EQ(100.0, received[0].price);
+    EXPECT_TRUE(received[0].trace.IsActive());
+    EXPECT_NE(0, received[0].trace.GetStageTimestamp(TraceStage::Generation));
+
+    // Without a new publish there is nothing to process
+    manager.ProcessLevelsAndGenerateSignals();
+    EXPECT_EQ(1u, received.size());
+
+    platform->PublishPrice(101.0);
+    manager.ProcessLevelsAndGenerateSignals();
+    ASSERT_EQ(3u, received.size());
+    EXPECT_DOUBLE_EQ(100.0, received[1].price);
+    EXPECT_DOUBLE_EQ(101.0, received[2].price);
+    EXPECT_NE(received[0].trace.iteration, received[1].trace.iteration);
+
+    std::vector<BaseLevel> levels = manager.GetLevelsInRange(100.5, 1.0);
+    ASSERT_EQ(2u, levels.size());
+    EXPECT_TRUE(levels[0].touched);
+    EXPECT_TRUE(levels[1].touched);
+}
+
+TEST(LevelManagerTest, AsynchronousManagerProcessesEachPublishedUpdate) {
+    auto platform = std::make_shared<FakeTradingPlatform>();
+    auto generator = std::make_shared<FixedLevelGenerator>(platform, 100.0);
+    std::atomic<int> signals{0};
+    {
+        LevelManager manager({generator}, std::make_shared<TouchSignalProcessor>(platform), platform, Mode::Asynchronous);
+        manager.SubscribeToSignals([&signals](const TradeSignal&) { ++signals; });
+
+        auto waitFor = [](const std::function<bool()>& condition) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!condition() && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return condition();
+        };
+
+        // Nothing runs until the platform publishes: the loop parks without having called the generator
+        ASSERT_TRUE(waitFor([&] { return platform->GetMarketUpdateNotifier().GetWaiterCount() > 0; }));
+        EXPECT_EQ(0, generator->calls.load());
+
+        platform->PublishPrice(100.5);
+        ASSERT_TRUE(waitFor([&] { return generator->calls.load() == 1; }));
+
+        platform->PublishPrice(99.5);
+        ASSERT_TRUE(waitFor([&] { return signals.load() == 1; }));
+        EXPECT_EQ(2, generator->calls.load());
+    } // the destructor wakes the parked loop and joins it
+    EXPECT_EQ(1, signals.load());
+}
+
+TEST(LevelManagerTest, InitializeMergesTheSnapshotIntoLevelsAlreadyGenerated) {
+    auto platform = std::make_shared<FakeTradingPlatform>();
+    std::string path = (std::filesystem::temp_directory_path() / "sf-level-manager-restore.bin").string();
+    {
+        LevelManager manager({std::make_shared<FixedLevelGenerator>(platform, 101.0)}, std::make_shared<TouchSignalProcessor>(platform), platform);
+        platform->PublishPrice(100.5);
+        manager.ProcessLevelsAndGenerateSignals();
+        std::vector<BaseLevel> generated = manager.GetLevelsInRange(101.0, 0.0);
+        ASSERT_EQ(1u, generated.size());
+
+        // The snapshot holds the level generation already added and one it has not
+        auto store = std::make_shared<LevelSnapshotStore>(path);
+        ASSERT_TRUE(store->Save({generated[0], BaseLevel(100.0, "restored", DateTime())}));
+        manager.SetSnapshotStore(store, std::chrono::seconds(3600));
+        manager.Initialize();
+
+        std::vector<BaseLevel> levels = manager.GetLevelsInRange(100.5, 1.0);
+        ASSERT_EQ(2u, levels.size());
+        EXPECT_EQ("restored", levels[0].levelType);
+        EXPECT_EQ(generated[0].id, levels[1].id);
+
+        // Restored levels take part in touch detection
+        std::vector<TradeSignal> received;
+        manager.SubscribeToSignals([&received](const TradeSignal& signal) { received.push_back(signal); });
+        platform->PublishPrice(99.75);
+        manager.ProcessLevelsAndGenerateSignals();
+        ASSERT_EQ(1u, received.size());
+        EXPECT_DOUBLE_EQ(100.0, received[0].price);
+    }
+    std::filesystem::remove(path);
+}
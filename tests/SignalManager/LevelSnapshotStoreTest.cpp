@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "LevelSnapshotStore.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+namespace {
+
+std::string TempSnapshotPath(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("sf-level-snapshot-" + name + ".bin");
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+BaseLevel MakeLevel(double price, const std::string& levelType) {
+    BaseLevel level(price, levelType, DateTime());
+    // Whole microseconds, the resolution the snapshot keeps
+    level.timestamp.timePoint = std::chrono::system_clock::time_point(std::chrono::microseconds(1700000000123456));
+    return level;
+}
+
+} // namespace
+
+TEST(LevelSnapshotStoreTest, RoundTripsEveryLevelField) {
+    BaseLevel plain = MakeLevel(4321.25, "vwap");
+    BaseLevel full = MakeLevel(4300.5, "pivot");
+    full.clearOnTouch = true;
+    full.touched = true;
+    full.targetPrice = 4310.0;
+    full.stopLossPrice = 4295.75;
+    full.tradeSystemName = "ReversalSystem";
+
+    std::string data = LevelSnapshotStore::Serialize({plain, full});
+    // Little-endian on every host: the magic reads as its ASCII tag, then version 1
+    EXPECT_EQ("SFLV", data.substr(0, 4));
+    EXPECT_EQ(std::string("\x01\x00", 2), data.substr(4, 2));
+    auto restored = LevelSnapshotStore::Deserialize(data);
+    ASSERT_TRUE(restored.has_value());
+    ASSERT_EQ(2u, restored->size());
+
+    const BaseLevel& first = (*restored)[0];
+    EXPECT_EQ(plain.id, first.id);
+    EXPECT_EQ(plain, first);
+    EXPECT_FALSE(first.clearOnTouch);
+    EXPECT_FALSE(first.touched);
+    EXPECT_FALSE(first.targetPrice.has_value());
+    EXPECT_FALSE(first.stopLossPrice.has_value());
+    EXPECT_EQ(plain.tradeSystemName, first.tradeSystemName);
+
+    const BaseLevel& second = (*restored)[1];
+    EXPECT_EQ(full.id, second.id);
+    EXPECT_EQ(full, second);
+    EXPECT_TRUE(second.clearOnTouch);
+    EXPECT_TRUE(second.touched);
+    EXPECT_EQ(full.targetPrice, second.targetPrice);
+    EXPECT_EQ(full.stopLossPrice, second.stopLossPrice);
+    EXPECT_EQ("ReversalSystem", second.tradeSystemName);
+
+    // The same snapshot survives a trip through the file
+    auto store = std::make_shared<LevelSnapshotStore>(TempSnapshotPath("round-trip"));
+    ASSERT_TRUE(store->Save({plain, full}));
+    auto loaded = store->Load();
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(2u, loaded->size());
+    EXPECT_EQ(full.id, (*loaded)[1].id);
+    std::filesystem::remove(store->GetFilePath());
+}
+
+TEST(LevelSnapshotStoreTest, RejectsCorruptOrTruncatedData) {
+    std::string data = LevelSnapshotStore::Serialize({MakeLevel(100.0, "test")});
+
+    std::string flipped = data;
+    flipped[20] ^= 0x01;
+    EXPECT_FALSE(LevelSnapshotStore::Deserialize(flipped).has_value());
+    EXPECT_FALSE(LevelSnapshotStore::Deserialize(data.substr(0, data.size() - 1)).has_value());
+    EXPECT_FALSE(LevelSnapshotStore::Deserialize("").has_value());
+
+    auto store = std::make_shared<LevelSnapshotStore>(TempSnapshotPath("missing"));
+    EXPECT_FALSE(store->Load().has_value());
+}
+
+TEST(LevelSnapshotStoreTest, FinalSaveIsNotOverwrittenByAnOlderAsyncSave) {
+    auto store = std::make_shared<LevelSnapshotStore>(TempSnapshotPath("ordering"));
+
+    // Occupy every pool worker so the async save is still queued when the final save runs
+    constexpr int Workers = 8;
+    std::atomic<int> blocked{0};
+    std::atomic<bool> release{false};
+    for (int i = 0; i < Workers; ++i) {
+        ThreadPool::Instance().Enqueue([&blocked, &release] {
+            ++blocked;
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            --blocked;
+        });
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (blocked < Workers && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(Workers, blocked.load());
+
+    store->SaveAsync({MakeLevel(100.0, "old")});
+    ASSERT_TRUE(store->Save({MakeLevel(200.0, "new")}));
+    release = true;
+
+    // The queued write holds a reference to the store until it has run
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (store.use_count() > 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // The blockers read this test's locals, so they must all be gone before it can return
+    while (blocked > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(1, store.use_count());
+
+    auto loaded = store->Load();
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(1u, loaded->size());
+    EXPECT_EQ("new", (*loaded)[0].levelType);
+    std::filesystem::remove(store->GetFilePath());
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "PriceLadder.h"
+#include <cmath>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+BaseLevel MakeLevel(double price, int secondsOffset = 0) {
+    BaseLevel level(price, "test", DateTime());
+    // Distinct timestamps keep levels at the same price from comparing equal
+    level.timestamp.timePoint += std::chrono::seconds(secondsOffset);
+    return level;
+}
+
+std::vector<double> Prices(const std::vector<BaseLevel>& levels) {
+    std::vector<double> prices;
+    for (const auto& level : levels) {
+        prices.push_back(level.price);
+    }
+    return prices;
+}
+
+std::vector<double> Prices(const std::vector<LevelTouch>& touches) {
+    std::vector<double> prices;
+    for (const auto& touch : touches) {
+        prices.push_back(touch.level.price);
+    }
+    return prices;
+}
+
+} // namespace
+
+TEST(PriceLadderTest, ReportsCrossedLevelsInTheOrderTheMarketReachedThem) {
+    PriceLadder ladder(0.25, 16);
+    ladder.Anchor(100.0);
+    for (double price : {99.0, 99.75, 100.25, 100.5, 110.0}) {
+        ladder.Add(MakeLevel(price));
+    }
+
+    // The starting tick is excluded and the ending tick included
+    EXPECT_EQ((std::vector<double>{100.25, 100.5}), Prices(ladder.GetLevelsCrossed(99.75, 100.5)));
+    EXPECT_EQ((std::vector<double>{99.75, 99.0}), Prices(ladder.GetLevelsCrossed(100.25, 99.0)));
+    EXPECT_TRUE(ladder.GetLevelsCrossed(100.5, 100.5).empty());
+
+    // 110 lies outside the dense window and is served from the sparse map
+    EXPECT_EQ((std::vector<double>{100.5, 110.0}), Prices(ladder.GetLevelsCrossed(100.25, 110.0)));
+    EXPECT_EQ((std::vector<double>{99.75, 100.25}), Prices(ladder.GetLevelsInRange(99.5, 100.25)));
+}
+
+TEST(PriceLadderTest, ReportsDirectionAndGapForEachCrossing) {
+    PriceLadder ladder(0.25, 64);
+    ladder.Anchor(100.0);
+    std::vector<BaseLevel> added{MakeLevel(99.5), MakeLevel(100.0), MakeLevel(100.5), MakeLevel(101.0)};
+    for (const auto& level : added) {
+        ladder.Add(level);
+    }
+
+    // Up from 100.0 to 100.75: 100.0 is where the market started, 100.5 was jumped over
+    std::vector<LevelTouch> touches = ladder.GetLevelsCrossed(100.0, 100.75);
+    ASSERT_EQ(1u, touches.size());
+    EXPECT_EQ(added[2].id, touches[0].level.id);
+    EXPECT_EQ(ladder.ToTick(100.5), touches[0].tick);
+    EXPECT_EQ(TouchDirection::Up, touches[0].direction);
+    EXPECT_TRUE(touches[0].gapped);
+
+    // Down from 100.75 to 99.5 reaches 100.5, 100.0 and then ends on 99.5, which was marked touched in the ladder
+    ASSERT_TRUE(ladder.MarkTouched(added[0].id));
+    touches = ladder.GetLevelsCrossed(100.75, 99.5);
+    ASSERT_EQ(3u, touches.size());
+    EXPECT_EQ(added[2].id, touches[0].level.id);
+    EXPECT_EQ(added[1].id, touches[1].level.id);
+    EXPECT_EQ(added[0].id, touches[2].level.id);
+    EXPECT_EQ(TouchDirection::Down, touches[2].direction);
+    EXPECT_TRUE(touches[1].gapped);
+    EXPECT_FALSE(touches[2].gapped);
+    EXPECT_TRUE(touches[2].level.touched);
+
+    // A removed level is gone from the next crossing
+    ASSERT_TRUE(ladder.RemoveById(added[2].id));
+    EXPECT_EQ((std::vector<double>{100.0}), Prices(ladder.GetLevelsCrossed(99.5, 100.25)));
+}
+
+TEST(PriceLadderTest, ReanchorKeepsEveryLevelAndAppliesANewTickSize) {
+    PriceLadder ladder(0.0, 8);
+    EXPECT_FALSE(ladder.IsAnchored());
+    EXPECT_TRUE(ladder.ShouldReanchor(50.0));
+
+    std::vector<BaseLevel> added;
+    for (int i = 0; i < 40; ++i) {
+        added.push_back(MakeLevel(48.0 + 0.25 * i, i));
+        ladder.Add(added.back());
+    }
+
+    ladder.Anchor(50.0, 0.25);
+    EXPECT_TRUE(ladder.IsAnchored());
+    EXPECT_DOUBLE_EQ(0.25, ladder.GetTickSize());
+    EXPECT_EQ(200, ladder.GetAnchorTick());
+    EXPECT_FALSE(ladder.ShouldReanchor(50.75));
+    EXPECT_TRUE(ladder.ShouldReanchor(51.25));
+
+    // Moving the anchor shifts levels between the dense window and the sparse map without losing any
+    ladder.Anchor(55.0);
+    EXPECT_EQ(220, ladder.GetAnchorTick());
+    EXPECT_EQ(added.size(), ladder.Size());
+    std::vector<double> expected;
+    for (const auto& level : added) {
+        expected.push_back(level.price);
+    }
+    std::vector<BaseLevel> all;
+    ladder.ForEach([&all](const BaseLevel& level) { all.push_back(level); });
+    EXPECT_EQ(expected, Prices(all));
+
+    ASSERT_TRUE(ladder.MarkTouched(added[5].id));
+    ASSERT_TRUE(ladder.RemoveById(added[6].id));
+    ladder.Anchor(49.0, 0.5);
+    EXPECT_EQ(added.size() - 1, ladder.Size());
+    std::vector<BaseLevel> touched;
+    ladder.ForEach([&touched](const BaseLevel& level) {
+        if (level.touched) {
+            touched.push_back(level);
+        }
+    });
+    ASSERT_EQ(1u, touched.size());
+    EXPECT_EQ(added[5].id, touched[0].id);
+}
+
+TEST(PriceLadderTest, MatchesABruteForceScanAcrossReanchors) {
+    std::mt19937 rng(7);
+    PriceLadder ladder(0.25, 64);
+    std::vector<BaseLevel> all;
+    for (int i = 0; i < 2000; ++i) {
+        all.push_back(MakeLevel(4000.0 + static_cast<int>(rng() % 2000 - 1000) * 0.25, i));
+        ladder.Add(all.back());
+        if (i == 100) {
+            ladder.Anchor(4000.0);
+        }
+    }
+
+    for (int query = 0; query < 300; ++query) {
+        double last = 4000.0 + static_cast<int>(rng() % 2200 - 1100) * 0.25;
+        double current = 4000.0 + static_cast<int>(rng() % 2200 - 1100) * 0.25;
+        if (query % 50 == 0) {
+            ladder.Anchor(last);
+        }
+
+        std::multiset<double> expected;
+        for (const auto& level : all) {
+            bool crossed = current > last ? (level.price > last && level.price <= current)
+                                          : (level.price >= current && level.price < last);
+            if (crossed) {
+                expected.insert(level.price);
+            }
+        }
+        std::vector<double> crossed = Prices(ladder.GetLevelsCrossed(last, current));
+        ASSERT_EQ(expected, std::multiset<double>(crossed.begin(), crossed.end()));
+        if (current > last) {
+            ASSERT_TRUE(std::is_sorted(crossed.begin(), crossed.end()));
+        } else {
+            ASSERT_TRUE(std::is_sorted(crossed.rbegin(), crossed.rend()));
+        }
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(ladder.Remove(all[i]));
+    }
+    EXPECT_EQ(1000u, ladder.Size());
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "SignalContainer.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+TradeSignal MakeSignal(const std::string& id, const std::string& key, std::vector<std::string> attachedIds = {}) {
+    TradeSignal signal;
+    signal.id = id;
+    signal.signalKey = key;
+    signal.attachedSignalIds = std::move(attachedIds);
+    return signal;
+}
+
+// SignalContainer is a process-wide singleton, so each test uses its own keys and ids and leaves the container empty.
+void Clear(const std::vector<std::string>& keys) {
+    for (const auto& key : keys) {
+        SignalContainer::Instance().RemoveAllSignals(key);
+    }
+}
+
+} // namespace
+
+TEST(SignalContainerTest, CompletesAGroupOnceEveryAttachedSignalIsPresent) {
+    SignalContainer& container = SignalContainer::Instance();
+    container.AddSignal(MakeSignal("graph-parent", "GRAPH_PARENT", {"graph-a", "graph-b"}));
+    EXPECT_FALSE(container.HasCompletedGroups("GRAPH_PARENT"));
+
+    container.AddSignal(MakeSignal("graph-a", "GRAPH_CHILD"));
+    EXPECT_FALSE(container.HasCompletedGroups("GRAPH_PARENT"));
+    container.AddSignal(MakeSignal("graph-b", "GRAPH_CHILD"));
+    EXPECT_TRUE(container.HasCompletedGroups("GRAPH_PARENT"));
+
+    // Removing an attached signal makes the group incomplete again until it is re-added
+    EXPECT_TRUE(container.RemoveSignalById("graph-b"));
+    EXPECT_FALSE(container.HasCompletedGroups("GRAPH_PARENT"));
+    container.AddSignal(MakeSignal("graph-b", "GRAPH_CHILD"));
+
+    std::vector<SignalGroup> groups = container.TakeCompletedGroups("GRAPH_PARENT");
+    ASSERT_EQ(1u, groups.size());
+    EXPECT_EQ("graph-parent", groups[0].parent.id);
+    ASSERT_EQ(2u, groups[0].attachedSignals.size());
+    EXPECT_EQ("graph-a", groups[0].attachedSignals[0].id);
+    EXPECT_EQ("graph-b", groups[0].attachedSignals[1].id);
+
+    // The group and its attached signals left the container together
+    EXPECT_FALSE(container.HasCompletedGroups("GRAPH_PARENT"));
+    EXPECT_FALSE(container.GetSignal("GRAPH_CHILD").has_value());
+    EXPECT_FALSE(container.GetSignal("GRAPH_PARENT").has_value());
+}
+
+TEST(SignalContainerTest, ParentsSharingAnAttachedSignalCompleteOneAtATime) {
+    SignalContainer& container = SignalContainer::Instance();
+    container.AddSignal(MakeSignal("shared-child", "SHARED_CHILD"));
+    container.AddSignal(MakeSignal("shared-p1", "SHARED_PARENT", {"shared-child"}));
+    container.AddSignal(MakeSignal("shared-p2", "SHARED_PARENT", {"shared-child"}));
+
+    std::vector<SignalGroup> groups = container.TakeCompletedGroups("SHARED_PARENT");
+    ASSERT_EQ(1u, groups.size());
+    EXPECT_EQ("shared-p1", groups[0].parent.id);
+    EXPECT_FALSE(container.HasCompletedGroups("SHARED_PARENT"));
+
+    container.AddSignal(MakeSignal("shared-child", "SHARED_CHILD"));
+    groups = container.TakeCompletedGroups("SHARED_PARENT");
+    ASSERT_EQ(1u, groups.size());
+    EXPECT_EQ("shared-p2", groups[0].parent.id);
+    Clear({"SHARED_CHILD", "SHARED_PARENT"});
+}
+
+TEST(SignalContainerTest, CollapsesADuplicatedAttachment) {
+    SignalContainer& container = SignalContainer::Instance();
+    container.AddSignal(MakeSignal("dup-parent", "DUP_PARENT", {"dup-child", "dup-child"}));
+    container.AddSignal(MakeSignal("dup-child", "DUP_CHILD"));
+
+    std::vector<SignalGroup> groups = container.TakeCompletedGroups("DUP_PARENT");
+    ASSERT_EQ(1u, groups.size());
+    ASSERT_EQ(1u, groups[0].parent.attachedSignalIds.size());
+    ASSERT_EQ(1u, groups[0].attachedSignals.size());
+    EXPECT_EQ("dup-child", groups[0].attachedSignals[0].id);
+
+    // No edge from the first parent survives: a new parent completes only once the child is back
+    container.AddSignal(MakeSignal("dup-parent-2", "DUP_PARENT", {"dup-child", "dup-child"}));
+    EXPECT_FALSE(container.HasCompletedGroups("DUP_PARENT"));
+    container.AddSignal(MakeSignal("dup-child", "DUP_CHILD"));
+    EXPECT_TRUE(container.HasCompletedGroups("DUP_PARENT"));
+    EXPECT_TRUE(container.RemoveSignalById("dup-child"));
+    EXPECT_FALSE(container.HasCompletedGroups("DUP_PARENT"));
+
+    groups = container.TakeCompletedGroups("DUP_PARENT");
+    EXPECT_TRUE(groups.empty());
+    Clear({"DUP_CHILD", "DUP_PARENT"});
+    EXPECT_FALSE(container.HasCompletedGroups());
+}
+
+TEST(SignalContainerTest, ReplacesASignalAddedAgainWithTheSameId) {
+    SignalContainer& container = SignalContainer::Instance();
+    TradeSignal original = MakeSignal("replaced", "REPLACE_OLD");
+    original.price = 1.0;
+    container.AddSignal(original);
+
+    // Same id under a different key: the old entry must leave its own key's queue
+    TradeSignal replacement = MakeSignal("replaced", "REPLACE_NEW");
+    replacement.price = 2.0;
+    container.AddSignal(replacement);
+
+    EXPECT_FALSE(container.GetSignal("REPLACE_OLD").has_value());
+    std::optional<TradeSignal> stored = container.GetSignalById("replaced");
+    ASSERT_TRUE(stored.has_value());
+    EXPECT_DOUBLE_EQ(2.0, stored->price);
+
+    std::optional<TradeSignal> taken = container.GetSignal("REPLACE_NEW");
+    ASSERT_TRUE(taken.has_value());
+    EXPECT_DOUBLE_EQ(2.0, taken->price);
+    EXPECT_FALSE(container.GetSignal("REPLACE_NEW").has_value());
+    EXPECT_FALSE(container.GetSignalById("replaced").has_value());
+}
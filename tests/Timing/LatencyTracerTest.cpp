@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "LatencyTracer.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(TraceContextTest, MeasuresStagesFromTheStartOfItsPass) {
+    TraceContext inactive;
+    EXPECT_FALSE(inactive.IsActive());
+    inactive.Stamp(TraceStage::Generation);
+    EXPECT_EQ(0, inactive.GetStageTimestamp(TraceStage::Generation));
+
+    TraceContext first = TraceContext::Begin();
+    TraceContext second = TraceContext::Begin();
+    EXPECT_TRUE(first.IsActive());
+    EXPECT_GT(second.iteration, first.iteration);
+
+    first.Stamp(TraceStage::Generation);
+    first.Stamp(TraceStage::Submission);
+    EXPECT_GE(first.GetLatencyFromStart(TraceStage::Generation), 0);
+    EXPECT_GE(first.GetLatencyFromStart(TraceStage::Submission), first.GetLatencyFromStart(TraceStage::Generation));
+    EXPECT_EQ(-1, first.GetLatencyFromStart(TraceStage::Ack));
+
+    TraceContext restored = TraceContext::FromJson(first.ToJson());
+    EXPECT_EQ(first.iteration, restored.iteration);
+    EXPECT_EQ(first.processStartNs, restored.processStartNs);
+    EXPECT_EQ(first.stageTimestampsNs, restored.stageTimestampsNs);
+}
+
+TEST(LatencyTracerTest, KeepsTheNewestTracesOldestFirst) {
+    LatencyTracer& tracer = LatencyTracer::Instance();
+    tracer.Record(TraceContext()); // inactive traces are ignored
+    uint64_t recordedBefore = tracer.GetRecordedCount();
+
+    // Wrap the ring so it holds only traces from this test
+    std::vector<uint64_t> iterations;
+    for (size_t i = 0; i < LatencyTracer::Capacity + 10; ++i) {
+        TraceContext trace = TraceContext::Begin();
+        trace.Stamp(TraceStage::Ack);
+        iterations.push_back(trace.iteration);
+        tracer.Record(trace);
+    }
+    EXPECT_EQ(recordedBefore + LatencyTracer::Capacity + 10, tracer.GetRecordedCount());
+
+    std::vector<TraceContext> traces = tracer.Snapshot();
+    ASSERT_EQ(LatencyTracer::Capacity, traces.size());
+    EXPECT_EQ(iterations[10], traces.front().iteration);
+    EXPECT_EQ(iterations.back(), traces.back().iteration);
+    EXPECT_NE(0, traces.back().GetStageTimestamp(TraceStage::Ack));
+
+    nlohmann::json exported = nlohmann::json::parse(tracer.ExportJson());
+    ASSERT_EQ(LatencyTracer::Capacity, exported.size());
+    EXPECT_EQ(iterations.back(), exported.back().at("iteration").get<uint64_t>());
+}
+
+TEST(LatencyTracerTest, SnapshotsOnlyCompleteTracesWhileWritersRun) {
+    LatencyTracer& tracer = LatencyTracer::Instance();
+    // The ring is shared with other tests, so only traces started after this one are checked
+    uint64_t firstIteration = TraceContext::Begin().iteration;
+    std::atomic<int> finishedWriters{0};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 4; ++w) {
+        writers.emplace_back([&tracer, &finishedWriters] {
+            for (int i = 0; i < 20000; ++i) {
+                TraceContext trace = TraceContext::Begin();
+                // Every stage carries the start time, so a torn read would show mismatched values
+                trace.stageTimestampsNs.fill(trace.processStartNs);
+                tracer.Record(trace);
+            }
+            finishedWriters.fetch_add(1);
+        });
+    }
+
+    size_t checked = 0;
+    size_t torn = 0;
+    // Keeps reading until the writers are done, then once more so the ring they left behind is checked too
+    bool writersDone = false;
+    while (!writersDone) {
+        writersDone = finishedWriters.load() == 4;
+        for (const TraceContext& trace : tracer.Snapshot()) {
+            if (trace.iteration <= firstIteration) {
+                continue;
+            }
+            ++checked;
+            for (int64_t timestamp : trace.stageTimestampsNs) {
+                if (timestamp != trace.processStartNs) {
+                    ++torn;
+                    break;
+                }
+            }
+        }
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    EXPECT_EQ(0u, torn);
+    EXPECT_GT(checked, 0u);
+}
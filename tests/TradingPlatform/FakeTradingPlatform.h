@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ITradingPlatform.h"
+#include <atomic>
+
+// Minimal platform for tests that need an ITradingPlatform: a settable price and tick size, no bars and no order routing.
+class FakeTradingPlatform : public ITradingPlatform {
+public:
+    void SetPrice(double price) { price_.store(price); }
+
+    // Sets the price and publishes it, as the platform does when new market data arrives.
+    void PublishPrice(double price) {
+        SetPrice(price);
+        notifier_.Publish();
+    }
+
+    void SetTickSize(double tickSize) { tickSize_ = tickSize; }
+
+    void AddMessageToLog(const std::string&, bool) override {}
+    std::optional<ExecutedOrder> BuyEntry(PendingOrder) override { return std::nullopt; }
+    std::optional<ExecutedOrder> SellEntry(PendingOrder) override { return std::nullopt; }
+    std::optional<ExecutedOrder> BuyExit(ExecutedOrder) override { return std::nullopt; }
+    std::optional<ExecutedOrder> SellExit(ExecutedOrder) override { return std::nullopt; }
+    std::optional<ExecutedOrder> CloseOrCancelOrder(ExecutedOrder) override { return std::nullopt; }
+    std::optional<std::vector<ExecutedOrder>> SubmitOCOOrder(PendingOrder, double, double, double, double, double, double) override { return std::nullopt; }
+    std::optional<BarData> GetBarByOffsetFromCurrent(int) const override { return std::nullopt; }
+    std::optional<BarData> GetBarByTime(const DateTime&) const override { return std::nullopt; }
+    std::vector<BarData> GetBarRangeByOffset(int, int) const override { return {}; }
+    std::vector<BarData> GetBarRangeByTime(const DateTime&, const DateTime&) const override { return {}; }
+    std::optional<BarData> GetBarByIndex(int) const override { return std::nullopt; }
+    TradeStatistics GetAccountWideTradeStatistics() const override { return TradeStatistics(); }
+    TradeStatistics GetCurrentSessionTradeStatistics(bool) const override { return TradeStatistics(); }
+    PositionData GetPositionData() const override { return PositionData(); }
+    void InitializePlatform(ContextType, std::optional<DateTime>, std::optional<DateTime>) override {}
+    void SetBarPeriod(const std::string&, std::string) override {}
+    void SetUpdateIntervalType(const UpdateIntervalType) override {}
+    std::pair<double, double> GetBidAskSpread() const override { return {price_.load(), price_.load()}; }
+    std::vector<MarketDepth> GetBidMarketDepth(int) const override { return {}; }
+    std::vector<MarketDepth> GetAskMarketDepth(int) const override { return {}; }
+    std::vector<MarketOrderData> GetBidMarketOrdersForPrice(double) const override { return {}; }
+    std::vector<MarketOrderData> GetAskMarketOrdersForPrice(double) const override { return {}; }
+    std::vector<TimeAndSales> GetTimeAndSalesData() override { return {}; }
+    std::optional<TimeAndSales> GetLatestTimeAndSales() override { return std::nullopt; }
+    std::vector<TimeAndSales> GetTimeAndSalesForBarIndex(int) override { return {}; }
+    double GetCurrentPrice() override { return price_.load(); }
+    int GetCurrentBarIndex() const override { return 0; }
+    double GetTickSize() override { return tickSize_; }
+    double GetCurrencyValuePerTick() override { return 1.0; }
+    bool IsReadyForTradeIteration() override { return true; }
+    MarketUpdateNotifier& GetMarketUpdateNotifier() override { return notifier_; }
+    Calculations::IndicatorCache& GetIndicatorCache() override { return indicatorCache_; }
+    ContextType GetPlatformContext() const override { return ContextType::Backtesting; }
+    DateTime GetCurrentPlatformTime(bool) const override { return DateTime(); }
+
+private:
+    std::atomic<double> price_{0.0};
+    double tickSize_ = 0.25;
+    MarketUpdateNotifier notifier_;
+    Calculations::IndicatorCache indicatorCache_;
+};
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "MarketUpdateNotifier.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+void WaitUntilParked(const MarketUpdateNotifier& notifier) {
+    while (notifier.GetWaiterCount() == 0) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+TEST(MarketUpdateNotifierTest, CoalescesPublishesBetweenWaitsPerCursor) {
+    MarketUpdateNotifier notifier;
+    uint64_t first = notifier.GetSequence();
+    uint64_t second = notifier.GetSequence();
+
+    notifier.Publish();
+    notifier.Publish();
+    notifier.Publish();
+
+    // Three publishes are one wake-up for a consumer that was not waiting
+    EXPECT_TRUE(notifier.WaitForUpdate(first, std::chrono::milliseconds(0)));
+    EXPECT_EQ(notifier.GetSequence(), first);
+    EXPECT_FALSE(notifier.WaitForUpdate(first, std::chrono::milliseconds(10)));
+
+    // Each consumer has its own cursor, so the first one consuming did not affect the second
+    EXPECT_TRUE(notifier.WaitForUpdate(second, std::chrono::milliseconds(0), WaitPolicy::SpinThenPark, 100));
+    EXPECT_EQ(first, second);
+}
+
+TEST(MarketUpdateNotifierTest, WakesAParkedConsumerOnPublish) {
+    for (WaitPolicy policy : {WaitPolicy::Park, WaitPolicy::SpinThenPark}) {
+        MarketUpdateNotifier notifier;
+        uint64_t cursor = notifier.GetSequence();
+        std::atomic<bool> woke{false};
+
+        std::thread consumer([&] {
+            woke = notifier.WaitForUpdate(cursor, std::chrono::seconds(10), policy, 1000);
+        });
+        WaitUntilParked(notifier);
+        auto published = std::chrono::steady_clock::now();
+        notifier.Publish();
+        consumer.join();
+
+        EXPECT_TRUE(woke);
+        EXPECT_LT(std::chrono::steady_clock::now() - published, std::chrono::seconds(5));
+        EXPECT_EQ(notifier.GetSequence(), cursor);
+    }
+}
+
+TEST(MarketUpdateNotifierTest, WakeAllReleasesWaitersWithoutNewData) {
+    MarketUpdateNotifier notifier;
+    uint64_t cursor = notifier.GetSequence();
+    std::atomic<bool> result{true};
+
+    std::thread consumer([&] { result = notifier.WaitForUpdate(cursor, std::chrono::seconds(10)); });
+    WaitUntilParked(notifier);
+    auto woken = std::chrono::steady_clock::now();
+    notifier.WakeAll();
+    consumer.join();
+
+    EXPECT_FALSE(result);
+    EXPECT_LT(std::chrono::steady_clock::now() - woken, std::chrono::seconds(5));
+}
+
+TEST(MarketUpdateNotifierTest, NeverLosesAPublishRacingAWait) {
+    MarketUpdateNotifier notifier;
+    constexpr uint64_t Publishes = 20000;
+    std::atomic<bool> done{false};
+
+    std::thread consumer([&] {
+        uint64_t cursor = 0;
+        while (cursor < Publishes) {
+            // A missed wake-up would show up as a wait running into its timeout
+            ASSERT_TRUE(notifier.WaitForUpdate(cursor, std::chrono::seconds(5)));
+        }
+        done = true;
+    });
+    for (uint64_t i = 0; i < Publishes; ++i) {
+        notifier.Publish();
+    }
+    consumer.join();
+    EXPECT_TRUE(done);
+}